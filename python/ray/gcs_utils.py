@@ -22,6 +22,7 @@ from ray.core.generated.gcs_pb2 import (
     PubSubMessage,
     WorkerTableData,
     PlacementGroupTableData,
+    SchedulingPolicyType,
 )
 
 __all__ = [
@@ -37,6 +38,7 @@ __all__ = [
     "ResourcesData",
     "ObjectTableData",
     "ProfileTableData",
+    "SchedulingPolicyType",
     "TablePrefix",
     "TablePubsub",
     "TaskTableData",
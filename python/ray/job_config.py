@@ -13,6 +13,11 @@ class JobConfig:
         code_search_path (list): A list of directories or jar files that
             specify the search path for user code. This will be used as
             `CLASSPATH` in Java and `PYTHONPATH` in Python.
+        scheduling_policy (str): How the raylets pick the node that a task
+            or an actor of the job runs on. One of "default" (local node
+            first), "hybrid" (pack onto nodes until they are half utilized,
+            by default, then spread), "spread" (round-robin over the nodes) and
+            "random_of_two" (the less utilized of two random nodes).
     """
 
     def __init__(
@@ -21,6 +26,7 @@ class JobConfig:
             num_java_workers_per_process=1,
             jvm_options=None,
             code_search_path=None,
+            scheduling_policy="default",
     ):
         if worker_env is None:
             self.worker_env = dict()
@@ -35,6 +41,25 @@ class JobConfig:
             self.code_search_path = []
         else:
             self.code_search_path = code_search_path
+        self.scheduling_policy = scheduling_policy
+
+    @property
+    def scheduling_policy(self):
+        return self._scheduling_policy
+
+    @scheduling_policy.setter
+    def scheduling_policy(self, scheduling_policy):
+        policy_types = ray.gcs_utils.SchedulingPolicyType
+        policy_name = str(scheduling_policy).upper() + "_POLICY"
+        if policy_name not in policy_types.keys():
+            valid_policies = [
+                name[:-len("_POLICY")].lower() for name in policy_types.keys()
+            ]
+            raise ValueError(
+                "Invalid scheduling_policy {!r}, expected one of {}.".format(
+                    scheduling_policy, valid_policies))
+        self._scheduling_policy = scheduling_policy
+        self._scheduling_policy_type = policy_types.Value(policy_name)
 
     def serialize(self):
         job_config = ray.gcs_utils.JobConfig()
@@ -44,4 +69,5 @@ class JobConfig:
             self.num_java_workers_per_process)
         job_config.jvm_options.extend(self.jvm_options)
         job_config.code_search_path.extend(self.code_search_path)
+        job_config.scheduling_policy = self._scheduling_policy_type
         return job_config.SerializeToString()
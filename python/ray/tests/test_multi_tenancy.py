@@ -126,6 +126,20 @@ def test_worker_env(shutdown_only):
     assert ray.get(get_env.remote("foo2")) == "bar2"
 
 
+def test_job_config_scheduling_policy():
+    job_config = ray.job_config.JobConfig(scheduling_policy="spread")
+    assert job_config.scheduling_policy == "spread"
+    job_config.scheduling_policy = "random_of_two"
+    assert job_config.scheduling_policy == "random_of_two"
+
+    # An unknown policy is rejected when it is set, not when the job starts.
+    with pytest.raises(ValueError):
+        ray.job_config.JobConfig(scheduling_policy="round_robin")
+    with pytest.raises(ValueError):
+        job_config.scheduling_policy = "round_robin"
+    assert job_config.scheduling_policy == "random_of_two"
+
+
 def test_worker_capping_kill_idle_workers(shutdown_only):
     # Avoid starting initial workers by setting num_cpus to 0.
     ray.init(num_cpus=0)
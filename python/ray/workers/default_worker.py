@@ -124,12 +124,27 @@ parser.add_argument(
     default=ray_constants.LOGGING_ROTATE_BACKUP_COUNT,
     help="Specify the backup count of rotated log file, default is "
     f"{ray_constants.LOGGING_ROTATE_BACKUP_COUNT}.")
+parser.add_argument(
+    "--zygote-socket",
+    required=False,
+    type=str,
+    default=None,
+    help="If set, fork workers on requests to this socket instead of "
+    "running a worker. Used by the raylet to start workers faster.")
 if __name__ == "__main__":
     # NOTE(sang): For some reason, if we move the code below
     # to a separate function, tensorflow will capture that method
     # as a step function. For more details, check out
     # https://github.com/ray-project/ray/pull/12225#issue-525059663.
     args = parser.parse_args()
+    if args.zygote_socket is not None:
+        from ray.workers import worker_zygote
+        # Only the forked workers return, with their own arguments.
+        argv, env = worker_zygote.serve(args.zygote_socket)
+        os.environ.update(env)
+        script_index = argv.index(sys.argv[0])
+        sys.argv = argv[script_index:]
+        args = parser.parse_args(sys.argv[1:])
     ray.ray_logging.setup_logger(args.logging_level, args.logging_format)
 
     if args.worker_type == "WORKER":
@@ -0,0 +1,125 @@
+"""A zygote forks Python workers that skip the imports of the worker runtime.
+
+The raylet starts one zygote per job with the command of the workers of the
+job and the `--zygote-socket` argument. The zygote imports the worker runtime
+like a worker, but instead of connecting to the raylet, it listens on an
+abstract Unix socket. For each request, it forks a worker and replies with its
+pid. The forked worker waits until the raylet acknowledges its pid with a
+`start` line, and then starts like a worker started from scratch, with the
+arguments and the environment of the request. It exits instead if the raylet
+closes the connection. Only the raylet that started the zygote may connect.
+
+A request is `<size>\n` followed by `size` bytes: the number of arguments, the
+arguments and the `KEY=VALUE` environment variables, separated by null bytes.
+"""
+
+import logging
+import os
+import signal
+import socket
+import struct
+
+logger = logging.getLogger(__name__)
+
+# How often the zygote checks that the raylet is still alive.
+ACCEPT_TIMEOUT_SECONDS = 1
+
+
+def _read_line(conn):
+    line = b""
+    while True:
+        c = conn.recv(1)
+        if not c:
+            raise ConnectionError("Connection closed before the end of line")
+        if c == b"\n":
+            return line
+        line += c
+
+
+def _peer_pid(conn):
+    creds = conn.getsockopt(socket.SOL_SOCKET, socket.SO_PEERCRED,
+                            struct.calcsize("3i"))
+    pid, _, _ = struct.unpack("3i", creds)
+    return pid
+
+
+def _read_request(conn):
+    size = int(_read_line(conn))
+    payload = b""
+    while len(payload) < size:
+        chunk = conn.recv(size - len(payload))
+        if not chunk:
+            raise ConnectionError(
+                "Connection closed before the end of request")
+        payload += chunk
+    fields = payload.decode().split("\0")
+    num_args = int(fields[0])
+    argv = fields[1:1 + num_args]
+    env = {}
+    for entry in fields[1 + num_args:]:
+        key, _, value = entry.partition("=")
+        env[key] = value
+    return argv, env
+
+
+def serve(socket_name):
+    """Fork workers on request until the raylet exits.
+
+    Args:
+        socket_name (str): The name of the abstract socket to listen on,
+            without the leading null byte.
+
+    Returns:
+        In the forked workers only, the command line arguments and the
+        environment variables of the worker.
+    """
+    raylet_pid = os.getppid()
+    # The forked workers are reaped automatically.
+    signal.signal(signal.SIGCHLD, signal.SIG_IGN)
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind("\0" + socket_name)
+    server.listen(128)
+    server.settimeout(ACCEPT_TIMEOUT_SECONDS)
+    logger.info("Worker zygote is listening on %s.", socket_name)
+
+    while True:
+        try:
+            conn, _ = server.accept()
+        except socket.timeout:
+            if os.getppid() != raylet_pid:
+                logger.info("The raylet exited, exiting the worker zygote.")
+                os._exit(0)
+            continue
+        with conn:
+            # The abstract socket is reachable by any local user, so only the
+            # raylet is served.
+            peer_pid = _peer_pid(conn)
+            if peer_pid != raylet_pid:
+                logger.warning(
+                    "Rejected a connection to the worker zygote from pid %d.",
+                    peer_pid)
+                continue
+            conn.settimeout(None)
+            try:
+                argv, env = _read_request(conn)
+            except (ConnectionError, ValueError):
+                logger.exception("Invalid request to the worker zygote.")
+                continue
+            pid = os.fork()
+            if pid == 0:
+                server.close()
+                signal.signal(signal.SIGCHLD, signal.SIG_DFL)
+                # Wait until the raylet knows the pid of this worker, so that
+                # it does not reject its registration.
+                try:
+                    started = _read_line(conn) == b"start"
+                except OSError:
+                    started = False
+                if not started:
+                    os._exit(1)
+                return argv, env
+            try:
+                conn.sendall(f"{pid}\n".encode())
+            except OSError:
+                # The raylet gave up on the fork, and the worker exits.
+                logger.exception("Failed to reply to the raylet.")
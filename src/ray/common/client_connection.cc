@@ -25,6 +25,7 @@
 #include <thread>
 
 #include "ray/common/ray_config.h"
+#include "ray/util/event_stats.h"
 #include "ray/util/util.h"
 
 namespace ray {
@@ -386,16 +387,19 @@ void ClientConnection::ProcessMessage(const boost::system::error_code &error) {
     read_type_ = error_message_type_;
   }
 
+  std::string message_type;
+  if (message_type_enum_names_.empty()) {
+    message_type = std::to_string(read_type_);
+  } else {
+    message_type = message_type_enum_names_[read_type_];
+  }
   int64_t start_ms = current_time_ms();
-  message_handler_(shared_ClientConnection_from_this(), read_type_, read_message_);
+  {
+    ScopedHandlerTimer timer(debug_label_ + "." + message_type);
+    message_handler_(shared_ClientConnection_from_this(), read_type_, read_message_);
+  }
   int64_t interval = current_time_ms() - start_ms;
   if (interval > RayConfig::instance().handler_warning_timeout_ms()) {
-    std::string message_type;
-    if (message_type_enum_names_.empty()) {
-      message_type = std::to_string(read_type_);
-    } else {
-      message_type = message_type_enum_names_[read_type_];
-    }
     RAY_LOG(WARNING) << "[" << debug_label_ << "]ProcessMessage with type "
                      << message_type << " took " << interval << " ms.";
   }
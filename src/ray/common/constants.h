@@ -26,6 +26,9 @@ constexpr int kObjectIdIndexSize = 32;
 static_assert(kObjectIdIndexSize % CHAR_BIT == 0,
               "ObjectID prefix not a multiple of bytes");
 
+/// The number of bytes in a unit of the memory resource.
+constexpr int64_t kMemoryResourceUnitBytes = 50 * 1024 * 1024;
+
 /// Raylet exit code on plasma store socket error.
 constexpr int kRayletStoreErrorExitCode = 100;
 
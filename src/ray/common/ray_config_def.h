@@ -34,6 +34,14 @@ RAY_CONFIG(int64_t, ray_cookie, 0x5241590000000000)
 /// warning is logged that the handler is taking too long.
 RAY_CONFIG(int64_t, handler_warning_timeout_ms, 1000)
 
+/// Whether the raylet exports the queueing delay and the execution time of each
+/// event loop handler as metrics.
+RAY_CONFIG(bool, event_stats_metrics_enabled, true)
+
+/// The period of the timer that measures how late handlers run on the event loop of
+/// the raylet. 0 disables it.
+RAY_CONFIG(int64_t, event_loop_lag_probe_period_ms, 250)
+
 /// The duration between heartbeats sent by the raylets.
 RAY_CONFIG(int64_t, raylet_heartbeat_timeout_milliseconds, 100)
 /// If a component has not sent a heartbeat in the last num_heartbeats_timeout
@@ -48,6 +56,11 @@ RAY_CONFIG(uint64_t, num_heartbeats_warning, 5)
 /// The duration between reporting resources sent by the raylets.
 RAY_CONFIG(int64_t, raylet_report_resources_period_milliseconds, 100)
 
+/// If positive, the raylets only report the resources and load that changed since
+/// their previous report, and send a full report every this many reports so that the
+/// receivers that missed a delta are resynced. Only used with the new scheduler.
+RAY_CONFIG(uint64_t, resource_usage_full_report_period, 50)
+
 /// The duration between dumping debug info to logs, or -1 to disable.
 RAY_CONFIG(int64_t, debug_dump_period_milliseconds, 10000)
 
@@ -104,6 +117,11 @@ RAY_CONFIG(int64_t, free_objects_period_milliseconds, 1000)
 /// to -1.
 RAY_CONFIG(size_t, free_objects_batch_size, 100)
 
+/// An owner forgets a raylet subscribed to the eviction of its objects, with the
+/// evictions buffered for it, once the raylet has not polled for this long. A raylet
+/// polls continuously while it pins objects of the owner.
+RAY_CONFIG(int64_t, object_eviction_subscriber_timeout_ms, 60000)
+
 RAY_CONFIG(bool, lineage_pinning_enabled, false)
 
 /// Whether to enable the new scheduler. The new scheduler is designed
@@ -170,6 +188,16 @@ RAY_CONFIG(int64_t, kill_worker_timeout_milliseconds, 100)
 /// starting_worker_timeout_callback() is called.
 RAY_CONFIG(int64_t, worker_register_timeout_seconds, 30)
 
+/// Whether the raylet forks the Python workers of each job from a zygote process of
+/// the job, which imports the worker runtime once, instead of starting each of them
+/// from scratch. Workers with environment variable overrides are always started from
+/// scratch. Only supported on Linux.
+RAY_CONFIG(bool, worker_zygote_enabled, false)
+
+/// How long the raylet waits for a worker zygote to fork a worker, before it starts
+/// the worker from scratch instead.
+RAY_CONFIG(int64_t, worker_zygote_fork_timeout_ms, 1000)
+
 /// Allow up to 5 seconds for connecting to Redis.
 RAY_CONFIG(int64_t, redis_db_connect_retries, 50)
 RAY_CONFIG(int64_t, redis_db_connect_wait_milliseconds, 100)
@@ -199,6 +227,11 @@ RAY_CONFIG(uint64_t, object_manager_default_chunk_size, 5 * 1024 * 1024)
 /// excessive memory usage during object broadcast to many receivers.
 RAY_CONFIG(uint64_t, object_manager_max_bytes_in_flight, 2L * 1024 * 1024 * 1024)
 
+/// The maximum number of object store notifications handled by the main thread of
+/// the raylet before it runs the other handlers queued meanwhile, such as the lease
+/// requests.
+RAY_CONFIG(uint64_t, object_store_notification_batch_size, 100)
+
 /// Maximum number of ids in one batch to send to GCS to delete keys.
 RAY_CONFIG(uint32_t, maximum_gcs_deletion_batch_size, 1000)
 
@@ -287,9 +320,20 @@ RAY_CONFIG(bool, put_small_object_in_memory_store, false)
 
 /// Maximum number of tasks that can be in flight between an owner and a worker for which
 /// the owner has been granted a lease. A value >1 is used when we want to enable
-/// pipelining task submission.
+/// pipelining task submission. The pipelined tasks are queued on the worker and run back
+/// to back, and they can be cancelled until they start.
 RAY_CONFIG(uint32_t, max_tasks_in_flight_per_worker, 1)
 
+/// Maximum number of worker leases that an owner requests for a scheduling key with a
+/// single request to the raylet. A value >1 lets large fan-outs lease their workers
+/// with fewer requests, and the raylet schedule the leases in batches.
+RAY_CONFIG(uint32_t, max_worker_leases_per_request, 1)
+
+/// How long a raylet waits for the other leases of a request for several leases
+/// once one of them was granted or spilled back. The leases still pending then are
+/// canceled, so that the granted workers don't wait for the slowest worker to start.
+RAY_CONFIG(int64_t, worker_lease_batch_reply_timeout_ms, 500)
+
 /// Interval to restart dashboard agent after the process exit.
 RAY_CONFIG(uint32_t, agent_restart_interval_ms, 1000)
 
@@ -304,6 +348,33 @@ RAY_CONFIG(int64_t, max_resource_shapes_per_load_report, 100)
 /// data.
 RAY_CONFIG(bool, report_worker_backlog, true)
 
+/// If true, a raylet with no queued tasks and free CPUs asks peers that report
+/// a resource load to hand over lease requests still waiting for dispatch.
+/// Only used by the new scheduler.
+RAY_CONFIG(bool, scheduler_work_stealing_enabled, false)
+
+/// Utilization of a node's most utilized resource above which the hybrid
+/// scheduling policy stops packing tasks onto the node and spreads them instead.
+RAY_CONFIG(float, scheduler_spread_threshold, 0.5)
+
+/// If true, the new scheduler only visits the nodes that the index of available
+/// predefined resources returns for a request, instead of scanning all nodes.
+RAY_CONFIG(bool, scheduler_node_index_enabled, true)
+
+/// How long a raylet waits for all the members of a gang lease to be reserved
+/// before it releases them and fails the request, if the request does not
+/// set a timeout.
+RAY_CONFIG(int64_t, gang_lease_timeout_milliseconds, 1000)
+
+/// Tasks queued on a raylet gain one priority level per this many milliseconds
+/// of waiting, so that tasks of a low priority are not starved by newer tasks of
+/// a higher priority. If 0, the priority of queued tasks does not change.
+RAY_CONFIG(int64_t, task_priority_aging_period_ms, 1000)
+
+/// Tasks queued on a raylet whose deadline is closer than this are scheduled and
+/// dispatched before tasks of any priority, earliest deadline first.
+RAY_CONFIG(int64_t, task_deadline_urgency_window_ms, 1000)
+
 /// The timeout for synchronous GCS requests in seconds.
 RAY_CONFIG(int64_t, gcs_server_request_timeout_seconds, 5)
 
@@ -319,6 +390,31 @@ RAY_CONFIG(int64_t, kill_idle_workers_interval_ms, 200)
 /// The idle time threshold for an idle worker to be killed.
 RAY_CONFIG(int64_t, idle_worker_killing_time_threshold_ms, 1000)
 
+/// Whether to keep idle workers warm, and prestart workers, according to a forecast of
+/// the number of workers each job needs. The forecast follows the busy workers and the
+/// backlog of the job, and decays once they drop.
+RAY_CONFIG(bool, worker_warm_pool_enabled, false)
+
+/// The half life of the forecast of the number of workers of a job once its demand
+/// drops.
+RAY_CONFIG(int64_t, worker_warm_pool_half_life_ms, 60000)
+
+/// Workers are prestarted for a job once it has fewer workers than this fraction of
+/// its forecast.
+RAY_CONFIG(float, worker_warm_pool_prestart_fraction, 0.5)
+
+/// Whether to place each worker process in its own cgroup v2, with a CPU weight and a
+/// memory limit derived from the resources of its lease. Only supported on Linux.
+RAY_CONFIG(bool, worker_cgroups_enabled, false)
+
+/// The cgroup v2 directory delegated to the raylet, under which the cgroups of the
+/// workers are created. It must hold no process.
+RAY_CONFIG(std::string, worker_cgroup_root, "/sys/fs/cgroup/ray")
+
+/// A worker is killed by the raylet once its memory usage reaches this fraction of
+/// the memory limit of its cgroup, before the kernel OOM killer fires.
+RAY_CONFIG(float, worker_cgroup_memory_kill_fraction, 0.95)
+
 /// Whether start the Plasma Store as a Raylet thread.
 RAY_CONFIG(bool, ownership_based_object_directory_enabled, false)
 
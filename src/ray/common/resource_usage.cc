@@ -0,0 +1,206 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/resource_usage.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ray {
+
+namespace {
+
+using ResourceMap = google::protobuf::Map<std::string, double>;
+using ShapeKey = std::map<std::string, double>;
+
+ShapeKey GetShapeKey(const rpc::ResourceDemand &demand) {
+  return ShapeKey(demand.shape().begin(), demand.shape().end());
+}
+
+bool HasNoDemand(const rpc::ResourceDemand &demand) {
+  return demand.num_ready_requests_queued() == 0 &&
+         demand.num_infeasible_requests_queued() == 0 && demand.backlog_size() == 0;
+}
+
+bool IsSameDemand(const rpc::ResourceDemand &lhs, const rpc::ResourceDemand &rhs) {
+  return lhs.num_ready_requests_queued() == rhs.num_ready_requests_queued() &&
+         lhs.num_infeasible_requests_queued() == rhs.num_infeasible_requests_queued() &&
+         lhs.backlog_size() == rhs.backlog_size();
+}
+
+/// Add the entries of `current` that differ from those of `base` to `delta`, and
+/// return the names of the entries of `base` that are not in `current`.
+std::vector<std::string> DiffResourceMap(const ResourceMap &base,
+                                         const ResourceMap &current,
+                                         ResourceMap *delta) {
+  for (const auto &entry : current) {
+    auto it = base.find(entry.first);
+    if (it == base.end() || it->second != entry.second) {
+      (*delta)[entry.first] = entry.second;
+    }
+  }
+  std::vector<std::string> removed;
+  for (const auto &entry : base) {
+    if (current.count(entry.first) == 0) {
+      removed.push_back(entry.first);
+    }
+  }
+  return removed;
+}
+
+/// Update the entries of `usage` with those of a delta. In a full usage, an entry
+/// that dropped to 0 is removed.
+void UpdateResourceMap(const ResourceMap &delta, bool is_full, ResourceMap *usage) {
+  for (const auto &entry : delta) {
+    if (is_full && entry.second == 0) {
+      usage->erase(entry.first);
+    } else {
+      (*usage)[entry.first] = entry.second;
+    }
+  }
+}
+
+}  // namespace
+
+void ComputeResourceUsageDelta(const rpc::ResourcesData &base,
+                               const rpc::ResourcesData &current,
+                               rpc::ResourcesData *delta) {
+  delta->set_node_id(current.node_id());
+  delta->set_usage_version(current.usage_version());
+  delta->set_base_usage_version(base.usage_version());
+  delta->set_should_global_gc(current.should_global_gc());
+
+  for (const auto &name : DiffResourceMap(base.resources_total(),
+                                          current.resources_total(),
+                                          delta->mutable_resources_total())) {
+    delta->add_resources_deleted(name);
+  }
+  for (const auto &name : DiffResourceMap(base.resources_available(),
+                                          current.resources_available(),
+                                          delta->mutable_resources_available())) {
+    // The available capacity of a deleted resource goes away with the resource.
+    if (current.resources_total().count(name) > 0) {
+      (*delta->mutable_resources_available())[name] = 0;
+    }
+  }
+  delta->set_resources_available_changed(delta->resources_total_size() > 0 ||
+                                         delta->resources_available_size() > 0 ||
+                                         delta->resources_deleted_size() > 0);
+
+  for (const auto &name : DiffResourceMap(base.resource_load(), current.resource_load(),
+                                          delta->mutable_resource_load())) {
+    (*delta->mutable_resource_load())[name] = 0;
+  }
+  std::map<ShapeKey, const rpc::ResourceDemand *> base_demands;
+  for (const auto &demand : base.resource_load_by_shape().resource_demands()) {
+    base_demands.emplace(GetShapeKey(demand), &demand);
+  }
+  auto demands = delta->mutable_resource_load_by_shape()->mutable_resource_demands();
+  for (const auto &demand : current.resource_load_by_shape().resource_demands()) {
+    auto it = base_demands.find(GetShapeKey(demand));
+    if (it == base_demands.end()) {
+      demands->Add()->CopyFrom(demand);
+      continue;
+    }
+    if (!IsSameDemand(*it->second, demand)) {
+      demands->Add()->CopyFrom(demand);
+    }
+    base_demands.erase(it);
+  }
+  // The shapes that are no longer queued are sent with zero counts.
+  for (const auto &entry : base_demands) {
+    *demands->Add()->mutable_shape() = entry.second->shape();
+  }
+  delta->set_resource_load_changed(delta->resource_load_size() > 0 ||
+                                   demands->size() > 0);
+}
+
+bool ApplyResourceUsageReport(const rpc::ResourcesData &report,
+                              rpc::ResourcesData *usage) {
+  const bool should_global_gc = usage->should_global_gc() || report.should_global_gc();
+  const bool resources_available_changed =
+      usage->resources_available_changed() || report.resources_available_changed();
+  const bool resource_load_changed =
+      usage->resource_load_changed() || report.resource_load_changed();
+  bool in_order = true;
+
+  if (report.base_usage_version() == 0 && usage->base_usage_version() != 0) {
+    // A full report supersedes the delta.
+    usage->CopyFrom(report);
+  } else if (report.base_usage_version() == 0) {
+    usage->set_node_id(report.node_id());
+    usage->set_usage_version(report.usage_version());
+    if (report.resources_total_size() > 0) {
+      *usage->mutable_resources_total() = report.resources_total();
+    }
+    if (report.resources_available_changed()) {
+      *usage->mutable_resources_available() = report.resources_available();
+    }
+    if (report.resource_load_changed()) {
+      *usage->mutable_resource_load() = report.resource_load();
+    }
+    *usage->mutable_resource_load_by_shape() = report.resource_load_by_shape();
+  } else {
+    in_order = report.base_usage_version() == usage->usage_version();
+    const bool is_full = usage->base_usage_version() == 0;
+    usage->set_node_id(report.node_id());
+    usage->set_usage_version(report.usage_version());
+
+    auto deleted = usage->mutable_resources_deleted();
+    for (const auto &name : report.resources_deleted()) {
+      usage->mutable_resources_total()->erase(name);
+      usage->mutable_resources_available()->erase(name);
+      if (!is_full &&
+          std::find(deleted->begin(), deleted->end(), name) == deleted->end()) {
+        usage->add_resources_deleted(name);
+      }
+    }
+    for (const auto &entry : report.resources_total()) {
+      (*usage->mutable_resources_total())[entry.first] = entry.second;
+      deleted->erase(std::remove(deleted->begin(), deleted->end(), entry.first),
+                     deleted->end());
+    }
+    UpdateResourceMap(report.resources_available(), is_full,
+                      usage->mutable_resources_available());
+    UpdateResourceMap(report.resource_load(), is_full, usage->mutable_resource_load());
+
+    auto demands = usage->mutable_resource_load_by_shape()->mutable_resource_demands();
+    std::map<ShapeKey, int> demand_indexes;
+    for (int i = 0; i < demands->size(); i++) {
+      demand_indexes.emplace(GetShapeKey(demands->Get(i)), i);
+    }
+    for (const auto &demand : report.resource_load_by_shape().resource_demands()) {
+      auto it = demand_indexes.find(GetShapeKey(demand));
+      if (it != demand_indexes.end()) {
+        demands->Mutable(it->second)->CopyFrom(demand);
+      } else {
+        demand_indexes.emplace(GetShapeKey(demand), demands->size());
+        demands->Add()->CopyFrom(demand);
+      }
+    }
+    if (is_full) {
+      demands->erase(std::remove_if(demands->begin(), demands->end(), HasNoDemand),
+                     demands->end());
+    }
+  }
+
+  usage->set_should_global_gc(should_global_gc);
+  usage->set_resources_available_changed(resources_available_changed);
+  usage->set_resource_load_changed(resource_load_changed);
+  return in_order;
+}
+
+}  // namespace ray
@@ -0,0 +1,48 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "src/ray/protobuf/gcs.pb.h"
+
+namespace ray {
+
+/// Compute the delta report that brings a receiver of the full report `base` to the
+/// full report `current`. See `ResourcesData.base_usage_version` for the encoding.
+///
+/// \param base The last full report sent by the node.
+/// \param current The current full report of the node.
+/// \param delta[out] The delta report. Its `*_changed` flags tell whether it changed
+/// the resources or the load of the node.
+void ComputeResourceUsageDelta(const rpc::ResourcesData &base,
+                               const rpc::ResourcesData &current,
+                               rpc::ResourcesData *delta);
+
+/// Apply a resource usage report of a node to the last known usage of the node.
+///
+/// If `usage` is a full usage (`base_usage_version` is 0), a delta report updates
+/// its entries and a full report replaces the fields whose `*_changed` flags are
+/// set. If `usage` is a delta itself, for instance a report buffered before it is
+/// sent, a delta report is merged into it and a full report replaces it. The
+/// `*_changed` flags and `should_global_gc` of the report are added to `usage`.
+///
+/// \param report The report to apply.
+/// \param usage[out] The usage to update.
+/// \return False if the report is a delta against another version than that of
+/// `usage`, i.e. a report of the node was missed. The report is applied anyway and
+/// the usage will be resynced by the next full report of the node.
+bool ApplyResourceUsageReport(const rpc::ResourcesData &report,
+                              rpc::ResourcesData *usage);
+
+}  // namespace ray
@@ -0,0 +1,175 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/resource_usage.h"
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+using ResourceMap = std::map<std::string, double>;
+
+class ResourceUsageTest : public ::testing::Test {
+ public:
+  rpc::ResourcesData MakeUsage(uint64_t version, const ResourceMap &total,
+                               const ResourceMap &available, const ResourceMap &load) {
+    rpc::ResourcesData usage;
+    usage.set_node_id("node");
+    usage.set_usage_version(version);
+    usage.mutable_resources_total()->insert(total.begin(), total.end());
+    usage.mutable_resources_available()->insert(available.begin(), available.end());
+    usage.mutable_resource_load()->insert(load.begin(), load.end());
+    usage.set_resources_available_changed(true);
+    usage.set_resource_load_changed(true);
+    return usage;
+  }
+
+  void AddDemand(rpc::ResourcesData *usage, const ResourceMap &shape, int num_ready,
+                 int num_infeasible = 0) {
+    auto demand = usage->mutable_resource_load_by_shape()->add_resource_demands();
+    demand->mutable_shape()->insert(shape.begin(), shape.end());
+    demand->set_num_ready_requests_queued(num_ready);
+    demand->set_num_infeasible_requests_queued(num_infeasible);
+  }
+
+  void ExpectSameUsage(const rpc::ResourcesData &expected,
+                       const rpc::ResourcesData &actual) {
+    ASSERT_EQ(actual.usage_version(), expected.usage_version());
+    ASSERT_EQ(ToMap(actual.resources_total()), ToMap(expected.resources_total()));
+    ASSERT_EQ(ToMap(actual.resources_available()),
+              ToMap(expected.resources_available()));
+    ASSERT_EQ(ToMap(actual.resource_load()), ToMap(expected.resource_load()));
+    ASSERT_EQ(GetDemands(actual), GetDemands(expected));
+  }
+
+ private:
+  ResourceMap ToMap(const google::protobuf::Map<std::string, double> &map) {
+    return ResourceMap(map.begin(), map.end());
+  }
+
+  std::map<ResourceMap, std::tuple<int, int>> GetDemands(
+      const rpc::ResourcesData &usage) {
+    std::map<ResourceMap, std::tuple<int, int>> demands;
+    for (const auto &demand : usage.resource_load_by_shape().resource_demands()) {
+      demands[ToMap(demand.shape())] = std::make_tuple(
+          demand.num_ready_requests_queued(), demand.num_infeasible_requests_queued());
+    }
+    return demands;
+  }
+};
+
+TEST_F(ResourceUsageTest, DeltaTest) {
+  auto base = MakeUsage(1, {{"CPU", 4}, {"GPU", 1}, {"custom", 1}},
+                        {{"CPU", 2}, {"GPU", 1}, {"custom", 1}}, {{"CPU", 2}});
+  AddDemand(&base, {{"CPU", 1}}, 2);
+  AddDemand(&base, {{"GPU", 1}}, 1);
+  auto current = MakeUsage(2, {{"CPU", 4}, {"GPU", 1}}, {{"CPU", 3}}, {{"GPU", 1}});
+  AddDemand(&current, {{"GPU", 1}}, 0, 1);
+
+  rpc::ResourcesData delta;
+  ComputeResourceUsageDelta(base, current, &delta);
+  ASSERT_EQ(delta.usage_version(), 2);
+  ASSERT_EQ(delta.base_usage_version(), 1);
+  // Only the changed entries are sent.
+  ASSERT_EQ(delta.resources_total_size(), 0);
+  ASSERT_EQ(delta.resources_deleted_size(), 1);
+  ASSERT_EQ(delta.resources_deleted(0), "custom");
+  ASSERT_EQ(delta.resources_available_size(), 2);
+  ASSERT_EQ(delta.resources_available().at("GPU"), 0);
+  ASSERT_EQ(delta.resource_load().at("CPU"), 0);
+  ASSERT_EQ(delta.resource_load_by_shape().resource_demands_size(), 2);
+  ASSERT_TRUE(delta.resources_available_changed());
+  ASSERT_TRUE(delta.resource_load_changed());
+
+  auto usage = base;
+  ASSERT_TRUE(ApplyResourceUsageReport(delta, &usage));
+  ExpectSameUsage(current, usage);
+  ASSERT_EQ(usage.base_usage_version(), 0);
+  ASSERT_EQ(usage.resources_deleted_size(), 0);
+
+  // Nothing is sent if nothing changed.
+  rpc::ResourcesData empty_delta;
+  ComputeResourceUsageDelta(current, current, &empty_delta);
+  ASSERT_FALSE(empty_delta.resources_available_changed());
+  ASSERT_FALSE(empty_delta.resource_load_changed());
+}
+
+TEST_F(ResourceUsageTest, MergeDeltasTest) {
+  auto first = MakeUsage(1, {{"CPU", 4}, {"custom", 1}}, {{"CPU", 4}, {"custom", 1}},
+                         {});
+  auto second = MakeUsage(2, {{"CPU", 4}}, {{"CPU", 2}}, {{"CPU", 1}});
+  AddDemand(&second, {{"CPU", 1}}, 1);
+  auto third = MakeUsage(3, {{"CPU", 4}, {"custom", 2}}, {{"CPU", 2}, {"custom", 2}},
+                         {});
+
+  // A receiver that only gets the merged delta ends up with the last usage.
+  rpc::ResourcesData buffered;
+  ComputeResourceUsageDelta(first, second, &buffered);
+  rpc::ResourcesData delta;
+  ComputeResourceUsageDelta(second, third, &delta);
+  ASSERT_TRUE(ApplyResourceUsageReport(delta, &buffered));
+  ASSERT_EQ(buffered.base_usage_version(), 1);
+  ASSERT_EQ(buffered.usage_version(), 3);
+  // The resource was added back, so it is no longer deleted.
+  ASSERT_EQ(buffered.resources_deleted_size(), 0);
+
+  auto usage = first;
+  ASSERT_TRUE(ApplyResourceUsageReport(buffered, &usage));
+  ExpectSameUsage(third, usage);
+}
+
+TEST_F(ResourceUsageTest, MissedDeltaTest) {
+  auto first = MakeUsage(1, {{"CPU", 4}}, {{"CPU", 4}}, {});
+  auto second = MakeUsage(2, {{"CPU", 4}}, {{"CPU", 2}}, {});
+  auto third = MakeUsage(3, {{"CPU", 4}}, {{"CPU", 1}}, {});
+  rpc::ResourcesData delta;
+  ComputeResourceUsageDelta(second, third, &delta);
+
+  // The delta is applied even though the previous one was missed.
+  auto usage = first;
+  ASSERT_FALSE(ApplyResourceUsageReport(delta, &usage));
+  ExpectSameUsage(third, usage);
+
+  // A full report resyncs the usage.
+  rpc::ResourcesData unknown;
+  ASSERT_FALSE(ApplyResourceUsageReport(delta, &unknown));
+  ASSERT_TRUE(ApplyResourceUsageReport(third, &unknown));
+  ExpectSameUsage(third, unknown);
+
+  // A full report replaces a buffered delta.
+  ASSERT_TRUE(ApplyResourceUsageReport(first, &delta));
+  ASSERT_EQ(delta.base_usage_version(), 0);
+  ExpectSameUsage(first, delta);
+}
+
+TEST_F(ResourceUsageTest, UnversionedReportTest) {
+  auto usage = MakeUsage(0, {{"CPU", 4}}, {{"CPU", 4}}, {{"CPU", 1}});
+  // Reports without versions only replace the fields whose flags are set.
+  rpc::ResourcesData report;
+  (*report.mutable_resources_available())["CPU"] = 2;
+  report.set_resources_available_changed(true);
+  report.set_should_global_gc(true);
+  usage.set_should_global_gc(false);
+  ASSERT_TRUE(ApplyResourceUsageReport(report, &usage));
+  ASSERT_EQ(usage.resources_total().at("CPU"), 4);
+  ASSERT_EQ(usage.resources_available().at("CPU"), 2);
+  ASSERT_EQ(usage.resource_load().at("CPU"), 1);
+  ASSERT_TRUE(usage.should_global_gc());
+}
+
+}  // namespace ray
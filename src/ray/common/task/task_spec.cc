@@ -80,6 +80,11 @@ void TaskSpecification::ComputeResources() {
     // Map the scheduling class descriptor to an integer for performance.
     auto sched_cls = GetRequiredResources();
     sched_cls_id_ = GetSchedulingClass(sched_cls);
+    if (GetRequiredPlacementResources().IsEqual(sched_cls)) {
+      placement_sched_cls_id_ = sched_cls_id_;
+    } else {
+      placement_sched_cls_id_ = GetSchedulingClass(GetRequiredPlacementResources());
+    }
   }
 }
 
@@ -116,6 +121,11 @@ const SchedulingClass TaskSpecification::GetSchedulingClass() const {
   return sched_cls_id_;
 }
 
+const SchedulingClass TaskSpecification::GetPlacementSchedulingClass() const {
+  RAY_CHECK(placement_sched_cls_id_ > 0);
+  return placement_sched_cls_id_;
+}
+
 size_t TaskSpecification::NumArgs() const { return message_->args_size(); }
 
 size_t TaskSpecification::NumReturns() const { return message_->num_returns(); }
@@ -202,6 +212,10 @@ TaskSpecification::OverrideEnvironmentVariables() const {
   return MapFromProtobuf(message_->override_environment_variables());
 }
 
+int32_t TaskSpecification::GetPriority() const { return message_->priority(); }
+
+int64_t TaskSpecification::GetDeadlineMs() const { return message_->deadline_ms(); }
+
 bool TaskSpecification::IsDriverTask() const {
   return message_->type() == TaskType::DRIVER_TASK;
 }
@@ -100,6 +100,14 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   /// \return The scheduling class used for fair task queueing.
   const SchedulingClass GetSchedulingClass() const;
 
+  /// Return the scheduling class whose descriptor is the placement resources
+  /// of the task. This is the same as GetSchedulingClass() unless the task
+  /// needs more resources to be placed than to run, e.g. an actor creation
+  /// task.
+  ///
+  /// \return The scheduling class of the placement resources.
+  const SchedulingClass GetPlacementSchedulingClass() const;
+
   /// Return the resources that are to be acquired during the execution of this
   /// task.
   ///
@@ -135,6 +143,13 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
 
   std::unordered_map<std::string, std::string> OverrideEnvironmentVariables() const;
 
+  /// Return the priority of the lease request of this task.
+  int32_t GetPriority() const;
+
+  /// Return the time by which this task should start, in milliseconds since the
+  /// Unix epoch, or 0 if the task has no deadline.
+  int64_t GetDeadlineMs() const;
+
   bool IsDriverTask() const;
 
   Language GetLanguage() const;
@@ -213,6 +228,8 @@ class TaskSpecification : public MessageWrapper<rpc::TaskSpec> {
   std::shared_ptr<ResourceSet> required_placement_resources_;
   /// Cached scheduling class of this task.
   SchedulingClass sched_cls_id_;
+  /// Cached scheduling class of the placement resources of this task.
+  SchedulingClass placement_sched_cls_id_ = 0;
 
   /// Below static fields could be mutated in `ComputeResources` concurrently due to
   /// multi-threading, we need a mutex to protect it.
@@ -116,6 +116,16 @@ class TaskSpecBuilder {
     return *this;
   }
 
+  /// Set the priority and the deadline of the lease request of the task.
+  /// See `common.proto` for meaning of the arguments.
+  ///
+  /// \return Reference to the builder object itself.
+  TaskSpecBuilder &SetSchedulingPriority(int32_t priority, int64_t deadline_ms = 0) {
+    message_->set_priority(priority);
+    message_->set_deadline_ms(deadline_ms);
+    return *this;
+  }
+
   /// Set the driver attributes of the task spec.
   /// See `common.proto` for meaning of the arguments.
   ///
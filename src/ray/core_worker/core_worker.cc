@@ -299,7 +299,10 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       num_executed_tasks_(0),
       task_execution_service_work_(task_execution_service_),
       resource_ids_(new ResourceMappingType()),
-      grpc_service_(io_service_, *this) {
+      grpc_service_(io_service_, *this),
+      eviction_publisher_(
+          RayConfig::instance().object_eviction_subscriber_timeout_ms(),
+          []() { return current_time_ms(); }) {
   // Initialize task receivers.
   if (options_.worker_type == WorkerType::WORKER || options_.is_local_mode) {
     RAY_CHECK(options_.task_execution_callback != nullptr);
@@ -514,7 +517,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
           local_raylet_id, RayConfig::instance().worker_lease_timeout_milliseconds(),
           std::move(actor_creator),
           RayConfig::instance().max_tasks_in_flight_per_worker(),
-          boost::asio::steady_timer(io_service_)));
+          boost::asio::steady_timer(io_service_),
+          RayConfig::instance().max_worker_leases_per_request()));
   future_resolver_.reset(
       new FutureResolver(memory_store_, core_worker_client_pool_, rpc_address_));
   // Unfortunately the raylet client has to be constructed after the receivers.
@@ -656,6 +660,7 @@ void CoreWorker::RunIOService() {
 
 void CoreWorker::OnNodeRemoved(const NodeID &node_id) {
   RAY_LOG(INFO) << "Node failure " << node_id;
+  eviction_publisher_.RemoveSubscriber(node_id);
   const auto lost_objects = reference_counter_->ResetObjectsOnRemovedNode(node_id);
   // Delete the objects from the in-memory store to indicate that they are not
   // available. The object recovery manager will guarantee that a new value
@@ -769,6 +774,7 @@ void CoreWorker::InternalHeartbeat(const boost::system::error_code &error) {
     }
     to_resubmit_.pop_front();
   }
+  eviction_publisher_.RemoveStaleSubscribers();
   internal_timer_.expires_at(internal_timer_.expiry() +
                              boost::asio::chrono::milliseconds(kInternalHeartbeatMillis));
   internal_timer_.async_wait(boost::bind(&CoreWorker::InternalHeartbeat, this, _1));
@@ -2158,6 +2164,44 @@ void CoreWorker::HandleWaitForObjectEviction(
   }
 }
 
+void CoreWorker::HandleAddObjectEvictionSubscriptions(
+    const rpc::AddObjectEvictionSubscriptionsRequest &request,
+    rpc::AddObjectEvictionSubscriptionsReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+
+  const auto subscriber_id = NodeID::FromBinary(request.subscriber_id());
+  eviction_publisher_.AddSubscriber(subscriber_id);
+  auto respond = [this, subscriber_id](const ObjectID &object_id) {
+    eviction_publisher_.PublishObjectEviction(subscriber_id, object_id);
+  };
+  for (const auto &object_id_binary : request.object_ids()) {
+    const auto object_id = ObjectID::FromBinary(object_id_binary);
+    // The object might have already been evicted by the time we get this
+    // request, in which case the raylet can unpin it right away.
+    if (!reference_counter_->SetDeleteCallback(object_id, respond)) {
+      RAY_LOG(DEBUG) << "ObjectID reference already gone for " << object_id;
+      reply->add_evicted_object_ids(object_id_binary);
+    }
+  }
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
+void CoreWorker::HandleGetObjectEvictions(const rpc::GetObjectEvictionsRequest &request,
+                                          rpc::GetObjectEvictionsReply *reply,
+                                          rpc::SendReplyCallback send_reply_callback) {
+  if (HandleWrongRecipient(WorkerID::FromBinary(request.intended_worker_id()),
+                           send_reply_callback)) {
+    return;
+  }
+
+  eviction_publisher_.HandleGetObjectEvictions(
+      NodeID::FromBinary(request.subscriber_id()), reply, send_reply_callback);
+}
+
 void CoreWorker::HandleAddObjectLocationOwner(
     const rpc::AddObjectLocationOwnerRequest &request,
     rpc::AddObjectLocationOwnerReply *reply, rpc::SendReplyCallback send_reply_callback) {
@@ -2250,9 +2294,15 @@ void CoreWorker::HandleCancelTask(const rpc::CancelTaskRequest &request,
   absl::MutexLock lock(&mutex_);
   TaskID task_id = TaskID::FromBinary(request.intended_task_id());
   bool success = main_thread_task_id_ == task_id;
+  bool is_running = success;
+  if (!is_running && direct_task_receiver_ != nullptr) {
+    // The task may be queued behind other tasks pipelined to this worker, in which
+    // case it is replied to as cancelled without being executed.
+    success = direct_task_receiver_->CancelQueuedNormalTask(task_id);
+  }
 
   // Try non-force kill
-  if (success && !request.force_kill()) {
+  if (is_running && !request.force_kill()) {
     RAY_LOG(INFO) << "Interrupting a running task " << main_thread_task_id_;
     success = options_.kill_main();
   }
@@ -2267,7 +2317,7 @@ void CoreWorker::HandleCancelTask(const rpc::CancelTaskRequest &request,
   send_reply_callback(Status::OK(), nullptr, nullptr);
 
   // Do force kill after reply callback sent
-  if (success && request.force_kill()) {
+  if (is_running && success && request.force_kill()) {
     RAY_LOG(INFO) << "Force killing a worker running " << main_thread_task_id_;
     Disconnect();
     if (options_.enable_logging) {
@@ -24,6 +24,7 @@
 #include "ray/core_worker/context.h"
 #include "ray/core_worker/future_resolver.h"
 #include "ray/core_worker/lease_policy.h"
+#include "ray/core_worker/object_eviction_publisher.h"
 #include "ray/core_worker/object_recovery_manager.h"
 #include "ray/core_worker/profiling.h"
 #include "ray/core_worker/reference_count.h"
@@ -840,6 +841,17 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
                                    rpc::WaitForObjectEvictionReply *reply,
                                    rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandleAddObjectEvictionSubscriptions(
+      const rpc::AddObjectEvictionSubscriptionsRequest &request,
+      rpc::AddObjectEvictionSubscriptionsReply *reply,
+      rpc::SendReplyCallback send_reply_callback) override;
+
+  /// Implements gRPC server handler.
+  void HandleGetObjectEvictions(const rpc::GetObjectEvictionsRequest &request,
+                                rpc::GetObjectEvictionsReply *reply,
+                                rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleWaitForRefRemoved(const rpc::WaitForRefRemovedRequest &request,
                                rpc::WaitForRefRemovedReply *reply,
@@ -1238,6 +1250,10 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   void PlasmaCallback(SetResultCallback success, std::shared_ptr<RayObject> ray_object,
                       ObjectID object_id, void *py_future);
 
+  /// Reports the eviction of objects subscribed through
+  /// AddObjectEvictionSubscriptions to the raylets that pinned them.
+  ObjectEvictionPublisher eviction_publisher_;
+
   /// Whether we are shutting down and not running further tasks.
   bool exiting_ = false;
 
@@ -0,0 +1,108 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/object_eviction_publisher.h"
+
+#include "ray/util/logging.h"
+
+namespace ray {
+
+ObjectEvictionPublisher::ObjectEvictionPublisher(int64_t subscriber_timeout_ms,
+                                                 std::function<int64_t()> get_time_ms)
+    : subscriber_timeout_ms_(subscriber_timeout_ms),
+      get_time_ms_(std::move(get_time_ms)) {}
+
+void ObjectEvictionPublisher::AddSubscriber(const NodeID &subscriber_id) {
+  absl::MutexLock lock(&mutex_);
+  subscribers_[subscriber_id].last_seen_ms = get_time_ms_();
+}
+
+void ObjectEvictionPublisher::HandleGetObjectEvictions(
+    const NodeID &subscriber_id, rpc::GetObjectEvictionsReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  absl::MutexLock lock(&mutex_);
+  auto &subscriber = subscribers_[subscriber_id];
+  subscriber.last_seen_ms = get_time_ms_();
+  if (subscriber.send_reply_callback) {
+    // The raylet only keeps one long-poll outstanding, so a previous one must
+    // be stale. Reply to it so that it doesn't leak.
+    subscriber.send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+  subscriber.reply = reply;
+  subscriber.send_reply_callback = std::move(send_reply_callback);
+  if (!subscriber.evicted_object_ids.empty()) {
+    Reply(&subscriber);
+  }
+}
+
+void ObjectEvictionPublisher::PublishObjectEviction(const NodeID &subscriber_id,
+                                                    const ObjectID &object_id) {
+  absl::MutexLock lock(&mutex_);
+  auto it = subscribers_.find(subscriber_id);
+  if (it == subscribers_.end()) {
+    RAY_LOG(DEBUG) << "Dropping the eviction of " << object_id << " for removed node "
+                   << subscriber_id;
+    return;
+  }
+  it->second.evicted_object_ids.push_back(object_id);
+  if (it->second.send_reply_callback) {
+    Reply(&it->second);
+  }
+}
+
+void ObjectEvictionPublisher::RemoveSubscriber(const NodeID &subscriber_id) {
+  absl::MutexLock lock(&mutex_);
+  auto it = subscribers_.find(subscriber_id);
+  if (it == subscribers_.end()) {
+    return;
+  }
+  if (it->second.send_reply_callback) {
+    it->second.send_reply_callback(Status::OK(), nullptr, nullptr);
+  }
+  subscribers_.erase(it);
+}
+
+void ObjectEvictionPublisher::RemoveStaleSubscribers() {
+  absl::MutexLock lock(&mutex_);
+  const int64_t now_ms = get_time_ms_();
+  for (auto it = subscribers_.begin(); it != subscribers_.end();) {
+    if (!it->second.send_reply_callback &&
+        now_ms - it->second.last_seen_ms > subscriber_timeout_ms_) {
+      RAY_LOG(DEBUG) << "Removing eviction subscriber " << it->first << " with "
+                     << it->second.evicted_object_ids.size() << " buffered evictions";
+      subscribers_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+}
+
+size_t ObjectEvictionPublisher::NumSubscribers() const {
+  absl::MutexLock lock(&mutex_);
+  return subscribers_.size();
+}
+
+void ObjectEvictionPublisher::Reply(Subscriber *subscriber) {
+  RAY_LOG(DEBUG) << "Replying to GetObjectEvictions with "
+                 << subscriber->evicted_object_ids.size() << " objects";
+  for (const auto &object_id : subscriber->evicted_object_ids) {
+    subscriber->reply->add_evicted_object_ids(object_id.Binary());
+  }
+  subscriber->evicted_object_ids.clear();
+  subscriber->send_reply_callback(Status::OK(), nullptr, nullptr);
+  subscriber->send_reply_callback = nullptr;
+  subscriber->reply = nullptr;
+}
+
+}  // namespace ray
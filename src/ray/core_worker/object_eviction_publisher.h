@@ -0,0 +1,109 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "ray/common/id.h"
+#include "ray/rpc/server_call.h"
+#include "src/ray/protobuf/core_worker.pb.h"
+
+namespace ray {
+
+/// \class ObjectEvictionPublisher
+///
+/// Reports the eviction of the objects owned by this worker to the raylets that
+/// pinned them. Each raylet keeps one GetObjectEvictions long-poll outstanding, which
+/// is answered with the evictions buffered since its previous poll. A raylet is
+/// forgotten with its buffered evictions once its node is removed, or once it has not
+/// polled for a while, i.e., it no longer pins objects of this worker. This class is
+/// thread safe.
+class ObjectEvictionPublisher {
+ public:
+  /// Create an eviction publisher.
+  ///
+  /// \param subscriber_timeout_ms A subscriber without an outstanding long-poll is
+  /// removed once it did not poll or subscribe for this long.
+  /// \param get_time_ms Returns the current time in milliseconds.
+  ObjectEvictionPublisher(int64_t subscriber_timeout_ms,
+                          std::function<int64_t()> get_time_ms);
+
+  /// Register a raylet that subscribed to the eviction of objects.
+  ///
+  /// \param subscriber_id The node of the raylet.
+  void AddSubscriber(const NodeID &subscriber_id) LOCKS_EXCLUDED(mutex_);
+
+  /// Handle a long-poll of a raylet. It is answered right away if evictions are
+  /// buffered, and otherwise on the next eviction. A previous long-poll of the same
+  /// raylet is stale and is answered empty.
+  ///
+  /// \param subscriber_id The node of the raylet.
+  /// \param reply The reply to fill with the evicted objects.
+  /// \param send_reply_callback Sends the reply.
+  void HandleGetObjectEvictions(const NodeID &subscriber_id,
+                                rpc::GetObjectEvictionsReply *reply,
+                                rpc::SendReplyCallback send_reply_callback)
+      LOCKS_EXCLUDED(mutex_);
+
+  /// Report an object as evicted to the raylet that pinned it. The eviction is
+  /// buffered until the raylet's next long-poll if none is outstanding, and dropped
+  /// if the raylet was removed.
+  ///
+  /// \param subscriber_id The node of the raylet.
+  /// \param object_id The evicted object.
+  void PublishObjectEviction(const NodeID &subscriber_id, const ObjectID &object_id)
+      LOCKS_EXCLUDED(mutex_);
+
+  /// Remove the raylet of a removed node, answering its outstanding long-poll.
+  ///
+  /// \param subscriber_id The removed node.
+  void RemoveSubscriber(const NodeID &subscriber_id) LOCKS_EXCLUDED(mutex_);
+
+  /// Remove the raylets that did not poll within the timeout.
+  void RemoveStaleSubscribers() LOCKS_EXCLUDED(mutex_);
+
+  /// Return the number of subscribed raylets.
+  size_t NumSubscribers() const LOCKS_EXCLUDED(mutex_);
+
+ private:
+  /// State of a raylet that subscribed to the eviction of objects owned by
+  /// this worker.
+  struct Subscriber {
+    /// Objects that went out of scope and have not been reported yet.
+    std::vector<ObjectID> evicted_object_ids;
+    /// The outstanding long-poll, if any.
+    rpc::GetObjectEvictionsReply *reply = nullptr;
+    rpc::SendReplyCallback send_reply_callback = nullptr;
+    /// When the raylet last subscribed or polled.
+    int64_t last_seen_ms = 0;
+  };
+
+  /// Send the reply of the outstanding long-poll of a subscriber.
+  void Reply(Subscriber *subscriber) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const int64_t subscriber_timeout_ms_;
+  const std::function<int64_t()> get_time_ms_;
+
+  mutable absl::Mutex mutex_;
+
+  /// Raylets that pinned objects owned by this worker, keyed by node ID.
+  absl::flat_hash_map<NodeID, Subscriber> subscribers_ GUARDED_BY(mutex_);
+};
+
+}  // namespace ray
@@ -14,16 +14,17 @@
 
 #include "ray/core_worker/reference_count.h"
 
-#define PRINT_REF_COUNT(it)                                                              \
-  RAY_LOG(DEBUG) << "REF " << it->first << " borrowers: " << it->second.borrowers.size() \
-                 << " local_ref_count: " << it->second.local_ref_count                   \
-                 << " submitted_count: " << it->second.submitted_task_ref_count          \
-                 << " contained_in_owned: " << it->second.contained_in_owned.size()      \
-                 << " contained_in_borrowed: "                                           \
-                 << (it->second.contained_in_borrowed_id.has_value()                     \
-                         ? *it->second.contained_in_borrowed_id                          \
-                         : ObjectID::Nil())                                              \
-                 << " contains: " << it->second.contains.size()                          \
+#define PRINT_REF_COUNT(it)                                                        \
+  RAY_LOG(DEBUG) << "REF " << it->first                                            \
+                 << " borrowers: " << it->second.borrow_info().borrowers.size()    \
+                 << " local_ref_count: " << it->second.local_ref_count             \
+                 << " submitted_count: " << it->second.submitted_task_ref_count    \
+                 << " contained_in_owned: "                                        \
+                 << it->second.nested().contained_in_owned.size()                  \
+                 << " contained_in_borrowed: "                                     \
+                 << it->second.nested().contained_in_borrowed_id.value_or(         \
+                        ObjectID::Nil())                                           \
+                 << " contains: " << it->second.nested().contains.size()           \
                  << " lineage_ref_count: " << it->second.lineage_ref_count;
 
 namespace {}  // namespace
@@ -91,16 +92,16 @@ bool ReferenceCounter::AddBorrowedObjectInternal(const ObjectID &object_id,
     return false;
   }
 
-  it->second.owner_address = owner_address;
+  it->second.owner_address = InternOwnerAddress(owner_address);
 
   if (!outer_id.IsNil()) {
     auto outer_it = object_id_refs_.find(outer_id);
     if (outer_it != object_id_refs_.end() && !outer_it->second.owned_by_us) {
       RAY_LOG(DEBUG) << "Setting borrowed inner ID " << object_id
                      << " contained_in_borrowed: " << outer_id;
-      RAY_CHECK(!it->second.contained_in_borrowed_id.has_value());
-      it->second.contained_in_borrowed_id = outer_id;
-      outer_it->second.contains.insert(object_id);
+      RAY_CHECK(!it->second.nested().contained_in_borrowed_id.has_value());
+      it->second.mutable_nested().contained_in_borrowed_id = outer_id;
+      outer_it->second.mutable_nested().contains.insert(object_id);
     }
   }
   return true;
@@ -113,7 +114,7 @@ void ReferenceCounter::AddObjectRefStats(
   for (const auto &ref : object_id_refs_) {
     auto ref_proto = stats->add_object_refs();
     ref_proto->set_object_id(ref.first.Binary());
-    ref_proto->set_call_site(ref.second.call_site);
+    ref_proto->set_call_site(ref.second.CallSite());
     ref_proto->set_object_size(ref.second.object_size);
     ref_proto->set_local_ref_count(ref.second.local_ref_count);
     ref_proto->set_submitted_task_ref_count(ref.second.submitted_task_ref_count);
@@ -124,11 +125,11 @@ void ReferenceCounter::AddObjectRefStats(
       if (ref.second.object_size <= 0) {
         ref_proto->set_object_size(it->second.first);
       }
-      if (ref.second.call_site.empty()) {
+      if (ref.second.CallSite().empty()) {
         ref_proto->set_call_site(it->second.second);
       }
     }
-    for (const auto &obj_id : ref.second.contained_in_owned) {
+    for (const auto &obj_id : ref.second.nested().contained_in_owned) {
       ref_proto->add_contained_in_owned(obj_id.Binary());
     }
   }
@@ -157,8 +158,14 @@ void ReferenceCounter::AddOwnedObject(const ObjectID &object_id,
   // If the entry doesn't exist, we initialize the direct reference count to zero
   // because this corresponds to a submitted task whose return ObjectID will be created
   // in the frontend language, incrementing the reference count.
-  object_id_refs_.emplace(object_id, Reference(owner_address, call_site, object_size,
-                                               is_reconstructable, pinned_at_raylet_id));
+  auto it = object_id_refs_
+                .emplace(object_id, Reference(InternOwnerAddress(owner_address),
+                                              InternCallSite(call_site), object_size,
+                                              is_reconstructable))
+                .first;
+  if (pinned_at_raylet_id.has_value()) {
+    it->second.mutable_object_locations().pinned_at_raylet_id = pinned_at_raylet_id;
+  }
   if (!inner_ids.empty()) {
     // Mark that this object ID contains other inner IDs. Then, we will not GC
     // the inner objects until the outer object ID goes out of scope.
@@ -194,7 +201,8 @@ void ReferenceCounter::AddLocalReference(const ObjectID &object_id,
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     // NOTE: ownership info for these objects must be added later via AddBorrowedObject.
-    it = object_id_refs_.emplace(object_id, Reference(call_site, -1)).first;
+    it = object_id_refs_.emplace(object_id, Reference(InternCallSite(call_site), -1))
+             .first;
   }
   it->second.local_ref_count++;
   RAY_LOG(DEBUG) << "Add local reference " << object_id;
@@ -438,7 +446,7 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
     // If distributed ref counting is enabled, then delete the object once its
     // ref count across all processes is 0.
     should_delete_value = true;
-    for (const auto &inner_id : it->second.contains) {
+    for (const auto &inner_id : it->second.nested().contains) {
       auto inner_it = object_id_refs_.find(inner_id);
       if (inner_it != object_id_refs_.end()) {
         RAY_LOG(DEBUG) << "Try to delete inner object " << inner_id;
@@ -446,12 +454,12 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
           // If this object ID was nested in an owned object, make sure that
           // the outer object counted towards the ref count for the inner
           // object.
-          RAY_CHECK(inner_it->second.contained_in_owned.erase(id));
+          RAY_CHECK(inner_it->second.mutable_nested().contained_in_owned.erase(id));
         } else {
           // If this object ID was nested in a borrowed object, make sure that
           // we have already returned this information through a previous
           // GetAndClearLocalBorrowers call.
-          RAY_CHECK(!inner_it->second.contained_in_borrowed_id.has_value())
+          RAY_CHECK(!inner_it->second.nested().contained_in_borrowed_id.has_value())
               << "Outer object " << id << ", inner object " << inner_id;
         }
         DeleteReferenceInternal(inner_it, deleted);
@@ -477,6 +485,7 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
     }
 
     freed_objects_.erase(id);
+    ReleaseInternedValues(it->second);
     object_id_refs_.erase(it);
     ShutdownIfNeeded();
   }
@@ -488,7 +497,10 @@ void ReferenceCounter::ReleasePlasmaObject(ReferenceTable::iterator it) {
     it->second.on_delete(it->first);
     it->second.on_delete = nullptr;
   }
-  it->second.pinned_at_raylet_id.reset();
+  if (it->second.object_locations().pinned_at_raylet_id.has_value()) {
+    it->second.mutable_object_locations().pinned_at_raylet_id.reset();
+    it->second.ShrinkSideTables();
+  }
 }
 
 bool ReferenceCounter::SetDeleteCallback(
@@ -527,7 +539,8 @@ std::vector<ObjectID> ReferenceCounter::ResetObjectsOnRemovedNode(
   std::vector<ObjectID> lost_objects;
   for (auto it = object_id_refs_.begin(); it != object_id_refs_.end(); it++) {
     const auto &object_id = it->first;
-    if (it->second.pinned_at_raylet_id.value_or(NodeID::Nil()) == raylet_id) {
+    if (it->second.object_locations().pinned_at_raylet_id.value_or(NodeID::Nil()) ==
+        raylet_id) {
       lost_objects.push_back(object_id);
       ReleasePlasmaObject(it);
     }
@@ -547,11 +560,11 @@ void ReferenceCounter::UpdateObjectPinnedAtRaylet(const ObjectID &object_id,
 
     // The object is still in scope. Track the raylet location until the object
     // has gone out of scope or the raylet fails, whichever happens first.
-    RAY_CHECK(!it->second.pinned_at_raylet_id.has_value());
+    RAY_CHECK(!it->second.object_locations().pinned_at_raylet_id.has_value());
     // Only the owner tracks the location.
     RAY_CHECK(it->second.owned_by_us);
     if (!it->second.OutOfScope(lineage_pinning_enabled_)) {
-      it->second.pinned_at_raylet_id = raylet_id;
+      it->second.mutable_object_locations().pinned_at_raylet_id = raylet_id;
     }
   }
 }
@@ -565,7 +578,8 @@ bool ReferenceCounter::IsPlasmaObjectPinnedOrSpilled(const ObjectID &object_id,
     if (it->second.owned_by_us) {
       *owned_by_us = true;
       *spilled = it->second.spilled;
-      *pinned_at = it->second.pinned_at_raylet_id.value_or(NodeID::Nil());
+      *pinned_at =
+          it->second.object_locations().pinned_at_raylet_id.value_or(NodeID::Nil());
     }
     return true;
   }
@@ -586,7 +600,7 @@ std::unordered_set<ObjectID> ReferenceCounter::GetAllInScopeObjectIDs() const {
   absl::MutexLock lock(&mutex_);
   std::unordered_set<ObjectID> in_scope_object_ids;
   in_scope_object_ids.reserve(object_id_refs_.size());
-  for (auto it : object_id_refs_) {
+  for (const auto &it : object_id_refs_) {
     in_scope_object_ids.insert(it.first);
   }
   return in_scope_object_ids;
@@ -597,7 +611,7 @@ ReferenceCounter::GetAllReferenceCounts() const {
   absl::MutexLock lock(&mutex_);
   std::unordered_map<ObjectID, std::pair<size_t, size_t>> all_ref_counts;
   all_ref_counts.reserve(object_id_refs_.size());
-  for (auto it : object_id_refs_) {
+  for (const auto &it : object_id_refs_) {
     all_ref_counts.emplace(it.first,
                            std::pair<size_t, size_t>(it.second.local_ref_count,
                                                      it.second.submitted_task_ref_count));
@@ -647,21 +661,21 @@ bool ReferenceCounter::GetAndClearLocalBorrowersInternal(const ObjectID &object_
   // Clear the local list of borrowers that we have accumulated. The receiver
   // of the returned borrowed_refs must merge this list into their own list
   // until all active borrowers are merged into the owner.
-  it->second.borrowers.clear();
-  it->second.stored_in_objects.clear();
+  it->second.ClearBorrowInfo();
 
-  if (it->second.contained_in_borrowed_id.has_value()) {
+  if (it->second.nested().contained_in_borrowed_id.has_value()) {
     /// This ID was nested in another ID that we (or a nested task) borrowed.
     /// Make sure that we also returned the ID that contained it.
-    RAY_CHECK(borrowed_refs->count(it->second.contained_in_borrowed_id.value()) > 0);
+    RAY_CHECK(borrowed_refs->count(it->second.nested().contained_in_borrowed_id.value()) >
+              0);
     /// Clear the fact that this ID was nested because we are including it in
     /// the returned borrowed_refs. If the nested ID is not being borrowed by
     /// us, then it will be deleted recursively when deleting the outer ID.
-    it->second.contained_in_borrowed_id.reset();
+    it->second.mutable_nested().contained_in_borrowed_id.reset();
   }
 
   // Attempt to pop children.
-  for (const auto &contained_id : it->second.contains) {
+  for (const auto &contained_id : it->second.nested().contains) {
     GetAndClearLocalBorrowersInternal(contained_id, borrowed_refs);
   }
 
@@ -678,28 +692,30 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
   }
   const auto &borrower_ref = borrower_it->second;
   RAY_LOG(DEBUG) << "Borrower ref " << object_id << " has "
-                 << borrower_ref.borrowers.size() << " borrowers "
+                 << borrower_ref.borrow_info().borrowers.size() << " borrowers "
                  << ", has local: " << borrower_ref.local_ref_count
                  << " submitted: " << borrower_ref.submitted_task_ref_count
-                 << " contained_in_owned " << borrower_ref.contained_in_owned.size();
+                 << " contained_in_owned "
+                 << borrower_ref.nested().contained_in_owned.size();
 
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     it = object_id_refs_.emplace(object_id, Reference()).first;
   }
-  if (!it->second.owner_address && borrower_ref.contained_in_borrowed_id.has_value()) {
+  if (!it->second.owner_address &&
+      borrower_ref.nested().contained_in_borrowed_id.has_value()) {
     // We don't have owner information about this object ID yet and the worker
     // received it because it was nested in another ID that the worker was
     // borrowing. Copy this information to our local table.
     RAY_CHECK(borrower_ref.owner_address);
-    AddBorrowedObjectInternal(object_id, *borrower_it->second.contained_in_borrowed_id,
+    AddBorrowedObjectInternal(object_id, *borrower_ref.nested().contained_in_borrowed_id,
                               *borrower_ref.owner_address);
   }
   std::vector<rpc::WorkerAddress> new_borrowers;
 
   // The worker is still using the reference, so it is still a borrower.
   if (borrower_ref.RefCount() > 0) {
-    auto inserted = it->second.borrowers.insert(worker_addr).second;
+    auto inserted = it->second.mutable_borrow_info().borrowers.insert(worker_addr).second;
     // If we are the owner of id, then send WaitForRefRemoved to borrower.
     if (inserted) {
       RAY_LOG(DEBUG) << "Adding borrower " << worker_addr.ip_address << ":"
@@ -709,8 +725,9 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
   }
 
   // Add any other workers that this worker passed the ID to as new borrowers.
-  for (const auto &nested_borrower : borrower_ref.borrowers) {
-    auto inserted = it->second.borrowers.insert(nested_borrower).second;
+  for (const auto &nested_borrower : borrower_ref.borrow_info().borrowers) {
+    auto inserted =
+        it->second.mutable_borrow_info().borrowers.insert(nested_borrower).second;
     if (inserted) {
       RAY_LOG(DEBUG) << "Adding borrower " << nested_borrower.ip_address << ":"
                      << nested_borrower.port << " to id " << object_id;
@@ -728,14 +745,14 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
 
   // If the borrower stored this object ID inside another object ID that it did
   // not own, then mark that the object ID is nested inside another.
-  for (const auto &stored_in_object : borrower_ref.stored_in_objects) {
+  for (const auto &stored_in_object : borrower_ref.borrow_info().stored_in_objects) {
     AddNestedObjectIdsInternal(stored_in_object.first, {object_id},
                                stored_in_object.second);
   }
 
   // Recursively merge any references that were contained in this object, to
   // handle any borrowers of nested objects.
-  for (const auto &inner_id : borrower_ref.contains) {
+  for (const auto &inner_id : borrower_ref.nested().contains) {
     MergeRemoteBorrowers(inner_id, worker_addr, borrowed_refs);
   }
 }
@@ -774,7 +791,8 @@ void ReferenceCounter::WaitForRefRemoved(const ReferenceTable::iterator &ref_it,
         // Erase the previous borrower.
         auto it = object_id_refs_.find(object_id);
         RAY_CHECK(it != object_id_refs_.end());
-        RAY_CHECK(it->second.borrowers.erase(addr));
+        RAY_CHECK(it->second.mutable_borrow_info().borrowers.erase(addr));
+        it->second.ShrinkSideTables();
         DeleteReferenceInternal(it, nullptr);
       });
 }
@@ -800,12 +818,12 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       // contained in the outer object ID so we do not GC the inner objects
       // until the outer object goes out of scope.
       for (const auto &inner_id : inner_ids) {
-        it->second.contains.insert(inner_id);
+        it->second.mutable_nested().contains.insert(inner_id);
         auto inner_it = object_id_refs_.find(inner_id);
         RAY_CHECK(inner_it != object_id_refs_.end());
         RAY_LOG(DEBUG) << "Setting inner ID " << inner_id
                        << " contained_in_owned: " << object_id;
-        inner_it->second.contained_in_owned.insert(object_id);
+        inner_it->second.mutable_nested().contained_in_owned.insert(object_id);
       }
     }
   } else {
@@ -819,14 +837,16 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       RAY_CHECK(inner_it != object_id_refs_.end());
       // Add the task's caller as a borrower.
       if (inner_it->second.owned_by_us) {
-        auto inserted = inner_it->second.borrowers.insert(owner_address).second;
+        auto inserted =
+            inner_it->second.mutable_borrow_info().borrowers.insert(owner_address).second;
         if (inserted) {
           // Wait for it to remove its reference.
           WaitForRefRemoved(inner_it, owner_address, object_id);
         }
       } else {
-        auto inserted =
-            inner_it->second.stored_in_objects.emplace(object_id, owner_address).second;
+        auto inserted = inner_it->second.mutable_borrow_info()
+                            .stored_in_objects.emplace(object_id, owner_address)
+                            .second;
         // This should be the first time that we have stored this object ID
         // inside this return ID.
         RAY_CHECK(inserted);
@@ -841,7 +861,7 @@ void ReferenceCounter::HandleRefRemoved(const ObjectID &object_id,
   ReferenceTable borrowed_refs;
   RAY_UNUSED(GetAndClearLocalBorrowersInternal(object_id, &borrowed_refs));
   for (const auto &pair : borrowed_refs) {
-    RAY_LOG(DEBUG) << pair.first << " has " << pair.second.borrowers.size()
+    RAY_LOG(DEBUG) << pair.first << " has " << pair.second.borrow_info().borrowers.size()
                    << " borrowers";
   }
   auto it = object_id_refs_.find(object_id);
@@ -919,7 +939,7 @@ bool ReferenceCounter::AddObjectLocation(const ObjectID &object_id,
                      << " that doesn't exist in the reference table";
     return false;
   }
-  it->second.locations.insert(node_id);
+  it->second.mutable_object_locations().locations.insert(node_id);
   return true;
 }
 
@@ -932,7 +952,10 @@ bool ReferenceCounter::RemoveObjectLocation(const ObjectID &object_id,
                      << " that doesn't exist in the reference table";
     return false;
   }
-  it->second.locations.erase(node_id);
+  if (!it->second.object_locations().locations.empty()) {
+    it->second.mutable_object_locations().locations.erase(node_id);
+    it->second.ShrinkSideTables();
+  }
   return true;
 }
 
@@ -945,7 +968,7 @@ absl::optional<absl::flat_hash_set<NodeID>> ReferenceCounter::GetObjectLocations
                      << " that doesn't exist in the reference table";
     return absl::nullopt;
   }
-  return it->second.locations;
+  return it->second.object_locations().locations;
 }
 
 size_t ReferenceCounter::GetObjectSize(const ObjectID &object_id) const {
@@ -981,10 +1004,10 @@ absl::optional<LocalityData> ReferenceCounter::GetLocalityData(
     return absl::nullopt;
   }
 
-  const auto &node_id = it->second.pinned_at_raylet_id;
+  const auto &node_id = it->second.object_locations().pinned_at_raylet_id;
   if (!node_id.has_value()) {
     RAY_LOG(DEBUG)
-        << "Reference " << it->second.call_site << " for object " << object_id
+        << "Reference " << it->second.CallSite() << " for object " << object_id
         << " doesn't have a defined pinned raylet ID, locality data not available";
     return absl::nullopt;
   }
@@ -992,7 +1015,7 @@ absl::optional<LocalityData> ReferenceCounter::GetLocalityData(
 
   const auto object_size = it->second.object_size;
   if (object_size < 0) {
-    RAY_LOG(DEBUG) << "Reference " << it->second.call_site << " for object " << object_id
+    RAY_LOG(DEBUG) << "Reference " << it->second.CallSite() << " for object " << object_id
                    << " has an unknown object size, locality data not available";
     return absl::nullopt;
   }
@@ -1003,26 +1026,66 @@ absl::optional<LocalityData> ReferenceCounter::GetLocalityData(
   return locality_data;
 }
 
+std::shared_ptr<const std::string> ReferenceCounter::InternCallSite(
+    const std::string &call_site) {
+  auto it = call_sites_.find(call_site);
+  if (it == call_sites_.end()) {
+    auto interned = std::make_shared<const std::string>(call_site);
+    it = call_sites_.emplace(*interned, interned).first;
+  }
+  return it->second;
+}
+
+std::shared_ptr<const rpc::Address> ReferenceCounter::InternOwnerAddress(
+    const rpc::Address &owner_address) {
+  const rpc::WorkerAddress key(owner_address);
+  auto it = owner_addresses_.find(key);
+  if (it == owner_addresses_.end()) {
+    it = owner_addresses_
+             .emplace(key, std::make_shared<const rpc::Address>(owner_address))
+             .first;
+  }
+  return it->second;
+}
+
+void ReferenceCounter::ReleaseInternedValues(const Reference &reference) {
+  // The tables hold the other copy of a value that only this reference uses.
+  if (reference.call_site && reference.call_site.use_count() == 2) {
+    auto it = call_sites_.find(*reference.call_site);
+    if (it != call_sites_.end() && it->second == reference.call_site) {
+      call_sites_.erase(it);
+    }
+  }
+  if (reference.owner_address && reference.owner_address.use_count() == 2) {
+    auto it = owner_addresses_.find(rpc::WorkerAddress(*reference.owner_address));
+    if (it != owner_addresses_.end() && it->second == reference.owner_address) {
+      owner_addresses_.erase(it);
+    }
+  }
+}
+
 ReferenceCounter::Reference ReferenceCounter::Reference::FromProto(
     const rpc::ObjectReferenceCount &ref_count) {
   Reference ref;
-  ref.owner_address = ref_count.reference().owner_address();
+  ref.owner_address =
+      std::make_shared<const rpc::Address>(ref_count.reference().owner_address());
   ref.local_ref_count = ref_count.has_local_ref() ? 1 : 0;
 
   for (const auto &borrower : ref_count.borrowers()) {
-    ref.borrowers.insert(rpc::WorkerAddress(borrower));
+    ref.mutable_borrow_info().borrowers.insert(rpc::WorkerAddress(borrower));
   }
   for (const auto &object : ref_count.stored_in_objects()) {
     const auto &object_id = ObjectID::FromBinary(object.object_id());
-    ref.stored_in_objects.emplace(object_id, rpc::WorkerAddress(object.owner_address()));
+    ref.mutable_borrow_info().stored_in_objects.emplace(
+        object_id, rpc::WorkerAddress(object.owner_address()));
   }
   for (const auto &id : ref_count.contains()) {
-    ref.contains.insert(ObjectID::FromBinary(id));
+    ref.mutable_nested().contains.insert(ObjectID::FromBinary(id));
   }
   const auto contained_in_borrowed_id =
       ObjectID::FromBinary(ref_count.contained_in_borrowed_id());
   if (!contained_in_borrowed_id.IsNil()) {
-    ref.contained_in_borrowed_id = contained_in_borrowed_id;
+    ref.mutable_nested().contained_in_borrowed_id = contained_in_borrowed_id;
   }
   return ref;
 }
@@ -1033,18 +1096,18 @@ void ReferenceCounter::Reference::ToProto(rpc::ObjectReferenceCount *ref) const
   }
   bool has_local_ref = RefCount() > 0;
   ref->set_has_local_ref(has_local_ref);
-  for (const auto &borrower : borrowers) {
+  for (const auto &borrower : borrow_info().borrowers) {
     ref->add_borrowers()->CopyFrom(borrower.ToProto());
   }
-  for (const auto &object : stored_in_objects) {
+  for (const auto &object : borrow_info().stored_in_objects) {
     auto ref_object = ref->add_stored_in_objects();
     ref_object->set_object_id(object.first.Binary());
     ref_object->mutable_owner_address()->CopyFrom(object.second.ToProto());
   }
-  if (contained_in_borrowed_id.has_value()) {
-    ref->set_contained_in_borrowed_id(contained_in_borrowed_id->Binary());
+  if (nested().contained_in_borrowed_id.has_value()) {
+    ref->set_contained_in_borrowed_id(nested().contained_in_borrowed_id->Binary());
   }
-  for (const auto &contains_id : contains) {
+  for (const auto &contains_id : nested().contains) {
     ref->add_contains(contains_id.Binary());
   }
 }
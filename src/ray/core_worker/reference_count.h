@@ -19,6 +19,7 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "ray/common/id.h"
 #include "ray/core_worker/lease_policy.h"
@@ -413,21 +414,123 @@ class ReferenceCounter : public ReferenceCounterInterface,
   absl::optional<LocalityData> GetLocalityData(const ObjectID &object_id);
 
  private:
+  /// The IDs that an object is nested in or contains. Most objects are not nested, so
+  /// this is only allocated for the references that are.
+  struct NestedReferenceCount {
+    /// Object IDs that we own and that contain this object ID.
+    /// ObjectIDs are added to this field when we discover that this object
+    /// contains other IDs. This can happen in 2 cases:
+    ///  1. We call ray.put() and store the inner ID(s) in the outer object.
+    ///  2. A task that we submitted returned an ID(s).
+    /// ObjectIDs are erased from this field when their Reference is deleted.
+    absl::flat_hash_set<ObjectID> contained_in_owned;
+    /// An Object ID that we (or one of our children) borrowed that contains
+    /// this object ID, which is also borrowed. This is used in cases where an
+    /// ObjectID is nested. We need to notify the owner of the outer ID of any
+    /// borrowers of this object, so we keep this field around until
+    /// GetAndClearLocalBorrowersInternal is called on the outer ID. This field
+    /// is updated in 2 cases:
+    ///  1. We deserialize an ID that we do not own and that was stored in
+    ///     another object that we do not own.
+    ///  2. Case (1) occurred for a task that we submitted and we also do not
+    ///     own the inner or outer object. Then, we need to notify our caller
+    ///     that the task we submitted is a borrower for the inner ID.
+    /// This field is reset to null once GetAndClearLocalBorrowersInternal is
+    /// called on contained_in_borrowed_id. For each borrower, this field is
+    /// set at most once during the reference's lifetime. If the object ID is
+    /// later found to be nested in a second object, we do not need to remember
+    /// the second ID because we will already have notified the owner of the
+    /// first outer object about our reference.
+    absl::optional<ObjectID> contained_in_borrowed_id;
+    /// The object IDs contained in this object. These could be objects that we
+    /// own or are borrowing. This field is updated in 2 cases:
+    ///  1. We call ray.put() on this ID and store the contained IDs.
+    ///  2. We call ray.get() on an ID whose contents we do not know and we
+    ///     discover that it contains these IDs.
+    absl::flat_hash_set<ObjectID> contains;
+  };
+
+  /// The processes that borrow an object through us. Most objects are never passed
+  /// to another process, so this is only allocated for the references that are.
+  struct BorrowInfo {
+    /// A list of processes that are we gave a reference to that are still
+    /// borrowing the ID. This field is updated in 2 cases:
+    ///  1. If we are a borrower of the ID, then we add a process to this list
+    ///     if we passed that process a copy of the ID via task submission and
+    ///     the process is still using the ID by the time it finishes its task.
+    ///     Borrowers are removed from the list when we recursively merge our
+    ///     list into the owner.
+    ///  2. If we are the owner of the ID, then either the above case, or when
+    ///     we hear from a borrower that it has passed the ID to other
+    ///     borrowers. A borrower is removed from the list when it responds
+    ///     that it is no longer using the reference.
+    absl::flat_hash_set<rpc::WorkerAddress> borrowers;
+    /// When a process that is borrowing an object ID stores the ID inside the
+    /// return value of a task that it executes, the caller of the task is also
+    /// considered a borrower for as long as its reference to the task's return
+    /// ID stays in scope. Thus, the borrower must notify the owner that the
+    /// task's caller is also a borrower. The key is the task's return ID, and
+    /// the value is the task ID and address of the task's caller.
+    absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
+
+    bool empty() const { return borrowers.empty() && stored_in_objects.empty(); }
+  };
+
+  /// Where the value of an object stored in plasma is. This is only allocated for the
+  /// references to plasma objects that we own.
+  struct ObjectLocations {
+    // If this object is owned by us and stored in plasma, and reference
+    // counting is enabled, then some raylet must be pinning the object value.
+    // This is the address of that raylet.
+    absl::optional<NodeID> pinned_at_raylet_id;
+    // If this object is owned by us and stored in plasma, this contains all
+    // object locations.
+    absl::flat_hash_set<NodeID> locations;
+
+    bool empty() const { return !pinned_at_raylet_id.has_value() && locations.empty(); }
+  };
+
+  /// The reference count of an object. A worker may hold millions of references, so
+  /// the fields that most references set are kept in this record, and the call site
+  /// and the owner address are shared with the other references that have the same.
+  /// The rarely set fields are kept in side tables that are only allocated for the
+  /// references that set them, and that are read through accessors returning an
+  /// empty table otherwise.
   struct Reference {
     /// Constructor for a reference whose origin is unknown.
     Reference() {}
-    Reference(std::string call_site, const int64_t object_size)
-        : call_site(call_site), object_size(object_size) {}
+    Reference(std::shared_ptr<const std::string> call_site, const int64_t object_size)
+        : call_site(std::move(call_site)), object_size(object_size) {}
     /// Constructor for a reference that we created.
-    Reference(const rpc::Address &owner_address, std::string call_site,
-              const int64_t object_size, bool is_reconstructable,
-              const absl::optional<NodeID> &pinned_at_raylet_id)
-        : call_site(call_site),
+    Reference(std::shared_ptr<const rpc::Address> owner_address,
+              std::shared_ptr<const std::string> call_site, const int64_t object_size,
+              bool is_reconstructable)
+        : call_site(std::move(call_site)),
           object_size(object_size),
+          owner_address(std::move(owner_address)),
           owned_by_us(true),
-          owner_address(owner_address),
-          pinned_at_raylet_id(pinned_at_raylet_id),
           is_reconstructable(is_reconstructable) {}
+    /// The copy owns copies of the side tables, so that it can be modified
+    /// independently.
+    Reference(const Reference &other)
+        : call_site(other.call_site),
+          object_size(other.object_size),
+          owner_address(other.owner_address),
+          local_ref_count(other.local_ref_count),
+          submitted_task_ref_count(other.submitted_task_ref_count),
+          lineage_ref_count(other.lineage_ref_count),
+          owned_by_us(other.owned_by_us),
+          is_reconstructable(other.is_reconstructable),
+          spilled(other.spilled),
+          on_delete(other.on_delete),
+          on_ref_removed(other.on_ref_removed),
+          nested_(other.nested_ ? new NestedReferenceCount(*other.nested_) : nullptr),
+          borrow_info_(other.borrow_info_ ? new BorrowInfo(*other.borrow_info_)
+                                          : nullptr),
+          object_locations_(other.object_locations_
+                                ? new ObjectLocations(*other.object_locations_)
+                                : nullptr) {}
+    Reference(Reference &&other) = default;
 
     /// Constructor from a protobuf. This is assumed to be a message from
     /// another process, so the object defaults to not being owned by us.
@@ -441,7 +544,8 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// - ObjectIDs that we own, that contain this ObjectID, and that are still
     ///   in scope.
     size_t RefCount() const {
-      return local_ref_count + submitted_task_ref_count + contained_in_owned.size();
+      return local_ref_count + submitted_task_ref_count +
+             nested().contained_in_owned.size();
     }
 
     /// Whether this reference is no longer in scope. A reference is in scope
@@ -452,9 +556,9 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// - We gave the reference to at least one other process.
     bool OutOfScope(bool lineage_pinning_enabled) const {
       bool in_scope = RefCount() > 0;
-      bool was_contained_in_borrowed_id = contained_in_borrowed_id.has_value();
-      bool has_borrowers = borrowers.size() > 0;
-      bool was_stored_in_objects = stored_in_objects.size() > 0;
+      bool was_contained_in_borrowed_id = nested().contained_in_borrowed_id.has_value();
+      bool has_borrowers = borrow_info().borrowers.size() > 0;
+      bool was_stored_in_objects = borrow_info().stored_in_objects.size() > 0;
 
       bool has_lineage_references = false;
       if (lineage_pinning_enabled && owned_by_us && !is_reconstructable) {
@@ -479,90 +583,87 @@ class ReferenceCounter : public ReferenceCounterInterface,
     }
 
     /// Description of the call site where the reference was created.
-    std::string call_site = "<unknown>";
+    const std::string &CallSite() const {
+      static const std::string unknown_call_site = "<unknown>";
+      return call_site ? *call_site : unknown_call_site;
+    }
+
+    /// Access to the side tables. The const accessors return an empty table if the
+    /// reference has none, and the mutable ones allocate it.
+    const NestedReferenceCount &nested() const {
+      static const NestedReferenceCount empty_nested;
+      return nested_ ? *nested_ : empty_nested;
+    }
+    NestedReferenceCount &mutable_nested() {
+      if (!nested_) {
+        nested_.reset(new NestedReferenceCount());
+      }
+      return *nested_;
+    }
+    const BorrowInfo &borrow_info() const {
+      static const BorrowInfo empty_borrow_info;
+      return borrow_info_ ? *borrow_info_ : empty_borrow_info;
+    }
+    BorrowInfo &mutable_borrow_info() {
+      if (!borrow_info_) {
+        borrow_info_.reset(new BorrowInfo());
+      }
+      return *borrow_info_;
+    }
+    const ObjectLocations &object_locations() const {
+      static const ObjectLocations empty_object_locations;
+      return object_locations_ ? *object_locations_ : empty_object_locations;
+    }
+    ObjectLocations &mutable_object_locations() {
+      if (!object_locations_) {
+        object_locations_.reset(new ObjectLocations());
+      }
+      return *object_locations_;
+    }
+
+    /// Forget the borrowers of the reference.
+    void ClearBorrowInfo() { borrow_info_.reset(); }
+
+    /// Free the side tables that became empty.
+    void ShrinkSideTables() {
+      if (borrow_info_ && borrow_info_->empty()) {
+        borrow_info_.reset();
+      }
+      if (object_locations_ && object_locations_->empty()) {
+        object_locations_.reset();
+      }
+    }
+
+    /// Description of the call site where the reference was created, shared with the
+    /// other references created there. Null if unknown.
+    std::shared_ptr<const std::string> call_site;
     /// Object size if known, otherwise -1;
     int64_t object_size = -1;
-
-    /// Whether we own the object. If we own the object, then we are
-    /// responsible for tracking the state of the task that creates the object
-    /// (see task_manager.h).
-    bool owned_by_us = false;
     /// The object's owner's address, if we know it. If this process is the
     /// owner, then this is added during creation of the Reference. If this is
     /// process is a borrower, the borrower must add the owner's address before
-    /// using the ObjectID.
-    absl::optional<rpc::Address> owner_address;
-    // If this object is owned by us and stored in plasma, and reference
-    // counting is enabled, then some raylet must be pinning the object value.
-    // This is the address of that raylet.
-    absl::optional<NodeID> pinned_at_raylet_id;
-    // If this object is owned by us and stored in plasma, this contains all
-    // object locations.
-    absl::flat_hash_set<NodeID> locations;
-    // Whether this object can be reconstructed via lineage. If false, then the
-    // object's value will be pinned as long as it is referenced by any other
-    // object's lineage.
-    const bool is_reconstructable = false;
+    /// using the ObjectID. Shared with the other references to objects of the same
+    /// owner.
+    std::shared_ptr<const rpc::Address> owner_address;
 
     /// The local ref count for the ObjectID in the language frontend.
     size_t local_ref_count = 0;
     /// The ref count for submitted tasks that depend on the ObjectID.
     size_t submitted_task_ref_count = 0;
-    /// Object IDs that we own and that contain this object ID.
-    /// ObjectIDs are added to this field when we discover that this object
-    /// contains other IDs. This can happen in 2 cases:
-    ///  1. We call ray.put() and store the inner ID(s) in the outer object.
-    ///  2. A task that we submitted returned an ID(s).
-    /// ObjectIDs are erased from this field when their Reference is deleted.
-    absl::flat_hash_set<ObjectID> contained_in_owned;
-    /// An Object ID that we (or one of our children) borrowed that contains
-    /// this object ID, which is also borrowed. This is used in cases where an
-    /// ObjectID is nested. We need to notify the owner of the outer ID of any
-    /// borrowers of this object, so we keep this field around until
-    /// GetAndClearLocalBorrowersInternal is called on the outer ID. This field
-    /// is updated in 2 cases:
-    ///  1. We deserialize an ID that we do not own and that was stored in
-    ///     another object that we do not own.
-    ///  2. Case (1) occurred for a task that we submitted and we also do not
-    ///     own the inner or outer object. Then, we need to notify our caller
-    ///     that the task we submitted is a borrower for the inner ID.
-    /// This field is reset to null once GetAndClearLocalBorrowersInternal is
-    /// called on contained_in_borrowed_id. For each borrower, this field is
-    /// set at most once during the reference's lifetime. If the object ID is
-    /// later found to be nested in a second object, we do not need to remember
-    /// the second ID because we will already have notified the owner of the
-    /// first outer object about our reference.
-    absl::optional<ObjectID> contained_in_borrowed_id;
-    /// The object IDs contained in this object. These could be objects that we
-    /// own or are borrowing. This field is updated in 2 cases:
-    ///  1. We call ray.put() on this ID and store the contained IDs.
-    ///  2. We call ray.get() on an ID whose contents we do not know and we
-    ///     discover that it contains these IDs.
-    absl::flat_hash_set<ObjectID> contains;
-    /// A list of processes that are we gave a reference to that are still
-    /// borrowing the ID. This field is updated in 2 cases:
-    ///  1. If we are a borrower of the ID, then we add a process to this list
-    ///     if we passed that process a copy of the ID via task submission and
-    ///     the process is still using the ID by the time it finishes its task.
-    ///     Borrowers are removed from the list when we recursively merge our
-    ///     list into the owner.
-    ///  2. If we are the owner of the ID, then either the above case, or when
-    ///     we hear from a borrower that it has passed the ID to other
-    ///     borrowers. A borrower is removed from the list when it responds
-    ///     that it is no longer using the reference.
-    absl::flat_hash_set<rpc::WorkerAddress> borrowers;
-    /// When a process that is borrowing an object ID stores the ID inside the
-    /// return value of a task that it executes, the caller of the task is also
-    /// considered a borrower for as long as its reference to the task's return
-    /// ID stays in scope. Thus, the borrower must notify the owner that the
-    /// task's caller is also a borrower. The key is the task's return ID, and
-    /// the value is the task ID and address of the task's caller.
-    absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
     /// The number of tasks that depend on this object that may be retried in
     /// the future (pending execution or finished but retryable). If the object
     /// is inlined (not stored in plasma), then its lineage ref count is 0
     /// because any dependent task will already have the value of the object.
     size_t lineage_ref_count = 0;
+
+    /// Whether we own the object. If we own the object, then we are
+    /// responsible for tracking the state of the task that creates the object
+    /// (see task_manager.h).
+    bool owned_by_us = false;
+    // Whether this object can be reconstructed via lineage. If false, then the
+    // object's value will be pinned as long as it is referenced by any other
+    // object's lineage.
+    const bool is_reconstructable = false;
     /// Whether this object has been spilled to external storage.
     bool spilled = false;
 
@@ -572,6 +673,11 @@ class ReferenceCounter : public ReferenceCounterInterface,
     /// Callback that is called when this process is no longer a borrower
     /// (RefCount() == 0).
     std::function<void(const ObjectID &)> on_ref_removed;
+
+   private:
+    std::unique_ptr<NestedReferenceCount> nested_;
+    std::unique_ptr<BorrowInfo> borrow_info_;
+    std::unique_ptr<ObjectLocations> object_locations_;
   };
 
   using ReferenceTable = absl::flat_hash_map<ObjectID, Reference>;
@@ -689,6 +795,20 @@ class ReferenceCounter : public ReferenceCounterInterface,
   void ReleaseLineageReferencesInternal(const std::vector<ObjectID> &argument_ids)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Return the copy of a call site shared by the references created there.
+  std::shared_ptr<const std::string> InternCallSite(const std::string &call_site)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Return the copy of an owner address shared by the references to the objects of
+  /// this owner.
+  std::shared_ptr<const rpc::Address> InternOwnerAddress(
+      const rpc::Address &owner_address) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Forget the call site and the owner address of a reference that is being erased,
+  /// if no other reference shares them.
+  void ReleaseInternedValues(const Reference &reference)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   /// Address of our RPC server. This is used to determine whether we own a
   /// given object or not, by comparing our WorkerID with the WorkerID of the
   /// object's owner.
@@ -719,6 +839,14 @@ class ReferenceCounter : public ReferenceCounterInterface,
   /// Holds all reference counts and dependency information for tracked ObjectIDs.
   ReferenceTable object_id_refs_ GUARDED_BY(mutex_);
 
+  /// The call sites and the owner addresses of the references in the table. Each is
+  /// shared by the references that have the same, and is erased with the last one.
+  /// The keys of call_sites_ point to the strings held by the values.
+  absl::flat_hash_map<absl::string_view, std::shared_ptr<const std::string>> call_sites_
+      GUARDED_BY(mutex_);
+  absl::flat_hash_map<rpc::WorkerAddress, std::shared_ptr<const rpc::Address>>
+      owner_addresses_ GUARDED_BY(mutex_);
+
   /// Objects whose values have been freed by the language frontend.
   /// The values in plasma will not be pinned. An object ID is
   /// removed from this set once its Reference has been deleted
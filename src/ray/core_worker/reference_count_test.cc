@@ -388,6 +388,60 @@ TEST_F(ReferenceCountTest, TestOwnerAddress) {
   ASSERT_FALSE(rc->GetOwner(object_id3, &added_address));
 }
 
+// Tests that the call sites and the owner addresses shared by several references
+// outlive the references that are deleted, and are found again once all are deleted.
+TEST_F(ReferenceCountTest, TestSharedCallSiteAndOwnerAddress) {
+  auto id1 = ObjectID::FromRandom();
+  auto id2 = ObjectID::FromRandom();
+  rpc::Address owner_address;
+  owner_address.set_ip_address("1234");
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+  rc->AddLocalReference(id1, "file.py:42");
+  rc->AddLocalReference(id2, "file.py:42");
+  ASSERT_TRUE(rc->AddBorrowedObject(id1, ObjectID::Nil(), owner_address));
+  ASSERT_TRUE(rc->AddBorrowedObject(id2, ObjectID::Nil(), owner_address));
+  rc->RemoveLocalReference(id1, nullptr);
+
+  rpc::Address added_address;
+  ASSERT_TRUE(rc->GetOwner(id2, &added_address));
+  ASSERT_EQ(added_address.ip_address(), "1234");
+  rpc::CoreWorkerStats stats;
+  rc->AddObjectRefStats({}, &stats);
+  ASSERT_EQ(stats.object_refs_size(), 1);
+  ASSERT_EQ(stats.object_refs(0).call_site(), "file.py:42");
+  rc->RemoveLocalReference(id2, nullptr);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 0);
+
+  // The same owner may have moved.
+  owner_address.set_ip_address("5678");
+  rc->AddLocalReference(id1, "file.py:42");
+  ASSERT_TRUE(rc->AddBorrowedObject(id1, ObjectID::Nil(), owner_address));
+  ASSERT_TRUE(rc->GetOwner(id1, &added_address));
+  ASSERT_EQ(added_address.ip_address(), "5678");
+  rpc::CoreWorkerStats stats2;
+  rc->AddObjectRefStats({}, &stats2);
+  ASSERT_EQ(stats2.object_refs(0).call_site(), "file.py:42");
+  rc->RemoveLocalReference(id1, nullptr);
+}
+
+// Tests that the locations of an object are kept until they are all removed.
+TEST_F(ReferenceCountTest, TestObjectLocations) {
+  auto object_id = ObjectID::FromRandom();
+  auto node1 = NodeID::FromRandom();
+  auto node2 = NodeID::FromRandom();
+  ASSERT_FALSE(rc->GetObjectLocations(object_id).has_value());
+  rc->AddOwnedObject(object_id, {}, rpc::Address(), "", 0, false);
+  ASSERT_TRUE(rc->GetObjectLocations(object_id)->empty());
+
+  ASSERT_TRUE(rc->AddObjectLocation(object_id, node1));
+  ASSERT_TRUE(rc->AddObjectLocation(object_id, node2));
+  ASSERT_TRUE(rc->RemoveObjectLocation(object_id, node1));
+  ASSERT_EQ(*rc->GetObjectLocations(object_id), absl::flat_hash_set<NodeID>{node2});
+  ASSERT_TRUE(rc->RemoveObjectLocation(object_id, node2));
+  ASSERT_TRUE(rc->RemoveObjectLocation(object_id, node2));
+  ASSERT_TRUE(rc->GetObjectLocations(object_id)->empty());
+}
+
 // Tests that the ref counts are properly integrated into the local
 // object memory store.
 TEST(MemoryStoreIntegrationTest, TestSimple) {
@@ -36,7 +36,8 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     callbacks.push_back(callback);
   }
 
-  bool ReplyPushTask(Status status = Status::OK(), bool exit = false) {
+  bool ReplyPushTask(Status status = Status::OK(), bool exit = false,
+                     bool cancelled = false) {
     if (callbacks.size() == 0) {
       return false;
     }
@@ -45,6 +46,9 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     if (exit) {
       reply.set_worker_exiting(true);
     }
+    if (cancelled) {
+      reply.set_task_cancelled(true);
+    }
     callback(status, reply);
     callbacks.pop_front();
     return true;
@@ -108,6 +112,15 @@ class MockRayletClient : public WorkerLeaseInterface {
     callbacks.push_back(callback);
   }
 
+  void RequestWorkerLeases(
+      const std::vector<ray::TaskSpecification> &resource_specs,
+      const rpc::ClientCallback<rpc::RequestWorkerLeasesReply> &callback,
+      const int64_t backlog_size) override {
+    num_workers_requested += resource_specs.size();
+    num_lease_batches_requested += 1;
+    batch_callbacks.push_back(callback);
+  }
+
   void ReleaseUnusedWorkers(
       const std::vector<WorkerID> &workers_in_use,
       const rpc::ClientCallback<rpc::ReleaseUnusedWorkersReply> &callback) override {}
@@ -144,6 +157,30 @@ class MockRayletClient : public WorkerLeaseInterface {
     }
   }
 
+  // Trigger reply to RequestWorkerLeases. A worker is granted at each of the ports, and
+  // the other leases are canceled.
+  bool GrantWorkerLeases(const std::string &address, const std::vector<int> &ports,
+                         int num_canceled) {
+    rpc::RequestWorkerLeasesReply reply;
+    for (int port : ports) {
+      auto lease = reply.add_leases();
+      lease->mutable_worker_address()->set_ip_address(address);
+      lease->mutable_worker_address()->set_port(port);
+      lease->mutable_worker_address()->set_raylet_id(NodeID::Nil().Binary());
+    }
+    for (int i = 0; i < num_canceled; i++) {
+      reply.add_leases()->set_canceled(true);
+    }
+    if (batch_callbacks.size() == 0) {
+      return false;
+    } else {
+      auto callback = batch_callbacks.front();
+      callback(Status::OK(), reply);
+      batch_callbacks.pop_front();
+      return true;
+    }
+  }
+
   bool ReplyCancelWorkerLease(bool success = true) {
     rpc::CancelWorkerLeaseReply reply;
     reply.set_success(success);
@@ -163,7 +200,9 @@ class MockRayletClient : public WorkerLeaseInterface {
   int num_workers_returned = 0;
   int num_workers_disconnected = 0;
   int num_leases_canceled = 0;
+  int num_lease_batches_requested = 0;
   std::list<rpc::ClientCallback<rpc::RequestWorkerLeaseReply>> callbacks = {};
+  std::list<rpc::ClientCallback<rpc::RequestWorkerLeasesReply>> batch_callbacks = {};
   std::list<rpc::ClientCallback<rpc::CancelWorkerLeaseReply>> cancel_callbacks = {};
 };
 
@@ -1551,6 +1590,187 @@ TEST(DirectTaskTransportTest, TestPipeliningNumberOfWorkersRequested) {
   ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
 }
 
+TEST(DirectTaskTransportTest, TestPipeliningWorkerFailure) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  uint32_t max_tasks_in_flight_per_worker = 2;
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, max_tasks_in_flight_per_worker);
+
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(empty_resources, empty_descriptor))
+                    .ok());
+  }
+
+  // Tasks 1-2 are pipelined to the first worker, and a second worker is requested.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 2);
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+
+  // Task 1 fails. Task 3 is not pushed to the failed worker, and the worker is not
+  // returned while task 2 is in flight to it.
+  ASSERT_TRUE(worker_client->ReplyPushTask(Status::IOError("worker dead")));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 0);
+
+  // Task 2 finishes, and the failed worker is returned.
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(worker_client->callbacks.size(), 0);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 1);
+
+  // Task 3 runs on the second worker.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1001, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 1);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 2);
+  ASSERT_EQ(task_finisher->num_tasks_failed, 1);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestPipeliningWorkerExiting) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  uint32_t max_tasks_in_flight_per_worker = 10;
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, max_tasks_in_flight_per_worker);
+
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  for (int i = 0; i < 2; i++) {
+    ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(empty_resources, empty_descriptor))
+                    .ok());
+  }
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 2);
+
+  // The worker exits once the tasks pipelined to it are done, and it is never
+  // returned to the raylet.
+  ASSERT_TRUE(worker_client->ReplyPushTask(Status::OK(), /*exit=*/true));
+  ASSERT_TRUE(worker_client->ReplyPushTask(Status::OK(), /*exit=*/true));
+  ASSERT_EQ(raylet_client->num_workers_returned, 0);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 0);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 2);
+  ASSERT_EQ(task_finisher->num_tasks_failed, 0);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestPipeliningCancelQueuedTask) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  uint32_t max_tasks_in_flight_per_worker = 10;
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, max_tasks_in_flight_per_worker);
+
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  auto task1 = BuildTaskSpec(empty_resources, empty_descriptor);
+  auto task2 = BuildTaskSpec(empty_resources, empty_descriptor);
+  ASSERT_TRUE(submitter.SubmitTask(task1).ok());
+  ASSERT_TRUE(submitter.SubmitTask(task2).ok());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 2);
+
+  // Task 2 is cancelled while it is queued on the worker behind task 1.
+  ASSERT_TRUE(submitter.CancelTask(task2, false, false).ok());
+  ASSERT_EQ(worker_client->kill_requests.size(), 1);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_TRUE(worker_client->ReplyPushTask(Status::OK(), false, /*cancelled=*/true));
+
+  // The worker is still healthy, and it is returned.
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+  ASSERT_EQ(raylet_client->num_workers_disconnected, 0);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 1);
+  ASSERT_EQ(task_finisher->num_tasks_failed, 1);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
+TEST(DirectTaskTransportTest, TestBatchedWorkerLeases) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto client_pool = std::make_shared<rpc::CoreWorkerClientPool>(
+      [&](const rpc::Address &addr) { return worker_client; });
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  auto actor_creator = std::make_shared<MockActorCreator>();
+  auto lease_policy = std::make_shared<MockLeasePolicy>();
+  uint32_t max_leases_per_request = 3;
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, client_pool, nullptr, lease_policy, store, task_finisher,
+      NodeID::Nil(), kLongTimeout, actor_creator, /*max_tasks_in_flight_per_worker=*/1,
+      absl::nullopt, max_leases_per_request);
+
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  // The first task is requested alone, as the others are not queued yet.
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(submitter.SubmitTask(BuildTaskSpec(empty_resources, empty_descriptor))
+                    .ok());
+  }
+  ASSERT_EQ(raylet_client->num_workers_requested, 1);
+  ASSERT_EQ(raylet_client->num_lease_batches_requested, 0);
+
+  // The remaining tasks request up to 3 workers at once.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_EQ(raylet_client->num_workers_requested, 4);
+  ASSERT_EQ(raylet_client->num_lease_batches_requested, 1);
+
+  // Two leases are granted, and workers are requested again for the 2 queued tasks.
+  ASSERT_TRUE(raylet_client->GrantWorkerLeases("localhost", {1001, 1002}, 1));
+  ASSERT_EQ(worker_client->callbacks.size(), 3);
+  ASSERT_EQ(raylet_client->num_workers_requested, 6);
+  ASSERT_EQ(raylet_client->num_lease_batches_requested, 2);
+
+  // One lease is granted, and a single worker is requested for the last task.
+  ASSERT_TRUE(raylet_client->GrantWorkerLeases("localhost", {1003}, 1));
+  ASSERT_EQ(worker_client->callbacks.size(), 4);
+  ASSERT_EQ(raylet_client->num_workers_requested, 7);
+  ASSERT_EQ(raylet_client->num_lease_batches_requested, 2);
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1004, NodeID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 5);
+
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(worker_client->ReplyPushTask());
+  }
+  ASSERT_EQ(raylet_client->num_workers_returned, 5);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 5);
+  ASSERT_EQ(task_finisher->num_tasks_failed, 0);
+  ASSERT_TRUE(submitter.CheckNoSchedulingKeyEntriesPublic());
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
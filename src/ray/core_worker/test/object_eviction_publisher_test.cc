@@ -0,0 +1,130 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/object_eviction_publisher.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+/// A long-poll of a raylet, and how many times it was answered.
+struct Poll {
+  rpc::GetObjectEvictionsReply reply;
+  int num_replies = 0;
+
+  rpc::SendReplyCallback Callback() {
+    return [this](Status status, std::function<void()> success,
+                  std::function<void()> failure) { num_replies++; };
+  }
+};
+
+class ObjectEvictionPublisherTest : public ::testing::Test {
+ public:
+  ObjectEvictionPublisherTest()
+      : publisher_(/*subscriber_timeout_ms=*/1000, [this]() { return now_ms_; }) {}
+
+ protected:
+  int64_t now_ms_ = 0;
+  ObjectEvictionPublisher publisher_;
+  const NodeID node_id_ = NodeID::FromRandom();
+};
+
+TEST_F(ObjectEvictionPublisherTest, TestBufferEvictions) {
+  const auto object1 = ObjectID::FromRandom();
+  const auto object2 = ObjectID::FromRandom();
+  const auto object3 = ObjectID::FromRandom();
+  publisher_.AddSubscriber(node_id_);
+
+  // The evictions without an outstanding poll are buffered.
+  publisher_.PublishObjectEviction(node_id_, object1);
+  publisher_.PublishObjectEviction(node_id_, object2);
+  Poll poll1;
+  publisher_.HandleGetObjectEvictions(node_id_, &poll1.reply, poll1.Callback());
+  ASSERT_EQ(poll1.num_replies, 1);
+  ASSERT_EQ(poll1.reply.evicted_object_ids_size(), 2);
+  ASSERT_EQ(poll1.reply.evicted_object_ids(0), object1.Binary());
+  ASSERT_EQ(poll1.reply.evicted_object_ids(1), object2.Binary());
+
+  // The next poll waits for an eviction.
+  Poll poll2;
+  publisher_.HandleGetObjectEvictions(node_id_, &poll2.reply, poll2.Callback());
+  ASSERT_EQ(poll2.num_replies, 0);
+  publisher_.PublishObjectEviction(node_id_, object3);
+  ASSERT_EQ(poll2.num_replies, 1);
+  ASSERT_EQ(poll2.reply.evicted_object_ids_size(), 1);
+  ASSERT_EQ(poll2.reply.evicted_object_ids(0), object3.Binary());
+  ASSERT_EQ(poll1.num_replies, 1);
+}
+
+TEST_F(ObjectEvictionPublisherTest, TestStalePollIsReplaced) {
+  const auto object_id = ObjectID::FromRandom();
+  publisher_.AddSubscriber(node_id_);
+  Poll stale_poll;
+  publisher_.HandleGetObjectEvictions(node_id_, &stale_poll.reply,
+                                      stale_poll.Callback());
+  Poll poll;
+  publisher_.HandleGetObjectEvictions(node_id_, &poll.reply, poll.Callback());
+
+  // The stale poll is answered empty, and the eviction goes to the new one.
+  ASSERT_EQ(stale_poll.num_replies, 1);
+  ASSERT_EQ(stale_poll.reply.evicted_object_ids_size(), 0);
+  ASSERT_EQ(poll.num_replies, 0);
+  publisher_.PublishObjectEviction(node_id_, object_id);
+  ASSERT_EQ(stale_poll.num_replies, 1);
+  ASSERT_EQ(poll.num_replies, 1);
+  ASSERT_EQ(poll.reply.evicted_object_ids_size(), 1);
+}
+
+TEST_F(ObjectEvictionPublisherTest, TestRemoveSubscriberOfRemovedNode) {
+  publisher_.AddSubscriber(node_id_);
+  Poll poll;
+  publisher_.HandleGetObjectEvictions(node_id_, &poll.reply, poll.Callback());
+  ASSERT_EQ(publisher_.NumSubscribers(), 1);
+
+  // The outstanding poll is answered, and the later evictions are dropped.
+  publisher_.RemoveSubscriber(node_id_);
+  ASSERT_EQ(poll.num_replies, 1);
+  ASSERT_EQ(publisher_.NumSubscribers(), 0);
+  publisher_.PublishObjectEviction(node_id_, ObjectID::FromRandom());
+  ASSERT_EQ(publisher_.NumSubscribers(), 0);
+  ASSERT_EQ(poll.num_replies, 1);
+}
+
+TEST_F(ObjectEvictionPublisherTest, TestRemoveStaleSubscribers) {
+  const auto polling_node_id = NodeID::FromRandom();
+  publisher_.AddSubscriber(node_id_);
+  publisher_.AddSubscriber(polling_node_id);
+  publisher_.PublishObjectEviction(node_id_, ObjectID::FromRandom());
+  Poll poll;
+  publisher_.HandleGetObjectEvictions(polling_node_id, &poll.reply, poll.Callback());
+
+  now_ms_ += 1000;
+  publisher_.RemoveStaleSubscribers();
+  ASSERT_EQ(publisher_.NumSubscribers(), 2);
+
+  // The subscriber that did not poll is removed with its buffered eviction, and the
+  // one with an outstanding poll is kept.
+  now_ms_ += 1;
+  publisher_.RemoveStaleSubscribers();
+  ASSERT_EQ(publisher_.NumSubscribers(), 1);
+  ASSERT_EQ(poll.num_replies, 0);
+  publisher_.PublishObjectEviction(polling_node_id, ObjectID::FromRandom());
+  ASSERT_EQ(poll.num_replies, 1);
+
+  // A subscriber is added again when it subscribes to new objects.
+  publisher_.AddSubscriber(node_id_);
+  ASSERT_EQ(publisher_.NumSubscribers(), 2);
+}
+
+}  // namespace ray
@@ -0,0 +1,129 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reports the heap bytes used by the reference counter per object reference, for
+// references owned by this worker and for references borrowed from other workers.
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "gflags/gflags.h"
+#include "ray/core_worker/reference_count.h"
+
+DEFINE_int64(num_refs, 1000000, "Number of object references to create.");
+DEFINE_int64(num_call_sites, 100, "Number of distinct call sites of the references.");
+DEFINE_int64(num_owners, 100, "Number of distinct owners of the borrowed references.");
+
+namespace {
+
+/// The heap bytes currently allocated through operator new.
+std::atomic<int64_t> live_bytes(0);
+
+/// Each allocation is prefixed with its size, so that its release can be counted.
+constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+void *CountedAlloc(size_t size) {
+  void *ptr = std::malloc(size + kHeaderSize);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  *static_cast<size_t *>(ptr) = size;
+  live_bytes += size;
+  return static_cast<char *>(ptr) + kHeaderSize;
+}
+
+void CountedFree(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  void *header = static_cast<char *>(ptr) - kHeaderSize;
+  live_bytes -= *static_cast<size_t *>(header);
+  std::free(header);
+}
+
+ray::rpc::Address RandomAddress() {
+  ray::rpc::Address address;
+  address.set_raylet_id(ray::NodeID::FromRandom().Binary());
+  address.set_ip_address("10.0.0.1");
+  address.set_port(10000);
+  address.set_worker_id(ray::WorkerID::FromRandom().Binary());
+  return address;
+}
+
+/// Create the references in a reference counter, and return the heap bytes that it
+/// holds per reference.
+double MeasureBytesPerReference(bool owned) {
+  std::vector<ray::ObjectID> object_ids;
+  object_ids.reserve(FLAGS_num_refs);
+  for (int64_t i = 0; i < FLAGS_num_refs; i++) {
+    object_ids.push_back(ray::ObjectID::FromRandom());
+  }
+  std::vector<std::string> call_sites;
+  for (int64_t i = 0; i < FLAGS_num_call_sites; i++) {
+    call_sites.push_back("remote_function (task call) at /home/ray/workload.py:" +
+                         std::to_string(i));
+  }
+  std::vector<ray::rpc::Address> owner_addresses;
+  for (int64_t i = 0; i < FLAGS_num_owners; i++) {
+    owner_addresses.push_back(RandomAddress());
+  }
+  const auto address = RandomAddress();
+
+  const int64_t bytes_before = live_bytes;
+  ray::ReferenceCounter reference_counter(address);
+  for (int64_t i = 0; i < FLAGS_num_refs; i++) {
+    const auto &object_id = object_ids[i];
+    const auto &call_site = call_sites[i % call_sites.size()];
+    if (owned) {
+      reference_counter.AddOwnedObject(object_id, {}, address, call_site,
+                                       /*object_size=*/100,
+                                       /*is_reconstructable=*/true);
+      reference_counter.AddLocalReference(object_id, call_site);
+    } else {
+      reference_counter.AddLocalReference(object_id, call_site);
+      reference_counter.AddBorrowedObject(object_id, ray::ObjectID::Nil(),
+                                          owner_addresses[i % owner_addresses.size()]);
+    }
+  }
+  RAY_CHECK(reference_counter.NumObjectIDsInScope() ==
+            static_cast<size_t>(FLAGS_num_refs));
+  return static_cast<double>(live_bytes - bytes_before) / FLAGS_num_refs;
+}
+
+}  // namespace
+
+void *operator new(size_t size) { return CountedAlloc(size); }
+
+void *operator new[](size_t size) { return CountedAlloc(size); }
+
+void operator delete(void *ptr) noexcept { CountedFree(ptr); }
+
+void operator delete[](void *ptr) noexcept { CountedFree(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { CountedFree(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { CountedFree(ptr); }
+
+int main(int argc, char *argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  RAY_CHECK(FLAGS_num_refs > 0 && FLAGS_num_call_sites > 0 && FLAGS_num_owners > 0);
+
+  std::cout << "Owned references: " << MeasureBytesPerReference(/*owned=*/true)
+            << " bytes per reference" << std::endl;
+  std::cout << "Borrowed references: " << MeasureBytesPerReference(/*owned=*/false)
+            << " bytes per reference" << std::endl;
+  return 0;
+}
@@ -158,6 +158,25 @@ TEST(SchedulingQueueTest, TestSkipAlreadyProcessedByClient) {
   ASSERT_EQ(n_rej, 2);
 }
 
+TEST(SchedulingQueueTest, TestCancelQueuedNormalTask) {
+  NormalSchedulingQueue queue;
+  int n_ok = 0;
+  int n_rej = 0;
+  auto fn_ok = [&n_ok]() { n_ok++; };
+  auto fn_rej = [&n_rej]() { n_rej++; };
+  auto task_id_1 = TaskID::ForFakeTask();
+  auto task_id_2 = TaskID::ForFakeTask();
+  queue.Add(-1, -1, fn_ok, fn_rej, {}, task_id_1);
+  queue.Add(-1, -1, fn_ok, fn_rej, {}, task_id_2);
+  ASSERT_TRUE(queue.CancelTaskIfFound(task_id_1));
+  ASSERT_FALSE(queue.CancelTaskIfFound(task_id_1));
+  ASSERT_EQ(n_rej, 1);
+  queue.ScheduleRequests();
+  ASSERT_EQ(n_ok, 1);
+  ASSERT_FALSE(queue.CancelTaskIfFound(task_id_2));
+  ASSERT_EQ(n_rej, 1);
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -465,6 +465,11 @@ void CoreWorkerDirectTaskReceiver::HandleTask(
   auto reject_callback = [send_reply_callback]() {
     send_reply_callback(Status::Invalid("client cancelled stale rpc"), nullptr, nullptr);
   };
+  // Normal tasks are only rejected when they are cancelled before they start.
+  auto cancel_callback = [reply, send_reply_callback]() {
+    reply->set_task_cancelled(true);
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+  };
 
   auto dependencies = task_spec.GetDependencies();
 
@@ -487,7 +492,7 @@ void CoreWorkerDirectTaskReceiver::HandleTask(
     // Add the normal task's callbacks to the non-actor scheduling queue.
     normal_scheduling_queue_->Add(request.sequence_number(),
                                   request.client_processed_up_to(), accept_callback,
-                                  reject_callback, dependencies);
+                                  cancel_callback, dependencies, task_spec.TaskId());
   }
 }
 
@@ -501,4 +506,8 @@ void CoreWorkerDirectTaskReceiver::RunNormalTasksFromQueue() {
   normal_scheduling_queue_->ScheduleRequests();
 }
 
+bool CoreWorkerDirectTaskReceiver::CancelQueuedNormalTask(const TaskID &task_id) {
+  return normal_scheduling_queue_->CancelTaskIfFound(task_id);
+}
+
 }  // namespace ray
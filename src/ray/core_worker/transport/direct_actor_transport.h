@@ -347,7 +347,8 @@ class SchedulingQueue {
   virtual void Add(int64_t seq_no, int64_t client_processed_up_to,
                    std::function<void()> accept_request,
                    std::function<void()> reject_request,
-                   const std::vector<rpc::ObjectReference> &dependencies = {}) = 0;
+                   const std::vector<rpc::ObjectReference> &dependencies = {},
+                   const TaskID &task_id = TaskID::Nil()) = 0;
   virtual void ScheduleRequests() = 0;
   virtual bool TaskQueueEmpty() const = 0;
   virtual ~SchedulingQueue(){};
@@ -371,7 +372,8 @@ class ActorSchedulingQueue : public SchedulingQueue {
   /// Add a new actor task's callbacks to the worker queue.
   void Add(int64_t seq_no, int64_t client_processed_up_to,
            std::function<void()> accept_request, std::function<void()> reject_request,
-           const std::vector<rpc::ObjectReference> &dependencies = {}) {
+           const std::vector<rpc::ObjectReference> &dependencies = {},
+           const TaskID &task_id = TaskID::Nil()) {
     // A seq_no of -1 means no ordering constraint. Actor tasks must be executed in order.
     RAY_CHECK(seq_no != -1);
 
@@ -520,30 +522,62 @@ class NormalSchedulingQueue : public SchedulingQueue {
   /// Add a new task's callbacks to the worker queue.
   void Add(int64_t seq_no, int64_t client_processed_up_to,
            std::function<void()> accept_request, std::function<void()> reject_request,
-           const std::vector<rpc::ObjectReference> &dependencies = {}) {
+           const std::vector<rpc::ObjectReference> &dependencies = {},
+           const TaskID &task_id = TaskID::Nil()) {
     absl::MutexLock lock(&mu_);
     // Normal tasks should not have ordering constraints.
     RAY_CHECK(seq_no == -1);
     // Create a InboundRequest object for the new task, and add it to the queue.
-    pending_normal_tasks_.push_back(
-        InboundRequest(accept_request, reject_request, dependencies.size() > 0));
+    pending_normal_tasks_.emplace_back(
+        task_id, InboundRequest(accept_request, reject_request, dependencies.size() > 0));
   }
 
-  /// Schedules as many requests as possible in sequence.
+  /// Schedules as many requests as possible in sequence. The lock is released while a
+  /// task executes, so that the tasks pipelined to this worker can be queued, or
+  /// cancelled, in the meantime.
   void ScheduleRequests() {
-    absl::MutexLock lock(&mu_);
-    while (!pending_normal_tasks_.empty()) {
-      auto &head = pending_normal_tasks_.front();
+    while (true) {
+      InboundRequest head;
+      {
+        absl::MutexLock lock(&mu_);
+        if (pending_normal_tasks_.empty()) {
+          return;
+        }
+        head = std::move(pending_normal_tasks_.front().second);
+        pending_normal_tasks_.pop_front();
+      }
       head.Accept();
-      pending_normal_tasks_.pop_front();
     }
   }
 
+  /// Remove a task from the queue and reject it, if it has not started yet.
+  ///
+  /// \param task_id The ID of the task to cancel.
+  /// \return Whether the task was queued.
+  bool CancelTaskIfFound(const TaskID &task_id) {
+    InboundRequest request;
+    {
+      absl::MutexLock lock(&mu_);
+      auto it = std::find_if(
+          pending_normal_tasks_.begin(), pending_normal_tasks_.end(),
+          [&task_id](const std::pair<TaskID, InboundRequest> &entry) {
+            return entry.first == task_id;
+          });
+      if (it == pending_normal_tasks_.end()) {
+        return false;
+      }
+      request = std::move(it->second);
+      pending_normal_tasks_.erase(it);
+    }
+    request.Cancel();
+    return true;
+  }
+
  private:
   /// Protects access to the dequeue below.
   mutable absl::Mutex mu_;
-  /// Queue with (accept, rej) callbacks for non-actor tasks
-  std::deque<InboundRequest> pending_normal_tasks_ GUARDED_BY(mu_);
+  /// Queue with (accept, rej) callbacks for non-actor tasks, with the IDs of the tasks.
+  std::deque<std::pair<TaskID, InboundRequest>> pending_normal_tasks_ GUARDED_BY(mu_);
   friend class SchedulingQueueTest;
 };
 
@@ -583,6 +617,13 @@ class CoreWorkerDirectTaskReceiver {
   /// Pop tasks from the queue and execute them sequentially
   void RunNormalTasksFromQueue();
 
+  /// Cancel a normal task that is queued behind other tasks pipelined to this worker.
+  /// The task is replied to as cancelled, without being executed.
+  ///
+  /// \param task_id The ID of the task to cancel.
+  /// \return Whether the task was queued, i.e. not started yet.
+  bool CancelQueuedNormalTask(const TaskID &task_id);
+
  private:
   // Worker context.
   WorkerContext &worker_context_;
@@ -602,8 +643,8 @@ class CoreWorkerDirectTaskReceiver {
   /// TODO(ekl) GC these queues once the handle is no longer active.
   std::unordered_map<WorkerID, std::unique_ptr<SchedulingQueue>> actor_scheduling_queues_;
   // Queue of pending normal (non-actor) tasks.
-  std::unique_ptr<SchedulingQueue> normal_scheduling_queue_ =
-      std::unique_ptr<SchedulingQueue>(new NormalSchedulingQueue());
+  std::unique_ptr<NormalSchedulingQueue> normal_scheduling_queue_ =
+      std::unique_ptr<NormalSchedulingQueue>(new NormalSchedulingQueue());
 };
 
 }  // namespace ray
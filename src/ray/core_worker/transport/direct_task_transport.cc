@@ -141,8 +141,13 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
   // Return the worker if there was an error executing the previous task,
   // the previous task is an actor creation task,
   // there are no more applicable queued tasks, or the lease is expired.
-  if (was_error || current_queue.empty() ||
-      current_time_ms() > lease_entry.lease_expiration_time) {
+  if (was_error) {
+    // Stop pushing tasks to the worker, and return it once the tasks pipelined to it
+    // are done.
+    StartDrainingWorker(addr, /*was_error=*/true, /*worker_exiting=*/false);
+    FinishDrainingWorkerIfIdle(addr);
+  } else if (current_queue.empty() ||
+             current_time_ms() > lease_entry.lease_expiration_time) {
     RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
 
     // Return the worker only if there are no tasks in flight
@@ -156,8 +161,8 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
         scheduling_key_entries_.erase(scheduling_key);
       }
 
-      auto status =
-          lease_entry.lease_client->ReturnWorker(addr.port, addr.worker_id, was_error);
+      auto status = lease_entry.lease_client->ReturnWorker(addr.port, addr.worker_id,
+                                                           /*was_error=*/false);
       if (!status.ok()) {
         RAY_LOG(ERROR) << "Error returning worker to raylet: " << status.ToString();
       }
@@ -194,6 +199,41 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
   RequestNewWorkerIfNeeded(scheduling_key);
 }
 
+void CoreWorkerDirectTaskSubmitter::StartDrainingWorker(const rpc::WorkerAddress &addr,
+                                                        bool was_error,
+                                                        bool worker_exiting) {
+  auto &lease_entry = worker_to_lease_entry_[addr];
+  RAY_CHECK(lease_entry.lease_client && !lease_entry.IsDraining());
+  lease_entry.was_error = was_error;
+  lease_entry.worker_exiting = worker_exiting;
+
+  const auto scheduling_key = lease_entry.scheduling_key;
+  auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+  scheduling_key_entry.active_workers.erase(addr);
+  RAY_CHECK(scheduling_key_entry.total_tasks_in_flight >= lease_entry.tasks_in_flight);
+  scheduling_key_entry.total_tasks_in_flight -= lease_entry.tasks_in_flight;
+  if (scheduling_key_entry.CanDelete()) {
+    scheduling_key_entries_.erase(scheduling_key);
+  }
+}
+
+void CoreWorkerDirectTaskSubmitter::FinishDrainingWorkerIfIdle(
+    const rpc::WorkerAddress &addr) {
+  auto &lease_entry = worker_to_lease_entry_[addr];
+  RAY_CHECK(lease_entry.IsDraining());
+  if (lease_entry.tasks_in_flight > 0) {
+    return;
+  }
+  if (!lease_entry.worker_exiting) {
+    auto status = lease_entry.lease_client->ReturnWorker(addr.port, addr.worker_id,
+                                                         lease_entry.was_error);
+    if (!status.ok()) {
+      RAY_LOG(ERROR) << "Error returning worker to raylet: " << status.ToString();
+    }
+  }
+  worker_to_lease_entry_.erase(addr);
+}
+
 void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
     const SchedulingKey &scheduling_key) {
   auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
@@ -290,62 +330,97 @@ void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
   }
   auto lease_client = GetOrConnectLeaseClient(raylet_address);
   TaskID task_id = resource_spec.TaskId();
-  // Subtract 1 so we don't double count the task we are requesting for.
-  int64_t queue_size = task_queue.size() - 1;
-  lease_client->RequestWorkerLease(
-      resource_spec,
-      [this, scheduling_key](const Status &status,
-                             const rpc::RequestWorkerLeaseReply &reply) {
-        absl::MutexLock lock(&mu_);
-
-        auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
-        auto &pending_lease_request = scheduling_key_entry.pending_lease_request;
-        RAY_CHECK(pending_lease_request.first);
-        auto lease_client = std::move(pending_lease_request.first);
-        const auto task_id = pending_lease_request.second;
-        pending_lease_request = std::make_pair(nullptr, TaskID::Nil());
-
-        if (status.ok()) {
-          if (reply.canceled()) {
-            RAY_LOG(DEBUG) << "Lease canceled " << task_id;
-            RequestNewWorkerIfNeeded(scheduling_key);
-          } else if (!reply.worker_address().raylet_id().empty()) {
-            // We got a lease for a worker. Add the lease client state and try to
-            // assign work to the worker.
-            RAY_LOG(DEBUG) << "Lease granted " << task_id;
-            rpc::WorkerAddress addr(reply.worker_address());
-            auto resources_copy = reply.resource_mapping();
-
-            AddWorkerLeaseClient(addr, std::move(lease_client), resources_copy,
-                                 scheduling_key);
-            RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
-            OnWorkerIdle(addr, scheduling_key,
-                         /*error=*/false, resources_copy);
-          } else {
-            // The raylet redirected us to a different raylet to retry at.
-            RequestNewWorkerIfNeeded(scheduling_key, &reply.retry_at_raylet_address());
-          }
-        } else if (lease_client != local_lease_client_) {
-          // A lease request to a remote raylet failed. Retry locally if the lease is
-          // still needed.
-          // TODO(swang): Fail after some number of retries?
-          RAY_LOG(ERROR) << "Retrying attempt to schedule task at remote node. Error: "
-                         << status.ToString();
-          RequestNewWorkerIfNeeded(scheduling_key);
-        } else {
-          // A local request failed. This shouldn't happen if the raylet is still alive
-          // and we don't currently handle raylet failures, so treat it as a fatal
-          // error.
-          RAY_LOG(ERROR) << "The worker failed to receive a response from the local "
-                            "raylet. This is most "
-                            "likely because the local raylet has crahsed.";
-          RAY_LOG(FATAL) << status.ToString();
-        }
-      },
-      queue_size);
+  // Request a worker for each pipeline of queued tasks, up to max_leases_per_request_
+  // workers at once.
+  size_t num_leases = std::min<size_t>(
+      max_leases_per_request_,
+      (task_queue.size() + max_tasks_in_flight_per_worker_ - 1) /
+          max_tasks_in_flight_per_worker_);
+  if (num_leases > 1) {
+    std::vector<TaskSpecification> resource_specs(task_queue.begin(),
+                                                  task_queue.begin() + num_leases);
+    // Don't double count the tasks we are requesting for. Cancelling the lease of the
+    // first task cancels the whole request.
+    int64_t queue_size = task_queue.size() - num_leases;
+    lease_client->RequestWorkerLeases(
+        resource_specs,
+        [this, scheduling_key](const Status &status,
+                               const rpc::RequestWorkerLeasesReply &reply) {
+          absl::MutexLock lock(&mu_);
+          HandleWorkerLeaseReplies(scheduling_key, status, reply.leases());
+        },
+        queue_size);
+  } else {
+    // Subtract 1 so we don't double count the task we are requesting for.
+    int64_t queue_size = task_queue.size() - 1;
+    lease_client->RequestWorkerLease(
+        resource_spec,
+        [this, scheduling_key](const Status &status,
+                               const rpc::RequestWorkerLeaseReply &reply) {
+          absl::MutexLock lock(&mu_);
+          google::protobuf::RepeatedPtrField<rpc::RequestWorkerLeaseReply> leases;
+          leases.Add()->CopyFrom(reply);
+          HandleWorkerLeaseReplies(scheduling_key, status, leases);
+        },
+        queue_size);
+  }
   pending_lease_request = std::make_pair(lease_client, task_id);
 }
 
+void CoreWorkerDirectTaskSubmitter::HandleWorkerLeaseReplies(
+    const SchedulingKey &scheduling_key, const Status &status,
+    const google::protobuf::RepeatedPtrField<rpc::RequestWorkerLeaseReply> &leases) {
+  auto &pending_lease_request =
+      scheduling_key_entries_[scheduling_key].pending_lease_request;
+  RAY_CHECK(pending_lease_request.first);
+  auto lease_client = std::move(pending_lease_request.first);
+  const auto task_id = pending_lease_request.second;
+  pending_lease_request = std::make_pair(nullptr, TaskID::Nil());
+
+  if (status.ok()) {
+    const rpc::Address *retry_at_raylet_address = nullptr;
+    std::vector<const rpc::RequestWorkerLeaseReply *> granted_leases;
+    for (const auto &reply : leases) {
+      if (reply.canceled()) {
+        RAY_LOG(DEBUG) << "Lease canceled " << task_id;
+      } else if (!reply.worker_address().raylet_id().empty()) {
+        // We got a lease for a worker. Add the lease client state.
+        RAY_LOG(DEBUG) << "Lease granted " << task_id;
+        AddWorkerLeaseClient(rpc::WorkerAddress(reply.worker_address()), lease_client,
+                             reply.resource_mapping(), scheduling_key);
+        granted_leases.push_back(&reply);
+      } else if (retry_at_raylet_address == nullptr) {
+        // The raylet redirected us to a different raylet to retry at. If several
+        // leases were spilled back, the first raylet is retried.
+        retry_at_raylet_address = &reply.retry_at_raylet_address();
+      }
+    }
+    // Assign work to the granted workers once they are all added, so that more
+    // workers are only requested for the tasks that none of them can take.
+    for (const auto *reply : granted_leases) {
+      RAY_CHECK(scheduling_key_entries_[scheduling_key].active_workers.size() >= 1);
+      OnWorkerIdle(rpc::WorkerAddress(reply->worker_address()), scheduling_key,
+                   /*error=*/false, reply->resource_mapping());
+    }
+    RequestNewWorkerIfNeeded(scheduling_key, retry_at_raylet_address);
+  } else if (lease_client != local_lease_client_) {
+    // A lease request to a remote raylet failed. Retry locally if the lease is
+    // still needed.
+    // TODO(swang): Fail after some number of retries?
+    RAY_LOG(ERROR) << "Retrying attempt to schedule task at remote node. Error: "
+                   << status.ToString();
+    RequestNewWorkerIfNeeded(scheduling_key);
+  } else {
+    // A local request failed. This shouldn't happen if the raylet is still alive
+    // and we don't currently handle raylet failures, so treat it as a fatal
+    // error.
+    RAY_LOG(ERROR) << "The worker failed to receive a response from the local "
+                      "raylet. This is most "
+                      "likely because the local raylet has crahsed.";
+    RAY_LOG(FATAL) << status.ToString();
+  }
+}
+
 void CoreWorkerDirectTaskSubmitter::PushNormalTask(
     const rpc::WorkerAddress &addr, rpc::CoreWorkerClientInterface &client,
     const SchedulingKey &scheduling_key, const TaskSpecification &task_spec,
@@ -374,30 +449,30 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
       RAY_CHECK(lease_entry.tasks_in_flight > 0);
       lease_entry.tasks_in_flight--;
 
-      // Decrement the total number of tasks in flight to any worker with the current
-      // scheduling_key.
-      auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
-      RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
-      RAY_CHECK(scheduling_key_entry.total_tasks_in_flight >= 1);
-      scheduling_key_entry.total_tasks_in_flight--;
-    }
-    if (reply.worker_exiting()) {
-      // The worker is draining and will shutdown after it is done. Don't return
-      // it to the Raylet since that will kill it early.
-      absl::MutexLock lock(&mu_);
-      worker_to_lease_entry_.erase(addr);
-      auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
-      scheduling_key_entry.active_workers.erase(addr);
-      if (scheduling_key_entry.CanDelete()) {
-        // We can safely remove the entry keyed by scheduling_key from the
-        // scheduling_key_entries_ hashmap.
-        scheduling_key_entries_.erase(scheduling_key);
+      if (lease_entry.IsDraining()) {
+        // The tasks pipelined to a draining worker no longer count for the scheduling
+        // key, and no more tasks are pushed to it.
+        FinishDrainingWorkerIfIdle(addr);
+      } else {
+        // Decrement the total number of tasks in flight to any worker with the current
+        // scheduling_key.
+        auto &scheduling_key_entry = scheduling_key_entries_[scheduling_key];
+        RAY_CHECK(scheduling_key_entry.active_workers.size() >= 1);
+        RAY_CHECK(scheduling_key_entry.total_tasks_in_flight >= 1);
+        scheduling_key_entry.total_tasks_in_flight--;
+
+        if (reply.worker_exiting()) {
+          // The worker is draining and will shutdown after it is done. Don't return
+          // it to the Raylet since that will kill it early. The tasks still pipelined
+          // to it are replied to before it exits.
+          StartDrainingWorker(addr, /*was_error=*/false, /*worker_exiting=*/true);
+          FinishDrainingWorkerIfIdle(addr);
+        } else if (!status.ok() || !is_actor_creation) {
+          // Successful actor creation leases the worker indefinitely from the raylet.
+          OnWorkerIdle(addr, scheduling_key,
+                       /*error=*/!status.ok(), assigned_resources);
+        }
       }
-    } else if (!status.ok() || !is_actor_creation) {
-      // Successful actor creation leases the worker indefinitely from the raylet.
-      absl::MutexLock lock(&mu_);
-      OnWorkerIdle(addr, scheduling_key,
-                   /*error=*/!status.ok(), assigned_resources);
     }
     if (!status.ok()) {
       // TODO: It'd be nice to differentiate here between process vs node
@@ -407,6 +482,11 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
       RAY_UNUSED(task_finisher_->PendingTaskFailed(
           task_id, is_actor ? rpc::ErrorType::ACTOR_DIED : rpc::ErrorType::WORKER_DIED,
           &status));
+    } else if (reply.task_cancelled()) {
+      // The task was cancelled while it was queued behind other tasks pipelined to the
+      // worker.
+      RAY_UNUSED(task_finisher_->PendingTaskFailed(
+          task_id, rpc::ErrorType::TASK_CANCELLED, nullptr));
     } else {
       task_finisher_->CompletePendingTask(task_id, reply, addr.ToProto());
     }
@@ -61,7 +61,9 @@ class CoreWorkerDirectTaskSubmitter {
       int64_t lease_timeout_ms, std::shared_ptr<ActorCreatorInterface> actor_creator,
       uint32_t max_tasks_in_flight_per_worker =
           RayConfig::instance().max_tasks_in_flight_per_worker(),
-      absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt)
+      absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt,
+      uint32_t max_leases_per_request =
+          RayConfig::instance().max_worker_leases_per_request())
       : rpc_address_(rpc_address),
         local_lease_client_(lease_client),
         lease_client_factory_(lease_client_factory),
@@ -73,6 +75,7 @@ class CoreWorkerDirectTaskSubmitter {
         actor_creator_(std::move(actor_creator)),
         client_cache_(core_worker_client_pool),
         max_tasks_in_flight_per_worker_(max_tasks_in_flight_per_worker),
+        max_leases_per_request_(max_leases_per_request),
         cancel_retry_timer_(std::move(cancel_timer)) {}
 
   /// Schedule a task for direct submission to a worker.
@@ -123,6 +126,18 @@ class CoreWorkerDirectTaskSubmitter {
                                 const rpc::Address *raylet_address = nullptr)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Handle the replies to the leases of the pending lease request of a scheduling key:
+  /// use the granted workers, and request the missing ones again, from the raylet that
+  /// spilled a lease back if any.
+  ///
+  /// \param[in] scheduling_key The scheduling key of the lease request.
+  /// \param[in] status The status of the lease request.
+  /// \param[in] leases The reply to each lease of the request.
+  void HandleWorkerLeaseReplies(
+      const SchedulingKey &scheduling_key, const Status &status,
+      const google::protobuf::RepeatedPtrField<rpc::RequestWorkerLeaseReply> &leases)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// Cancel a pending worker lease and retry until the cancellation succeeds
   /// (i.e., the raylet drops the request). This should be called when there
   /// are no more tasks queued with the given scheduling key and there is an
@@ -136,6 +151,21 @@ class CoreWorkerDirectTaskSubmitter {
       const google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> &assigned_resources,
       const SchedulingKey &scheduling_key) EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Stop pushing tasks to a worker, because a task pushed to it failed or because the
+  /// worker is exiting. The tasks already pipelined to the worker no longer count as
+  /// in flight for its scheduling key, and the lease ends once they are all done.
+  ///
+  /// \param[in] addr The address of the worker.
+  /// \param[in] was_error Whether to return the worker with an error.
+  /// \param[in] worker_exiting Whether the worker exits by itself, in which case it is
+  /// not returned to the raylet.
+  void StartDrainingWorker(const rpc::WorkerAddress &addr, bool was_error,
+                           bool worker_exiting) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// End the lease of a draining worker once no task is in flight to it.
+  void FinishDrainingWorkerIfIdle(const rpc::WorkerAddress &addr)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// Push a task to a specific worker.
   void PushNormalTask(const rpc::WorkerAddress &addr,
                       rpc::CoreWorkerClientInterface &client,
@@ -193,18 +223,26 @@ class CoreWorkerDirectTaskSubmitter {
   // worker using a single lease.
   const uint32_t max_tasks_in_flight_per_worker_;
 
+  // max_leases_per_request_ limits the number of workers that are requested for a
+  // scheduling key with a single lease request.
+  const uint32_t max_leases_per_request_;
+
   /// A LeaseEntry struct is used to condense the metadata about a single executor:
   /// (1) The lease client through which the worker should be returned
   /// (2) The expiration time of a worker's lease.
   /// (3) The number of tasks that are currently in flight to the worker
   /// (4) The resources assigned to the worker
   /// (5) The SchedulingKey assigned to tasks that will be sent to the worker
+  /// (6) Whether the worker is draining, i.e. no more tasks are sent to it, and how
+  ///     its lease ends.
   struct LeaseEntry {
     std::shared_ptr<WorkerLeaseInterface> lease_client;
     int64_t lease_expiration_time;
     uint32_t tasks_in_flight;
     google::protobuf::RepeatedPtrField<rpc::ResourceMapEntry> assigned_resources;
     SchedulingKey scheduling_key;
+    bool was_error = false;
+    bool worker_exiting = false;
 
     LeaseEntry(
         std::shared_ptr<WorkerLeaseInterface> lease_client = nullptr,
@@ -223,6 +261,10 @@ class CoreWorkerDirectTaskSubmitter {
     bool PipelineToWorkerFull(uint32_t max_tasks_in_flight_per_worker) const {
       return tasks_in_flight == max_tasks_in_flight_per_worker;
     }
+
+    // Check whether the worker waits for the tasks in flight to it before its lease
+    // ends.
+    bool IsDraining() const { return was_error || worker_exiting; }
   };
 
   // Map from worker address to a LeaseEntry struct containing the lease's metadata.
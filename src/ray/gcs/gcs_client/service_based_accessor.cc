@@ -734,6 +734,9 @@ void ServiceBasedNodeResourceInfoAccessor::FillResourceUsageRequest(
   SchedulingResources cached_resources = SchedulingResources(*GetLastResourceUsage());
 
   auto resources_data = resources.mutable_resources();
+  // The rereport replaces the usage of the node, even if the cached report is a delta.
+  resources_data->clear_base_usage_version();
+  resources_data->clear_resources_deleted();
   resources_data->clear_resources_total();
   for (const auto &resource_pair :
        cached_resources.GetTotalResources().GetResourceMap()) {
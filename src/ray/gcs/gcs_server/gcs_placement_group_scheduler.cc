@@ -20,6 +20,22 @@
 namespace ray {
 namespace gcs {
 
+namespace {
+
+/// Group the bundles of the given locations by the node they are placed on, so that
+/// the bundles of a node are sent to it in a single request.
+std::unordered_map<NodeID, std::vector<std::shared_ptr<BundleSpecification>>>
+GroupBundlesByNode(const BundleLocations &bundle_locations) {
+  std::unordered_map<NodeID, std::vector<std::shared_ptr<BundleSpecification>>>
+      node_to_bundles;
+  for (const auto &iter : bundle_locations) {
+    node_to_bundles[iter.second.first].push_back(iter.second.second);
+  }
+  return node_to_bundles;
+}
+
+}  // namespace
+
 GcsPlacementGroupScheduler::GcsPlacementGroupScheduler(
     boost::asio::io_context &io_context,
     std::shared_ptr<gcs::GcsTableStorage> gcs_table_storage,
@@ -161,17 +177,27 @@ void GcsPlacementGroupScheduler::ScheduleUnplacedBundles(
                 .second);
 
   /// TODO(AlisaWu): Change the strategy when reserve resource failed.
+  std::unordered_map<NodeID, std::vector<std::shared_ptr<BundleSpecification>>>
+      node_to_bundles;
   for (const auto &bundle : bundles) {
-    const auto &bundle_id = bundle->BundleId();
-    const auto &node_id = selected_nodes[bundle_id];
+    const auto &node_id = selected_nodes[bundle->BundleId()];
     lease_status_tracker->MarkPreparePhaseStarted(node_id, bundle);
+    node_to_bundles[node_id].push_back(bundle);
+  }
+  // The bundles of a node are prepared by a single request, so that creating a large
+  // placement group takes one round trip per node rather than per bundle.
+  for (const auto &entry : node_to_bundles) {
+    const auto &node_id = entry.first;
+    const auto &bundles_on_node = entry.second;
     // TODO(sang): The callback might not be called at all if nodes are dead. We should
     // handle this case properly.
-    PrepareResources(bundle, gcs_node_manager_.GetAliveNode(node_id),
-                     [this, bundle, node_id, lease_status_tracker, failure_callback,
-                      success_callback](const Status &status) {
-                       lease_status_tracker->MarkPrepareRequestReturned(node_id, bundle,
-                                                                        status);
+    PrepareResources(bundles_on_node, gcs_node_manager_.GetAliveNode(node_id),
+                     [this, bundles_on_node, node_id, lease_status_tracker,
+                      failure_callback, success_callback](const Status &status) {
+                       for (const auto &bundle : bundles_on_node) {
+                         lease_status_tracker->MarkPrepareRequestReturned(
+                             node_id, bundle, status);
+                       }
                        if (lease_status_tracker->AllPrepareRequestsReturned()) {
                          OnAllBundlePrepareRequestReturned(
                              lease_status_tracker, failure_callback, success_callback);
@@ -204,7 +230,7 @@ void GcsPlacementGroupScheduler::MarkScheduleCancelled(
 }
 
 void GcsPlacementGroupScheduler::PrepareResources(
-    const std::shared_ptr<BundleSpecification> &bundle,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
     const StatusCallback &callback) {
   if (!node.has_value()) {
@@ -214,43 +240,47 @@ void GcsPlacementGroupScheduler::PrepareResources(
 
   const auto lease_client = GetLeaseClientFromNode(node.value());
   const auto node_id = NodeID::FromBinary(node.value()->node_id());
-  RAY_LOG(DEBUG) << "Preparing resource from node " << node_id
-                 << " for a bundle: " << bundle->DebugString();
+  RAY_LOG(DEBUG) << "Preparing resource from node " << node_id << " for "
+                 << bundles.size() << " bundles.";
   lease_client->PrepareBundleResources(
-      *bundle, [node_id, bundle, callback](
-                   const Status &status, const rpc::PrepareBundleResourcesReply &reply) {
+      std::vector<std::shared_ptr<const BundleSpecification>>(bundles.begin(),
+                                                              bundles.end()),
+      [node_id, bundles, callback](const Status &status,
+                                   const rpc::PrepareBundleResourcesReply &reply) {
         auto result = reply.success() ? Status::OK()
                                       : Status::IOError("Failed to reserve resource");
         if (result.ok()) {
-          RAY_LOG(DEBUG) << "Finished leasing resource from " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Finished leasing resource from " << node_id << " for "
+                         << bundles.size() << " bundles.";
         } else {
-          RAY_LOG(DEBUG) << "Failed to lease resource from " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Failed to lease resource from " << node_id << " for "
+                         << bundles.size() << " bundles.";
         }
         callback(result);
       });
 }
 
 void GcsPlacementGroupScheduler::CommitResources(
-    const std::shared_ptr<BundleSpecification> &bundle,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
     const StatusCallback callback) {
   RAY_CHECK(node.has_value());
   const auto lease_client = GetLeaseClientFromNode(node.value());
   const auto node_id = NodeID::FromBinary(node.value()->node_id());
 
-  RAY_LOG(DEBUG) << "Committing resource to a node " << node_id
-                 << " for a bundle: " << bundle->DebugString();
+  RAY_LOG(DEBUG) << "Committing resource to a node " << node_id << " for "
+                 << bundles.size() << " bundles.";
   lease_client->CommitBundleResources(
-      *bundle, [bundle, node_id, callback](const Status &status,
-                                           const rpc::CommitBundleResourcesReply &reply) {
+      std::vector<std::shared_ptr<const BundleSpecification>>(bundles.begin(),
+                                                              bundles.end()),
+      [bundles, node_id, callback](const Status &status,
+                                   const rpc::CommitBundleResourcesReply &reply) {
         if (status.ok()) {
-          RAY_LOG(DEBUG) << "Finished committing resource to " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Finished committing resource to " << node_id << " for "
+                         << bundles.size() << " bundles.";
         } else {
-          RAY_LOG(DEBUG) << "Failed to commit resource to " << node_id
-                         << " for bundle: " << bundle->DebugString();
+          RAY_LOG(DEBUG) << "Failed to commit resource to " << node_id << " for "
+                         << bundles.size() << " bundles.";
         }
         RAY_CHECK(callback);
         callback(status);
@@ -258,24 +288,26 @@ void GcsPlacementGroupScheduler::CommitResources(
 }
 
 void GcsPlacementGroupScheduler::CancelResourceReserve(
-    const std::shared_ptr<BundleSpecification> &bundle_spec,
+    const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
     const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node) {
   if (!node.has_value()) {
-    RAY_LOG(INFO) << "Node for a placement group id " << bundle_spec->PlacementGroupId()
-                  << " and a bundle index, " << bundle_spec->Index()
+    RAY_LOG(INFO) << "Node for " << bundles.size() << " bundles of placement group "
+                  << bundles.front()->PlacementGroupId()
                   << " has already removed. Cancellation request will be ignored.";
     return;
   }
   auto node_id = NodeID::FromBinary(node.value()->node_id());
-  RAY_LOG(DEBUG) << "Cancelling the resource reserved for bundle: "
-                 << bundle_spec->DebugString() << " at node " << node_id;
+  RAY_LOG(DEBUG) << "Cancelling the resource reserved for " << bundles.size()
+                 << " bundles at node " << node_id;
   const auto return_client = GetLeaseClientFromNode(node.value());
 
   return_client->CancelResourceReserve(
-      *bundle_spec, [bundle_spec, node_id](const Status &status,
-                                           const rpc::CancelResourceReserveReply &reply) {
-        RAY_LOG(DEBUG) << "Finished cancelling the resource reserved for bundle: "
-                       << bundle_spec->DebugString() << " at node " << node_id;
+      std::vector<std::shared_ptr<const BundleSpecification>>(bundles.begin(),
+                                                              bundles.end()),
+      [bundles, node_id](const Status &status,
+                         const rpc::CancelResourceReserveReply &reply) {
+        RAY_LOG(DEBUG) << "Finished cancelling the resource reserved for "
+                       << bundles.size() << " bundles at node " << node_id;
       });
 }
 
@@ -303,15 +335,17 @@ void GcsPlacementGroupScheduler::CommitAllBundles(
   const std::shared_ptr<BundleLocations> &prepared_bundle_locations =
       lease_status_tracker->GetPreparedBundleLocations();
   lease_status_tracker->MarkCommitPhaseStarted();
-  for (const auto &bundle_to_commit : *prepared_bundle_locations) {
-    const auto &node_id = bundle_to_commit.second.first;
+  for (const auto &entry : GroupBundlesByNode(*prepared_bundle_locations)) {
+    const auto &node_id = entry.first;
     const auto &node = gcs_node_manager_.GetAliveNode(node_id);
-    const auto &bundle = bundle_to_commit.second.second;
+    const auto &bundles_on_node = entry.second;
 
-    auto commit_resources_callback = [this, lease_status_tracker, bundle, node_id,
-                                      schedule_failure_handler,
+    auto commit_resources_callback = [this, lease_status_tracker, bundles_on_node,
+                                      node_id, schedule_failure_handler,
                                       schedule_success_handler](const Status &status) {
-      lease_status_tracker->MarkCommitRequestReturned(node_id, bundle, status);
+      for (const auto &bundle : bundles_on_node) {
+        lease_status_tracker->MarkCommitRequestReturned(node_id, bundle, status);
+      }
       if (lease_status_tracker->AllCommitRequestReturned()) {
         OnAllBundleCommitRequestReturned(lease_status_tracker, schedule_failure_handler,
                                          schedule_success_handler);
@@ -319,7 +353,7 @@ void GcsPlacementGroupScheduler::CommitAllBundles(
     };
 
     if (node.has_value()) {
-      CommitResources(bundle, node, commit_resources_callback);
+      CommitResources(bundles_on_node, node, commit_resources_callback);
     } else {
       RAY_LOG(INFO) << "Failed to commit resources because the node is dead, node id = "
                     << node_id;
@@ -513,10 +547,8 @@ void GcsPlacementGroupScheduler::DestroyPlacementGroupPreparedBundleResources(
     // Cancel all resource reservation of prepared bundles.
     RAY_LOG(INFO) << "Cancelling all prepared bundles of a placement group, id is "
                   << placement_group_id;
-    for (const auto &iter : *(leasing_bundle_locations)) {
-      auto &bundle_spec = iter.second.second;
-      auto &node_id = iter.second.first;
-      CancelResourceReserve(bundle_spec, gcs_node_manager_.GetAliveNode(node_id));
+    for (const auto &entry : GroupBundlesByNode(*leasing_bundle_locations)) {
+      CancelResourceReserve(entry.second, gcs_node_manager_.GetAliveNode(entry.first));
     }
   }
 }
@@ -532,10 +564,8 @@ void GcsPlacementGroupScheduler::DestroyPlacementGroupCommittedBundleResources(
     // Cancel all resource reservation of committed bundles.
     RAY_LOG(INFO) << "Cancelling all committed bundles of a placement group, id is "
                   << placement_group_id;
-    for (const auto &iter : *(committed_bundle_locations)) {
-      auto &bundle_spec = iter.second.second;
-      auto &node_id = iter.second.first;
-      CancelResourceReserve(bundle_spec, gcs_node_manager_.GetAliveNode(node_id));
+    for (const auto &entry : GroupBundlesByNode(*committed_bundle_locations)) {
+      CancelResourceReserve(entry.second, gcs_node_manager_.GetAliveNode(entry.first));
     }
     committed_bundle_location_index_.Erase(placement_group_id);
   }
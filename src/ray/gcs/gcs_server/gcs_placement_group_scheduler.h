@@ -442,35 +442,37 @@ class GcsPlacementGroupScheduler : public GcsPlacementGroupSchedulerInterface {
                                 &node_to_bundles) override;
 
  protected:
-  /// Send a bundle PREPARE request to a node. The PREPARE request will lock resources
-  /// on a node until COMMIT or CANCEL requests are sent to a node.
+  /// Send a PREPARE request for the bundles placed on a node. The PREPARE request will
+  /// lock resources on a node until COMMIT or CANCEL requests are sent to a node. The
+  /// bundles are prepared atomically: either all of them are prepared, or none of them
+  /// is.
   ///
-  /// \param bundle A bundle to schedule on a node.
-  /// \param node A node to prepare resources for a given bundle.
+  /// \param bundles The bundles to schedule on a node.
+  /// \param node A node to prepare resources for the given bundles.
   /// \param callback
   void PrepareResources(
-      const std::shared_ptr<BundleSpecification> &bundle,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
       const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
       const StatusCallback &callback);
 
-  /// Send a bundle COMMIT request to a node. This means the placement group creation
-  /// is ready and GCS will commit resources on a given node.
+  /// Send a COMMIT request for the bundles placed on a node. This means the placement
+  /// group creation is ready and GCS will commit resources on a given node.
   ///
-  /// \param bundle A bundle to schedule on a node.
-  /// \param node A node to commit resources for a given bundle.
+  /// \param bundles The bundles to schedule on a node.
+  /// \param node A node to commit resources for the given bundles.
   /// \param callback
-  void CommitResources(const std::shared_ptr<BundleSpecification> &bundle,
+  void CommitResources(const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
                        const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node,
                        const StatusCallback callback);
 
-  /// Cacnel prepared or committed resources from a node.
+  /// Cacnel prepared or committed resources of bundles from a node.
   /// Nodes will be in charge of tracking state of a bundle.
   /// This method is supposed to be idempotent.
   ///
-  /// \param bundle A description of the bundle to return.
-  /// \param node The node that the worker will be returned for.
+  /// \param bundles A description of the bundles to return.
+  /// \param node The node that the bundles are placed on.
   void CancelResourceReserve(
-      const std::shared_ptr<BundleSpecification> &bundle_spec,
+      const std::vector<std::shared_ptr<BundleSpecification>> &bundles,
       const absl::optional<std::shared_ptr<ray::rpc::GcsNodeInfo>> &node);
 
   /// Get an existing lease client or connect a new one or connect a new one.
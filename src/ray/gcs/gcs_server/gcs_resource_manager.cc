@@ -14,6 +14,7 @@
 
 #include "ray/gcs/gcs_server/gcs_resource_manager.h"
 #include "ray/common/ray_config.h"
+#include "ray/common/resource_usage.h"
 #include "ray/stats/stats.h"
 
 namespace ray {
@@ -168,19 +169,28 @@ void GcsResourceManager::HandleReportResourceUsage(
 
   // We use `node_resource_usages_` to filter out the nodes that report resource
   // information for the first time. `UpdateNodeResourceUsage` will modify
-  // `node_resource_usages_`, so we need to do it before `UpdateNodeResourceUsage`.
-  if (node_resource_usages_.count(node_id) == 0 ||
-      resources_data->resources_available_changed()) {
-    const auto &resource_changed = MapFromProtobuf(resources_data->resources_available());
+  // `node_resource_usages_`, so we need to check it before `UpdateNodeResourceUsage`.
+  bool is_first_report = node_resource_usages_.count(node_id) == 0;
+  UpdateNodeResourceUsage(node_id, request);
+  // The available resources are read from the updated usage, as the report may only
+  // contain those that changed.
+  if (is_first_report || resources_data->resources_available_changed()) {
+    const auto &resource_changed =
+        MapFromProtobuf(node_resource_usages_[node_id].resources_available());
     SetAvailableResources(node_id, ResourceSet(resource_changed));
   }
 
-  UpdateNodeResourceUsage(node_id, request);
-
   if (resources_data->should_global_gc() || resources_data->resources_total_size() > 0 ||
       resources_data->resources_available_changed() ||
       resources_data->resource_load_changed()) {
-    resources_buffer_[node_id] = *resources_data;
+    // A delta is merged into the report of the node that is not broadcast yet, so
+    // that the raylets that apply the broadcast report do not miss it.
+    auto it = resources_buffer_.find(node_id);
+    if (it == resources_buffer_.end() || resources_data->base_usage_version() == 0) {
+      resources_buffer_[node_id] = *resources_data;
+    } else {
+      ApplyResourceUsageReport(*resources_data, &it->second);
+    }
   }
 
   GCS_RPC_SEND_REPLY(send_reply_callback, reply, Status::OK());
@@ -240,22 +250,17 @@ void GcsResourceManager::UpdateNodeResourceUsage(
     const NodeID node_id, const rpc::ReportResourceUsageRequest &request) {
   auto iter = node_resource_usages_.find(node_id);
   if (iter == node_resource_usages_.end()) {
-    auto resources_data = std::make_shared<rpc::ResourcesData>();
-    resources_data->CopyFrom(request.resources());
-    node_resource_usages_[node_id] = *resources_data;
-  } else {
-    if (request.resources().resources_total_size() > 0) {
-      (*iter->second.mutable_resources_total()) = request.resources().resources_total();
-    }
-    if (request.resources().resources_available_changed()) {
-      (*iter->second.mutable_resources_available()) =
-          request.resources().resources_available();
-    }
-    if (request.resources().resource_load_changed()) {
-      (*iter->second.mutable_resource_load()) = request.resources().resource_load();
+    iter = node_resource_usages_.emplace(node_id, request.resources()).first;
+    // The usage is kept in full, even if the first report is a delta.
+    iter->second.clear_base_usage_version();
+    iter->second.clear_resources_deleted();
+    if (request.resources().base_usage_version() != 0) {
+      RAY_LOG(DEBUG) << "The first resource usage report of node " << node_id
+                     << " is a delta, it will be resynced by its next full report.";
     }
-    (*iter->second.mutable_resource_load_by_shape()) =
-        request.resources().resource_load_by_shape();
+  } else if (!ApplyResourceUsageReport(request.resources(), &iter->second)) {
+    RAY_LOG(DEBUG) << "Missed a resource usage report of node " << node_id
+                   << ", it will be resynced by its next full report.";
   }
 }
 
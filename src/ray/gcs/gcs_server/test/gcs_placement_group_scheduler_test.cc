@@ -156,12 +156,11 @@ class GcsPlacementGroupSchedulerTest : public ::testing::Test {
           success_placement_groups_.emplace_back(std::move(placement_group));
         });
 
-    ASSERT_EQ(2, raylet_clients_[0]->num_lease_requested);
-    ASSERT_EQ(2, raylet_clients_[0]->lease_callbacks.size());
+    // The bundles placed on the same node are prepared by a single request.
+    ASSERT_EQ(1, raylet_clients_[0]->num_lease_requested);
+    ASSERT_EQ(1, raylet_clients_[0]->lease_callbacks.size());
     ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-    ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-    WaitPendingDone(raylet_clients_[0]->commit_callbacks, 2);
-    ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
+    WaitPendingDone(raylet_clients_[0]->commit_callbacks, 1);
     ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
     WaitPlacementGroupPendingDone(0, GcsPlacementGroupStatus::FAILURE);
     WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::SUCCESS);
@@ -194,9 +193,7 @@ class GcsPlacementGroupSchedulerTest : public ::testing::Test {
     scheduler_->ScheduleUnplacedBundles(placement_group, failure_handler,
                                         success_handler);
     ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-    ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-    WaitPendingDone(raylet_clients_[0]->commit_callbacks, 2);
-    ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
+    WaitPendingDone(raylet_clients_[0]->commit_callbacks, 1);
     ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
     WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::SUCCESS);
   }
@@ -272,12 +269,11 @@ TEST_F(GcsPlacementGroupSchedulerTest, TestSchedulePlacementGroupReplyFailure) {
         success_placement_groups_.emplace_back(std::move(placement_group));
       });
 
-  ASSERT_EQ(2, raylet_clients_[0]->num_lease_requested);
-  ASSERT_EQ(2, raylet_clients_[0]->lease_callbacks.size());
+  ASSERT_EQ(1, raylet_clients_[0]->num_lease_requested);
+  ASSERT_EQ(1, raylet_clients_[0]->lease_callbacks.size());
 
   // Reply failure, so the placement group scheduling failed.
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources(false));
-  ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources(false));
 
   WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::FAILURE);
   WaitPlacementGroupPendingDone(0, GcsPlacementGroupStatus::SUCCESS);
@@ -310,15 +306,16 @@ TEST_F(GcsPlacementGroupSchedulerTest, TestSpreadStrategyResourceCheck) {
 }
 
 TEST_F(GcsPlacementGroupSchedulerTest, TestSchedulePlacementGroupReturnResource) {
-  auto node = Mocker::GenNodeInfo();
-  AddNode(node);
-  ASSERT_EQ(1, gcs_node_manager_->GetAllAliveNodes().size());
+  AddNode(Mocker::GenNodeInfo(0));
+  AddNode(Mocker::GenNodeInfo(1));
+  ASSERT_EQ(2, gcs_node_manager_->GetAllAliveNodes().size());
 
-  auto request = Mocker::GenCreatePlacementGroupRequest();
+  auto request =
+      Mocker::GenCreatePlacementGroupRequest("", rpc::PlacementStrategy::STRICT_SPREAD);
   auto placement_group = std::make_shared<gcs::GcsPlacementGroup>(request);
 
-  // Schedule the placement_group with 1 available node, and the lease request should be
-  // send to the node.
+  // Schedule the placement_group with 2 available nodes, and the lease requests should
+  // be send to both nodes.
   scheduler_->ScheduleUnplacedBundles(
       placement_group,
       [this](std::shared_ptr<gcs::GcsPlacementGroup> placement_group) {
@@ -330,12 +327,13 @@ TEST_F(GcsPlacementGroupSchedulerTest, TestSchedulePlacementGroupReturnResource)
         success_placement_groups_.emplace_back(std::move(placement_group));
       });
 
-  ASSERT_EQ(2, raylet_clients_[0]->num_lease_requested);
-  ASSERT_EQ(2, raylet_clients_[0]->lease_callbacks.size());
+  ASSERT_EQ(1, raylet_clients_[0]->num_lease_requested);
+  ASSERT_EQ(1, raylet_clients_[1]->num_lease_requested);
   // One bundle success and the other failed.
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-  ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources(false));
+  ASSERT_TRUE(raylet_clients_[1]->GrantPrepareBundleResources(false));
   ASSERT_EQ(1, raylet_clients_[0]->num_return_requested);
+  ASSERT_EQ(0, raylet_clients_[1]->num_return_requested);
   // Reply the placement_group creation request, then the placement_group should be
   // scheduled successfully.
   WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::FAILURE);
@@ -368,11 +366,9 @@ TEST_F(GcsPlacementGroupSchedulerTest, TestStrictPackStrategyBalancedScheduling)
 
     node_index = !raylet_clients_[0]->lease_callbacks.empty() ? 0 : 1;
     ++node_select_count[node_index];
-    node_commit_count[node_index] += 2;
+    node_commit_count[node_index] += 1;
     ASSERT_TRUE(raylet_clients_[node_index]->GrantPrepareBundleResources());
-    ASSERT_TRUE(raylet_clients_[node_index]->GrantPrepareBundleResources());
-    WaitPendingDone(raylet_clients_[node_index]->commit_callbacks, 2);
-    ASSERT_TRUE(raylet_clients_[node_index]->GrantCommitBundleResources());
+    WaitPendingDone(raylet_clients_[node_index]->commit_callbacks, 1);
     ASSERT_TRUE(raylet_clients_[node_index]->GrantCommitBundleResources());
     auto condition = [this, node_index, node_commit_count]() {
       return raylet_clients_[node_index]->num_commit_requested ==
@@ -406,9 +402,7 @@ TEST_F(GcsPlacementGroupSchedulerTest, TestStrictPackStrategyResourceCheck) {
   auto placement_group = std::make_shared<gcs::GcsPlacementGroup>(request);
   scheduler_->ScheduleUnplacedBundles(placement_group, failure_handler, success_handler);
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-  ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 2);
-  ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
+  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 1);
   ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
   WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::SUCCESS);
 
@@ -422,9 +416,7 @@ TEST_F(GcsPlacementGroupSchedulerTest, TestStrictPackStrategyResourceCheck) {
       std::make_shared<gcs::GcsPlacementGroup>(create_placement_group_request2);
   scheduler_->ScheduleUnplacedBundles(placement_group2, failure_handler, success_handler);
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-  ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 2);
-  ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
+  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 1);
   ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
   WaitPlacementGroupPendingDone(2, GcsPlacementGroupStatus::SUCCESS);
 }
@@ -451,20 +443,16 @@ TEST_F(GcsPlacementGroupSchedulerTest, DestroyPlacementGroup) {
         success_placement_groups_.emplace_back(std::move(placement_group));
       });
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-  ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 2);
-  ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
+  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 1);
   ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
   WaitPlacementGroupPendingDone(0, GcsPlacementGroupStatus::FAILURE);
   WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::SUCCESS);
   const auto &placement_group_id = placement_group->GetPlacementGroupID();
   scheduler_->DestroyPlacementGroupBundleResourcesIfExists(placement_group_id);
   ASSERT_TRUE(raylet_clients_[0]->GrantCancelResourceReserve());
-  ASSERT_TRUE(raylet_clients_[0]->GrantCancelResourceReserve());
   // Subsequent destroy request should not do anything.
   scheduler_->DestroyPlacementGroupBundleResourcesIfExists(placement_group_id);
   ASSERT_FALSE(raylet_clients_[0]->GrantCancelResourceReserve());
-  ASSERT_FALSE(raylet_clients_[0]->GrantCancelResourceReserve());
 }
 
 TEST_F(GcsPlacementGroupSchedulerTest, DestroyCancelledPlacementGroup) {
@@ -491,11 +479,10 @@ TEST_F(GcsPlacementGroupSchedulerTest, DestroyCancelledPlacementGroup) {
       });
 
   // Now, cancel the schedule request.
-  ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
   scheduler_->MarkScheduleCancelled(placement_group_id);
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
   ASSERT_TRUE(raylet_clients_[0]->GrantCancelResourceReserve());
-  ASSERT_TRUE(raylet_clients_[0]->GrantCancelResourceReserve());
+  ASSERT_FALSE(raylet_clients_[0]->GrantCancelResourceReserve());
   WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::FAILURE);
 }
 
@@ -524,13 +511,10 @@ TEST_F(GcsPlacementGroupSchedulerTest, PlacementGroupCancelledDuringCommit) {
 
   // Now, cancel the schedule request.
   ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
-  ASSERT_TRUE(raylet_clients_[0]->GrantPrepareBundleResources());
   scheduler_->MarkScheduleCancelled(placement_group_id);
-  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 2);
-  ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
+  WaitPendingDone(raylet_clients_[0]->commit_callbacks, 1);
   ASSERT_TRUE(raylet_clients_[0]->GrantCommitBundleResources());
   ASSERT_TRUE(raylet_clients_[0]->GrantCancelResourceReserve());
-  ASSERT_TRUE(raylet_clients_[0]->GrantCancelResourceReserve());
   WaitPlacementGroupPendingDone(1, GcsPlacementGroupStatus::FAILURE);
 }
 
@@ -84,6 +84,58 @@ TEST_F(GcsResourceManagerTest, TestResourceUsageAPI) {
   ASSERT_EQ(get_all_reply2.resource_usage_data().batch().size(), 0);
 }
 
+TEST_F(GcsResourceManagerTest, TestDeltaResourceUsage) {
+  auto node_id = NodeID::FromRandom();
+  gcs_resource_manager_->UpdateResourceCapacity(node_id, {{"CPU", 4}});
+  auto send_reply_callback = [](ray::Status status, std::function<void()> f1,
+                                std::function<void()> f2) {};
+
+  rpc::ReportResourceUsageRequest full_request;
+  auto full_report = full_request.mutable_resources();
+  full_report->set_node_id(node_id.Binary());
+  full_report->set_usage_version(1);
+  (*full_report->mutable_resources_total())["CPU"] = 4;
+  (*full_report->mutable_resources_available())["CPU"] = 4;
+  full_report->set_resources_available_changed(true);
+  rpc::ReportResourceUsageReply reply;
+  gcs_resource_manager_->HandleReportResourceUsage(full_request, &reply,
+                                                   send_reply_callback);
+
+  // The delta only contains the resources that changed.
+  rpc::ReportResourceUsageRequest delta_request;
+  auto delta = delta_request.mutable_resources();
+  delta->set_node_id(node_id.Binary());
+  delta->set_usage_version(2);
+  delta->set_base_usage_version(1);
+  (*delta->mutable_resource_load())["CPU"] = 1;
+  delta->set_resource_load_changed(true);
+  gcs_resource_manager_->HandleReportResourceUsage(delta_request, &reply,
+                                                   send_reply_callback);
+
+  rpc::GetAllResourceUsageRequest get_all_request;
+  rpc::GetAllResourceUsageReply get_all_reply;
+  gcs_resource_manager_->HandleGetAllResourceUsage(get_all_request, &get_all_reply,
+                                                   send_reply_callback);
+  ASSERT_EQ(get_all_reply.resource_usage_data().batch().size(), 1);
+  const auto &usage = get_all_reply.resource_usage_data().batch(0);
+  ASSERT_EQ(usage.usage_version(), 2);
+  ASSERT_EQ(usage.resources_total().at("CPU"), 4);
+  ASSERT_EQ(usage.resources_available().at("CPU"), 4);
+  ASSERT_EQ(usage.resource_load().at("CPU"), 1);
+
+  // An exhausted resource is sent as 0 and removed from the available resources.
+  delta->clear_resource_load();
+  delta->set_resource_load_changed(false);
+  delta->set_usage_version(3);
+  delta->set_base_usage_version(2);
+  (*delta->mutable_resources_available())["CPU"] = 0;
+  delta->set_resources_available_changed(true);
+  gcs_resource_manager_->HandleReportResourceUsage(delta_request, &reply,
+                                                   send_reply_callback);
+  const auto &cluster_resources = gcs_resource_manager_->GetClusterResources();
+  ASSERT_TRUE(cluster_resources.at(node_id).GetAvailableResources().IsEmpty());
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
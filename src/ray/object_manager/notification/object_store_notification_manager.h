@@ -15,13 +15,16 @@
 #ifndef RAY_OBJECT_STORE_NOTIFICATION_MANAGER_H
 #define RAY_OBJECT_STORE_NOTIFICATION_MANAGER_H
 
+#include <algorithm>
 #include <boost/asio.hpp>
+#include <deque>
 #include <iostream>
 #include <memory>
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "ray/common/id.h"
+#include "ray/common/ray_config.h"
 #include "ray/common/status.h"
 #include "ray/object_manager/format/object_manager_generated.h"
 
@@ -30,7 +33,14 @@ namespace ray {
 /// \class ObjectStoreNotificationManager
 ///
 /// Encapsulates notification handling from the object store.
-class ObjectStoreNotificationManager {
+///
+/// The notifications are received on the thread of the object store and handed off
+/// to the main service through a queue. The queue is drained in batches of bounded
+/// size, so that a burst of notifications does not delay the other handlers of the
+/// main service, such as the lease requests, by more than one batch. This object must
+/// be owned by a shared pointer.
+class ObjectStoreNotificationManager
+    : public std::enable_shared_from_this<ObjectStoreNotificationManager> {
  public:
   ObjectStoreNotificationManager(boost::asio::io_service &io_service)
       : main_service_(&io_service), num_adds_processed_(0), num_removes_processed_(0) {}
@@ -56,19 +66,18 @@ class ObjectStoreNotificationManager {
 
   /// Support for rebroadcasting object add/rem events.
   void ProcessStoreAdd(const object_manager::protocol::ObjectInfoT &object_info) {
-    // TODO(suquark): Use strand in boost asio to enforce sequential execution.
-    absl::MutexLock lock(&store_add_mutex_);
-    for (auto &handler : add_handlers_) {
-      main_service_->post([handler, object_info]() { handler(object_info); });
-    }
+    Notification notification;
+    notification.added = true;
+    notification.object_info = object_info;
+    PushNotification(std::move(notification));
     num_adds_processed_++;
   }
 
   void ProcessStoreRemove(const ObjectID &object_id) {
-    absl::MutexLock lock(&store_remove_mutex_);
-    for (auto &handler : rem_handlers_) {
-      main_service_->post([handler, object_id]() { handler(object_id); });
-    }
+    Notification notification;
+    notification.added = false;
+    notification.object_id = object_id;
+    PushNotification(std::move(notification));
     num_removes_processed_++;
   }
 
@@ -80,10 +89,86 @@ class ObjectStoreNotificationManager {
     result << "ObjectStoreNotificationManager:";
     result << "\n- num adds processed: " << num_adds_processed_;
     result << "\n- num removes processed: " << num_removes_processed_;
+    {
+      absl::MutexLock lock(&notifications_mutex_);
+      result << "\n- num notifications pending: " << pending_notifications_.size();
+    }
     return result.str();
   }
 
  private:
+  /// An object added to or removed from the local store.
+  struct Notification {
+    bool added;
+    /// The removed object.
+    ObjectID object_id;
+    /// The added object.
+    object_manager::protocol::ObjectInfoT object_info;
+  };
+
+  /// Queue a notification, and post a drain of the queue to the main service unless
+  /// one is already posted.
+  void PushNotification(Notification notification) {
+    {
+      absl::MutexLock lock(&notifications_mutex_);
+      pending_notifications_.push_back(std::move(notification));
+      if (drain_posted_) {
+        return;
+      }
+      drain_posted_ = true;
+    }
+    auto self = shared_from_this();
+    main_service_->post([self]() { self->DrainNotifications(); });
+  }
+
+  /// Run the handlers of a batch of queued notifications, in the order in which the
+  /// notifications were received. If more notifications are queued, the drain is
+  /// posted again behind the handlers that were posted in the meantime.
+  void DrainNotifications() {
+    const size_t batch_size = std::max<size_t>(
+        RayConfig::instance().object_store_notification_batch_size(), 1);
+    std::vector<Notification> batch;
+    bool drain_again = false;
+    {
+      absl::MutexLock lock(&notifications_mutex_);
+      const size_t num_notifications =
+          std::min(batch_size, pending_notifications_.size());
+      batch.reserve(num_notifications);
+      for (size_t i = 0; i < num_notifications; i++) {
+        batch.push_back(std::move(pending_notifications_.front()));
+        pending_notifications_.pop_front();
+      }
+      drain_again = !pending_notifications_.empty();
+      drain_posted_ = drain_again;
+    }
+    std::vector<std::function<void(const object_manager::protocol::ObjectInfoT &)>>
+        add_handlers;
+    std::vector<std::function<void(const ray::ObjectID &)>> rem_handlers;
+    {
+      absl::MutexLock lock(&store_add_mutex_);
+      add_handlers = add_handlers_;
+    }
+    {
+      absl::MutexLock lock(&store_remove_mutex_);
+      rem_handlers = rem_handlers_;
+    }
+    for (const auto &notification : batch) {
+      if (notification.added) {
+        for (const auto &handler : add_handlers) {
+          handler(notification.object_info);
+        }
+      } else {
+        for (const auto &handler : rem_handlers) {
+          handler(notification.object_id);
+        }
+      }
+    }
+    if (drain_again) {
+      auto self = shared_from_this();
+      main_service_->post([self]() { self->DrainNotifications(); });
+    }
+  }
+
   /// Weak reference to main service. We ensure this object is destroyed before
   /// main_service_ is stopped.
   boost::asio::io_service *main_service_;
@@ -92,6 +177,11 @@ class ObjectStoreNotificationManager {
   std::vector<std::function<void(const ray::ObjectID &)>> rem_handlers_;
   absl::Mutex store_add_mutex_;
   absl::Mutex store_remove_mutex_;
+  mutable absl::Mutex notifications_mutex_;
+  /// The notifications received from the object store and not handled yet.
+  std::deque<Notification> pending_notifications_ GUARDED_BY(notifications_mutex_);
+  /// Whether a drain of the pending notifications is posted to the main service.
+  bool drain_posted_ GUARDED_BY(notifications_mutex_) = false;
   int64_t num_adds_processed_;
   int64_t num_removes_processed_;
 };
@@ -19,6 +19,7 @@
 #include <memory>
 
 #include "ray/object_manager/plasma/common.h"
+#include "ray/stats/stats.h"
 #include "ray/util/asio_util.h"
 #include "ray/util/util.h"
 
@@ -112,6 +113,7 @@ Status CreateRequestQueue::ProcessRequests() {
         oom_start_time_ns_ = now;
       }
       if (spill_objects_callback_()) {
+        ray::stats::SpillManagerBlockedCreateRequests.Record(queue_.size());
         return Status::TransientObjectStoreFull("Waiting for spilling.");
       } else if (now - oom_start_time_ns_ < oom_grace_period_ns_) {
         // We need a grace period since (1) global GC takes a bit of time to
@@ -125,6 +127,7 @@ Status CreateRequestQueue::ProcessRequests() {
       }
     }
   }
+  ray::stats::SpillManagerBlockedCreateRequests.Record(0);
   return Status::OK();
 }
 
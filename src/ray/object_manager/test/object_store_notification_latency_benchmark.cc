@@ -0,0 +1,119 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reports how long a lease request posted to the main service of the raylet waits
+// behind a burst of object store notifications, when the notifications are posted as
+// one handler per subscriber, as the object store used to, and when they are drained
+// in batches by the ObjectStoreNotificationManager.
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "ray/object_manager/notification/object_store_notification_manager.h"
+
+DEFINE_int64(num_notifications, 10000, "Number of notifications in each burst.");
+DEFINE_int64(num_subscribers, 2, "Number of subscribers to the notifications.");
+DEFINE_int64(handler_us, 5, "Microseconds taken by a subscriber per notification.");
+DEFINE_int64(num_bursts, 10, "Number of bursts to measure.");
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Simulate the work of a subscriber, e.g., the object manager updating the object
+/// directory.
+void Spin(int64_t duration_us) {
+  const auto deadline = Clock::now() + std::chrono::microseconds(duration_us);
+  while (Clock::now() < deadline) {
+  }
+}
+
+/// Send a burst of notifications from the object store thread, post a lease request
+/// to the main service right behind them, and return the microseconds until the lease
+/// request was handled.
+int64_t MeasureLeaseRequestLatencyUs(bool batched) {
+  std::vector<ray::ObjectID> object_ids;
+  object_ids.reserve(FLAGS_num_notifications);
+  for (int64_t i = 0; i < FLAGS_num_notifications; i++) {
+    object_ids.push_back(ray::ObjectID::FromRandom());
+  }
+
+  boost::asio::io_service main_service;
+  auto work = std::make_unique<boost::asio::io_service::work>(main_service);
+  auto notification_manager =
+      std::make_shared<ray::ObjectStoreNotificationManager>(main_service);
+  std::vector<std::function<void(const ray::ObjectID &)>> handlers;
+  for (int64_t i = 0; i < FLAGS_num_subscribers; i++) {
+    handlers.push_back([](const ray::ObjectID &) { Spin(FLAGS_handler_us); });
+    notification_manager->SubscribeObjDeleted(handlers.back());
+  }
+  std::thread main_thread([&main_service]() { main_service.run(); });
+
+  for (const auto &object_id : object_ids) {
+    if (batched) {
+      notification_manager->ProcessStoreRemove(object_id);
+    } else {
+      for (const auto &handler : handlers) {
+        main_service.post([handler, object_id]() { handler(object_id); });
+      }
+    }
+  }
+  std::promise<int64_t> latency_us;
+  const auto posted = Clock::now();
+  main_service.post([posted, &latency_us]() {
+    latency_us.set_value(std::chrono::duration_cast<std::chrono::microseconds>(
+                             Clock::now() - posted)
+                             .count());
+  });
+  const int64_t result = latency_us.get_future().get();
+
+  // Let the rest of the burst be handled before the next one.
+  work.reset();
+  main_thread.join();
+  return result;
+}
+
+/// Print the median and the maximum latency of a lease request over the bursts.
+void ReportLeaseRequestLatency(bool batched) {
+  std::vector<int64_t> latencies_us;
+  for (int64_t i = 0; i < FLAGS_num_bursts; i++) {
+    latencies_us.push_back(MeasureLeaseRequestLatencyUs(batched));
+  }
+  std::sort(latencies_us.begin(), latencies_us.end());
+  std::cout << (batched ? "Batched drain: " : "Handler per subscriber: ")
+            << "median " << latencies_us[latencies_us.size() / 2] / 1000.0
+            << " ms, max " << latencies_us.back() / 1000.0
+            << " ms lease request latency" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  RAY_CHECK(FLAGS_num_notifications > 0 && FLAGS_num_subscribers > 0 &&
+            FLAGS_handler_us >= 0 && FLAGS_num_bursts > 0);
+
+  std::cout << "Bursts of " << FLAGS_num_notifications << " notifications to "
+            << FLAGS_num_subscribers << " subscribers, "
+            << RayConfig::instance().object_store_notification_batch_size()
+            << " notifications per batch" << std::endl;
+  ReportLeaseRequestLatency(/*batched=*/false);
+  ReportLeaseRequestLatency(/*batched=*/true);
+  return 0;
+}
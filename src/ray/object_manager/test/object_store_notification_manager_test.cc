@@ -0,0 +1,77 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/notification/object_store_notification_manager.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+class ObjectStoreNotificationManagerTest : public ::testing::Test {
+ public:
+  ObjectStoreNotificationManagerTest()
+      : notification_manager_(
+            std::make_shared<ObjectStoreNotificationManager>(io_service_)) {
+    RayConfig::instance().initialize({{"object_store_notification_batch_size", "10"}});
+    notification_manager_->SubscribeObjAdded(
+        [this](const object_manager::protocol::ObjectInfoT &object_info) {
+          handled_.push_back(ObjectID::FromBinary(object_info.object_id));
+        });
+    notification_manager_->SubscribeObjDeleted(
+        [this](const ObjectID &object_id) { handled_.push_back(object_id); });
+  }
+
+  void ProcessStoreAdd(const ObjectID &object_id) {
+    object_manager::protocol::ObjectInfoT object_info;
+    object_info.object_id = object_id.Binary();
+    notification_manager_->ProcessStoreAdd(object_info);
+  }
+
+ protected:
+  boost::asio::io_service io_service_;
+  std::shared_ptr<ObjectStoreNotificationManager> notification_manager_;
+  std::vector<ObjectID> handled_;
+};
+
+TEST_F(ObjectStoreNotificationManagerTest, TestNotificationOrder) {
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 25; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    if (i % 2 == 0) {
+      ProcessStoreAdd(object_ids.back());
+    } else {
+      notification_manager_->ProcessStoreRemove(object_ids.back());
+    }
+  }
+  ASSERT_TRUE(handled_.empty());
+  io_service_.run();
+  ASSERT_EQ(handled_, object_ids);
+}
+
+TEST_F(ObjectStoreNotificationManagerTest, TestBurstDoesNotDelayOtherHandlers) {
+  for (int i = 0; i < 35; i++) {
+    ProcessStoreAdd(ObjectID::FromRandom());
+  }
+  // A handler posted behind a burst of notifications runs after the first batch.
+  size_t num_handled_before = 0;
+  io_service_.post([this, &num_handled_before]() {
+    num_handled_before = handled_.size();
+    ProcessStoreAdd(ObjectID::FromRandom());
+  });
+  io_service_.run();
+  ASSERT_EQ(num_handled_before, 10);
+  ASSERT_EQ(handled_.size(), 36);
+}
+
+}  // namespace ray
@@ -0,0 +1,235 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/cgroup_manager.h"
+
+#ifdef __linux__
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "ray/util/filesystem.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+namespace {
+
+/// The controllers that the raylet enables for its workers.
+const char kControllers[] = "+cpu +memory";
+
+/// The CPU weight of a cgroup without a lease, and the range of weights.
+constexpr int64_t kDefaultCpuWeight = 100;
+constexpr int64_t kMinCpuWeight = 1;
+constexpr int64_t kMaxCpuWeight = 10000;
+
+}  // namespace
+
+CgroupManager::CgroupManager(const std::string &root_path, double memory_kill_fraction)
+    : root_path_(root_path), memory_kill_fraction_(memory_kill_fraction) {}
+
+CgroupManager::~CgroupManager() {
+  if (path_.empty()) {
+    return;
+  }
+  for (const auto &entry : workers_) {
+    RemoveCgroup(entry.second.path);
+  }
+  for (const auto &path : cgroups_to_remove_) {
+    RemoveCgroup(path);
+  }
+  RemoveCgroup(path_);
+}
+
+bool CgroupManager::Initialize() {
+#ifdef __linux__
+  std::ifstream controllers_file(JoinPaths(root_path_, "cgroup.controllers"));
+  std::string controller;
+  bool has_cpu = false;
+  bool has_memory = false;
+  while (controllers_file >> controller) {
+    has_cpu |= controller == "cpu";
+    has_memory |= controller == "memory";
+  }
+  if (!has_cpu || !has_memory) {
+    RAY_LOG(WARNING) << root_path_
+                     << " is not a cgroup v2 with the cpu and memory controllers.";
+    return false;
+  }
+  if (!WriteCgroupFile(JoinPaths(root_path_, "cgroup.subtree_control"), kControllers)) {
+    return false;
+  }
+  const std::string path = JoinPaths(root_path_, "raylet_" + std::to_string(getpid()));
+  if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+    RAY_LOG(WARNING) << "Failed to create cgroup " << path << ": " << strerror(errno);
+    return false;
+  }
+  if (!WriteCgroupFile(JoinPaths(path, "cgroup.subtree_control"), kControllers)) {
+    RemoveCgroup(path);
+    return false;
+  }
+  path_ = path;
+  RAY_LOG(INFO) << "Placing workers in cgroups under " << path_;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool CgroupManager::AddWorker(const WorkerID &worker_id, pid_t pid) {
+#ifdef __linux__
+  RAY_CHECK(!path_.empty());
+  const std::string path = JoinPaths(path_, "worker_" + worker_id.Hex());
+  if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+    RAY_LOG(WARNING) << "Failed to create cgroup " << path << ": " << strerror(errno);
+    return false;
+  }
+  workers_[worker_id].path = path;
+  return WriteCgroupFile(JoinPaths(path, "cgroup.procs"), std::to_string(pid));
+#else
+  return false;
+#endif
+}
+
+void CgroupManager::SetWorkerLimits(const WorkerID &worker_id, double num_cpus,
+                                    int64_t memory_bytes) {
+  auto it = workers_.find(worker_id);
+  if (it == workers_.end()) {
+    return;
+  }
+  // A lease without CPUs, e.g., of an actor, keeps the default weight rather than
+  // being starved by the leases with CPUs.
+  int64_t cpu_weight = kDefaultCpuWeight;
+  if (num_cpus > 0) {
+    cpu_weight = std::llround(num_cpus * kDefaultCpuWeight);
+    cpu_weight = std::min(std::max(cpu_weight, kMinCpuWeight), kMaxCpuWeight);
+  }
+  WriteCgroupFile(JoinPaths(it->second.path, "cpu.weight"), std::to_string(cpu_weight));
+  std::string memory_max = "max";
+  if (memory_bytes > 0) {
+    int64_t usage = 0;
+    if (ReadMemoryUsage(it->second.path, &usage) && usage >= memory_bytes) {
+      // Lowering the limit below the usage would make the kernel reclaim or OOM kill
+      // the worker. It is left unlimited, and reported for killing by the next update.
+      RAY_LOG(WARNING) << "Worker " << worker_id << " already uses " << usage
+                       << " bytes, more than the memory limit of " << memory_bytes
+                       << " bytes of its lease.";
+    } else {
+      memory_max = std::to_string(memory_bytes);
+    }
+  }
+  WriteCgroupFile(JoinPaths(it->second.path, "memory.max"), memory_max);
+  it->second.memory_limit_bytes = std::max<int64_t>(memory_bytes, 0);
+}
+
+void CgroupManager::ResetWorkerLimits(const WorkerID &worker_id) {
+  auto it = workers_.find(worker_id);
+  if (it == workers_.end()) {
+    return;
+  }
+  WriteCgroupFile(JoinPaths(it->second.path, "cpu.weight"),
+                  std::to_string(kDefaultCpuWeight));
+  WriteCgroupFile(JoinPaths(it->second.path, "memory.max"), "max");
+  it->second.memory_limit_bytes = 0;
+}
+
+void CgroupManager::RemoveWorker(const WorkerID &worker_id) {
+  auto it = workers_.find(worker_id);
+  if (it == workers_.end()) {
+    return;
+  }
+  if (!RemoveCgroup(it->second.path)) {
+    cgroups_to_remove_.push_back(it->second.path);
+  }
+  workers_.erase(it);
+}
+
+std::vector<WorkerID> CgroupManager::UpdateMemoryUsage() {
+  // Retry removing the cgroups whose process exited since.
+  cgroups_to_remove_.erase(
+      std::remove_if(cgroups_to_remove_.begin(), cgroups_to_remove_.end(),
+                     [this](const std::string &path) { return RemoveCgroup(path); }),
+      cgroups_to_remove_.end());
+
+  std::vector<WorkerID> workers_to_kill;
+  for (auto &entry : workers_) {
+    int64_t usage = 0;
+    if (!ReadMemoryUsage(entry.second.path, &usage)) {
+      continue;
+    }
+    entry.second.memory_usage_bytes = usage;
+    if (entry.second.memory_limit_bytes > 0 &&
+        usage >= memory_kill_fraction_ * entry.second.memory_limit_bytes) {
+      workers_to_kill.push_back(entry.first);
+    }
+  }
+  return workers_to_kill;
+}
+
+int64_t CgroupManager::GetMemoryUsage(const WorkerID &worker_id) const {
+  auto it = workers_.find(worker_id);
+  return it == workers_.end() ? 0 : it->second.memory_usage_bytes;
+}
+
+std::string CgroupManager::DebugString() const {
+  int64_t memory_usage_bytes = 0;
+  for (const auto &entry : workers_) {
+    memory_usage_bytes += entry.second.memory_usage_bytes;
+  }
+  std::stringstream result;
+  result << "CgroupManager:";
+  result << "\n- num worker cgroups: " << workers_.size();
+  result << "\n- worker memory usage bytes: " << memory_usage_bytes;
+  result << "\n- num cgroups to remove: " << cgroups_to_remove_.size();
+  return result.str();
+}
+
+bool CgroupManager::WriteCgroupFile(const std::string &path,
+                                    const std::string &value) const {
+  std::ofstream file(path);
+  file << value;
+  file.flush();
+  if (!file.good()) {
+    RAY_LOG(WARNING) << "Failed to write " << value << " to " << path;
+    return false;
+  }
+  return true;
+}
+
+bool CgroupManager::ReadMemoryUsage(const std::string &path, int64_t *usage) const {
+  std::ifstream usage_file(JoinPaths(path, "memory.current"));
+  return static_cast<bool>(usage_file >> *usage);
+}
+
+bool CgroupManager::RemoveCgroup(const std::string &path) const {
+#ifdef __linux__
+  return rmdir(path.c_str()) == 0 || errno == ENOENT;
+#else
+  return true;
+#endif
+}
+
+}  // namespace raylet
+
+}  // end namespace ray
@@ -0,0 +1,127 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ray/common/id.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// \class CgroupManager
+///
+/// Places each worker process in its own cgroup v2, so that the CPU and memory used
+/// by a worker are limited by the resources of its lease. The processes that host
+/// several workers are not placed in cgroups, as their workers hold different leases.
+///
+/// The root cgroup must be delegated to the raylet: it must be writable, have the cpu
+/// and memory controllers available, and hold no process. The raylet creates a cgroup
+/// under it, and a cgroup per worker under that one. The CPU weight of a worker is
+/// proportional to its CPU resource, and its memory is limited to its memory resource.
+/// The memory usage of the workers is polled, so that a worker that nears its limit is
+/// killed by the raylet rather than by the kernel OOM killer.
+class CgroupManager {
+ public:
+  /// Create a cgroup manager.
+  ///
+  /// \param root_path The cgroup v2 directory delegated to the raylet.
+  /// \param memory_kill_fraction A worker is reported for killing once its memory usage
+  /// reaches this fraction of its memory limit.
+  CgroupManager(const std::string &root_path, double memory_kill_fraction);
+
+  /// Remove the cgroups of the raylet and of its workers.
+  ~CgroupManager();
+
+  /// Create the cgroup of the raylet.
+  ///
+  /// \return Whether the cgroups can be used.
+  bool Initialize();
+
+  /// Create the cgroup of a worker and move its process to it. The limits of the
+  /// worker are unset until it is leased.
+  ///
+  /// \param worker_id The ID of the worker.
+  /// \param pid The process of the worker.
+  /// \return Whether the process was moved to the cgroup of the worker.
+  bool AddWorker(const WorkerID &worker_id, pid_t pid);
+
+  /// Set the limits of a worker from the resources of its lease.
+  ///
+  /// \param worker_id The ID of the worker.
+  /// \param num_cpus The CPU resource of the lease. The CPU weight of the worker is
+  /// proportional to it, and a lease without CPUs keeps the default weight.
+  /// \param memory_bytes The memory resource of the lease. 0 means no limit. If the
+  /// worker already uses more, its cgroup is not limited, and the worker is reported
+  /// for killing by the next update instead.
+  void SetWorkerLimits(const WorkerID &worker_id, double num_cpus, int64_t memory_bytes);
+
+  /// Reset the limits of a worker that returned to the idle pool.
+  void ResetWorkerLimits(const WorkerID &worker_id);
+
+  /// Remove the cgroup of a disconnected worker. If its process did not exit yet, the
+  /// removal is retried on the next update.
+  void RemoveWorker(const WorkerID &worker_id);
+
+  /// Read the memory usage of the workers.
+  ///
+  /// \return The workers whose memory usage reached the kill fraction of their limit.
+  std::vector<WorkerID> UpdateMemoryUsage();
+
+  /// Return the memory usage of a worker read by the last update.
+  int64_t GetMemoryUsage(const WorkerID &worker_id) const;
+
+  std::string DebugString() const;
+
+ private:
+  struct WorkerCgroup {
+    /// The directory of the cgroup.
+    std::string path;
+    /// The memory limit of the worker, 0 if unlimited.
+    int64_t memory_limit_bytes = 0;
+    /// The memory usage read by the last update.
+    int64_t memory_usage_bytes = 0;
+  };
+
+  /// Write a value to a file of a cgroup.
+  bool WriteCgroupFile(const std::string &path, const std::string &value) const;
+
+  /// Read the memory usage of a cgroup.
+  ///
+  /// \param path The directory of the cgroup.
+  /// \param usage[out] The memory usage in bytes.
+  /// \return Whether the usage could be read.
+  bool ReadMemoryUsage(const std::string &path, int64_t *usage) const;
+
+  /// Remove the directory of a cgroup.
+  bool RemoveCgroup(const std::string &path) const;
+
+  const std::string root_path_;
+  const double memory_kill_fraction_;
+  /// The cgroup of the raylet, empty until initialized.
+  std::string path_;
+  std::unordered_map<WorkerID, WorkerCgroup> workers_;
+  /// The cgroups of disconnected workers that still held a process.
+  std::vector<std::string> cgroups_to_remove_;
+};
+
+}  // namespace raylet
+
+}  // end namespace ray
@@ -0,0 +1,145 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/cgroup_manager.h"
+
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "ray/util/filesystem.h"
+
+namespace ray {
+
+namespace raylet {
+
+std::string ReadFile(const std::string &path) {
+  std::ifstream file(path);
+  std::string value;
+  std::getline(file, value);
+  return value;
+}
+
+void WriteFile(const std::string &path, const std::string &value) {
+  std::ofstream file(path);
+  file << value;
+}
+
+/// The cgroup manager is tested on a regular directory that mimics the files of a
+/// cgroup v2 hierarchy.
+class CgroupManagerTest : public ::testing::Test {
+ public:
+  CgroupManagerTest()
+      : root_path_(JoinPaths(GetUserTempDir(),
+                             "cgroup_manager_test_" + std::to_string(getpid()))) {
+    boost::filesystem::create_directories(root_path_);
+    raylet_path_ = JoinPaths(root_path_, "raylet_" + std::to_string(getpid()));
+  }
+
+  ~CgroupManagerTest() { boost::filesystem::remove_all(root_path_); }
+
+  std::string WorkerFile(const WorkerID &worker_id, const std::string &name) {
+    return JoinPaths(raylet_path_, "worker_" + worker_id.Hex(), name);
+  }
+
+ protected:
+  std::string root_path_;
+  std::string raylet_path_;
+};
+
+TEST_F(CgroupManagerTest, TestMissingControllers) {
+  CgroupManager cgroup_manager(root_path_, 0.9);
+  ASSERT_FALSE(cgroup_manager.Initialize());
+  WriteFile(JoinPaths(root_path_, "cgroup.controllers"), "cpuset cpu io pids");
+  ASSERT_FALSE(cgroup_manager.Initialize());
+}
+
+TEST_F(CgroupManagerTest, TestWorkerLimits) {
+  WriteFile(JoinPaths(root_path_, "cgroup.controllers"), "cpuset cpu io memory pids");
+  CgroupManager cgroup_manager(root_path_, 0.9);
+  ASSERT_TRUE(cgroup_manager.Initialize());
+  ASSERT_EQ(ReadFile(JoinPaths(root_path_, "cgroup.subtree_control")), "+cpu +memory");
+  ASSERT_EQ(ReadFile(JoinPaths(raylet_path_, "cgroup.subtree_control")),
+            "+cpu +memory");
+
+  WorkerID worker_id = WorkerID::FromRandom();
+  ASSERT_TRUE(cgroup_manager.AddWorker(worker_id, 1234));
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "cgroup.procs")), "1234");
+
+  // The CPU weight is proportional to the CPU resource of the lease.
+  cgroup_manager.SetWorkerLimits(worker_id, 1.5, 1000);
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "cpu.weight")), "150");
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "memory.max")), "1000");
+  cgroup_manager.SetWorkerLimits(worker_id, 0.001, 0);
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "cpu.weight")), "1");
+  // A lease without CPUs keeps the default weight.
+  cgroup_manager.SetWorkerLimits(worker_id, 0, 0);
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "cpu.weight")), "100");
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "memory.max")), "max");
+  cgroup_manager.SetWorkerLimits(worker_id, 1000, 0);
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "cpu.weight")), "10000");
+
+  cgroup_manager.SetWorkerLimits(worker_id, 1, 1000);
+  cgroup_manager.ResetWorkerLimits(worker_id);
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "cpu.weight")), "100");
+  ASSERT_EQ(ReadFile(WorkerFile(worker_id, "memory.max")), "max");
+
+  // The limits of an unknown worker are ignored.
+  cgroup_manager.SetWorkerLimits(WorkerID::FromRandom(), 1, 1000);
+}
+
+TEST_F(CgroupManagerTest, TestMemoryUsage) {
+  WriteFile(JoinPaths(root_path_, "cgroup.controllers"), "cpu memory");
+  CgroupManager cgroup_manager(root_path_, 0.9);
+  ASSERT_TRUE(cgroup_manager.Initialize());
+  WorkerID limited_worker_id = WorkerID::FromRandom();
+  WorkerID unlimited_worker_id = WorkerID::FromRandom();
+  ASSERT_TRUE(cgroup_manager.AddWorker(limited_worker_id, 1));
+  ASSERT_TRUE(cgroup_manager.AddWorker(unlimited_worker_id, 2));
+  cgroup_manager.SetWorkerLimits(limited_worker_id, 1, 1000);
+
+  WriteFile(WorkerFile(limited_worker_id, "memory.current"), "800");
+  WriteFile(WorkerFile(unlimited_worker_id, "memory.current"), "5000");
+  ASSERT_TRUE(cgroup_manager.UpdateMemoryUsage().empty());
+  ASSERT_EQ(cgroup_manager.GetMemoryUsage(limited_worker_id), 800);
+  ASSERT_EQ(cgroup_manager.GetMemoryUsage(unlimited_worker_id), 5000);
+
+  // The worker is reported before it reaches its limit.
+  WriteFile(WorkerFile(limited_worker_id, "memory.current"), "900");
+  auto workers_to_kill = cgroup_manager.UpdateMemoryUsage();
+  ASSERT_EQ(workers_to_kill, std::vector<WorkerID>({limited_worker_id}));
+
+  // The memory of a worker that already uses more than its lease is not limited, and
+  // the worker is reported by the next update.
+  cgroup_manager.ResetWorkerLimits(limited_worker_id);
+  WriteFile(WorkerFile(limited_worker_id, "memory.current"), "2000");
+  cgroup_manager.SetWorkerLimits(limited_worker_id, 1, 1000);
+  ASSERT_EQ(ReadFile(WorkerFile(limited_worker_id, "memory.max")), "max");
+  workers_to_kill = cgroup_manager.UpdateMemoryUsage();
+  ASSERT_EQ(workers_to_kill, std::vector<WorkerID>({limited_worker_id}));
+
+  // The worker is no longer reported once it is idle or removed.
+  cgroup_manager.ResetWorkerLimits(limited_worker_id);
+  ASSERT_TRUE(cgroup_manager.UpdateMemoryUsage().empty());
+  cgroup_manager.SetWorkerLimits(limited_worker_id, 1, 1000);
+  cgroup_manager.RemoveWorker(limited_worker_id);
+  ASSERT_TRUE(cgroup_manager.UpdateMemoryUsage().empty());
+  ASSERT_EQ(cgroup_manager.GetMemoryUsage(limited_worker_id), 0);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
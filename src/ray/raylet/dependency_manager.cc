@@ -160,24 +160,40 @@ void DependencyManager::CancelGetRequest(const WorkerID &worker_id) {
 bool DependencyManager::RequestTaskDependencies(
     const TaskID &task_id, const std::vector<rpc::ObjectReference> &required_objects) {
   RAY_LOG(DEBUG) << "Adding dependencies for task " << task_id;
-  auto inserted = queued_task_requests_.emplace(task_id, required_objects);
+  uint32_t slot;
+  if (!free_task_slots_.empty()) {
+    slot = free_task_slots_.back();
+    free_task_slots_.pop_back();
+  } else {
+    slot = task_slots_.size();
+    task_slots_.emplace_back();
+  }
+  auto inserted = queued_task_requests_.emplace(task_id, slot);
   RAY_CHECK(inserted.second) << "Task depedencies can be requested only once per task.";
-  auto &task_entry = inserted.first->second;
+  auto &task_entry = task_slots_[slot];
+  task_entry.task_id = task_id;
+  task_entry.dependencies.reserve(required_objects.size());
 
+  std::vector<rpc::ObjectReference> distinct_objects;
   for (const auto &ref : required_objects) {
     const auto obj_id = ObjectRefToId(ref);
-    RAY_LOG(DEBUG) << "Task " << task_id << " blocked on object " << obj_id;
-
     auto it = GetOrInsertRequiredObject(obj_id, ref);
-    it->second.dependent_tasks.insert(task_id);
-
-    if (local_objects_.count(obj_id)) {
-      task_entry.num_missing_dependencies--;
+    auto &dependent_tasks = it->second.dependent_tasks;
+    if (!dependent_tasks.empty() && dependent_tasks.back().first == slot) {
+      // The object is passed several times to the task.
+      continue;
     }
+    RAY_LOG(DEBUG) << "Task " << task_id << " blocked on object " << obj_id;
+    dependent_tasks.emplace_back(slot, task_entry.dependencies.size());
+    task_entry.dependencies.emplace_back(obj_id, dependent_tasks.size() - 1);
+    if (!local_objects_.count(obj_id)) {
+      task_entry.num_missing_dependencies++;
+    }
+    distinct_objects.push_back(ref);
   }
 
-  if (!required_objects.empty()) {
-    task_entry.pull_request_id = object_manager_.Pull(required_objects);
+  if (!distinct_objects.empty()) {
+    task_entry.pull_request_id = object_manager_.Pull(distinct_objects);
     RAY_LOG(DEBUG) << "Started pull for dependencies of task " << task_id
                    << " request: " << task_entry.pull_request_id;
   }
@@ -188,29 +204,46 @@ bool DependencyManager::RequestTaskDependencies(
 bool DependencyManager::IsTaskReady(const TaskID &task_id) const {
   auto task_entry = queued_task_requests_.find(task_id);
   RAY_CHECK(task_entry != queued_task_requests_.end());
-  return task_entry->second.num_missing_dependencies == 0;
+  return task_slots_[task_entry->second].num_missing_dependencies == 0;
+}
+
+void DependencyManager::RemoveDependentTask(ObjectDependencies &object, uint32_t index) {
+  auto &dependent_tasks = object.dependent_tasks;
+  RAY_CHECK(index < dependent_tasks.size());
+  if (index + 1 < dependent_tasks.size()) {
+    dependent_tasks[index] = dependent_tasks.back();
+    // Update the index of the moved task in the dependencies of that task.
+    const auto &moved = dependent_tasks[index];
+    task_slots_[moved.first].dependencies[moved.second].second = index;
+  }
+  dependent_tasks.pop_back();
 }
 
 void DependencyManager::RemoveTaskDependencies(const TaskID &task_id) {
   RAY_LOG(DEBUG) << "Removing dependencies for task " << task_id;
-  auto task_entry = queued_task_requests_.find(task_id);
-  RAY_CHECK(task_entry != queued_task_requests_.end())
+  auto task_it = queued_task_requests_.find(task_id);
+  RAY_CHECK(task_it != queued_task_requests_.end())
       << "Can't remove dependencies of tasks that are not queued.";
+  const uint32_t slot = task_it->second;
+  auto &task_entry = task_slots_[slot];
 
-  if (task_entry->second.pull_request_id > 0) {
+  if (task_entry.pull_request_id > 0) {
     RAY_LOG(DEBUG) << "Canceling pull for dependencies of task " << task_id
-                   << " request: " << task_entry->second.pull_request_id;
-    object_manager_.CancelPull(task_entry->second.pull_request_id);
+                   << " request: " << task_entry.pull_request_id;
+    object_manager_.CancelPull(task_entry.pull_request_id);
   }
 
-  for (const auto &obj_id : task_entry->second.dependencies) {
-    auto it = required_objects_.find(obj_id);
+  for (const auto &dependency : task_entry.dependencies) {
+    auto it = required_objects_.find(dependency.first);
     RAY_CHECK(it != required_objects_.end());
-    it->second.dependent_tasks.erase(task_id);
+    RemoveDependentTask(it->second, dependency.second);
     RemoveObjectIfNotNeeded(it);
   }
 
-  queued_task_requests_.erase(task_entry);
+  // Release the memory of the dependencies, which can be large.
+  task_entry = TaskDependencies();
+  free_task_slots_.push_back(slot);
+  queued_task_requests_.erase(task_it);
 }
 
 std::vector<TaskID> DependencyManager::HandleObjectMissing(
@@ -222,15 +255,13 @@ std::vector<TaskID> DependencyManager::HandleObjectMissing(
   std::vector<TaskID> waiting_task_ids;
   auto object_entry = required_objects_.find(object_id);
   if (object_entry != required_objects_.end()) {
-    for (auto &dependent_task_id : object_entry->second.dependent_tasks) {
-      auto it = queued_task_requests_.find(dependent_task_id);
-      RAY_CHECK(it != queued_task_requests_.end());
-      auto &task_entry = it->second;
+    for (const auto &dependent_task : object_entry->second.dependent_tasks) {
+      auto &task_entry = task_slots_[dependent_task.first];
       // If the dependent task had all of its arguments ready, it was ready to
       // run but must be switched to waiting since one of its arguments is now
       // missing.
       if (task_entry.num_missing_dependencies == 0) {
-        waiting_task_ids.push_back(dependent_task_id);
+        waiting_task_ids.push_back(task_entry.task_id);
         // During normal execution we should be able to include the check
         // RAY_CHECK(pending_tasks_.count(dependent_task_id) == 1);
         // However, this invariant will not hold during unit test execution.
@@ -249,24 +280,30 @@ std::vector<TaskID> DependencyManager::HandleObjectMissing(
 }
 
 std::vector<TaskID> DependencyManager::HandleObjectLocal(const ray::ObjectID &object_id) {
-  // Add the object to the table of locally available objects.
-  auto inserted = local_objects_.insert(object_id);
-  RAY_CHECK(inserted.second) << "Local object was already local " << object_id;
+  return HandleObjectsLocal({object_id});
+}
 
-  // Find all tasks and workers that depend on the newly available object.
+std::vector<TaskID> DependencyManager::HandleObjectsLocal(
+    const std::vector<ray::ObjectID> &object_ids) {
+  // Find all tasks and workers that depend on the newly available objects.
   std::vector<TaskID> ready_task_ids;
-  auto object_entry = required_objects_.find(object_id);
-  if (object_entry != required_objects_.end()) {
+  for (const auto &object_id : object_ids) {
+    // Add the object to the table of locally available objects.
+    auto inserted = local_objects_.insert(object_id);
+    RAY_CHECK(inserted.second) << "Local object was already local " << object_id;
+
+    auto object_entry = required_objects_.find(object_id);
+    if (object_entry == required_objects_.end()) {
+      continue;
+    }
     // Loop through all tasks that depend on the newly available object.
-    for (const auto &dependent_task_id : object_entry->second.dependent_tasks) {
-      auto it = queued_task_requests_.find(dependent_task_id);
-      RAY_CHECK(it != queued_task_requests_.end());
-      auto &task_entry = it->second;
+    for (const auto &dependent_task : object_entry->second.dependent_tasks) {
+      auto &task_entry = task_slots_[dependent_task.first];
       task_entry.num_missing_dependencies--;
       // If the dependent task now has all of its arguments ready, it's ready
       // to run.
       if (task_entry.num_missing_dependencies == 0) {
-        ready_task_ids.push_back(dependent_task_id);
+        ready_task_ids.push_back(task_entry.task_id);
       }
     }
 
@@ -157,6 +157,13 @@ class DependencyManager : public TaskDependencyManagerInterface {
   /// all of their dependencies fulfilled.
   std::vector<TaskID> HandleObjectLocal(const ray::ObjectID &object_id);
 
+  /// Handle a batch of objects becoming locally available.
+  ///
+  /// \param object_ids The IDs of the objects to mark as locally available.
+  /// \return A list of task IDs. This contains all added tasks that now have
+  /// all of their dependencies fulfilled, each once.
+  std::vector<TaskID> HandleObjectsLocal(const std::vector<ray::ObjectID> &object_ids);
+
   /// Handle an object that is no longer locally available.
   ///
   /// \param object_id The object ID of the object that was previously locally
@@ -177,9 +184,10 @@ class DependencyManager : public TaskDependencyManagerInterface {
   struct ObjectDependencies {
     ObjectDependencies(const rpc::ObjectReference &ref)
         : owner_address(ref.owner_address()) {}
-    /// The tasks that depend on this object, either because the object is a task argument
-    /// or because the task called `ray.get` on the object.
-    std::unordered_set<TaskID> dependent_tasks;
+    /// The queued tasks that depend on this object because the object is a task
+    /// argument. Each entry is the slot of the task in task_slots_ and the index of
+    /// this object in the dependencies of the task.
+    std::vector<std::pair<uint32_t, uint32_t>> dependent_tasks;
     /// The workers that depend on this object because they called `ray.get` on the
     /// object.
     std::unordered_set<WorkerID> dependent_get_requests;
@@ -200,24 +208,28 @@ class DependencyManager : public TaskDependencyManagerInterface {
 
   /// A struct to represent the object dependencies of a task.
   struct TaskDependencies {
-    TaskDependencies(const std::vector<rpc::ObjectReference> &deps)
-        : num_missing_dependencies(deps.size()) {
-      const auto dep_ids = ObjectRefsToIds(deps);
-      dependencies.insert(dep_ids.begin(), dep_ids.end());
-    }
-    /// The objects that the task depends on. These are the arguments to the
-    /// task. These must all be simultaneously local before the task is ready
-    /// to execute. Objects are removed from this set once
-    /// UnsubscribeGetDependencies is called.
-    absl::flat_hash_set<ObjectID> dependencies;
+    /// The ID of the task.
+    TaskID task_id;
+    /// The distinct objects that the task depends on. These are the arguments
+    /// to the task. These must all be simultaneously local before the task is
+    /// ready to execute. Each entry is the object ID and the index of this task
+    /// in the dependent_tasks of the object.
+    std::vector<std::pair<ObjectID, uint32_t>> dependencies;
     /// The number of object arguments that are not available locally. This
     /// must be zero before the task is ready to execute.
-    size_t num_missing_dependencies;
+    size_t num_missing_dependencies = 0;
     /// Used to identify the pull request for the dependencies to the object
     /// manager.
     uint64_t pull_request_id = 0;
   };
 
+  /// Remove a task from the dependent tasks of an object, in constant time. The
+  /// last dependent task takes its place.
+  ///
+  /// \param object The object that the task depends on.
+  /// \param index The index of the task in the dependent tasks of the object.
+  void RemoveDependentTask(ObjectDependencies &object, uint32_t index);
+
   /// Stop tracking this object, if it is no longer needed by any worker or
   /// queued task.
   void RemoveObjectIfNotNeeded(
@@ -237,9 +249,18 @@ class DependencyManager : public TaskDependencyManagerInterface {
   /// into this class.
   ReconstructionPolicyInterface &reconstruction_policy_;
 
-  /// A map from the ID of a queued task to metadata about whether the task's
-  /// dependencies are all local or not.
-  absl::flat_hash_map<TaskID, TaskDependencies> queued_task_requests_;
+  /// A map from the ID of a queued task to the slot of its dependencies in
+  /// task_slots_.
+  absl::flat_hash_map<TaskID, uint32_t> queued_task_requests_;
+
+  /// Pool of metadata about whether the dependencies of the queued tasks are all
+  /// local or not. The objects refer to their dependent tasks by slot, so that the
+  /// index of a task with many arguments stays compact. The slots of removed
+  /// tasks are reused.
+  std::vector<TaskDependencies> task_slots_;
+
+  /// The slots of task_slots_ that are not used by a queued task.
+  std::vector<uint32_t> free_task_slots_;
 
   /// A map from worker ID to the set of objects that the worker called
   /// `ray.get` on and a pull request ID for these objects. The pull request ID
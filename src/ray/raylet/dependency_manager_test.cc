@@ -227,6 +227,79 @@ TEST_F(DependencyManagerTest, TestTaskArgEviction) {
   AssertNoLeaks();
 }
 
+/// Test a task that passes the same object several times. The task should be
+/// ready once the object is local, and waiting again once it is evicted.
+TEST_F(DependencyManagerTest, TestDuplicateArguments) {
+  ObjectID argument_id = ObjectID::FromRandom();
+  ObjectID other_argument_id = ObjectID::FromRandom();
+  std::vector<ObjectID> arguments = {argument_id, other_argument_id, argument_id};
+  TaskID task_id = RandomTaskId();
+  EXPECT_CALL(reconstruction_policy_mock_, ListenAndMaybeReconstruct(argument_id, _))
+      .Times(2);
+  EXPECT_CALL(reconstruction_policy_mock_,
+              ListenAndMaybeReconstruct(other_argument_id, _));
+  bool ready =
+      dependency_manager_.RequestTaskDependencies(task_id, ObjectIdsToRefs(arguments));
+  ASSERT_FALSE(ready);
+
+  EXPECT_CALL(reconstruction_policy_mock_, Cancel(argument_id)).Times(2);
+  EXPECT_CALL(reconstruction_policy_mock_, Cancel(other_argument_id));
+  auto ready_task_ids = dependency_manager_.HandleObjectLocal(other_argument_id);
+  ASSERT_TRUE(ready_task_ids.empty());
+  ready_task_ids = dependency_manager_.HandleObjectLocal(argument_id);
+  ASSERT_EQ(ready_task_ids, std::vector<TaskID>({task_id}));
+
+  // The task waits for the object again once it is evicted.
+  auto waiting_task_ids = dependency_manager_.HandleObjectMissing(argument_id);
+  ASSERT_EQ(waiting_task_ids, std::vector<TaskID>({task_id}));
+  ASSERT_FALSE(dependency_manager_.IsTaskReady(task_id));
+  ready_task_ids = dependency_manager_.HandleObjectLocal(argument_id);
+  ASSERT_EQ(ready_task_ids, std::vector<TaskID>({task_id}));
+
+  dependency_manager_.RemoveTaskDependencies(task_id);
+  AssertNoLeaks();
+}
+
+/// Test many tasks that share arguments, with objects becoming local in bulk.
+/// Each task should be returned once, when all of its arguments are local.
+TEST_F(DependencyManagerTest, TestObjectsLocalInBulk) {
+  int num_objects = 10;
+  std::vector<ObjectID> oids;
+  for (int i = 0; i < num_objects; i++) {
+    oids.push_back(ObjectID::FromRandom());
+  }
+  EXPECT_CALL(reconstruction_policy_mock_, ListenAndMaybeReconstruct(_, _))
+      .Times(num_objects);
+  // Task i depends on the objects [i, num_objects).
+  std::vector<TaskID> task_ids;
+  for (int i = 0; i < num_objects; i++) {
+    task_ids.push_back(RandomTaskId());
+    std::vector<ObjectID> arguments(oids.begin() + i, oids.end());
+    ASSERT_FALSE(dependency_manager_.RequestTaskDependencies(
+        task_ids.back(), ObjectIdsToRefs(arguments)));
+  }
+  // Removing a task in the middle reorders the dependent tasks of its objects.
+  dependency_manager_.RemoveTaskDependencies(task_ids[num_objects / 2]);
+
+  EXPECT_CALL(reconstruction_policy_mock_, Cancel(_)).Times(num_objects);
+  // The tasks that depend only on the last objects are ready.
+  std::vector<ObjectID> last_half(oids.begin() + num_objects / 2, oids.end());
+  auto ready_task_ids = dependency_manager_.HandleObjectsLocal(last_half);
+  ASSERT_EQ(ready_task_ids.size(), num_objects / 2 - 1);
+  ASSERT_FALSE(dependency_manager_.IsTaskReady(task_ids[0]));
+  std::vector<ObjectID> first_half(oids.begin(), oids.begin() + num_objects / 2);
+  ready_task_ids = dependency_manager_.HandleObjectsLocal(first_half);
+  ASSERT_EQ(ready_task_ids.size(), num_objects / 2);
+  for (int i = 0; i < num_objects; i++) {
+    if (i == num_objects / 2) {
+      continue;
+    }
+    ASSERT_TRUE(dependency_manager_.IsTaskReady(task_ids[i]));
+    dependency_manager_.RemoveTaskDependencies(task_ids[i]);
+  }
+  AssertNoLeaks();
+}
+
 /// Test `ray.get`. Worker calls ray.get on {oid1}, then {oid1, oid2}, then
 /// {oid1, oid2, oid3}.
 TEST_F(DependencyManagerTest, TestGet) {
@@ -0,0 +1,401 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/gang_lease_manager.h"
+
+#include "ray/common/ray_config.h"
+
+namespace ray {
+
+namespace raylet {
+
+GangLeaseManager::GangLeaseManager(
+    boost::asio::io_service &io_service, const NodeID &self_node_id,
+    std::shared_ptr<ClusterResourceScheduler> cluster_resource_scheduler,
+    std::shared_ptr<PlacementGroupResourceManager> local_bundles,
+    std::function<std::shared_ptr<ResourceReserveInterface>(const NodeID &)>
+        get_reserve_client,
+    std::function<void(const BundleSpecification &)> return_local_bundle)
+    : io_service_(io_service),
+      self_node_id_(self_node_id),
+      cluster_resource_scheduler_(cluster_resource_scheduler),
+      local_bundles_(local_bundles),
+      get_reserve_client_(get_reserve_client),
+      return_local_bundle_(return_local_bundle) {}
+
+void GangLeaseManager::RequestGangLease(
+    const std::vector<std::unordered_map<std::string, double>> &shapes,
+    int64_t timeout_ms, const WorkerID &owner_worker_id, const JobID &job_id,
+    const GangLeaseCallback &callback) {
+  auto gang = std::make_shared<Gang>(PlacementGroupID::FromRandom(), owner_worker_id,
+                                     job_id, io_service_, callback);
+  RAY_LOG(DEBUG) << "Reserving gang " << gang->gang_id << " of " << shapes.size()
+                 << " leases.";
+
+  // Place and reserve every member in the local view first, so that the members
+  // that come after it see its resources as taken. A member placed on the local node
+  // is prepared right away. The reservations on remote nodes are only in the local
+  // view of the cluster until their prepare requests succeed, and are corrected by
+  // the next resource report of these nodes if they fail.
+  bool placed = true;
+  for (size_t i = 0; i < shapes.size(); i++) {
+    int64_t violations;
+    bool is_infeasible;
+    const std::string node_id = cluster_resource_scheduler_->GetBestSchedulableNode(
+        shapes[i], /*actor_creation=*/false, &violations, &is_infeasible);
+    if (node_id.empty()) {
+      placed = false;
+      break;
+    }
+    rpc::Bundle message;
+    message.mutable_bundle_id()->set_placement_group_id(gang->gang_id.Binary());
+    message.mutable_bundle_id()->set_bundle_index(i);
+    message.mutable_unit_resources()->insert(shapes[i].begin(), shapes[i].end());
+    message.set_node_id(node_id);
+    message.set_gang_node_id(self_node_id_.Binary());
+    BundleSpecification bundle(message);
+
+    if (node_id == self_node_id_.Binary()) {
+      if (!local_bundles_->PrepareBundle(bundle)) {
+        placed = false;
+        break;
+      }
+      gang->member_states.push_back(MemberState::PREPARED);
+    } else {
+      if (!cluster_resource_scheduler_->AllocateRemoteTaskResources(node_id,
+                                                                    shapes[i])) {
+        placed = false;
+        break;
+      }
+      gang->member_states.push_back(MemberState::PENDING);
+      gang->num_pending_replies++;
+    }
+    gang->bundles.push_back(std::move(bundle));
+    gang->nodes.push_back(NodeID::FromBinary(node_id));
+  }
+
+  if (!placed) {
+    RAY_LOG(DEBUG) << "Failed to place every member of gang " << gang->gang_id;
+    // None of the remote members was sent yet, so only the local members are
+    // cancelled.
+    std::vector<size_t> local_members;
+    for (size_t i = 0; i < gang->bundles.size(); i++) {
+      if (gang->nodes[i] == self_node_id_) {
+        local_members.push_back(i);
+      }
+    }
+    CancelMembers(*gang, local_members);
+    gang->state = GangState::ABORTED;
+    gang->callback(false, gang->gang_id, {});
+    return;
+  }
+
+  gangs_.emplace(gang->gang_id, gang);
+  if (gang->num_pending_replies == 0) {
+    CommitGang(gang);
+    return;
+  }
+
+  if (timeout_ms <= 0) {
+    timeout_ms = RayConfig::instance().gang_lease_timeout_milliseconds();
+  }
+  gang->timer.expires_from_now(boost::posix_time::milliseconds(timeout_ms));
+  gang->timer.async_wait([this, gang](const boost::system::error_code &error) {
+    if (error == boost::asio::error::operation_aborted) {
+      return;
+    }
+    if (gang->state == GangState::PREPARING || gang->state == GangState::COMMITTING) {
+      RAY_LOG(INFO) << "Gang " << gang->gang_id << " was not reserved in time.";
+      AbortGang(gang);
+    }
+  });
+
+  // The members placed on the same remote node are prepared by a single request.
+  std::vector<size_t> pending_members;
+  for (size_t i = 0; i < gang->bundles.size(); i++) {
+    if (gang->member_states[i] == MemberState::PENDING) {
+      pending_members.push_back(i);
+    }
+  }
+  for (const auto &entry : GroupMembersByNode(*gang, pending_members)) {
+    auto client = get_reserve_client_(entry.first);
+    if (!client) {
+      AbortGang(gang);
+      return;
+    }
+    const auto &members = entry.second;
+    client->PrepareBundleResources(
+        GetMemberBundles(*gang, members),
+        [this, gang, members](const Status &status,
+                              const rpc::PrepareBundleResourcesReply &reply) {
+          OnMembersPrepared(gang, members, status.ok() && reply.success());
+        });
+  }
+}
+
+void GangLeaseManager::OnMembersPrepared(const std::shared_ptr<Gang> &gang,
+                                         const std::vector<size_t> &members,
+                                         bool success) {
+  if (gang->state != GangState::PREPARING) {
+    // The gang failed while these members were being prepared. They were not
+    // cancelled then, so cancel them now.
+    if (success) {
+      for (size_t index : members) {
+        gang->member_states[index] = MemberState::PREPARED;
+      }
+      CancelMembers(*gang, members);
+    }
+    return;
+  }
+  if (!success) {
+    RAY_LOG(DEBUG) << "Failed to prepare " << members.size() << " members of gang "
+                   << gang->gang_id << " on node " << gang->nodes[members.front()];
+    AbortGang(gang);
+    return;
+  }
+  for (size_t index : members) {
+    gang->member_states[index] = MemberState::PREPARED;
+  }
+  gang->num_pending_replies -= members.size();
+  if (gang->num_pending_replies == 0) {
+    CommitGang(gang);
+  }
+}
+
+void GangLeaseManager::CommitGang(const std::shared_ptr<Gang> &gang) {
+  gang->state = GangState::COMMITTING;
+  std::vector<size_t> all_members;
+  for (size_t i = 0; i < gang->bundles.size(); i++) {
+    all_members.push_back(i);
+  }
+  for (const auto &entry : GroupMembersByNode(*gang, all_members)) {
+    if (entry.first == self_node_id_) {
+      local_bundles_->CommitBundles(GetMemberBundles(*gang, entry.second));
+      continue;
+    }
+    auto client = get_reserve_client_(entry.first);
+    if (!client) {
+      AbortGang(gang);
+      return;
+    }
+    gang->num_pending_replies++;
+    client->CommitBundleResources(
+        GetMemberBundles(*gang, entry.second),
+        [this, gang](const Status &status, const rpc::CommitBundleResourcesReply &reply) {
+          OnMembersCommitted(gang, status.ok());
+        });
+  }
+  if (gang->num_pending_replies == 0) {
+    OnMembersCommitted(gang, true);
+  }
+}
+
+void GangLeaseManager::OnMembersCommitted(const std::shared_ptr<Gang> &gang,
+                                          bool success) {
+  if (gang->state != GangState::COMMITTING) {
+    return;
+  }
+  if (!success) {
+    AbortGang(gang);
+    return;
+  }
+  if (gang->num_pending_replies > 0 && --gang->num_pending_replies > 0) {
+    return;
+  }
+  gang->state = GangState::COMMITTED;
+  gang->timer.cancel();
+  RAY_LOG(DEBUG) << "Reserved gang " << gang->gang_id;
+  gang->callback(true, gang->gang_id, gang->bundles);
+}
+
+void GangLeaseManager::AbortGang(const std::shared_ptr<Gang> &gang) {
+  RAY_CHECK(gang->state == GangState::PREPARING ||
+            gang->state == GangState::COMMITTING);
+  gang->state = GangState::ABORTED;
+  gang->timer.cancel();
+  // The members whose prepare reply is pending are cancelled once it arrives.
+  std::vector<size_t> prepared_members;
+  for (size_t i = 0; i < gang->bundles.size(); i++) {
+    if (gang->member_states[i] == MemberState::PREPARED) {
+      prepared_members.push_back(i);
+    }
+  }
+  CancelMembers(*gang, prepared_members);
+  gangs_.erase(gang->gang_id);
+  gang->callback(false, gang->gang_id, {});
+}
+
+bool GangLeaseManager::ReturnGangLease(const PlacementGroupID &gang_id) {
+  auto it = gangs_.find(gang_id);
+  if (it == gangs_.end()) {
+    return false;
+  }
+  auto gang = it->second;
+  if (gang->state != GangState::COMMITTED) {
+    AbortGang(gang);
+    return true;
+  }
+  RAY_LOG(DEBUG) << "Returning gang " << gang_id;
+  gang->state = GangState::ABORTED;
+  std::vector<size_t> all_members;
+  for (size_t i = 0; i < gang->bundles.size(); i++) {
+    all_members.push_back(i);
+  }
+  CancelMembers(*gang, all_members);
+  gangs_.erase(it);
+  return true;
+}
+
+void GangLeaseManager::OnWorkerDisconnected(const WorkerID &worker_id) {
+  ReturnGangLeases(
+      [&worker_id](const Gang &gang) { return gang.owner_worker_id == worker_id; });
+}
+
+void GangLeaseManager::OnJobFinished(const JobID &job_id) {
+  ReturnGangLeases([&job_id](const Gang &gang) { return gang.job_id == job_id; });
+}
+
+void GangLeaseManager::ReturnGangLeases(
+    const std::function<bool(const Gang &)> &predicate) {
+  std::vector<PlacementGroupID> gang_ids;
+  for (const auto &entry : gangs_) {
+    if (predicate(*entry.second)) {
+      gang_ids.push_back(entry.first);
+    }
+  }
+  for (const auto &gang_id : gang_ids) {
+    RAY_LOG(DEBUG) << "Releasing gang " << gang_id << " whose owner is gone.";
+    ReturnGangLease(gang_id);
+  }
+}
+
+void GangLeaseManager::OnNodeRemoved(const NodeID &node_id) {
+  std::vector<std::shared_ptr<Gang>> failed_gangs;
+  for (const auto &entry : gangs_) {
+    const auto &gang = entry.second;
+    if (gang->state == GangState::COMMITTED) {
+      // The owner of the gang releases it once its tasks on the node fail.
+      continue;
+    }
+    for (const auto &member_node_id : gang->nodes) {
+      if (member_node_id == node_id) {
+        failed_gangs.push_back(gang);
+        break;
+      }
+    }
+  }
+  for (const auto &gang : failed_gangs) {
+    RAY_LOG(INFO) << "Failing gang " << gang->gang_id << " because node " << node_id
+                  << " was removed.";
+    AbortGang(gang);
+  }
+
+  // Nobody will return the members that the removed node reserved here.
+  std::vector<BundleSpecification> orphaned_members;
+  for (auto it = remote_members_.begin(); it != remote_members_.end();) {
+    if (it->second.gang_node_id == node_id) {
+      orphaned_members.push_back(it->second.bundle);
+      remote_members_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+  for (const auto &bundle : orphaned_members) {
+    RAY_LOG(INFO) << "Releasing member " << bundle.Index() << " of gang "
+                  << bundle.PlacementGroupId() << " because node " << node_id
+                  << " was removed.";
+    return_local_bundle_(bundle);
+  }
+}
+
+void GangLeaseManager::AddRemoteMembers(
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundles) {
+  for (const auto &bundle : bundles) {
+    const auto &gang_node_id = bundle->GetMessage().gang_node_id();
+    if (gang_node_id.empty()) {
+      continue;
+    }
+    remote_members_.emplace(bundle->BundleId(),
+                            RemoteMember{NodeID::FromBinary(gang_node_id), *bundle});
+  }
+}
+
+void GangLeaseManager::RemoveRemoteMembers(
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundles) {
+  for (const auto &bundle : bundles) {
+    remote_members_.erase(bundle->BundleId());
+  }
+}
+
+void GangLeaseManager::GetBundlesInUse(
+    std::unordered_set<BundleID, pair_hash> *bundles_in_use) const {
+  for (const auto &entry : gangs_) {
+    const auto &gang = entry.second;
+    for (size_t i = 0; i < gang->bundles.size(); i++) {
+      if (gang->nodes[i] == self_node_id_) {
+        bundles_in_use->insert(gang->bundles[i].BundleId());
+      }
+    }
+  }
+  for (const auto &entry : remote_members_) {
+    bundles_in_use->insert(entry.first);
+  }
+}
+
+void GangLeaseManager::CancelMembers(const Gang &gang,
+                                     const std::vector<size_t> &members) {
+  for (const auto &entry : GroupMembersByNode(gang, members)) {
+    if (entry.first == self_node_id_) {
+      for (size_t index : entry.second) {
+        return_local_bundle_(gang.bundles[index]);
+      }
+      continue;
+    }
+    auto client = get_reserve_client_(entry.first);
+    if (!client) {
+      // The node is gone, and its resources with it.
+      continue;
+    }
+    client->CancelResourceReserve(
+        GetMemberBundles(gang, entry.second),
+        [](const Status &status, const rpc::CancelResourceReserveReply &) {
+          if (!status.ok()) {
+            RAY_LOG(WARNING) << "Failed to cancel the members of a gang: " << status;
+          }
+        });
+  }
+}
+
+std::unordered_map<NodeID, std::vector<size_t>> GangLeaseManager::GroupMembersByNode(
+    const Gang &gang, const std::vector<size_t> &members) const {
+  std::unordered_map<NodeID, std::vector<size_t>> node_to_members;
+  for (size_t index : members) {
+    node_to_members[gang.nodes[index]].push_back(index);
+  }
+  return node_to_members;
+}
+
+std::vector<std::shared_ptr<const BundleSpecification>>
+GangLeaseManager::GetMemberBundles(const Gang &gang,
+                                   const std::vector<size_t> &members) const {
+  std::vector<std::shared_ptr<const BundleSpecification>> bundles;
+  for (size_t index : members) {
+    bundles.push_back(std::make_shared<const BundleSpecification>(gang.bundles[index]));
+  }
+  return bundles;
+}
+
+}  // namespace raylet
+
+}  // end namespace ray
@@ -0,0 +1,229 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ray/common/bundle_spec.h"
+#include "ray/common/id.h"
+#include "ray/raylet/placement_group_resource_manager.h"
+#include "ray/raylet/scheduling/cluster_resource_scheduler.h"
+#include "ray/raylet_client/raylet_client.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// Callback invoked when a gang lease request finishes. If success is false, none of
+/// the resources of the gang are reserved.
+using GangLeaseCallback = std::function<void(
+    bool success, const PlacementGroupID &gang_id,
+    const std::vector<BundleSpecification> &bundles)>;
+
+/// Reserves the resources of a group of leases (a gang) all or nothing, on the local
+/// node and on the remote nodes the request spills to, without going through the GCS.
+///
+/// Each member of the gang is reserved as a bundle of a placement group whose ID is
+/// the ID of the gang, so that tasks are placed in the gang like in a placement
+/// group. The bundles are reserved with the same two-phase commit as the bundles of
+/// placement groups: every member is first prepared, on its node, and only once all
+/// of them are prepared are they committed. If a member cannot be prepared, or the
+/// gang is not prepared before its timeout, every prepared member is cancelled.
+/// A reserved gang is released when its owner returns it, when the owner
+/// disconnects from this raylet, or when the owner's job finishes.
+///
+/// This class is only used with the new scheduler.
+class GangLeaseManager {
+ public:
+  /// Create a gang lease manager.
+  ///
+  /// \param io_service The event loop on which the timeouts of the gangs run.
+  /// \param self_node_id ID of the local node.
+  /// \param cluster_resource_scheduler The view of the cluster used to place the
+  /// members of the gangs.
+  /// \param local_bundles Reserves the members of the gangs on the local node.
+  /// \param get_reserve_client Returns a client to reserve bundles on the given
+  /// remote node, or nullptr if the node is unknown.
+  /// \param return_local_bundle Releases a member of a gang on the local node,
+  /// including the workers that run in it.
+  GangLeaseManager(
+      boost::asio::io_service &io_service, const NodeID &self_node_id,
+      std::shared_ptr<ClusterResourceScheduler> cluster_resource_scheduler,
+      std::shared_ptr<PlacementGroupResourceManager> local_bundles,
+      std::function<std::shared_ptr<ResourceReserveInterface>(const NodeID &)>
+          get_reserve_client,
+      std::function<void(const BundleSpecification &)> return_local_bundle);
+
+  /// Reserve a gang with one member per given resource shape.
+  ///
+  /// \param shapes The resources of each member of the gang.
+  /// \param timeout_ms How long to wait for all the members to be reserved. If not
+  /// positive, gang_lease_timeout_milliseconds is used.
+  /// \param owner_worker_id The worker or driver that owns the gang. The gang is
+  /// released when it disconnects.
+  /// \param job_id The job of the owner. The gang is released when it finishes.
+  /// \param callback Called once the gang is reserved or has failed.
+  void RequestGangLease(
+      const std::vector<std::unordered_map<std::string, double>> &shapes,
+      int64_t timeout_ms, const WorkerID &owner_worker_id, const JobID &job_id,
+      const GangLeaseCallback &callback);
+
+  /// Release the resources of a gang. If the gang is still being reserved, the
+  /// request fails.
+  ///
+  /// \param gang_id ID of the gang to release.
+  /// \return False if the gang is unknown.
+  bool ReturnGangLease(const PlacementGroupID &gang_id);
+
+  /// Release the gangs owned by a worker or driver that disconnected.
+  ///
+  /// \param worker_id ID of the worker or driver.
+  void OnWorkerDisconnected(const WorkerID &worker_id);
+
+  /// Release the gangs of a finished job.
+  ///
+  /// \param job_id ID of the job.
+  void OnJobFinished(const JobID &job_id);
+
+  /// Fail the gangs that are being reserved and have a member on a removed node,
+  /// and release the members that the removed node reserved on the local node.
+  ///
+  /// \param node_id ID of the removed node.
+  void OnNodeRemoved(const NodeID &node_id);
+
+  /// Remember the members of gangs of other raylets that were prepared on the local
+  /// node. The bundles of placement groups are ignored.
+  ///
+  /// \param bundles The prepared bundles.
+  void AddRemoteMembers(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundles);
+
+  /// Forget the members of gangs of other raylets that were cancelled on the local
+  /// node.
+  ///
+  /// \param bundles The cancelled bundles.
+  void RemoveRemoteMembers(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundles);
+
+  /// Add the bundles of gangs reserved on the local node, by this raylet or by
+  /// another one, to the given set, so that they are not released as unused
+  /// bundles of placement groups. The GCS does not know about them.
+  void GetBundlesInUse(std::unordered_set<BundleID, pair_hash> *bundles_in_use) const;
+
+  /// \return The number of gangs that are being reserved or are reserved.
+  size_t NumGangs() const { return gangs_.size(); }
+
+ private:
+  enum class GangState {
+    /// The members are being prepared.
+    PREPARING,
+    /// Every member is prepared and the members are being committed.
+    COMMITTING,
+    /// Every member is committed.
+    COMMITTED,
+    /// The gang failed or was released.
+    ABORTED,
+  };
+
+  enum class MemberState {
+    /// Waiting for the reply of the remote node.
+    PENDING,
+    /// The resources of the member are reserved on its node.
+    PREPARED,
+  };
+
+  struct Gang {
+    Gang(const PlacementGroupID &gang_id, const WorkerID &owner_worker_id,
+         const JobID &job_id, boost::asio::io_service &io_service,
+         const GangLeaseCallback &callback)
+        : gang_id(gang_id),
+          owner_worker_id(owner_worker_id),
+          job_id(job_id),
+          timer(io_service),
+          callback(callback) {}
+
+    const PlacementGroupID gang_id;
+    /// The worker or driver that requested the gang, and its job.
+    const WorkerID owner_worker_id;
+    const JobID job_id;
+    GangState state = GangState::PREPARING;
+    /// The members of the gang. The node of each of them is set in its message.
+    std::vector<BundleSpecification> bundles;
+    std::vector<NodeID> nodes;
+    std::vector<MemberState> member_states;
+    /// Number of remote members whose prepare reply is pending, then number of remote
+    /// nodes whose commit reply is pending.
+    size_t num_pending_replies = 0;
+    /// Fails the gang if it is not committed in time.
+    boost::asio::deadline_timer timer;
+    GangLeaseCallback callback;
+  };
+
+  /// Handle the reply of a remote node to the prepare request of its members.
+  void OnMembersPrepared(const std::shared_ptr<Gang> &gang,
+                         const std::vector<size_t> &members, bool success);
+
+  /// Commit every member of a gang whose members are all prepared.
+  void CommitGang(const std::shared_ptr<Gang> &gang);
+
+  /// Handle the reply of a remote node to the commit request of its members.
+  void OnMembersCommitted(const std::shared_ptr<Gang> &gang, bool success);
+
+  /// Fail a gang that is not committed yet and cancel its prepared members.
+  void AbortGang(const std::shared_ptr<Gang> &gang);
+
+  /// Release the gangs for which the given predicate returns true.
+  void ReturnGangLeases(const std::function<bool(const Gang &)> &predicate);
+
+  /// Release members of a gang on their nodes, with a single request per node.
+  void CancelMembers(const Gang &gang, const std::vector<size_t> &members);
+
+  /// Group members of a gang by the node they are placed on.
+  std::unordered_map<NodeID, std::vector<size_t>> GroupMembersByNode(
+      const Gang &gang, const std::vector<size_t> &members) const;
+
+  /// Return the bundles of members of a gang.
+  std::vector<std::shared_ptr<const BundleSpecification>> GetMemberBundles(
+      const Gang &gang, const std::vector<size_t> &members) const;
+
+  boost::asio::io_service &io_service_;
+  const NodeID self_node_id_;
+  std::shared_ptr<ClusterResourceScheduler> cluster_resource_scheduler_;
+  std::shared_ptr<PlacementGroupResourceManager> local_bundles_;
+  std::function<std::shared_ptr<ResourceReserveInterface>(const NodeID &)>
+      get_reserve_client_;
+  std::function<void(const BundleSpecification &)> return_local_bundle_;
+
+  /// The gangs that are being reserved or are reserved, by ID.
+  std::unordered_map<PlacementGroupID, std::shared_ptr<Gang>> gangs_;
+
+  /// A member of a gang of another raylet that is reserved on the local node.
+  struct RemoteMember {
+    /// The raylet that reserved the member.
+    NodeID gang_node_id;
+    BundleSpecification bundle;
+  };
+  /// The members of gangs of other raylets reserved on the local node, by bundle.
+  std::unordered_map<BundleID, RemoteMember, pair_hash> remote_members_;
+};
+
+}  // namespace raylet
+
+}  // end namespace ray
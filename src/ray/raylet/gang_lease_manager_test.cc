@@ -0,0 +1,366 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/gang_lease_manager.h"
+
+#include <list>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace raylet {
+
+class MockResourceReserveClient : public ResourceReserveInterface {
+ public:
+  void PrepareBundleResources(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
+      const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback)
+      override {
+    num_bundles_prepared += bundle_specs.size();
+    prepare_callbacks.push_back(callback);
+  }
+
+  void CommitBundleResources(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
+      const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback)
+      override {
+    commit_callbacks.push_back(callback);
+  }
+
+  void CancelResourceReserve(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
+      const ray::rpc::ClientCallback<ray::rpc::CancelResourceReserveReply> &callback)
+      override {
+    num_cancel_requested++;
+    num_bundles_cancelled += bundle_specs.size();
+  }
+
+  void ReleaseUnusedBundles(
+      const std::vector<rpc::Bundle> &bundles_in_use,
+      const rpc::ClientCallback<rpc::ReleaseUnusedBundlesReply> &callback) override {}
+
+  bool GrantPrepareBundleResources(bool success = true) {
+    if (prepare_callbacks.empty()) {
+      return false;
+    }
+    rpc::PrepareBundleResourcesReply reply;
+    reply.set_success(success);
+    auto callback = prepare_callbacks.front();
+    prepare_callbacks.pop_front();
+    callback(Status::OK(), reply);
+    return true;
+  }
+
+  bool GrantCommitBundleResources() {
+    if (commit_callbacks.empty()) {
+      return false;
+    }
+    auto callback = commit_callbacks.front();
+    commit_callbacks.pop_front();
+    callback(Status::OK(), rpc::CommitBundleResourcesReply());
+    return true;
+  }
+
+  std::list<rpc::ClientCallback<rpc::PrepareBundleResourcesReply>> prepare_callbacks;
+  std::list<rpc::ClientCallback<rpc::CommitBundleResourcesReply>> commit_callbacks;
+  int num_cancel_requested = 0;
+  size_t num_bundles_prepared = 0;
+  size_t num_bundles_cancelled = 0;
+};
+
+class GangLeaseManagerTest : public ::testing::Test {
+ public:
+  GangLeaseManagerTest()
+      : local_node_id_(NodeID::FromRandom()),
+        remote_node_id_(NodeID::FromRandom()),
+        scheduler_(std::make_shared<ClusterResourceScheduler>(
+            local_node_id_.Binary(),
+            std::unordered_map<std::string, double>{{"CPU", 4}})),
+        local_bundles_(std::make_shared<NewPlacementGroupResourceManager>(scheduler_)),
+        client_(std::make_shared<MockResourceReserveClient>()),
+        gang_lease_manager_(
+            io_service_, local_node_id_, scheduler_, local_bundles_,
+            [this](const NodeID &node_id) -> std::shared_ptr<ResourceReserveInterface> {
+              return node_id == remote_node_id_ ? client_ : nullptr;
+            },
+            [this](const BundleSpecification &bundle_spec) {
+              num_local_returned_++;
+              local_bundles_->ReturnBundle(bundle_spec);
+            }) {}
+
+  void AddRemoteNode(double num_cpus) {
+    scheduler_->AddOrUpdateNode(remote_node_id_.Binary(), {{"CPU", num_cpus}},
+                                {{"CPU", num_cpus}});
+  }
+
+  double LocalAvailableCpus() {
+    return scheduler_->GetLocalNodeResources()
+        .predefined_resources[CPU]
+        .available.Double();
+  }
+
+  GangLeaseCallback RecordReply() {
+    return [this](bool success, const PlacementGroupID &gang_id,
+                  const std::vector<BundleSpecification> &bundles) {
+      num_replies_++;
+      success_ = success;
+      gang_id_ = gang_id;
+      bundles_ = bundles;
+    };
+  }
+
+ protected:
+  boost::asio::io_service io_service_;
+  NodeID local_node_id_;
+  NodeID remote_node_id_;
+  WorkerID owner_worker_id_ = WorkerID::FromRandom();
+  JobID job_id_ = JobID::FromInt(1);
+  std::shared_ptr<ClusterResourceScheduler> scheduler_;
+  std::shared_ptr<NewPlacementGroupResourceManager> local_bundles_;
+  std::shared_ptr<MockResourceReserveClient> client_;
+  GangLeaseManager gang_lease_manager_;
+  int num_local_returned_ = 0;
+
+  int num_replies_ = 0;
+  bool success_ = false;
+  PlacementGroupID gang_id_;
+  std::vector<BundleSpecification> bundles_;
+};
+
+TEST_F(GangLeaseManagerTest, TestLocalGang) {
+  gang_lease_manager_.RequestGangLease({{{"CPU", 2}}, {{"CPU", 2}}}, 1000,
+                                       owner_worker_id_, job_id_, RecordReply());
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_TRUE(success_);
+  ASSERT_EQ(bundles_.size(), 2);
+  for (const auto &bundle : bundles_) {
+    ASSERT_EQ(bundle.PlacementGroupId(), gang_id_);
+    ASSERT_EQ(bundle.GetMessage().node_id(), local_node_id_.Binary());
+    ASSERT_EQ(bundle.GetMessage().gang_node_id(), local_node_id_.Binary());
+  }
+  ASSERT_EQ(LocalAvailableCpus(), 0);
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 1);
+  std::unordered_set<BundleID, pair_hash> bundles_in_use;
+  gang_lease_manager_.GetBundlesInUse(&bundles_in_use);
+  ASSERT_EQ(bundles_in_use.size(), 2);
+
+  ASSERT_TRUE(gang_lease_manager_.ReturnGangLease(gang_id_));
+  ASSERT_EQ(num_local_returned_, 2);
+  ASSERT_EQ(LocalAvailableCpus(), 4);
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 0);
+  ASSERT_FALSE(gang_lease_manager_.ReturnGangLease(gang_id_));
+}
+
+TEST_F(GangLeaseManagerTest, TestInfeasibleGang) {
+  // The gang does not fit the local node, and there is no other node.
+  gang_lease_manager_.RequestGangLease({{{"CPU", 2}}, {{"CPU", 2}}, {{"CPU", 2}}}, 1000,
+                                       owner_worker_id_, job_id_, RecordReply());
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_FALSE(success_);
+  ASSERT_EQ(num_local_returned_, 2);
+  ASSERT_EQ(LocalAvailableCpus(), 4);
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 0);
+}
+
+TEST_F(GangLeaseManagerTest, TestSpilledGang) {
+  AddRemoteNode(4);
+  gang_lease_manager_.RequestGangLease({{{"CPU", 4}}, {{"CPU", 4}}}, 1000,
+                                       owner_worker_id_, job_id_, RecordReply());
+  ASSERT_EQ(num_replies_, 0);
+  ASSERT_EQ(LocalAvailableCpus(), 0);
+
+  // The gang is only committed once every member is prepared.
+  ASSERT_FALSE(client_->GrantCommitBundleResources());
+  ASSERT_TRUE(client_->GrantPrepareBundleResources());
+  ASSERT_EQ(num_replies_, 0);
+  ASSERT_TRUE(client_->GrantCommitBundleResources());
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_TRUE(success_);
+  ASSERT_EQ(bundles_[0].GetMessage().node_id(), local_node_id_.Binary());
+  ASSERT_EQ(bundles_[1].GetMessage().node_id(), remote_node_id_.Binary());
+
+  ASSERT_TRUE(gang_lease_manager_.ReturnGangLease(gang_id_));
+  ASSERT_EQ(num_local_returned_, 1);
+  ASSERT_EQ(client_->num_cancel_requested, 1);
+  ASSERT_EQ(LocalAvailableCpus(), 4);
+}
+
+TEST_F(GangLeaseManagerTest, TestMembersOnSameNodeAreBatched) {
+  AddRemoteNode(4);
+  gang_lease_manager_.RequestGangLease({{{"CPU", 4}}, {{"CPU", 2}}, {{"CPU", 2}}}, 1000,
+                                       owner_worker_id_, job_id_, RecordReply());
+  // The two members spilled to the remote node are prepared and committed by a single
+  // request each.
+  ASSERT_EQ(client_->prepare_callbacks.size(), 1);
+  ASSERT_EQ(client_->num_bundles_prepared, 2);
+  ASSERT_TRUE(client_->GrantPrepareBundleResources());
+  ASSERT_EQ(client_->commit_callbacks.size(), 1);
+  ASSERT_TRUE(client_->GrantCommitBundleResources());
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_TRUE(success_);
+
+  ASSERT_TRUE(gang_lease_manager_.ReturnGangLease(gang_id_));
+  ASSERT_EQ(num_local_returned_, 1);
+  ASSERT_EQ(client_->num_cancel_requested, 1);
+  ASSERT_EQ(client_->num_bundles_cancelled, 2);
+}
+
+TEST_F(GangLeaseManagerTest, TestPrepareFailure) {
+  AddRemoteNode(4);
+  gang_lease_manager_.RequestGangLease({{{"CPU", 4}}, {{"CPU", 4}}}, 1000,
+                                       owner_worker_id_, job_id_, RecordReply());
+  ASSERT_TRUE(client_->GrantPrepareBundleResources(false));
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_FALSE(success_);
+  ASSERT_EQ(num_local_returned_, 1);
+  // The remote member was not prepared, so there is nothing to cancel.
+  ASSERT_EQ(client_->num_cancel_requested, 0);
+  ASSERT_FALSE(client_->GrantCommitBundleResources());
+  ASSERT_EQ(LocalAvailableCpus(), 4);
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 0);
+}
+
+TEST_F(GangLeaseManagerTest, TestTimeout) {
+  AddRemoteNode(4);
+  gang_lease_manager_.RequestGangLease({{{"CPU", 4}}, {{"CPU", 4}}}, 10,
+                                       owner_worker_id_, job_id_, RecordReply());
+  io_service_.run();
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_FALSE(success_);
+  ASSERT_EQ(num_local_returned_, 1);
+  ASSERT_EQ(LocalAvailableCpus(), 4);
+
+  // The remote member is cancelled once it is prepared.
+  ASSERT_EQ(client_->num_cancel_requested, 0);
+  ASSERT_TRUE(client_->GrantPrepareBundleResources());
+  ASSERT_EQ(client_->num_cancel_requested, 1);
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_FALSE(client_->GrantCommitBundleResources());
+}
+
+TEST_F(GangLeaseManagerTest, TestNodeRemoved) {
+  AddRemoteNode(4);
+  gang_lease_manager_.RequestGangLease({{{"CPU", 4}}, {{"CPU", 4}}}, 1000,
+                                       owner_worker_id_, job_id_, RecordReply());
+  gang_lease_manager_.OnNodeRemoved(remote_node_id_);
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_FALSE(success_);
+  ASSERT_EQ(LocalAvailableCpus(), 4);
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 0);
+}
+
+TEST_F(GangLeaseManagerTest, TestOwnerDisconnected) {
+  AddRemoteNode(4);
+  gang_lease_manager_.RequestGangLease({{{"CPU", 4}}, {{"CPU", 4}}}, 1000,
+                                       owner_worker_id_, job_id_, RecordReply());
+  ASSERT_TRUE(client_->GrantPrepareBundleResources());
+  ASSERT_TRUE(client_->GrantCommitBundleResources());
+  ASSERT_TRUE(success_);
+
+  // The disconnection of another worker of the job does not release the gang.
+  gang_lease_manager_.OnWorkerDisconnected(WorkerID::FromRandom());
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 1);
+
+  // Both the local and the remote members are released with the owner.
+  gang_lease_manager_.OnWorkerDisconnected(owner_worker_id_);
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 0);
+  ASSERT_EQ(num_local_returned_, 1);
+  ASSERT_EQ(client_->num_cancel_requested, 1);
+  ASSERT_EQ(LocalAvailableCpus(), 4);
+}
+
+TEST_F(GangLeaseManagerTest, TestJobFinished) {
+  gang_lease_manager_.RequestGangLease({{{"CPU", 2}}}, 1000, owner_worker_id_, job_id_,
+                                       RecordReply());
+  ASSERT_TRUE(success_);
+  AddRemoteNode(4);
+  gang_lease_manager_.RequestGangLease({{{"CPU", 2}}, {{"CPU", 4}}}, 1000,
+                                       WorkerID::FromRandom(), job_id_, RecordReply());
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 2);
+
+  gang_lease_manager_.OnJobFinished(JobID::FromInt(2));
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 2);
+
+  // The committed gang is released, and the gang that is still being reserved
+  // fails.
+  gang_lease_manager_.OnJobFinished(job_id_);
+  ASSERT_EQ(gang_lease_manager_.NumGangs(), 0);
+  ASSERT_EQ(num_replies_, 2);
+  ASSERT_FALSE(success_);
+  ASSERT_EQ(num_local_returned_, 2);
+  ASSERT_EQ(LocalAvailableCpus(), 4);
+
+  // The remote member is cancelled once it is prepared.
+  ASSERT_TRUE(client_->GrantPrepareBundleResources());
+  ASSERT_EQ(client_->num_cancel_requested, 1);
+}
+
+TEST_F(GangLeaseManagerTest, TestRemoteMembers) {
+  // Members of gangs of another raylet, prepared on the local node by its requests.
+  std::vector<std::shared_ptr<const BundleSpecification>> members;
+  const auto gang_id = PlacementGroupID::FromRandom();
+  for (int i = 0; i < 2; i++) {
+    rpc::Bundle message;
+    message.mutable_bundle_id()->set_placement_group_id(gang_id.Binary());
+    message.mutable_bundle_id()->set_bundle_index(i);
+    message.mutable_unit_resources()->insert({"CPU", 1});
+    message.set_node_id(local_node_id_.Binary());
+    message.set_gang_node_id(remote_node_id_.Binary());
+    members.push_back(std::make_shared<const BundleSpecification>(message));
+  }
+  // The bundles of placement groups are not members of gangs.
+  rpc::Bundle message;
+  message.mutable_bundle_id()->set_placement_group_id(
+      PlacementGroupID::FromRandom().Binary());
+  message.mutable_unit_resources()->insert({"CPU", 1});
+  message.set_node_id(local_node_id_.Binary());
+  auto placement_group_bundle = std::make_shared<const BundleSpecification>(message);
+  auto bundles = members;
+  bundles.push_back(placement_group_bundle);
+  ASSERT_TRUE(local_bundles_->PrepareBundles(bundles));
+  local_bundles_->CommitBundles(bundles);
+  gang_lease_manager_.AddRemoteMembers(bundles);
+  ASSERT_EQ(LocalAvailableCpus(), 1);
+
+  // The members are protected from a release of the unused bundles by the GCS.
+  std::unordered_set<BundleID, pair_hash> bundles_in_use;
+  gang_lease_manager_.GetBundlesInUse(&bundles_in_use);
+  ASSERT_EQ(bundles_in_use.size(), 2);
+  ASSERT_EQ(bundles_in_use.count(members[0]->BundleId()), 1);
+  ASSERT_EQ(bundles_in_use.count(placement_group_bundle->BundleId()), 0);
+
+  // A cancelled member is no longer in use.
+  gang_lease_manager_.RemoveRemoteMembers({members[0]});
+  local_bundles_->ReturnBundle(*members[0]);
+  bundles_in_use.clear();
+  gang_lease_manager_.GetBundlesInUse(&bundles_in_use);
+  ASSERT_EQ(bundles_in_use.size(), 1);
+
+  // The members are released when the raylet that reserved them is removed.
+  gang_lease_manager_.OnNodeRemoved(NodeID::FromRandom());
+  ASSERT_EQ(num_local_returned_, 0);
+  gang_lease_manager_.OnNodeRemoved(remote_node_id_);
+  ASSERT_EQ(num_local_returned_, 1);
+  ASSERT_EQ(LocalAvailableCpus(), 3);
+  bundles_in_use.clear();
+  gang_lease_manager_.GetBundlesInUse(&bundles_in_use);
+  ASSERT_TRUE(bundles_in_use.empty());
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "ray/raylet/local_object_manager.h"
+#include "ray/stats/stats.h"
 #include "ray/util/asio_util.h"
 #include "ray/util/util.h"
 
@@ -38,23 +39,122 @@ void LocalObjectManager::PinObjects(const std::vector<ObjectID> &object_ids,
 
 void LocalObjectManager::WaitForObjectFree(const rpc::Address &owner_address,
                                            const std::vector<ObjectID> &object_ids) {
+  const auto owner_id = WorkerID::FromBinary(owner_address.worker_id());
+  auto &subscription = owner_subscriptions_[owner_id];
+  subscription.owner_address = owner_address;
   for (const auto &object_id : object_ids) {
-    // Send a long-running RPC request to the owner for each object. When we get a
-    // response or the RPC fails (due to the owner crashing), unpin the object.
-    // TODO(edoakes): we should be batching these requests instead of sending one per
-    // pinned object.
-    rpc::WaitForObjectEvictionRequest wait_request;
-    wait_request.set_object_id(object_id.Binary());
-    wait_request.set_intended_worker_id(owner_address.worker_id());
-    auto owner_client = owner_client_pool_.GetOrConnect(owner_address);
-    owner_client->WaitForObjectEviction(
-        wait_request,
-        [this, object_id](Status status, const rpc::WaitForObjectEvictionReply &reply) {
-          if (!status.ok()) {
-            RAY_LOG(DEBUG) << "Worker failed. Unpinning object " << object_id;
-          }
-          ReleaseFreedObject(object_id);
-        });
+    if (subscription.object_ids.insert(object_id).second) {
+      subscription.pending_object_ids.push_back(object_id);
+    }
+  }
+  SendEvictionSubscriptions(owner_id);
+}
+
+void LocalObjectManager::SendEvictionSubscriptions(const WorkerID &owner_id) {
+  auto it = owner_subscriptions_.find(owner_id);
+  if (it == owner_subscriptions_.end()) {
+    return;
+  }
+  auto &subscription = it->second;
+  if (subscription.subscribe_in_flight || subscription.pending_object_ids.empty()) {
+    return;
+  }
+
+  rpc::AddObjectEvictionSubscriptionsRequest request;
+  request.set_intended_worker_id(subscription.owner_address.worker_id());
+  request.set_subscriber_id(self_node_id_.Binary());
+  for (const auto &object_id : subscription.pending_object_ids) {
+    request.add_object_ids(object_id.Binary());
+  }
+  RAY_LOG(DEBUG) << "Subscribing to the eviction of "
+                 << subscription.pending_object_ids.size() << " objects owned by "
+                 << owner_id;
+  subscription.pending_object_ids.clear();
+  subscription.subscribe_in_flight = true;
+  auto owner_client = owner_client_pool_.GetOrConnect(subscription.owner_address);
+  owner_client->AddObjectEvictionSubscriptions(
+      request, [this, owner_id](Status status,
+                                const rpc::AddObjectEvictionSubscriptionsReply &reply) {
+        auto it = owner_subscriptions_.find(owner_id);
+        if (it == owner_subscriptions_.end()) {
+          return;
+        }
+        it->second.subscribe_in_flight = false;
+        if (!status.ok()) {
+          RAY_LOG(DEBUG) << "Worker " << owner_id << " failed. Unpinning its objects.";
+          ReleaseOwnerObjects(owner_id);
+          return;
+        }
+        HandleObjectsEvicted(owner_id, reply.evicted_object_ids());
+        // Flush the subscriptions that were buffered while this request was in
+        // flight.
+        SendEvictionSubscriptions(owner_id);
+        PollObjectEvictions(owner_id);
+      });
+}
+
+void LocalObjectManager::PollObjectEvictions(const WorkerID &owner_id) {
+  auto it = owner_subscriptions_.find(owner_id);
+  if (it == owner_subscriptions_.end()) {
+    return;
+  }
+  auto &subscription = it->second;
+  if (subscription.poll_in_flight) {
+    return;
+  }
+  if (subscription.object_ids.empty()) {
+    if (!subscription.subscribe_in_flight) {
+      owner_subscriptions_.erase(it);
+    }
+    return;
+  }
+
+  rpc::GetObjectEvictionsRequest request;
+  request.set_intended_worker_id(subscription.owner_address.worker_id());
+  request.set_subscriber_id(self_node_id_.Binary());
+  subscription.poll_in_flight = true;
+  auto owner_client = owner_client_pool_.GetOrConnect(subscription.owner_address);
+  owner_client->GetObjectEvictions(
+      request,
+      [this, owner_id](Status status, const rpc::GetObjectEvictionsReply &reply) {
+        auto it = owner_subscriptions_.find(owner_id);
+        if (it == owner_subscriptions_.end()) {
+          return;
+        }
+        it->second.poll_in_flight = false;
+        if (!status.ok()) {
+          RAY_LOG(DEBUG) << "Worker " << owner_id << " failed. Unpinning its objects.";
+          ReleaseOwnerObjects(owner_id);
+          return;
+        }
+        HandleObjectsEvicted(owner_id, reply.evicted_object_ids());
+        PollObjectEvictions(owner_id);
+      });
+}
+
+void LocalObjectManager::HandleObjectsEvicted(
+    const WorkerID &owner_id,
+    const google::protobuf::RepeatedPtrField<std::string> &evicted_object_ids) {
+  auto it = owner_subscriptions_.find(owner_id);
+  RAY_CHECK(it != owner_subscriptions_.end());
+  for (const auto &object_id_binary : evicted_object_ids) {
+    const auto object_id = ObjectID::FromBinary(object_id_binary);
+    // Skip duplicate notifications for objects that were already released.
+    if (it->second.object_ids.erase(object_id) > 0) {
+      ReleaseFreedObject(object_id);
+    }
+  }
+}
+
+void LocalObjectManager::ReleaseOwnerObjects(const WorkerID &owner_id) {
+  auto it = owner_subscriptions_.find(owner_id);
+  if (it == owner_subscriptions_.end()) {
+    return;
+  }
+  const auto object_ids = std::move(it->second.object_ids);
+  owner_subscriptions_.erase(it);
+  for (const auto &object_id : object_ids) {
+    ReleaseFreedObject(object_id);
   }
 }
 
@@ -170,6 +270,12 @@ bool LocalObjectManager::SpillObjectsOfSize(int64_t num_bytes_to_spill) {
                                             spill_time_total_s_)
                         << " MiB/s";
         }
+        if (spill_time_total_s_ > 0) {
+          stats::SpillManagerThroughputMB.Record(
+              static_cast<double>(spilled_bytes_total_) / (1024 * 1024) /
+                  spill_time_total_s_,
+              {{stats::SpillOperationKey, "Spill"}});
+        }
         last_spill_finish_ns_ = now;
       }
     });
@@ -187,6 +293,7 @@ void LocalObjectManager::SpillObjectsInternal(
     const std::vector<ObjectID> &object_ids,
     std::function<void(const ray::Status &)> callback) {
   std::vector<ObjectID> objects_to_spill;
+  int64_t bytes_to_spill = 0;
   // Filter for the objects that can be spilled.
   for (const auto &id : object_ids) {
     // We should not spill an object that we are not the primary copy for, or
@@ -206,6 +313,7 @@ void LocalObjectManager::SpillObjectsInternal(
     if (it != pinned_objects_.end()) {
       RAY_LOG(DEBUG) << "Spilling object " << id;
       objects_to_spill.push_back(id);
+      bytes_to_spill += it->second->GetSize();
       num_bytes_pending_spill_ += it->second->GetSize();
       objects_pending_spill_[id] = std::move(it->second);
       pinned_objects_.erase(it);
@@ -218,15 +326,22 @@ void LocalObjectManager::SpillObjectsInternal(
     }
     return;
   }
+  stats::SpillManagerBatchBytes.Record(bytes_to_spill,
+                                       {{stats::SpillOperationKey, "Spill"}});
+  auto start_time = absl::GetCurrentTimeNanos();
   io_worker_pool_.PopSpillWorker(
-      [this, objects_to_spill, callback](std::shared_ptr<WorkerInterface> io_worker) {
+      [this, objects_to_spill, callback,
+       start_time](std::shared_ptr<WorkerInterface> io_worker) {
+        stats::SpillManagerIOWorkerQueueingMs.Record(
+            (absl::GetCurrentTimeNanos() - start_time) / 1e6,
+            {{stats::SpillOperationKey, "Spill"}});
         rpc::SpillObjectsRequest request;
         for (const auto &object_id : objects_to_spill) {
           RAY_LOG(DEBUG) << "Sending spill request for object " << object_id;
           request.add_object_ids_to_spill(object_id.Binary());
         }
         io_worker->rpc_client()->SpillObjects(
-            request, [this, objects_to_spill, callback, io_worker](
+            request, [this, objects_to_spill, callback, io_worker, start_time](
                          const ray::Status &status, const rpc::SpillObjectsReply &r) {
               {
                 absl::MutexLock lock(&mutex_);
@@ -247,6 +362,9 @@ void LocalObjectManager::SpillObjectsInternal(
                   callback(status);
                 }
               } else {
+                stats::SpillManagerLatencyMs.Record(
+                    (absl::GetCurrentTimeNanos() - start_time) / 1e6,
+                    {{stats::SpillOperationKey, "Spill"}});
                 AddSpilledUrls(objects_to_spill, r, callback);
               }
             });
@@ -333,16 +451,20 @@ void LocalObjectManager::AsyncRestoreSpilledObject(
 
   RAY_CHECK(objects_pending_restore_.emplace(object_id).second)
       << "Object dedupe wasn't done properly. Please report if you see this issue.";
-  io_worker_pool_.PopRestoreWorker([this, object_id, object_url, callback](
+  auto pop_start_time = absl::GetCurrentTimeNanos();
+  io_worker_pool_.PopRestoreWorker([this, object_id, object_url, callback,
+                                    pop_start_time](
                                        std::shared_ptr<WorkerInterface> io_worker) {
     auto start_time = absl::GetCurrentTimeNanos();
+    stats::SpillManagerIOWorkerQueueingMs.Record(
+        (start_time - pop_start_time) / 1e6, {{stats::SpillOperationKey, "Restore"}});
     RAY_LOG(DEBUG) << "Sending restore spilled object request";
     rpc::RestoreSpilledObjectsRequest request;
     request.add_spilled_objects_url(std::move(object_url));
     request.add_object_ids_to_restore(object_id.Binary());
     io_worker->rpc_client()->RestoreSpilledObjects(
         request,
-        [this, start_time, object_id, callback, io_worker](
+        [this, start_time, pop_start_time, object_id, callback, io_worker](
             const ray::Status &status, const rpc::RestoreSpilledObjectsReply &r) {
           io_worker_pool_.PushRestoreWorker(io_worker);
           objects_pending_restore_.erase(object_id);
@@ -352,6 +474,10 @@ void LocalObjectManager::AsyncRestoreSpilledObject(
           } else {
             auto now = absl::GetCurrentTimeNanos();
             auto restored_bytes = r.bytes_restored_total();
+            stats::SpillManagerLatencyMs.Record(
+                (now - pop_start_time) / 1e6, {{stats::SpillOperationKey, "Restore"}});
+            stats::SpillManagerBatchBytes.Record(restored_bytes,
+                                                 {{stats::SpillOperationKey, "Restore"}});
             RAY_LOG(DEBUG) << "Restored " << restored_bytes << " in "
                            << (now - start_time) / 1e6 << "ms. Object id:" << object_id;
             restored_bytes_total_ += restored_bytes;
@@ -369,6 +495,12 @@ void LocalObjectManager::AsyncRestoreSpilledObject(
                                                 restore_time_total_s_)
                             << " MiB/s";
             }
+            if (restore_time_total_s_ > 0) {
+              stats::SpillManagerThroughputMB.Record(
+                  static_cast<double>(restored_bytes_total_) / (1024 * 1024) /
+                      restore_time_total_s_,
+                  {{stats::SpillOperationKey, "Restore"}});
+            }
             last_restore_finish_ns_ = now;
           }
           if (callback) {
@@ -424,8 +556,12 @@ void LocalObjectManager::ProcessSpilledObjectsDeleteQueue(uint32_t max_batch_siz
 }
 
 void LocalObjectManager::DeleteSpilledObjects(std::vector<std::string> &urls_to_delete) {
+  auto start_time = absl::GetCurrentTimeNanos();
   io_worker_pool_.PopDeleteWorker(
-      [this, urls_to_delete](std::shared_ptr<WorkerInterface> io_worker) {
+      [this, urls_to_delete, start_time](std::shared_ptr<WorkerInterface> io_worker) {
+        stats::SpillManagerIOWorkerQueueingMs.Record(
+            (absl::GetCurrentTimeNanos() - start_time) / 1e6,
+            {{stats::SpillOperationKey, "Delete"}});
         RAY_LOG(DEBUG) << "Sending delete spilled object request. Length: "
                        << urls_to_delete.size();
         rpc::DeleteSpilledObjectsRequest request;
@@ -433,12 +569,17 @@ void LocalObjectManager::DeleteSpilledObjects(std::vector<std::string> &urls_to_
           request.add_spilled_objects_url(std::move(url));
         }
         io_worker->rpc_client()->DeleteSpilledObjects(
-            request, [this, io_worker](const ray::Status &status,
-                                       const rpc::DeleteSpilledObjectsReply &reply) {
+            request, [this, io_worker, start_time](
+                         const ray::Status &status,
+                         const rpc::DeleteSpilledObjectsReply &reply) {
               io_worker_pool_.PushDeleteWorker(io_worker);
               if (!status.ok()) {
                 RAY_LOG(ERROR) << "Failed to send delete spilled object request: "
                                << status.ToString();
+              } else {
+                stats::SpillManagerLatencyMs.Record(
+                    (absl::GetCurrentTimeNanos() - start_time) / 1e6,
+                    {{stats::SpillOperationKey, "Delete"}});
               }
             });
       });
@@ -75,7 +75,9 @@ class LocalObjectManager {
 
   /// Wait for the objects' owner to free the object.  The objects will be
   /// released when the owner at the given address fails or replies that the
-  /// object can be evicted.
+  /// object can be evicted. Subscriptions are batched per owner: at most one
+  /// subscription request and one eviction long-poll are in flight per owner,
+  /// and objects added while a request is in flight are sent in the next one.
   ///
   /// \param owner_address The address of the owner of the objects.
   /// \param object_ids The objects to be freed.
@@ -158,6 +160,22 @@ class LocalObjectManager {
   /// Release an object that has been freed by its owner.
   void ReleaseFreedObject(const ObjectID &object_id);
 
+  /// Send the owner's buffered eviction subscriptions, if there is no
+  /// subscription request in flight already.
+  void SendEvictionSubscriptions(const WorkerID &owner_id);
+
+  /// Start a long-poll for evicted objects to the owner, if there is none in
+  /// flight already. Drops the owner's state once no objects are subscribed.
+  void PollObjectEvictions(const WorkerID &owner_id);
+
+  /// Release the given objects, which the owner reported as evicted.
+  void HandleObjectsEvicted(
+      const WorkerID &owner_id,
+      const google::protobuf::RepeatedPtrField<std::string> &evicted_object_ids);
+
+  /// Release all objects subscribed to the owner. Called when the owner fails.
+  void ReleaseOwnerObjects(const WorkerID &owner_id);
+
   /// Clear any freed objects. This will trigger the callback for freed
   /// objects.
   void FlushFreeObjects();
@@ -200,6 +218,23 @@ class LocalObjectManager {
   /// A callback to call when an object has been freed.
   std::function<void(const std::vector<ObjectID> &)> on_objects_freed_;
 
+  /// The state of the objects pinned on this node for a single owner.
+  struct OwnerEvictionSubscription {
+    rpc::Address owner_address;
+    /// Objects pinned on behalf of this owner that are waiting to be freed,
+    /// including the ones that have not been sent to the owner yet.
+    absl::flat_hash_set<ObjectID> object_ids;
+    /// Objects to send to the owner in the next subscription request.
+    std::vector<ObjectID> pending_object_ids;
+    /// Whether an AddObjectEvictionSubscriptions request is in flight.
+    bool subscribe_in_flight = false;
+    /// Whether a GetObjectEvictions long-poll is in flight.
+    bool poll_in_flight = false;
+  };
+
+  /// Eviction subscriptions of pinned objects, keyed by owner worker ID.
+  absl::flat_hash_map<WorkerID, OwnerEvictionSubscription> owner_subscriptions_;
+
   // Objects that are pinned on this node.
   absl::flat_hash_map<ObjectID, std::unique_ptr<RayObject>> pinned_objects_;
 
@@ -22,11 +22,13 @@
 #include "ray/common/common_protocol.h"
 #include "ray/common/constants.h"
 #include "ray/common/id.h"
+#include "ray/common/resource_usage.h"
 #include "ray/common/status.h"
 #include "ray/gcs/pb_util.h"
 #include "ray/raylet/format/node_manager_generated.h"
 #include "ray/stats/stats.h"
 #include "ray/util/asio_util.h"
+#include "ray/util/event_stats.h"
 #include "ray/util/sample.h"
 
 namespace {
@@ -133,6 +135,7 @@ NodeManager::NodeManager(boost::asio::io_service &io_service, const NodeID &self
       object_pinning_enabled_(config.object_pinning_enabled),
       temp_dir_(config.temp_dir),
       object_manager_profile_timer_(io_service),
+      event_loop_lag_timer_(io_service),
       initial_config_(config),
       local_available_resources_(config.resource_config),
       worker_pool_(io_service, config.num_workers_soft_limit,
@@ -181,10 +184,20 @@ NodeManager::NodeManager(boost::asio::io_service &io_service, const NodeID &self
             SendSpilledObjectRestorationRequestToRemoteNode(object_id, spilled_url,
                                                             node_id);
           }),
+      worker_lease_batcher_(io_service,
+                            [this](const TaskID &task_id) {
+                              return cluster_task_manager_->CancelTask(task_id);
+                            }),
       report_worker_backlog_(RayConfig::instance().report_worker_backlog()),
       last_local_gc_ns_(absl::GetCurrentTimeNanos()),
       local_gc_interval_ns_(RayConfig::instance().local_gc_interval_s() * 1e9),
       local_gc_min_interval_ns_(RayConfig::instance().local_gc_min_interval_s() * 1e9),
+      work_stealing_enabled_(RayConfig::instance().new_scheduler_enabled() &&
+                             RayConfig::instance().scheduler_work_stealing_enabled()),
+      resource_usage_full_report_period_(
+          RayConfig::instance().new_scheduler_enabled()
+              ? RayConfig::instance().resource_usage_full_report_period()
+              : 0),
       record_metrics_period_(config.record_metrics_period_ms) {
   RAY_LOG(INFO) << "Initializing NodeManager with ID " << self_node_id_;
   RAY_CHECK(heartbeat_period_.count() > 0);
@@ -192,6 +205,16 @@ NodeManager::NodeManager(boost::asio::io_service &io_service, const NodeID &self
   cluster_resource_map_.emplace(self_node_id_,
                                 SchedulingResources(config.resource_config));
 
+  if (RayConfig::instance().event_stats_metrics_enabled()) {
+    EventTracker::Instance().SetRecorder(
+        [](const std::string &name, int64_t queueing_ns, int64_t execution_ns) {
+          stats::HandlerQueueingMs.Record(queueing_ns / 1e6,
+                                          {{stats::HandlerNameKey, name}});
+          stats::HandlerExecutionMs.Record(execution_ns / 1e6,
+                                           {{stats::HandlerNameKey, name}});
+        });
+  }
+
   RAY_CHECK_OK(object_manager_.SubscribeObjAdded(
       [this](const object_manager::protocol::ObjectInfoT &object_info) {
         ObjectID object_id = ObjectID::FromBinary(object_info.object_id);
@@ -227,6 +250,29 @@ NodeManager::NodeManager(boost::asio::io_service &io_service, const NodeID &self
         std::make_shared<NewPlacementGroupResourceManager>(
             std::dynamic_pointer_cast<ClusterResourceScheduler>(
                 cluster_resource_scheduler_));
+    auto get_reserve_client =
+        [this](const NodeID &node_id) -> std::shared_ptr<ResourceReserveInterface> {
+      const auto client_entry = gang_reserve_clients_.find(node_id);
+      if (client_entry != gang_reserve_clients_.end()) {
+        return client_entry->second;
+      }
+      const auto entry = remote_node_manager_addresses_.find(node_id);
+      if (entry == remote_node_manager_addresses_.end()) {
+        return nullptr;
+      }
+      auto client = std::make_shared<ray::raylet::RayletClient>(
+          rpc::NodeManagerWorkerClient::make(entry->second.first, entry->second.second,
+                                             client_call_manager_));
+      gang_reserve_clients_.emplace(node_id, client);
+      return client;
+    };
+    gang_lease_manager_.reset(new GangLeaseManager(
+        io_service_, self_node_id_,
+        std::dynamic_pointer_cast<ClusterResourceScheduler>(cluster_resource_scheduler_),
+        placement_group_resource_manager_, get_reserve_client,
+        [this](const BundleSpecification &bundle_spec) {
+          ReleaseBundles({std::make_shared<const BundleSpecification>(bundle_spec)});
+        }));
   } else {
     cluster_resource_scheduler_ = std::make_shared<OldClusterResourceScheduler>(
         self_node_id_, local_available_resources_, cluster_resource_map_,
@@ -335,6 +381,9 @@ ray::Status NodeManager::RegisterGcs() {
   // Start the timer that gets object manager profiling information and sends it
   // to the GCS.
   GetObjectManagerProfileInfo();
+  if (RayConfig::instance().event_loop_lag_probe_period_ms() > 0) {
+    ProbeEventLoopLag();
+  }
 
   return ray::Status::OK();
 }
@@ -375,6 +424,8 @@ void NodeManager::HandleJobStarted(const JobID &job_id, const JobTableData &job_
   RAY_CHECK(!job_data.is_dead());
 
   worker_pool_.HandleJobStarted(job_id, job_data.config());
+  cluster_task_manager_->SetJobSchedulingPolicy(job_id,
+                                                job_data.config().scheduling_policy());
   // Tasks of this job may already arrived but failed to pop a worker because the job
   // config is not local yet. So we trigger dispatching again here to try to
   // reschedule these tasks.
@@ -385,6 +436,12 @@ void NodeManager::HandleJobFinished(const JobID &job_id, const JobTableData &job
   RAY_LOG(DEBUG) << "HandleJobFinished " << job_id;
   RAY_CHECK(job_data.is_dead());
   worker_pool_.HandleJobFinished(job_id);
+  // Forget the job's scheduling policy.
+  cluster_task_manager_->SetJobSchedulingPolicy(
+      job_id, rpc::SchedulingPolicyType::DEFAULT_POLICY);
+  if (gang_lease_manager_) {
+    gang_lease_manager_->OnJobFinished(job_id);
+  }
 
   auto workers = worker_pool_.GetWorkersRunningTasksForJob(job_id);
   // Kill all the workers. The actual cleanup for these workers is done
@@ -443,8 +500,11 @@ void NodeManager::Heartbeat() {
 
   // Reset the timer.
   heartbeat_timer_.expires_from_now(heartbeat_period_);
-  heartbeat_timer_.async_wait([this](const boost::system::error_code &error) {
+  const int64_t due_ns = absl::GetCurrentTimeNanos() +
+                         std::chrono::nanoseconds(heartbeat_period_).count();
+  heartbeat_timer_.async_wait([this, due_ns](const boost::system::error_code &error) {
     RAY_CHECK(!error);
+    ScopedHandlerTimer timer("NodeManager.Heartbeat", due_ns);
     Heartbeat();
   });
 }
@@ -452,10 +512,17 @@ void NodeManager::Heartbeat() {
 void NodeManager::ReportResourceUsage() {
   auto resources_data = std::make_shared<rpc::ResourcesData>();
   resources_data->set_node_id(self_node_id_.Binary());
-  // Update local chche from gcs remote cache, this is needed when gcs restart.
-  // We should always keep the cache view consistent.
-  cluster_resource_scheduler_->UpdateLastResourceUsage(
-      gcs_client_->NodeResources().GetLastResourceUsage());
+  if (resource_usage_full_report_period_ > 0) {
+    // Fill the full usage of this node, from which the delta against the last report
+    // is computed.
+    cluster_resource_scheduler_->UpdateLastResourceUsage(
+        std::make_shared<SchedulingResources>());
+  } else {
+    // Update local chche from gcs remote cache, this is needed when gcs restart.
+    // We should always keep the cache view consistent.
+    cluster_resource_scheduler_->UpdateLastResourceUsage(
+        gcs_client_->NodeResources().GetLastResourceUsage());
+  }
   cluster_resource_scheduler_->FillResourceUsage(resources_data);
   cluster_task_manager_->FillResourceUsage(resources_data);
 
@@ -475,19 +542,53 @@ void NodeManager::ReportResourceUsage() {
     last_local_gc_ns_ = now;
   }
 
-  if (resources_data->resources_total_size() > 0 ||
-      resources_data->resources_available_changed() ||
-      resources_data->resource_load_changed() || resources_data->should_global_gc()) {
+  if (resource_usage_full_report_period_ > 0) {
+    resources_data = MakeResourceUsageReport(resources_data);
+  }
+
+  if (resources_data && (resources_data->resources_total_size() > 0 ||
+                         resources_data->resources_available_changed() ||
+                         resources_data->resource_load_changed() ||
+                         resources_data->should_global_gc())) {
     RAY_CHECK_OK(gcs_client_->NodeResources().AsyncReportResourceUsage(resources_data,
                                                                        /*done*/ nullptr));
   }
 
   // Reset the timer.
   report_resources_timer_.expires_from_now(report_resources_period_);
-  report_resources_timer_.async_wait([this](const boost::system::error_code &error) {
-    RAY_CHECK(!error);
-    ReportResourceUsage();
-  });
+  const int64_t due_ns = absl::GetCurrentTimeNanos() +
+                         std::chrono::nanoseconds(report_resources_period_).count();
+  report_resources_timer_.async_wait(
+      [this, due_ns](const boost::system::error_code &error) {
+        RAY_CHECK(!error);
+        ScopedHandlerTimer timer("NodeManager.ReportResourceUsage", due_ns);
+        ReportResourceUsage();
+      });
+}
+
+std::shared_ptr<rpc::ResourcesData> NodeManager::MakeResourceUsageReport(
+    const std::shared_ptr<rpc::ResourcesData> &usage) {
+  // Every available resource is filled, so those that are not are exhausted.
+  usage->set_resources_available_changed(true);
+  usage->set_resource_load_changed(true);
+  usage->set_usage_version(last_reported_usage_.usage_version() + 1);
+
+  if (last_reported_usage_.usage_version() == 0 ||
+      ++num_reports_since_full_report_ >= resource_usage_full_report_period_) {
+    num_reports_since_full_report_ = 0;
+    last_reported_usage_ = *usage;
+    return usage;
+  }
+
+  auto delta = std::make_shared<rpc::ResourcesData>();
+  ComputeResourceUsageDelta(last_reported_usage_, *usage, delta.get());
+  if (!delta->resources_available_changed() && !delta->resource_load_changed() &&
+      !delta->should_global_gc()) {
+    // Nothing changed, so nothing is reported and the version is not bumped.
+    return nullptr;
+  }
+  last_reported_usage_ = *usage;
+  return delta;
 }
 
 void NodeManager::DoLocalGC() {
@@ -539,6 +640,20 @@ void NodeManager::HandleRestoreSpilledObject(
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
+void NodeManager::HandleStealTasks(const rpc::StealTasksRequest &request,
+                                   rpc::StealTasksReply *reply,
+                                   rpc::SendReplyCallback send_reply_callback) {
+  const NodeID thief_node_id = NodeID::FromBinary(request.thief_node_id());
+  int64_t num_stolen = 0;
+  if (thief_node_id != self_node_id_) {
+    num_stolen = cluster_task_manager_->StealTasks(thief_node_id, request.max_tasks());
+  }
+  RAY_LOG(DEBUG) << "Redirected " << num_stolen << " queued tasks to node "
+                 << thief_node_id;
+  reply->set_num_stolen(num_stolen);
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
+
 void NodeManager::HandleReleaseUnusedBundles(
     const rpc::ReleaseUnusedBundlesRequest &request,
     rpc::ReleaseUnusedBundlesReply *reply, rpc::SendReplyCallback send_reply_callback) {
@@ -551,6 +666,11 @@ void NodeManager::HandleReleaseUnusedBundles(
                        bundle_id.bundle_index()));
   }
 
+  // The bundles of the gangs reserved on this node are not known to the GCS.
+  if (gang_lease_manager_) {
+    gang_lease_manager_->GetBundlesInUse(&in_use_bundles);
+  }
+
   // Kill all workers that are currently associated with the unused bundles.
   // NOTE: We can't traverse directly with `leased_workers_`, because `DestroyWorker` will
   // delete the element of `leased_workers_`. So we need to filter out
@@ -659,9 +779,12 @@ void NodeManager::GetObjectManagerProfileInfo() {
 
   // Reset the timer.
   object_manager_profile_timer_.expires_from_now(heartbeat_period_);
+  const int64_t due_ns = absl::GetCurrentTimeNanos() +
+                         std::chrono::nanoseconds(heartbeat_period_).count();
   object_manager_profile_timer_.async_wait(
-      [this](const boost::system::error_code &error) {
+      [this, due_ns](const boost::system::error_code &error) {
         RAY_CHECK(!error);
+        ScopedHandlerTimer timer("NodeManager.GetObjectManagerProfileInfo", due_ns);
         GetObjectManagerProfileInfo();
       });
 
@@ -671,6 +794,23 @@ void NodeManager::GetObjectManagerProfileInfo() {
   }
 }
 
+void NodeManager::ProbeEventLoopLag() {
+  event_loop_lag_timer_.expires_from_now(
+      std::chrono::milliseconds(RayConfig::instance().event_loop_lag_probe_period_ms()));
+  const auto due = event_loop_lag_timer_.expiry();
+  event_loop_lag_timer_.async_wait([this, due](const boost::system::error_code &error) {
+    if (error == boost::asio::error::operation_aborted) {
+      return;
+    }
+    // The timer runs late by the time the event loop spent on other handlers.
+    event_loop_lag_ms_ = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - due)
+                             .count();
+    stats::EventLoopLagMs.Record(event_loop_lag_ms_);
+    ProbeEventLoopLag();
+  });
+}
+
 void NodeManager::NodeAdded(const GcsNodeInfo &node_info) {
   const NodeID node_id = NodeID::FromBinary(node_info.node_id());
 
@@ -737,6 +877,13 @@ void NodeManager::NodeRemoved(const NodeID &node_id) {
   if (node_entry != remote_node_manager_addresses_.end()) {
     remote_node_manager_addresses_.erase(node_entry);
   }
+  gang_reserve_clients_.erase(node_id);
+  remote_resource_usages_.erase(node_id);
+
+  // Fail the gangs that were being reserved on the node.
+  if (gang_lease_manager_) {
+    gang_lease_manager_->OnNodeRemoved(node_id);
+  }
 
   // Notify the object directory that the node has been removed so that it
   // can remove it from any cached locations.
@@ -871,6 +1018,51 @@ void NodeManager::UpdateResourceUsage(const NodeID &node_id,
   // If light resource usage report enabled, we update remote resources only when related
   // resources map in heartbeat is not empty.
   cluster_task_manager_->OnNodeResourceUsageUpdated(node_id, resource_data);
+
+  if (work_stealing_enabled_) {
+    MaybeStealTasks(node_id, resource_data);
+  }
+}
+
+void NodeManager::MaybeStealTasks(const NodeID &node_id,
+                                  const rpc::ResourcesData &resource_data) {
+  if (steal_request_in_flight_ || !resource_data.resource_load_changed()) {
+    return;
+  }
+  auto load_it = resource_data.resource_load().find(kCPU_ResourceLabel);
+  if (load_it == resource_data.resource_load().end() || load_it->second <= 0) {
+    return;
+  }
+  const auto node_entry = remote_node_manager_addresses_.find(node_id);
+  if (node_entry == remote_node_manager_addresses_.end()) {
+    return;
+  }
+  // Note: this is computed after `OnNodeResourceUsageUpdated`, so any tasks
+  // that could be spilled to us at schedule time are already on their way.
+  int64_t num_to_steal = cluster_task_manager_->NumTasksToSteal();
+  if (num_to_steal <= 0) {
+    return;
+  }
+
+  RAY_LOG(DEBUG) << "Asking node " << node_id << " for up to " << num_to_steal
+                 << " queued tasks";
+  rpc::StealTasksRequest request;
+  request.set_thief_node_id(self_node_id_.Binary());
+  request.set_max_tasks(num_to_steal);
+  steal_request_in_flight_ = true;
+  std::unique_ptr<rpc::NodeManagerClient> client(new rpc::NodeManagerClient(
+      node_entry->second.first, node_entry->second.second, client_call_manager_));
+  client->StealTasks(request, [this, node_id](const ray::Status &status,
+                                              const rpc::StealTasksReply &reply) {
+    steal_request_in_flight_ = false;
+    if (!status.ok()) {
+      RAY_LOG(DEBUG) << "Failed to steal tasks from node " << node_id << ": "
+                     << status.ToString();
+      return;
+    }
+    RAY_LOG(DEBUG) << "Node " << node_id << " redirected " << reply.num_stolen()
+                   << " queued tasks to this node";
+  });
 }
 
 void NodeManager::ResourceUsageBatchReceived(
@@ -882,7 +1074,25 @@ void NodeManager::ResourceUsageBatchReceived(
       // Skip messages from self.
       continue;
     }
-    UpdateResourceUsage(node_id, resource_usage);
+    if (resource_usage.usage_version() == 0) {
+      UpdateResourceUsage(node_id, resource_usage);
+      continue;
+    }
+    // Apply the versioned report to the last known usage of the node, so that the
+    // scheduler is updated with the full usage of the node even if the report is a
+    // delta. The flags of the usage then tell what this report changed.
+    auto &usage = remote_resource_usages_[node_id];
+    usage.set_resources_available_changed(false);
+    usage.set_resource_load_changed(false);
+    usage.set_should_global_gc(false);
+    if (!ApplyResourceUsageReport(resource_usage, &usage)) {
+      RAY_LOG(DEBUG) << "Missed a resource usage report of node " << node_id
+                     << ", it will be resynced by its next full report.";
+    }
+    for (const auto &resource_name : resource_usage.resources_deleted()) {
+      cluster_resource_scheduler_->DeleteResource(node_id.Binary(), resource_name);
+    }
+    UpdateResourceUsage(node_id, usage);
   }
 }
 
@@ -1227,6 +1437,11 @@ void NodeManager::DisconnectClient(const std::shared_ptr<ClientConnection> &clie
   // Erase any lease metadata.
   leased_workers_.erase(worker->WorkerId());
 
+  // Release the gangs of leases that the worker or driver reserved.
+  if (gang_lease_manager_) {
+    gang_lease_manager_->OnWorkerDisconnected(worker->WorkerId());
+  }
+
   // Publish the worker failure.
   auto worker_failure_data_ptr =
       gcs::CreateWorkerFailureData(self_node_id_, worker->WorkerId(), worker->IpAddress(),
@@ -1344,6 +1559,7 @@ void NodeManager::ProcessWaitRequestMessage(
   }
 
   bool resolve_objects = false;
+  FlushLocalObjects();
   for (auto const &object_id : object_ids) {
     if (!dependency_manager_.CheckObjectLocal(object_id)) {
       // At least one object requires resolution.
@@ -1482,14 +1698,67 @@ void NodeManager::HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest
   cluster_task_manager_->QueueAndScheduleTask(task, reply, send_reply_callback);
 }
 
+void NodeManager::HandleRequestWorkerLeases(
+    const rpc::RequestWorkerLeasesRequest &request, rpc::RequestWorkerLeasesReply *reply,
+    rpc::SendReplyCallback send_reply_callback) {
+  if (request.resource_specs().empty()) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
+  const TaskID batch_id = TaskID::FromBinary(request.resource_specs(0).task_id());
+  std::vector<TaskID> task_ids;
+  for (const auto &resource_spec : request.resource_specs()) {
+    task_ids.push_back(TaskID::FromBinary(resource_spec.task_id()));
+    // The replies are allocated upfront, as the scheduler keeps pointers to them.
+    reply->add_leases();
+  }
+  worker_lease_batcher_.AddBatch(task_ids, send_reply_callback);
+  auto backlog_size = -1;
+  if (report_worker_backlog_) {
+    backlog_size = request.backlog_size();
+  }
+  metrics_num_task_scheduled_ += request.resource_specs_size();
+
+  if (RayConfig::instance().enable_worker_prestart()) {
+    // The other leases of the request count in the backlog of the first one.
+    TaskSpecification task_spec(request.resource_specs(0));
+    worker_pool_.PrestartWorkers(
+        task_spec, request.backlog_size() + request.resource_specs_size() - 1);
+  }
+
+  for (int i = 0; i < request.resource_specs_size(); i++) {
+    rpc::Task task_message;
+    task_message.mutable_task_spec()->CopyFrom(request.resource_specs(i));
+    Task task(task_message, backlog_size);
+    auto lease_reply = reply->mutable_leases(i);
+    cluster_task_manager_->QueueAndScheduleTask(
+        task, lease_reply,
+        [this, batch_id, task_id = task_ids[i], lease_reply](
+            Status status, std::function<void()> success,
+            std::function<void()> failure) {
+          if (!status.ok()) {
+            lease_reply->set_canceled(true);
+          }
+          worker_lease_batcher_.OnLeaseResolved(batch_id, task_id, failure);
+        });
+  }
+}
+
 void NodeManager::HandlePrepareBundleResources(
     const rpc::PrepareBundleResourcesRequest &request,
     rpc::PrepareBundleResourcesReply *reply, rpc::SendReplyCallback send_reply_callback) {
-  auto bundle_spec = BundleSpecification(request.bundle_spec());
-  RAY_LOG(DEBUG) << "Request to prepare bundle resources is received, "
-                 << bundle_spec.DebugString();
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs;
+  for (const auto &bundle : request.bundle_specs()) {
+    bundle_specs.push_back(std::make_shared<const BundleSpecification>(bundle));
+  }
+  RAY_LOG(DEBUG) << "Request to prepare " << bundle_specs.size()
+                 << " bundles is received.";
 
-  auto prepared = placement_group_resource_manager_->PrepareBundle(bundle_spec);
+  auto prepared = placement_group_resource_manager_->PrepareBundles(bundle_specs);
+  if (prepared && gang_lease_manager_) {
+    // The GCS does not know about the members of gangs reserved by other raylets.
+    gang_lease_manager_->AddRemoteMembers(bundle_specs);
+  }
   reply->set_success(prepared);
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
@@ -1497,10 +1766,13 @@ void NodeManager::HandlePrepareBundleResources(
 void NodeManager::HandleCommitBundleResources(
     const rpc::CommitBundleResourcesRequest &request,
     rpc::CommitBundleResourcesReply *reply, rpc::SendReplyCallback send_reply_callback) {
-  auto bundle_spec = BundleSpecification(request.bundle_spec());
-  RAY_LOG(DEBUG) << "Request to commit bundle resources is received, "
-                 << bundle_spec.DebugString();
-  placement_group_resource_manager_->CommitBundle(bundle_spec);
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs;
+  for (const auto &bundle : request.bundle_specs()) {
+    bundle_specs.push_back(std::make_shared<const BundleSpecification>(bundle));
+  }
+  RAY_LOG(DEBUG) << "Request to commit " << bundle_specs.size()
+                 << " bundles is received.";
+  placement_group_resource_manager_->CommitBundles(bundle_specs);
   send_reply_callback(Status::OK(), nullptr, nullptr);
 
   cluster_task_manager_->ScheduleInfeasibleTasks();
@@ -1510,18 +1782,33 @@ void NodeManager::HandleCommitBundleResources(
 void NodeManager::HandleCancelResourceReserve(
     const rpc::CancelResourceReserveRequest &request,
     rpc::CancelResourceReserveReply *reply, rpc::SendReplyCallback send_reply_callback) {
-  auto bundle_spec = BundleSpecification(request.bundle_spec());
-  RAY_LOG(INFO) << "Request to cancel reserved resource is received, "
-                << bundle_spec.DebugString();
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs;
+  for (const auto &bundle : request.bundle_specs()) {
+    bundle_specs.push_back(std::make_shared<const BundleSpecification>(bundle));
+  }
+  RAY_LOG(INFO) << "Request to cancel the reserved resources of " << bundle_specs.size()
+                << " bundles is received.";
+  if (gang_lease_manager_) {
+    gang_lease_manager_->RemoveRemoteMembers(bundle_specs);
+  }
+  ReleaseBundles(bundle_specs);
+  send_reply_callback(Status::OK(), nullptr, nullptr);
+}
 
-  // Kill all workers that are currently associated with the placement group.
+void NodeManager::ReleaseBundles(
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs) {
+  absl::flat_hash_set<PlacementGroupID> placement_group_ids;
+  for (const auto &bundle_spec : bundle_specs) {
+    placement_group_ids.insert(bundle_spec->PlacementGroupId());
+  }
+  // Kill all workers that are currently associated with the placement groups.
   // NOTE: We can't traverse directly with `leased_workers_`, because `DestroyWorker` will
   // delete the element of `leased_workers_`. So we need to filter out
   // `workers_associated_with_pg` separately.
   std::vector<std::shared_ptr<WorkerInterface>> workers_associated_with_pg;
   for (const auto &worker_it : leased_workers_) {
     auto &worker = worker_it.second;
-    if (worker->GetBundleId().first == bundle_spec.PlacementGroupId()) {
+    if (placement_group_ids.contains(worker->GetBundleId().first)) {
       workers_associated_with_pg.emplace_back(worker);
     }
   }
@@ -1529,7 +1816,7 @@ void NodeManager::HandleCancelResourceReserve(
     RAY_LOG(DEBUG)
         << "Destroying worker since its placement group was removed. Placement group id: "
         << worker->GetBundleId().first
-        << ", bundle index: " << bundle_spec.BundleId().second
+        << ", bundle index: " << worker->GetBundleId().second
         << ", task id: " << worker->GetAssignedTaskId()
         << ", actor id: " << worker->GetActorId()
         << ", worker id: " << worker->WorkerId();
@@ -1537,9 +1824,47 @@ void NodeManager::HandleCancelResourceReserve(
   }
 
   // Return bundle resources.
-  placement_group_resource_manager_->ReturnBundle(bundle_spec);
+  for (const auto &bundle_spec : bundle_specs) {
+    placement_group_resource_manager_->ReturnBundle(*bundle_spec);
+  }
   cluster_task_manager_->ScheduleInfeasibleTasks();
   cluster_task_manager_->ScheduleAndDispatchTasks();
+}
+
+void NodeManager::HandleRequestGangLease(const rpc::RequestGangLeaseRequest &request,
+                                         rpc::RequestGangLeaseReply *reply,
+                                         rpc::SendReplyCallback send_reply_callback) {
+  if (!gang_lease_manager_) {
+    RAY_LOG(WARNING) << "Gang leases are only supported by the new scheduler.";
+    reply->set_success(false);
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
+  std::vector<std::unordered_map<std::string, double>> shapes;
+  for (const auto &bundle : request.bundles()) {
+    shapes.emplace_back(bundle.unit_resources().begin(), bundle.unit_resources().end());
+  }
+  gang_lease_manager_->RequestGangLease(
+      shapes, request.timeout_ms(), WorkerID::FromBinary(request.owner_worker_id()),
+      JobID::FromBinary(request.job_id()),
+      [reply, send_reply_callback](bool success, const PlacementGroupID &gang_id,
+                                   const std::vector<BundleSpecification> &bundles) {
+        reply->set_success(success);
+        reply->set_gang_id(gang_id.Binary());
+        for (const auto &bundle : bundles) {
+          reply->add_bundles()->CopyFrom(bundle.GetMessage());
+        }
+        send_reply_callback(Status::OK(), nullptr, nullptr);
+      });
+}
+
+void NodeManager::HandleReturnGangLease(const rpc::ReturnGangLeaseRequest &request,
+                                        rpc::ReturnGangLeaseReply *reply,
+                                        rpc::SendReplyCallback send_reply_callback) {
+  const auto gang_id = PlacementGroupID::FromBinary(request.gang_id());
+  if (!gang_lease_manager_ || !gang_lease_manager_->ReturnGangLease(gang_id)) {
+    RAY_LOG(DEBUG) << "Received a return request for an unknown gang " << gang_id;
+  }
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
@@ -1600,7 +1925,13 @@ void NodeManager::HandleCancelWorkerLease(const rpc::CancelWorkerLeaseRequest &r
                                           rpc::CancelWorkerLeaseReply *reply,
                                           rpc::SendReplyCallback send_reply_callback) {
   const TaskID task_id = TaskID::FromBinary(request.task_id());
-  bool canceled = cluster_task_manager_->CancelTask(task_id);
+  bool canceled = false;
+  if (worker_lease_batcher_.HasBatch(task_id)) {
+    // Cancel all the pending leases of a `RequestWorkerLeases` request.
+    canceled = worker_lease_batcher_.CancelBatch(task_id);
+  } else {
+    canceled = cluster_task_manager_->CancelTask(task_id);
+  }
   // The task cancellation failed if we did not have the task queued, since
   // this means that we may not have received the task request yet. It is
   // successful if we did have the task queued, since we have now replied to
@@ -2119,11 +2450,24 @@ void NodeManager::HandleTaskReconstruction(const TaskID &task_id,
 }
 
 void NodeManager::HandleObjectLocal(const ObjectID &object_id) {
-  // Notify the task dependency manager that this object is local.
-  const auto ready_task_ids = dependency_manager_.HandleObjectLocal(object_id);
-  RAY_LOG(DEBUG) << "Object local " << object_id << ", "
-                 << " on " << self_node_id_ << ", " << ready_task_ids.size()
-                 << " tasks ready";
+  RAY_LOG(DEBUG) << "Object local " << object_id << " on " << self_node_id_;
+  if (newly_local_objects_.empty()) {
+    PostWithStats(
+        io_service_, [this]() { FlushLocalObjects(); }, "NodeManager.FlushLocalObjects");
+  }
+  newly_local_objects_.push_back(object_id);
+}
+
+void NodeManager::FlushLocalObjects() {
+  if (newly_local_objects_.empty()) {
+    return;
+  }
+  std::vector<ObjectID> object_ids;
+  object_ids.swap(newly_local_objects_);
+  // Notify the task dependency manager that these objects are local.
+  const auto ready_task_ids = dependency_manager_.HandleObjectsLocal(object_ids);
+  RAY_LOG(DEBUG) << object_ids.size() << " objects local on " << self_node_id_ << ", "
+                 << ready_task_ids.size() << " tasks ready";
   cluster_task_manager_->TasksUnblocked(ready_task_ids);
 }
 
@@ -2138,6 +2482,8 @@ bool NodeManager::IsActorCreationTask(const TaskID &task_id) {
 }
 
 void NodeManager::HandleObjectMissing(const ObjectID &object_id) {
+  // The object may have become local in the same event loop iteration.
+  FlushLocalObjects();
   // Notify the task dependency manager that this object is no longer local.
   const auto waiting_task_ids = dependency_manager_.HandleObjectMissing(object_id);
   std::stringstream result;
@@ -2241,6 +2587,7 @@ void NodeManager::ProcessSubscribePlasmaReady(
   auto message = flatbuffers::GetRoot<protocol::SubscribePlasmaReady>(message_data);
   ObjectID id = from_flatbuf<ObjectID>(*message->object_id());
 
+  FlushLocalObjects();
   if (dependency_manager_.CheckObjectLocal(id)) {
     // Object is already local, so we directly fire the callback to tell the core worker
     // that the plasma object is ready.
@@ -2335,6 +2682,8 @@ std::string NodeManager::DebugString() const {
   result << "\n" << local_queues_.DebugString();
   result << "\n" << reconstruction_policy_.DebugString();
   result << "\n" << dependency_manager_.DebugString();
+  result << "\nEvent loop lag ms: " << event_loop_lag_ms_;
+  result << "\n" << EventTracker::Instance().DebugString();
   {
     absl::MutexLock guard(&plasma_object_notification_lock_);
     result << "\nnum async plasma notifications: "
@@ -2430,6 +2779,18 @@ void NodeManager::HandleGetNodeStats(const rpc::GetNodeStatsRequest &node_stats_
   local_object_manager_.FillObjectSpillingStats(reply);
   // Report object store stats.
   object_manager_.FillObjectStoreStats(reply);
+  // Report the handlers that load the event loops of the raylet.
+  for (const auto &entry : EventTracker::Instance().GetStats()) {
+    auto handler_stats = reply->add_handler_stats();
+    const auto &stats = entry.second;
+    handler_stats->set_handler_name(entry.first);
+    handler_stats->set_count(stats.count);
+    handler_stats->set_cum_queueing_ms(stats.cum_queueing_ns / 1e6);
+    handler_stats->set_max_queueing_ms(stats.max_queueing_ns / 1e6);
+    handler_stats->set_cum_execution_ms(stats.cum_execution_ns / 1e6);
+    handler_stats->set_max_execution_ms(stats.max_execution_ns / 1e6);
+  }
+  reply->set_event_loop_lag_ms(event_loop_lag_ms_);
   // Ensure we never report an empty set of metrics.
   if (!recorded_metrics_) {
     RecordMetrics();
@@ -39,11 +39,13 @@
 #include "ray/raylet/scheduling_queue.h"
 #include "ray/raylet/reconstruction_policy.h"
 #include "ray/raylet/dependency_manager.h"
+#include "ray/raylet/worker_lease_batcher.h"
 #include "ray/raylet/worker_pool.h"
 #include "ray/rpc/worker/core_worker_client_pool.h"
 #include "ray/util/ordered_set.h"
 #include "ray/common/bundle_spec.h"
 #include "ray/raylet/placement_group_resource_manager.h"
+#include "ray/raylet/gang_lease_manager.h"
 // clang-format on
 
 namespace ray {
@@ -209,9 +211,22 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// Send heartbeats to the GCS.
   void Heartbeat();
 
+  /// Measure how late a periodic timer runs on the event loop, which is how long
+  /// handlers wait for the event loop.
+  void ProbeEventLoopLag();
+
   /// Report resource usage to the GCS.
   void ReportResourceUsage();
 
+  /// Make the report of the full resource usage of this node, when the reports are
+  /// deltas: every `resource_usage_full_report_period_` reports, the full usage is
+  /// sent, and otherwise its delta against the last report.
+  ///
+  /// \param usage The full resource usage of this node.
+  /// \return The report to send, or nullptr if nothing changed.
+  std::shared_ptr<rpc::ResourcesData> MakeResourceUsageReport(
+      const std::shared_ptr<rpc::ResourcesData> &usage);
+
   /// Write out debug state to a file.
   void DumpDebugState() const;
 
@@ -406,11 +421,15 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   void CleanUpTasksForFinishedJob(const JobID &job_id);
 
   /// Handle an object becoming local. This updates any local accounting, but
-  /// does not write to any global accounting in the GCS.
+  /// does not write to any global accounting in the GCS. The objects that become
+  /// local in the same event loop iteration are handled in bulk.
   ///
   /// \param object_id The object that is locally available.
   /// \return Void.
   void HandleObjectLocal(const ObjectID &object_id);
+  /// Handle the objects that became local since the last call, in a single pass
+  /// over the dependency manager.
+  void FlushLocalObjects();
   /// Handle an object that is no longer local. This updates any local
   /// accounting, but does not write to any global accounting in the GCS.
   ///
@@ -560,11 +579,23 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
                                    rpc::CancelResourceReserveReply *reply,
                                    rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Release the resources of bundles and destroy the workers of their placement
+  /// groups.
+  ///
+  /// \param bundle_specs The bundles to release.
+  void ReleaseBundles(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs);
+
   /// Handle a `WorkerLease` request.
   void HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest &request,
                                 rpc::RequestWorkerLeaseReply *reply,
                                 rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle a `RequestWorkerLeases` request.
+  void HandleRequestWorkerLeases(const rpc::RequestWorkerLeasesRequest &request,
+                                 rpc::RequestWorkerLeasesReply *reply,
+                                 rpc::SendReplyCallback send_reply_callback) override;
+
   /// Handle a `ReturnWorker` request.
   void HandleReturnWorker(const rpc::ReturnWorkerRequest &request,
                           rpc::ReturnWorkerReply *reply,
@@ -614,6 +645,28 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
                                   rpc::ReleaseUnusedBundlesReply *reply,
                                   rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Handle a `StealTasks` request.
+  void HandleStealTasks(const rpc::StealTasksRequest &request,
+                        rpc::StealTasksReply *reply,
+                        rpc::SendReplyCallback send_reply_callback) override;
+
+  /// Ask a busy remote node to redirect some of its queued tasks to this node,
+  /// if this node is idle and no other steal request is in flight.
+  ///
+  /// \param node_id ID of the remote node.
+  /// \param resource_data The latest resource usage reported by the remote node.
+  void MaybeStealTasks(const NodeID &node_id, const rpc::ResourcesData &resource_data);
+
+  /// Handle a `RequestGangLease` request.
+  void HandleRequestGangLease(const rpc::RequestGangLeaseRequest &request,
+                              rpc::RequestGangLeaseReply *reply,
+                              rpc::SendReplyCallback send_reply_callback) override;
+
+  /// Handle a `ReturnGangLease` request.
+  void HandleReturnGangLease(const rpc::ReturnGangLeaseRequest &request,
+                             rpc::ReturnGangLeaseReply *reply,
+                             rpc::SendReplyCallback send_reply_callback) override;
+
   /// Trigger local GC on each worker of this raylet.
   void DoLocalGC();
 
@@ -746,6 +799,16 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   void OnNodeResourceUsageUpdated(const NodeID &node_id,
                                   const rpc::ResourcesData &resource_data) override;
 
+  /// Scheduling policies are not supported by the legacy scheduler.
+  void SetJobSchedulingPolicy(const JobID &job_id,
+                              rpc::SchedulingPolicyType policy_type) override;
+
+  /// Work stealing is not supported by the legacy scheduler.
+  int64_t StealTasks(const NodeID &thief_node_id, int64_t max_tasks) override;
+
+  /// Work stealing is not supported by the legacy scheduler.
+  int64_t NumTasksToSteal() const override;
+
   /// Handle the object missing event.
   ///
   /// \param object_id ID of the missing object.
@@ -803,6 +866,10 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// The timer used to get profiling information from the object manager and
   /// push it to the GCS.
   boost::asio::steady_timer object_manager_profile_timer_;
+  /// The timer used to measure the event loop lag.
+  boost::asio::steady_timer event_loop_lag_timer_;
+  /// The last measured event loop lag.
+  double event_loop_lag_ms_ = 0;
   /// The time that the last heartbeat was sent at. Used to make sure we are
   /// keeping up with heartbeats.
   uint64_t last_heartbeat_at_ms_;
@@ -830,6 +897,11 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// called `ray.get` or `ray.wait`.
   DependencyManager dependency_manager_;
 
+  /// The objects that became local but were not passed to the dependency manager
+  /// yet. They are flushed from the event loop, or before reading the local
+  /// objects of the dependency manager.
+  std::vector<ObjectID> newly_local_objects_;
+
   std::unique_ptr<AgentManager> agent_manager_;
 
   /// The RPC server.
@@ -857,6 +929,11 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   absl::flat_hash_map<NodeID, std::pair<std::string, int32_t>>
       remote_node_manager_addresses_;
 
+  /// Clients of the remote node managers that reserve the members of gangs, by
+  /// node ID. A client is removed with its node.
+  absl::flat_hash_map<NodeID, std::shared_ptr<raylet::RayletClient>>
+      gang_reserve_clients_;
+
   /// Map of workers leased out to direct call clients.
   std::unordered_map<WorkerID, std::shared_ptr<WorkerInterface>> leased_workers_;
 
@@ -864,6 +941,9 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// lease on.
   absl::flat_hash_map<WorkerID, std::vector<WorkerID>> leased_workers_by_owner_;
 
+  /// Replies to the `RequestWorkerLeases` requests once their leases are resolved.
+  WorkerLeaseBatcher worker_lease_batcher_;
+
   /// Whether to report the worker's backlog size in the GCS heartbeat.
   const bool report_worker_backlog_;
 
@@ -885,6 +965,26 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
   /// triggered).
   const int64_t local_gc_min_interval_ns_;
 
+  /// Whether this node asks busy peers for queued tasks when it is idle.
+  const bool work_stealing_enabled_;
+
+  /// Whether a `StealTasks` request sent by this node is awaiting its reply.
+  bool steal_request_in_flight_ = false;
+
+  /// If positive, the resource usage reports of this node are deltas against its
+  /// previous report, with a full report every this many reports.
+  const uint64_t resource_usage_full_report_period_;
+
+  /// The last resource usage reported by this node, when its reports are deltas.
+  rpc::ResourcesData last_reported_usage_;
+
+  /// The number of resource usage reports sent since the last full report.
+  uint64_t num_reports_since_full_report_ = 0;
+
+  /// The last known resource usage of the remote nodes that version their reports.
+  /// The deltas they report are applied to it.
+  absl::flat_hash_map<NodeID, rpc::ResourcesData> remote_resource_usages_;
+
   /// These two classes make up the new scheduler. ClusterResourceScheduler is
   /// responsible for maintaining a view of the cluster state w.r.t resource
   /// usage. ClusterTaskManager is responsible for queuing, spilling back, and
@@ -925,6 +1025,9 @@ class NodeManager : public rpc::NodeManagerServiceHandler,
 
   /// Managers all bundle-related operations.
   std::shared_ptr<PlacementGroupResourceManager> placement_group_resource_manager_;
+
+  /// Reserves gangs of leases. Only set if the new scheduler is enabled.
+  std::unique_ptr<GangLeaseManager> gang_lease_manager_;
 };
 
 }  // namespace raylet
@@ -295,6 +295,15 @@ void NodeManager::OnNodeResourceUsageUpdated(const NodeID &node_id,
   }
 }
 
+void NodeManager::SetJobSchedulingPolicy(const JobID &job_id,
+                                         rpc::SchedulingPolicyType policy_type) {}
+
+int64_t NodeManager::StealTasks(const NodeID &thief_node_id, int64_t max_tasks) {
+  return 0;
+}
+
+int64_t NodeManager::NumTasksToSteal() const { return 0; }
+
 void NodeManager::FillPendingActorInfo(rpc::GetNodeStatsReply *reply) const {
   // TODO(Shanly): Implement.
 }
@@ -74,6 +74,26 @@ class PlacementGroupResourceManager {
   /// \param bundle_spec: Specification of bundle whose resources will be returned.
   virtual void ReturnBundle(const BundleSpecification &bundle_spec) = 0;
 
+  /// Whether the resources of a bundle are committed.
+  ///
+  /// \param bundle_id: The ID of the bundle.
+  virtual bool IsBundleCommitted(const BundleID &bundle_id) const = 0;
+
+  /// Lock the required resources of several bundles atomically: either all the bundles
+  /// are prepared, or none of them is.
+  ///
+  /// \param bundle_specs: Specifications of the bundles whose resources will be
+  /// prepared.
+  bool PrepareBundles(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs);
+
+  /// Convert the required resources of several bundles to placement group resources.
+  ///
+  /// \param bundle_specs: Specifications of the bundles whose resources will be
+  /// committed.
+  void CommitBundles(
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs);
+
   /// Return back all the bundle(which is unused) resource.
   ///
   /// \param bundle_spec: A set of bundles which in use.
@@ -111,6 +131,8 @@ class OldPlacementGroupResourceManager : public PlacementGroupResourceManager {
 
   void ReturnBundle(const BundleSpecification &bundle_spec);
 
+  bool IsBundleCommitted(const BundleID &bundle_id) const;
+
   /// Get all local available resource(IDs specificed).
   const ResourceIdSet &GetAllResourceIdSet() const { return local_available_resources_; };
 
@@ -151,6 +173,8 @@ class NewPlacementGroupResourceManager : public PlacementGroupResourceManager {
 
   void ReturnBundle(const BundleSpecification &bundle_spec);
 
+  bool IsBundleCommitted(const BundleID &bundle_id) const;
+
   const std::shared_ptr<ClusterResourceScheduler> GetResourceScheduler() const {
     return cluster_resource_scheduler_;
   }
@@ -416,6 +416,50 @@ TEST_F(NewPlacementGroupResourceManagerTest, TestNewMultipleBundlesCommitAndRetu
   CheckRemainingResourceCorrect(remaining_resouece_instance);
 }
 
+TEST_F(NewPlacementGroupResourceManagerTest, TestNewPrepareBundlesAtomically) {
+  // 1. create three bundles spec, with more resources than available in total.
+  auto group_id = PlacementGroupID::FromRandom();
+  std::unordered_map<std::string, double> unit_resource;
+  unit_resource.insert({"CPU", 1.0});
+  std::vector<std::shared_ptr<const BundleSpecification>> bundle_specs;
+  for (int index = 1; index <= 3; index++) {
+    bundle_specs.push_back(std::make_shared<const BundleSpecification>(
+        Mocker::GenBundleCreation(group_id, index, unit_resource)));
+  }
+  /// 2. init local available resource.
+  std::unordered_map<std::string, double> init_unit_resource;
+  init_unit_resource.insert({"CPU", 2.0});
+  InitLocalAvailableResource(init_unit_resource);
+  /// 3. the batch fails, and the bundles prepared before the failure are returned.
+  ASSERT_FALSE(new_placement_group_resource_manager_->PrepareBundles(bundle_specs));
+  auto remaining_resource_scheduler =
+      std::make_shared<ClusterResourceScheduler>("remaining", init_unit_resource);
+  auto remaining_resouece_instance = remaining_resource_scheduler->GetLocalResources();
+  CheckRemainingResourceCorrect(remaining_resouece_instance);
+  /// 4. a batch that fits is prepared and committed.
+  bundle_specs.pop_back();
+  ASSERT_TRUE(new_placement_group_resource_manager_->PrepareBundles(bundle_specs));
+  new_placement_group_resource_manager_->CommitBundles(bundle_specs);
+  std::unordered_map<std::string, double> remaining_resources = {
+      {"CPU_group_" + group_id.Hex(), 2.0},
+      {"CPU_group_1_" + group_id.Hex(), 1.0},
+      {"CPU_group_2_" + group_id.Hex(), 1.0},
+      {"CPU", 2.0}};
+  remaining_resource_scheduler =
+      std::make_shared<ClusterResourceScheduler>("remaining", remaining_resources);
+  std::shared_ptr<TaskResourceInstances> resource_instances =
+      std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(remaining_resource_scheduler->AllocateLocalTaskResources(
+      init_unit_resource, resource_instances));
+  remaining_resouece_instance = remaining_resource_scheduler->GetLocalResources();
+  CheckRemainingResourceCorrect(remaining_resouece_instance);
+  /// 5. a failed batch does not return the bundles it holds that were committed.
+  bundle_specs.push_back(std::make_shared<const BundleSpecification>(
+      Mocker::GenBundleCreation(group_id, 3, unit_resource)));
+  ASSERT_FALSE(new_placement_group_resource_manager_->PrepareBundles(bundle_specs));
+  CheckRemainingResourceCorrect(remaining_resouece_instance);
+}
+
 TEST_F(NewPlacementGroupResourceManagerTest, TestNewIdempotencyWithMultiPrepare) {
   // 1. create one bundle spec.
   auto group_id = PlacementGroupID::FromRandom();
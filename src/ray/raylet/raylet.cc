@@ -20,6 +20,7 @@
 #include <iostream>
 
 #include "ray/common/status.h"
+#include "ray/util/event_stats.h"
 #include "ray/util/util.h"
 
 namespace {
@@ -81,16 +82,21 @@ Raylet::Raylet(boost::asio::io_service &main_service, const std::string &socket_
           [this]() {
             // This callback is called from the plasma store thread.
             // NOTE: It means the local object manager should be thread-safe.
-            main_service_.post([this]() {
-              node_manager_.GetLocalObjectManager().SpillObjectUptoMaxThroughput();
-            });
+            PostWithStats(
+                main_service_,
+                [this]() {
+                  node_manager_.GetLocalObjectManager().SpillObjectUptoMaxThroughput();
+                },
+                "Raylet.SpillObjects");
             return node_manager_.GetLocalObjectManager().IsSpillingInProgress();
           },
           [this]() {
             // Post on the node manager's event loop since this
             // callback is called from the plasma store thread.
             // This will help keep node manager lock-less.
-            main_service_.post([this]() { node_manager_.TriggerGlobalGC(); });
+            PostWithStats(
+                main_service_, [this]() { node_manager_.TriggerGlobalGC(); },
+                "Raylet.TriggerGlobalGC");
           }),
       node_manager_(main_service, self_node_id_, node_manager_config, object_manager_,
                     gcs_client_, object_directory_,
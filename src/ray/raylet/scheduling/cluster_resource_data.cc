@@ -1,5 +1,14 @@
 #include "ray/raylet/scheduling/cluster_resource_data.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RAY_SCHEDULING_HAVE_AVX2_KERNEL
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 const std::string resource_labels[] = {ray::kCPU_ResourceLabel,
                                        ray::kMemory_ResourceLabel,
                                        ray::kGPU_ResourceLabel, ray::kTPU_ResourceLabel};
@@ -58,6 +67,56 @@ std::vector<double> VectorFixedPointToVectorDouble(
   return vector;
 }
 
+namespace {
+
+/// Return the position of the lowest set bit of a non-zero word.
+inline size_t FindFirstSet(uint64_t word) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, word);
+  return index;
+#else
+  return __builtin_ctzll(word);
+#endif
+}
+
+}  // namespace
+
+void ResourceInstanceCapacities::ResetFreeUnits() {
+  free_units.assign((available.size() + 63) / 64, 0);
+  for (size_t i = 0; i < available.size(); i++) {
+    if (available[i] == kUnitCapacity) {
+      free_units[i / 64] |= uint64_t(1) << (i % 64);
+    }
+  }
+}
+
+void ResourceInstanceCapacities::UpdateFreeUnit(size_t index) {
+  if (index / 64 >= free_units.size()) {
+    return;
+  }
+  const uint64_t bit = uint64_t(1) << (index % 64);
+  if (available[index] == kUnitCapacity) {
+    free_units[index / 64] |= bit;
+  } else {
+    free_units[index / 64] &= ~bit;
+  }
+}
+
+int64_t ResourceInstanceCapacities::FindFreeUnit(size_t index) const {
+  for (size_t word_index = index / 64; word_index < free_units.size(); word_index++) {
+    uint64_t word = free_units[word_index];
+    if (word_index == index / 64) {
+      // Ignore the instances before "index".
+      word &= ~uint64_t(0) << (index % 64);
+    }
+    if (word != 0) {
+      return static_cast<int64_t>(word_index * 64 + FindFirstSet(word));
+    }
+  }
+  return -1;
+}
+
 /// Convert a map of resources to a TaskRequest data structure.
 TaskRequest ResourceMapToTaskRequest(
     StringIdMap &string_to_int_map,
@@ -466,3 +525,135 @@ bool TaskResourceInstances::operator==(const TaskResourceInstances &other) {
   }
   return true;
 }
+
+namespace {
+
+/// Columns of a NodeResourceTable and the demand each of them is checked
+/// against. A row passes if every column is at least its demand.
+struct ColumnChecks {
+  const int64_t *columns[PredefinedResources_MAX];
+  int64_t demands[PredefinedResources_MAX];
+  size_t num_columns = 0;
+};
+
+/// Check rows [begin, end) one at a time.
+void CheckRowsScalar(const ColumnChecks &checks, size_t begin, size_t end,
+                     uint8_t *out) {
+  for (size_t row = begin; row < end; row++) {
+    bool pass = true;
+    for (size_t k = 0; k < checks.num_columns; k++) {
+      pass &= checks.columns[k][row] >= checks.demands[k];
+    }
+    out[row] = pass;
+  }
+}
+
+#ifdef RAY_SCHEDULING_HAVE_AVX2_KERNEL
+/// Check rows four at a time with AVX2 compares. Returns the number of rows
+/// checked; the remaining rows must be checked with CheckRowsScalar.
+__attribute__((target("avx2"))) size_t CheckRowsAvx2(const ColumnChecks &checks,
+                                                     size_t num_rows, uint8_t *out) {
+  __m256i demands[PredefinedResources_MAX];
+  for (size_t k = 0; k < checks.num_columns; k++) {
+    demands[k] = _mm256_set1_epi64x(checks.demands[k]);
+  }
+  size_t row = 0;
+  for (; row + 4 <= num_rows; row += 4) {
+    __m256i violated = _mm256_setzero_si256();
+    for (size_t k = 0; k < checks.num_columns; k++) {
+      __m256i values =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(checks.columns[k] + row));
+      violated = _mm256_or_si256(violated, _mm256_cmpgt_epi64(demands[k], values));
+    }
+    int mask = _mm256_movemask_pd(_mm256_castsi256_pd(violated));
+    out[row] = !(mask & 1);
+    out[row + 1] = !(mask & 2);
+    out[row + 2] = !(mask & 4);
+    out[row + 3] = !(mask & 8);
+  }
+  return row;
+}
+#endif
+
+void CheckRows(const ColumnChecks &checks, size_t num_rows, uint8_t *out) {
+  size_t begin = 0;
+#ifdef RAY_SCHEDULING_HAVE_AVX2_KERNEL
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2) {
+    begin = CheckRowsAvx2(checks, num_rows, out);
+  }
+#endif
+  CheckRowsScalar(checks, begin, num_rows, out);
+}
+
+}  // namespace
+
+void NodeResourceTable::AddOrUpdateNode(int64_t node_id, const NodeResources &resources) {
+  auto it = rows_.find(node_id);
+  size_t row;
+  if (it == rows_.end()) {
+    row = node_ids_.size();
+    rows_.emplace(node_id, row);
+    node_ids_.push_back(node_id);
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      total_[i].push_back(0);
+      available_[i].push_back(0);
+    }
+  } else {
+    row = it->second;
+  }
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    if (i < resources.predefined_resources.size()) {
+      total_[i][row] = resources.predefined_resources[i].total.Raw();
+      available_[i][row] = resources.predefined_resources[i].available.Raw();
+    } else {
+      total_[i][row] = 0;
+      available_[i][row] = 0;
+    }
+  }
+}
+
+void NodeResourceTable::RemoveNode(int64_t node_id) {
+  auto it = rows_.find(node_id);
+  if (it == rows_.end()) {
+    return;
+  }
+  size_t row = it->second;
+  size_t last = node_ids_.size() - 1;
+  rows_.erase(it);
+  if (row != last) {
+    node_ids_[row] = node_ids_[last];
+    rows_[node_ids_[row]] = row;
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      total_[i][row] = total_[i][last];
+      available_[i][row] = available_[i][last];
+    }
+  }
+  node_ids_.pop_back();
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    total_[i].pop_back();
+    available_[i].pop_back();
+  }
+}
+
+void NodeResourceTable::CheckPredefinedResources(
+    const TaskRequest &task_req, std::vector<uint8_t> *feasible,
+    std::vector<uint8_t> *schedulable) const {
+  ColumnChecks total_checks;
+  ColumnChecks available_checks;
+  const size_t num_resources =
+      std::min<size_t>(PredefinedResources_MAX, task_req.predefined_resources.size());
+  for (size_t i = 0; i < num_resources; i++) {
+    const auto &request = task_req.predefined_resources[i];
+    total_checks.columns[total_checks.num_columns] = total_[i].data();
+    total_checks.demands[total_checks.num_columns++] = request.demand.Raw();
+    if (!request.soft) {
+      available_checks.columns[available_checks.num_columns] = available_[i].data();
+      available_checks.demands[available_checks.num_columns++] = request.demand.Raw();
+    }
+  }
+  feasible->resize(NumNodes());
+  schedulable->resize(NumNodes());
+  CheckRows(total_checks, NumNodes(), feasible->data());
+  CheckRows(available_checks, NumNodes(), schedulable->data());
+}
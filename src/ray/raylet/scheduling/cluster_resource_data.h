@@ -45,10 +45,27 @@ struct ResourceCapacity {
   FixedPoint available;
 };
 
+/// Capacity of each instance of a resource that is split in unit instances.
+constexpr FixedPoint kUnitCapacity = FixedPoint(1);
+
 /// Capacities of each instance of a resource.
 struct ResourceInstanceCapacities {
   std::vector<FixedPoint> total;
   std::vector<FixedPoint> available;
+  /// Bitmap of the instances whose available capacity is a whole unit, one bit
+  /// per instance. Only used for resources split in unit instances, so that
+  /// whole instances are allocated with a find-first-set instead of a scan of
+  /// "available". Empty until ResetFreeUnits() is called.
+  std::vector<uint64_t> free_units;
+
+  /// Rebuild free_units from the available capacities.
+  void ResetFreeUnits();
+  /// Update the bit of an instance after its available capacity changed. This
+  /// is a no-op if free_units is not maintained for this resource.
+  void UpdateFreeUnit(size_t index);
+  /// Return the index of the first instance with a whole unit available at or
+  /// after "index", or -1 if there is none.
+  int64_t FindFreeUnit(size_t index) const;
 };
 
 struct ResourceRequest {
@@ -185,6 +202,53 @@ class NodeResourceInstances {
   std::string DebugString(StringIdMap string_to_int_map) const;
 };
 
+/// Columnar copy of the predefined resources of every node in the cluster.
+/// The total and available capacities of each predefined resource are kept in
+/// contiguous arrays of raw FixedPoint values, one entry per node, so the
+/// predefined resources of a task request can be checked against all nodes
+/// with vectorized compares instead of visiting each NodeResources in turn.
+class NodeResourceTable {
+ public:
+  /// Add a new node to the table or update the resources of an existing node.
+  ///
+  /// \param node_id: ID of the node.
+  /// \param resources: Up to date resources of the node.
+  void AddOrUpdateNode(int64_t node_id, const NodeResources &resources);
+
+  /// Remove a node from the table. The last row is moved into its place.
+  ///
+  /// \param node_id: ID of the node.
+  void RemoveNode(int64_t node_id);
+
+  /// Check the predefined resources of a task request against every node.
+  /// Custom resources and placement hints are not considered.
+  ///
+  /// \param task_req: Task request to be checked.
+  /// \param feasible: Set to 1 for each row whose total capacities cover
+  /// every predefined demand, and 0 otherwise.
+  /// \param schedulable: Set to 1 for each row whose available capacities
+  /// cover every hard predefined demand, and 0 otherwise.
+  void CheckPredefinedResources(const TaskRequest &task_req,
+                                std::vector<uint8_t> *feasible,
+                                std::vector<uint8_t> *schedulable) const;
+
+  /// Get the ID of the node stored in a row.
+  int64_t NodeIdAt(size_t row) const { return node_ids_[row]; }
+
+  /// Get number of nodes in the table.
+  size_t NumNodes() const { return node_ids_.size(); }
+
+ private:
+  /// ID of the node stored in each row.
+  std::vector<int64_t> node_ids_;
+  /// Row of each node.
+  absl::flat_hash_map<int64_t, size_t> rows_;
+  /// Raw total capacity of each predefined resource, indexed by row.
+  std::vector<int64_t> total_[PredefinedResources_MAX];
+  /// Raw available capacity of each predefined resource, indexed by row.
+  std::vector<int64_t> available_[PredefinedResources_MAX];
+};
+
 /// \request Conversion result to a TaskRequest data structure.
 NodeResources ResourceMapToNodeResources(
     StringIdMap &string_to_int_map,
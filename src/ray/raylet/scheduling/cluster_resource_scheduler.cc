@@ -21,14 +21,16 @@ namespace ray {
 
 ClusterResourceScheduler::ClusterResourceScheduler(
     int64_t local_node_id, const NodeResources &local_node_resources)
-    : local_node_id_(local_node_id) {
+    : node_index_enabled_(RayConfig::instance().scheduler_node_index_enabled()),
+      local_node_id_(local_node_id) {
   AddOrUpdateNode(local_node_id_, local_node_resources);
   InitLocalResources(local_node_resources);
 }
 
 ClusterResourceScheduler::ClusterResourceScheduler(
     const std::string &local_node_id,
-    const std::unordered_map<std::string, double> &local_node_resources) {
+    const std::unordered_map<std::string, double> &local_node_resources)
+    : node_index_enabled_(RayConfig::instance().scheduler_node_index_enabled()) {
   local_node_id_ = string_to_int_map_.Insert(local_node_id);
   NodeResources node_resources = ResourceMapToNodeResources(
       string_to_int_map_, local_node_resources, local_node_resources);
@@ -51,11 +53,14 @@ void ClusterResourceScheduler::AddOrUpdateNode(int64_t node_id,
   auto it = nodes_.find(node_id);
   if (it == nodes_.end()) {
     // This node is new, so add it to the map.
+    BumpIncreasedResources(nullptr, node_resources);
     nodes_.emplace(node_id, node_resources);
   } else {
     // This node exists, so update its resources.
+    BumpIncreasedResources(&it->second.GetLocalView(), node_resources);
     it->second = Node(node_resources);
   }
+  UpdateNodeIndexes(node_id, node_resources);
 }
 
 bool ClusterResourceScheduler::UpdateNode(const std::string &node_id_string,
@@ -103,6 +108,8 @@ bool ClusterResourceScheduler::RemoveNode(int64_t node_id) {
     return false;
   } else {
     nodes_.erase(it);
+    node_index_.RemoveNode(node_id);
+    node_table_.RemoveNode(node_id);
     string_to_int_map_.Remove(node_id);
     return true;
   }
@@ -126,6 +133,93 @@ bool ClusterResourceScheduler::IsLocallyFeasible(
   return IsFeasible(task_req, it->second.GetLocalView());
 }
 
+bool ClusterResourceScheduler::IsLocallySchedulable(
+    const std::unordered_map<std::string, double> &shape) {
+  return IsLocallySchedulable(ResourceMapToTaskRequest(string_to_int_map_, shape));
+}
+
+bool ClusterResourceScheduler::IsLocallySchedulable(SchedulingClass sched_cls) {
+  return IsLocallySchedulable(GetTaskRequest(sched_cls));
+}
+
+bool ClusterResourceScheduler::IsLocallySchedulable(const TaskRequest &task_req) {
+  const auto &it = nodes_.find(local_node_id_);
+  RAY_CHECK(it != nodes_.end());
+  return IsSchedulable(task_req, local_node_id_, it->second.GetLocalView()) == 0;
+}
+
+const TaskRequest &ClusterResourceScheduler::GetTaskRequest(SchedulingClass sched_cls) {
+  auto it = task_requests_.find(sched_cls);
+  if (it == task_requests_.end()) {
+    const auto &shape = TaskSpecification::GetSchedulingClassDescriptor(sched_cls);
+    it = task_requests_
+             .emplace(sched_cls, ResourceMapToTaskRequest(string_to_int_map_,
+                                                          shape.GetResourceMap()))
+             .first;
+  }
+  return it->second;
+}
+
+uint64_t ClusterResourceScheduler::GetResourceVersion(
+    const std::unordered_map<std::string, double> &shape) {
+  return GetResourceVersion(ResourceMapToTaskRequest(string_to_int_map_, shape));
+}
+
+uint64_t ClusterResourceScheduler::GetResourceVersion(SchedulingClass sched_cls) {
+  return GetResourceVersion(GetTaskRequest(sched_cls));
+}
+
+uint64_t ClusterResourceScheduler::GetResourceVersion(const TaskRequest &task_req) {
+  // The versions only grow, so their sum only changes if one of them does.
+  uint64_t version = 0;
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    if (task_req.predefined_resources[i].demand > 0) {
+      version += predefined_resource_versions_[i];
+    }
+  }
+  for (const auto &task_req_custom_resource : task_req.custom_resources) {
+    auto it = custom_resource_versions_.find(task_req_custom_resource.id);
+    if (it != custom_resource_versions_.end()) {
+      version += it->second;
+    }
+  }
+  return version;
+}
+
+void ClusterResourceScheduler::BumpIncreasedResources(const NodeResources *before,
+                                                      const NodeResources &after) {
+  const size_t num_predefined =
+      std::min<size_t>(PredefinedResources_MAX, after.predefined_resources.size());
+  for (size_t i = 0; i < num_predefined; i++) {
+    const auto &capacity = after.predefined_resources[i];
+    if (before == nullptr || i >= before->predefined_resources.size() ||
+        capacity.total > before->predefined_resources[i].total ||
+        capacity.available > before->predefined_resources[i].available) {
+      BumpResourceVersion(i, 0);
+    }
+  }
+  for (const auto &entry : after.custom_resources) {
+    if (before == nullptr) {
+      BumpResourceVersion(-1, entry.first);
+      continue;
+    }
+    auto it = before->custom_resources.find(entry.first);
+    if (it == before->custom_resources.end() || entry.second.total > it->second.total ||
+        entry.second.available > it->second.available) {
+      BumpResourceVersion(-1, entry.first);
+    }
+  }
+}
+
+void ClusterResourceScheduler::BumpResourceVersion(int predefined_index,
+                                                   int64_t resource_id) {
+  if (predefined_index != -1) {
+    predefined_resource_versions_[predefined_index]++;
+  } else {
+    custom_resource_versions_[resource_id]++;
+  }
+}
+
 bool ClusterResourceScheduler::IsFeasible(const TaskRequest &task_req,
                                           const NodeResources &resources) const {
   // First, check predefined resources.
@@ -211,14 +305,22 @@ int64_t ClusterResourceScheduler::IsSchedulable(const TaskRequest &task_req,
   return violations;
 }
 
-int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task_req,
-                                                         bool actor_creation,
-                                                         int64_t *total_violations,
-                                                         bool *is_infeasible) {
+int64_t ClusterResourceScheduler::GetBestSchedulableNode(
+    const TaskRequest &task_req, bool actor_creation, int64_t *total_violations,
+    bool *is_infeasible, rpc::SchedulingPolicyType policy_type) {
   // NOTE: We need to set `is_infeasible` to false in advance to avoid `is_infeasible` not
   // being set.
   *is_infeasible = false;
 
+  auto policy = GetNodeSelectionPolicy(policy_type);
+  if (policy != nullptr) {
+    int64_t node_id = policy->Schedule(task_req, *this);
+    if (node_id != -1) {
+      *total_violations = 0;
+      return node_id;
+    }
+  }
+
   // Minimum number of soft violations across all nodes that can schedule the request.
   // We will pick the node with the smallest number of soft violations.
   int64_t min_violations = INT_MAX;
@@ -268,13 +370,13 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task
 
   bool local_node_feasible = IsFeasible(task_req, local_node_it->second.GetLocalView());
 
-  for (const auto &node : nodes_) {
+  // Returns false once a node without violations is found, to stop the scan.
+  auto check_node = [&](int64_t node_id, const NodeResources &resources) {
     // Return -1 if node not schedulable. otherwise return the number
     // of soft constraint violations.
-    int64_t violations = IsSchedulable(task_req, node.first, node.second.GetLocalView());
+    int64_t violations = IsSchedulable(task_req, node_id, resources);
     if (violations == -1) {
-      if (!local_node_feasible && best_node == -1 &&
-          IsFeasible(task_req, node.second.GetLocalView())) {
+      if (!local_node_feasible && best_node == -1 && IsFeasible(task_req, resources)) {
         // If the local node is not feasible, and a better node has not yet
         // been found, and this node does not currently have the resources
         // available but is feasible, then schedule to this node.
@@ -283,19 +385,50 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task
         // appropriate total resources in a timely manner. If there are
         // multiple feasible nodes, this algorithm can still introduce delays
         // because of inefficient load-balancing.
-        best_node = node.first;
+        best_node = node_id;
       }
-      continue;
+      return true;
     }
 
     // Update the node with the smallest number of soft constraints violated.
     if (min_violations > violations) {
       min_violations = violations;
-      best_node = node.first;
+      best_node = node_id;
     }
-    if (violations == 0) {
-      // If violation is 0, we can schedule the task. So just break the loop
-      break;
+    // If violation is 0, we can schedule the task. So just stop the scan.
+    return violations != 0;
+  };
+
+  // Only visit the nodes that may have enough of the request's hard
+  // predefined demands available.
+  bool indexed =
+      node_index_enabled_ &&
+      node_index_.ForEachCandidateNode(task_req, [&](int64_t node_id) {
+        const auto it = nodes_.find(node_id);
+        RAY_CHECK(it != nodes_.end());
+        return check_node(node_id, it->second.GetLocalView());
+      });
+  if (!indexed || (best_node == -1 && !local_node_feasible)) {
+    // Either the index cannot narrow down the request, or no node has the
+    // resources available and we need to find a node on which the request
+    // is at least feasible.
+    // The predefined resources of all nodes are checked at once, and nodes
+    // that fail them are skipped unless they could still become best_node as
+    // a feasible fallback.
+    std::vector<uint8_t> feasible;
+    std::vector<uint8_t> schedulable;
+    node_table_.CheckPredefinedResources(task_req, &feasible, &schedulable);
+    for (size_t row = 0; row < node_table_.NumNodes(); row++) {
+      if (!schedulable[row] &&
+          (!feasible[row] || local_node_feasible || best_node != -1)) {
+        continue;
+      }
+      const int64_t node_id = node_table_.NodeIdAt(row);
+      const auto it = nodes_.find(node_id);
+      RAY_CHECK(it != nodes_.end());
+      if (!check_node(node_id, it->second.GetLocalView())) {
+        break;
+      }
     }
   }
   *total_violations = min_violations;
@@ -305,12 +438,166 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task
   return best_node;
 }
 
+std::vector<std::pair<int64_t, int64_t>>
+ClusterResourceScheduler::GetBestSchedulableNodes(
+    const TaskRequest &task_req, int64_t num_tasks, bool *is_infeasible) {
+  *is_infeasible = false;
+  std::vector<std::pair<int64_t, int64_t>> plan;
+  if (num_tasks <= 0) {
+    return plan;
+  }
+
+  // The local node is not charged for tasks until they are dispatched, so if
+  // it can schedule one task, it takes all of them.
+  const auto local_node_it = nodes_.find(local_node_id_);
+  RAY_CHECK(local_node_it != nodes_.end());
+  const auto &local_view = local_node_it->second.GetLocalView();
+  if (IsSchedulable(task_req, local_node_id_, local_view) == 0) {
+    plan.emplace_back(local_node_id_, num_tasks);
+    return plan;
+  }
+
+  // Collect the nodes that have the resources available and how many tasks
+  // each of them fits.
+  std::vector<std::pair<int64_t, int64_t>> candidates;
+  auto add_candidate = [&](int64_t node_id, const NodeResources &resources) {
+    if (IsSchedulable(task_req, node_id, resources) == 0) {
+      int64_t capacity = std::min(NumSchedulable(task_req, resources), num_tasks);
+      if (capacity > 0) {
+        candidates.emplace_back(node_id, capacity);
+      }
+    }
+    return true;
+  };
+  bool indexed =
+      node_index_enabled_ &&
+      node_index_.ForEachCandidateNode(task_req, [&](int64_t node_id) {
+        const auto it = nodes_.find(node_id);
+        RAY_CHECK(it != nodes_.end());
+        return add_candidate(node_id, it->second.GetLocalView());
+      });
+  if (!indexed) {
+    for (const auto &node : nodes_) {
+      add_candidate(node.first, node.second.GetLocalView());
+    }
+  }
+
+  // Spread the tasks round-robin over the candidates.
+  std::vector<int64_t> assigned(candidates.size(), 0);
+  int64_t remaining = num_tasks;
+  bool progress = true;
+  while (remaining > 0 && progress) {
+    progress = false;
+    for (size_t i = 0; i < candidates.size() && remaining > 0; i++) {
+      if (assigned[i] < candidates[i].second) {
+        assigned[i]++;
+        remaining--;
+        progress = true;
+      }
+    }
+  }
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (assigned[i] > 0) {
+      plan.emplace_back(candidates[i].first, assigned[i]);
+    }
+  }
+
+  if (remaining > 0 && !IsFeasible(task_req, local_view)) {
+    // Send the rest to a node on which the request is at least feasible, so
+    // that it does not wait here forever.
+    for (const auto &node : nodes_) {
+      if (IsFeasible(task_req, node.second.GetLocalView())) {
+        plan.emplace_back(node.first, remaining);
+        remaining = 0;
+        break;
+      }
+    }
+    *is_infeasible = plan.empty();
+  }
+  return plan;
+}
+
+std::vector<std::pair<std::string, int64_t>>
+ClusterResourceScheduler::GetBestSchedulableNodes(
+    const std::unordered_map<std::string, double> &task_resources, int64_t num_tasks,
+    bool *is_infeasible) {
+  TaskRequest task_request = ResourceMapToTaskRequest(string_to_int_map_, task_resources);
+  return ToNodeStrings(GetBestSchedulableNodes(task_request, num_tasks, is_infeasible));
+}
+
+std::vector<std::pair<std::string, int64_t>>
+ClusterResourceScheduler::GetBestSchedulableNodes(SchedulingClass sched_cls,
+                                                  int64_t num_tasks,
+                                                  bool *is_infeasible) {
+  return ToNodeStrings(
+      GetBestSchedulableNodes(GetTaskRequest(sched_cls), num_tasks, is_infeasible));
+}
+
+std::vector<std::pair<std::string, int64_t>> ClusterResourceScheduler::ToNodeStrings(
+    const std::vector<std::pair<int64_t, int64_t>> &plan) const {
+  std::vector<std::pair<std::string, int64_t>> result;
+  for (const auto &entry : plan) {
+    result.emplace_back(string_to_int_map_.Get(entry.first), entry.second);
+  }
+  return result;
+}
+
+int64_t ClusterResourceScheduler::NumSchedulable(const TaskRequest &task_req,
+                                                 const NodeResources &resources) const {
+  int64_t num_schedulable = std::numeric_limits<int64_t>::max();
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    const auto &demand = task_req.predefined_resources[i].demand;
+    if (demand > 0) {
+      num_schedulable = std::min(
+          num_schedulable,
+          resources.predefined_resources[i].available.Raw() / demand.Raw());
+    }
+  }
+  for (const auto &task_req_custom_resource : task_req.custom_resources) {
+    if (task_req_custom_resource.demand > 0) {
+      auto it = resources.custom_resources.find(task_req_custom_resource.id);
+      if (it == resources.custom_resources.end()) {
+        return 0;
+      }
+      num_schedulable =
+          std::min(num_schedulable,
+                   it->second.available.Raw() / task_req_custom_resource.demand.Raw());
+    }
+  }
+  return std::max<int64_t>(num_schedulable, 0);
+}
+
+const NodeResources &ClusterResourceScheduler::GetNodeView(int64_t node_id) const {
+  const auto it = nodes_.find(node_id);
+  RAY_CHECK(it != nodes_.end()) << "Node " << node_id << " is not in the cluster view";
+  return it->second.GetLocalView();
+}
+
+NodeSelectionPolicyInterface *ClusterResourceScheduler::GetNodeSelectionPolicy(
+    rpc::SchedulingPolicyType policy_type) {
+  if (policy_type == rpc::SchedulingPolicyType::DEFAULT_POLICY) {
+    return nullptr;
+  }
+  auto &policy = node_selection_policies_[policy_type];
+  if (policy == nullptr) {
+    policy = CreateNodeSelectionPolicy(policy_type);
+  }
+  return policy.get();
+}
+
+void ClusterResourceScheduler::UpdateNodeIndexes(int64_t node_id,
+                                                 const NodeResources &resources) {
+  node_index_.AddOrUpdateNode(node_id, resources);
+  node_table_.AddOrUpdateNode(node_id, resources);
+}
+
 std::string ClusterResourceScheduler::GetBestSchedulableNode(
     const std::unordered_map<std::string, double> &task_resources, bool actor_creation,
-    int64_t *total_violations, bool *is_infeasible) {
+    int64_t *total_violations, bool *is_infeasible,
+    rpc::SchedulingPolicyType policy_type) {
   TaskRequest task_request = ResourceMapToTaskRequest(string_to_int_map_, task_resources);
   int64_t node_id = GetBestSchedulableNode(task_request, actor_creation, total_violations,
-                                           is_infeasible);
+                                           is_infeasible, policy_type);
 
   std::string id_string;
   if (node_id == -1) {
@@ -321,6 +608,17 @@ std::string ClusterResourceScheduler::GetBestSchedulableNode(
   return string_to_int_map_.Get(node_id);
 }
 
+std::string ClusterResourceScheduler::GetBestSchedulableNode(
+    SchedulingClass sched_cls, bool actor_creation, int64_t *total_violations,
+    bool *is_infeasible, rpc::SchedulingPolicyType policy_type) {
+  int64_t node_id = GetBestSchedulableNode(GetTaskRequest(sched_cls), actor_creation,
+                                           total_violations, is_infeasible, policy_type);
+  if (node_id == -1) {
+    return "";
+  }
+  return string_to_int_map_.Get(node_id);
+}
+
 bool ClusterResourceScheduler::SubtractRemoteNodeAvailableResources(
     int64_t node_id, const TaskRequest &task_req) {
   RAY_CHECK(node_id != local_node_id_);
@@ -351,6 +649,7 @@ bool ClusterResourceScheduler::SubtractRemoteNodeAvailableResources(
           std::max(FixedPoint(0), it->second.available - task_req_custom_resource.demand);
     }
   }
+  UpdateNodeIndexes(node_id, *resources);
   return true;
 }
 
@@ -389,6 +688,7 @@ void ClusterResourceScheduler::AddLocalResource(const std::string &resource_name
         local_node_it->second.GetMutableLocalView()->custom_resources[resource_id];
     capacity.available += total;
     capacity.total += total;
+    BumpResourceVersion(-1, resource_id);
   } else {
     ResourceInstanceCapacities capacity;
     capacity.total.resize(1);
@@ -473,6 +773,7 @@ void ClusterResourceScheduler::UpdateResourceCapacity(const std::string &node_id
     if (local_view->predefined_resources[idx].total < 0) {
       local_view->predefined_resources[idx].total = 0;
     }
+    BumpResourceVersion(idx, 0);
   } else {
     string_to_int_map_.Insert(resource_name);
     int64_t resource_id = string_to_int_map_.Get(resource_name);
@@ -492,7 +793,9 @@ void ClusterResourceScheduler::UpdateResourceCapacity(const std::string &node_id
       resource_capacity.total = resource_capacity.available = resource_total_fp;
       local_view->custom_resources.emplace(resource_id, resource_capacity);
     }
+    BumpResourceVersion(-1, resource_id);
   }
+  UpdateNodeIndexes(node_id, *local_view);
 }
 
 void ClusterResourceScheduler::DeleteLocalResource(const std::string &resource_name) {
@@ -520,17 +823,25 @@ void ClusterResourceScheduler::DeleteResource(const std::string &node_id_string,
   auto local_view = it->second.GetMutableLocalView();
   if (idx != -1) {
     local_view->predefined_resources[idx].total = 0;
+    UpdateNodeIndexes(node_id, *local_view);
+    // Losing a resource may make the local node infeasible, in which case
+    // requests should be spilled to remote nodes instead.
+    BumpResourceVersion(idx, 0);
 
     if (node_id == local_node_id_) {
       local_resources_.predefined_resources[idx].total.clear();
       local_resources_.predefined_resources[idx].available.clear();
+      local_resources_.predefined_resources[idx].free_units.clear();
     }
   } else {
     int64_t resource_id = string_to_int_map_.Get(resource_name);
+    BumpResourceVersion(-1, resource_id);
     auto itr = local_view->custom_resources.find(resource_id);
     if (itr != local_view->custom_resources.end()) {
       string_to_int_map_.Remove(resource_id);
       local_view->custom_resources.erase(itr);
+      // The resource may get another ID if it is added back.
+      task_requests_.clear();
     }
 
     auto c_itr = local_resources_.custom_resources.find(resource_id);
@@ -560,12 +871,14 @@ void ClusterResourceScheduler::InitResourceInstances(
     instance_list->total.resize(num_instances);
     instance_list->available.resize(num_instances);
     for (size_t i = 0; i < num_instances; i++) {
-      instance_list->total[i] = instance_list->available[i] = 1.0;
+      instance_list->total[i] = instance_list->available[i] = kUnitCapacity;
     };
+    instance_list->ResetFreeUnits();
   } else {
     instance_list->total.resize(1);
     instance_list->available.resize(1);
     instance_list->total[0] = instance_list->available[0] = total;
+    instance_list->free_units.clear();
   }
 }
 
@@ -610,6 +923,7 @@ std::vector<FixedPoint> ClusterResourceScheduler::AddAvailableResourceInstances(
       overflow[i] = (resource_instances->available[i] - resource_instances->total[i]);
       resource_instances->available[i] = resource_instances->total[i];
     }
+    resource_instances->UpdateFreeUnit(i);
   }
 
   return overflow;
@@ -636,13 +950,15 @@ std::vector<FixedPoint> ClusterResourceScheduler::SubtractAvailableResourceInsta
         resource_instances->available[i] = 0;
       }
     }
+    resource_instances->UpdateFreeUnit(i);
   }
   return underflow;
 }
 
 bool ClusterResourceScheduler::AllocateResourceInstances(
-    FixedPoint demand, bool soft, std::vector<FixedPoint> &available,
+    FixedPoint demand, bool soft, ResourceInstanceCapacities *instances,
     std::vector<FixedPoint> *allocation) {
+  auto &available = instances->available;
   allocation->resize(available.size());
   FixedPoint remaining_demand = demand;
 
@@ -673,17 +989,20 @@ bool ClusterResourceScheduler::AllocateResourceInstances(
   // If resource constraint is soft, allocate as many full unit-capacity resources and
   // then distribute remaining_demand across remaining instances. Note that in case we can
   // overallocate this resource.
-  if (remaining_demand >= 1.) {
-    for (size_t i = 0; i < available.size(); i++) {
-      if (available[i] == 1.) {
-        // Allocate a full unit-capacity instance.
-        (*allocation)[i] = 1.;
-        available[i] = 0;
-        remaining_demand -= 1.;
-      }
-      if (remaining_demand < 1.) {
-        break;
-      }
+  if (instances->free_units.size() != (available.size() + 63) / 64) {
+    instances->ResetFreeUnits();
+  }
+  if (remaining_demand >= kUnitCapacity) {
+    // Full instances are found through the bitmap of free units, in the same order as
+    // a scan of "available" would find them.
+    for (int64_t i = instances->FindFreeUnit(0);
+         i != -1 && remaining_demand >= kUnitCapacity;
+         i = instances->FindFreeUnit(i + 1)) {
+      // Allocate a full unit-capacity instance.
+      (*allocation)[i] = kUnitCapacity;
+      available[i] = 0;
+      instances->UpdateFreeUnit(i);
+      remaining_demand -= kUnitCapacity;
     }
   }
 
@@ -693,25 +1012,27 @@ bool ClusterResourceScheduler::AllocateResourceInstances(
       if (available[i] >= remaining_demand) {
         available[i] -= remaining_demand;
         (*allocation)[i] = remaining_demand;
+        instances->UpdateFreeUnit(i);
         return true;
       } else {
         (*allocation)[i] += available[i];
         remaining_demand -= available[i];
         available[i] = 0;
+        instances->UpdateFreeUnit(i);
       }
     }
     return true;
   }
 
-  if (remaining_demand >= 1.) {
+  if (remaining_demand >= kUnitCapacity) {
     // Cannot satisfy a demand greater than one if no unit capacity resource is available.
     return false;
   }
 
   // Remaining demand is fractional. Find the best fit, if exists.
-  if (remaining_demand > 0.) {
+  if (remaining_demand > FixedPoint()) {
     int64_t idx_best_fit = -1;
-    FixedPoint available_best_fit = 1.;
+    FixedPoint available_best_fit = kUnitCapacity;
     for (size_t i = 0; i < available.size(); i++) {
       if (available[i] >= remaining_demand) {
         if (idx_best_fit == -1 ||
@@ -726,6 +1047,7 @@ bool ClusterResourceScheduler::AllocateResourceInstances(
     } else {
       (*allocation)[idx_best_fit] = remaining_demand;
       available[idx_best_fit] -= remaining_demand;
+      instances->UpdateFreeUnit(idx_best_fit);
     }
   }
   return true;
@@ -743,7 +1065,7 @@ bool ClusterResourceScheduler::AllocateTaskResourceInstances(
     if (task_req.predefined_resources[i].demand > 0) {
       if (!AllocateResourceInstances(task_req.predefined_resources[i].demand,
                                      task_req.predefined_resources[i].soft,
-                                     local_resources_.predefined_resources[i].available,
+                                     &local_resources_.predefined_resources[i],
                                      &task_allocation->predefined_resources[i])) {
         // Allocation failed. Restore node's local resources by freeing the resources
         // of the failed allocation.
@@ -760,7 +1082,7 @@ bool ClusterResourceScheduler::AllocateTaskResourceInstances(
         std::vector<FixedPoint> allocation;
         bool success = AllocateResourceInstances(task_req_custom_resource.demand,
                                                  task_req_custom_resource.soft,
-                                                 it->second.available, &allocation);
+                                                 &it->second, &allocation);
         // Even if allocation failed we need to remember partial allocations to correctly
         // free resources.
         task_allocation->custom_resources.emplace(it->first, allocation);
@@ -801,6 +1123,7 @@ void ClusterResourceScheduler::UpdateLocalAvailableResourcesFromResourceInstance
       }
     }
   }
+  UpdateNodeIndexes(local_node_id_, *local_view);
 }
 
 void ClusterResourceScheduler::FreeTaskResourceInstances(
@@ -907,6 +1230,12 @@ bool ClusterResourceScheduler::AllocateLocalTaskResources(
   return AllocateLocalTaskResources(task_request, task_allocation);
 }
 
+bool ClusterResourceScheduler::AllocateLocalTaskResources(
+    SchedulingClass sched_cls, std::shared_ptr<TaskResourceInstances> task_allocation) {
+  RAY_CHECK(task_allocation != nullptr);
+  return AllocateLocalTaskResources(GetTaskRequest(sched_cls), task_allocation);
+}
+
 std::string ClusterResourceScheduler::GetResourceNameFromIndex(int64_t res_idx) {
   if (res_idx == CPU) {
     return ray::kCPU_ResourceLabel;
@@ -930,6 +1259,13 @@ bool ClusterResourceScheduler::AllocateRemoteTaskResources(
   return SubtractRemoteNodeAvailableResources(node_id, task_request);
 }
 
+bool ClusterResourceScheduler::AllocateRemoteTaskResources(const std::string &node_string,
+                                                           SchedulingClass sched_cls) {
+  auto node_id = string_to_int_map_.Insert(node_string);
+  RAY_CHECK(node_id != local_node_id_);
+  return SubtractRemoteNodeAvailableResources(node_id, GetTaskRequest(sched_cls));
+}
+
 void ClusterResourceScheduler::ReleaseWorkerResources(
     std::shared_ptr<TaskResourceInstances> task_allocation) {
   if (task_allocation == nullptr || task_allocation->IsEmpty()) {
@@ -967,8 +1303,11 @@ void ClusterResourceScheduler::FillResourceUsage(
   // node. Then, the remote node's resource availability may not change and
   // so it may not send us another update.
   for (auto &node : nodes_) {
-    if (node.first != local_node_id_) {
+    if (node.first != local_node_id_ && node.second.IsDirty()) {
+      NodeResources before = node.second.GetLocalView();
       node.second.ResetLocalView();
+      BumpIncreasedResources(&before, node.second.GetLocalView());
+      UpdateNodeIndexes(node.first, node.second.GetLocalView());
     }
   }
 
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -21,9 +22,12 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "ray/common/task/scheduling_resources.h"
+#include "ray/common/task/task_spec.h"
 #include "ray/raylet/scheduling/cluster_resource_data.h"
 #include "ray/raylet/scheduling/cluster_resource_scheduler_interface.h"
 #include "ray/raylet/scheduling/fixed_point.h"
+#include "ray/raylet/scheduling/node_resource_index.h"
+#include "ray/raylet/scheduling/node_selection_policy.h"
 #include "ray/raylet/scheduling/scheduling_ids.h"
 #include "ray/util/logging.h"
 #include "src/ray/protobuf/gcs.pb.h"
@@ -38,7 +42,8 @@ static std::unordered_set<int64_t> UnitInstanceResources{CPU, GPU, TPU};
 /// Class encapsulating the cluster resources and the logic to assign
 /// tasks to nodes based on the task's constraints and the available
 /// resources at those nodes.
-class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
+class ClusterResourceScheduler : public ClusterResourceSchedulerInterface,
+                                 public ClusterResourceViewInterface {
  public:
   ClusterResourceScheduler(void){};
 
@@ -87,6 +92,41 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   /// \param shape The resource demand's shape.
   bool IsLocallyFeasible(const std::unordered_map<std::string, double> shape);
 
+  /// Check whether a task request can be scheduled on the local node now,
+  /// i.e., whether the local node has the requested resources available.
+  ///
+  /// \param shape The resource demand's shape.
+  bool IsLocallySchedulable(const std::unordered_map<std::string, double> &shape);
+
+  /// Similar to IsLocallySchedulable above, but takes the scheduling class
+  /// whose descriptor is the shape.
+  bool IsLocallySchedulable(SchedulingClass sched_cls);
+
+  /// Get the version of the resources requested by a shape. The version
+  /// changes whenever the capacity of any of those resources may have grown
+  /// on some node: a node was added or reported more resources, a node's
+  /// capacity was updated or deleted, or resources we spilled to a node were
+  /// given back on a heartbeat tick. Allocations on the local node do not
+  /// change it. If no node could schedule the shape and the version has not
+  /// changed since, then still no node other than possibly the local one can.
+  ///
+  /// \param shape The resource demand's shape.
+  uint64_t GetResourceVersion(const std::unordered_map<std::string, double> &shape);
+
+  /// Similar to GetResourceVersion above, but takes the scheduling class
+  /// whose descriptor is the shape.
+  uint64_t GetResourceVersion(SchedulingClass sched_cls);
+
+  /// Get the task request of the resource shape of a scheduling class. Each
+  /// class is converted once, and the same immutable request is returned for
+  /// all the tasks of the class, so scheduling them does not hash resource
+  /// names or allocate.
+  ///
+  /// \param sched_cls: Scheduling class whose descriptor is the shape.
+  /// \return The task request. The reference is valid until a custom resource
+  /// is deleted.
+  const TaskRequest &GetTaskRequest(SchedulingClass sched_cls);
+
   /// Check whether a task request is feasible on a given node. A node is
   /// feasible if it has the total resources needed to eventually execute the
   /// task, even if those resources are currently allocated.
@@ -110,7 +150,7 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   ///           >= 0, the number soft constraint violations. If 0, no
   ///           constraint is violated.
   int64_t IsSchedulable(const TaskRequest &task_req, int64_t node_id,
-                        const NodeResources &resources) const;
+                        const NodeResources &resources) const override;
 
   ///  Find a node in the cluster on which we can schedule a given task request.
   ///
@@ -134,6 +174,14 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   ///  should queue the task and try again once resource availability has been
   ///  updated.
   ///
+  ///  When the request has a hard demand for a predefined resource, only the
+  ///  nodes that the availability index reports as possibly fitting that
+  ///  demand are considered, instead of every node in the cluster.
+  ///
+  ///  A policy other than the default one first picks among the nodes that
+  ///  have the resources available, see NodeSelectionPolicyInterface. If no
+  ///  such node is found, the default policy above is applied.
+  ///
   ///  \param task_request: Task to be scheduled.
   ///  \param actor_creation: True if this is an actor creation task.
   ///  \param violations: The number of soft constraint violations associated
@@ -141,11 +189,14 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   ///                     a node that can schedule task_req is found).
   ///  \param is_infeasible[in]: It is set true if the task is not schedulable because it
   ///  is infeasible.
+  ///  \param policy_type: The policy of the job the task belongs to.
   ///
   ///  \return -1, if no node can schedule the current request; otherwise,
   ///          return the ID of a node that can schedule the task request.
-  int64_t GetBestSchedulableNode(const TaskRequest &task_request, bool actor_creation,
-                                 int64_t *violations, bool *is_infeasible);
+  int64_t GetBestSchedulableNode(
+      const TaskRequest &task_request, bool actor_creation, int64_t *violations,
+      bool *is_infeasible,
+      rpc::SchedulingPolicyType policy_type = rpc::SchedulingPolicyType::DEFAULT_POLICY);
 
   /// Similar to
   ///    int64_t GetBestSchedulableNode(const TaskRequest &task_request, int64_t
@@ -156,7 +207,45 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   //           task request.
   std::string GetBestSchedulableNode(
       const std::unordered_map<std::string, double> &task_request, bool actor_creation,
-      int64_t *violations, bool *is_infeasible);
+      int64_t *violations, bool *is_infeasible,
+      rpc::SchedulingPolicyType policy_type = rpc::SchedulingPolicyType::DEFAULT_POLICY);
+
+  /// Similar to the string version above, but takes the scheduling class
+  /// whose descriptor is the requested resources.
+  std::string GetBestSchedulableNode(
+      SchedulingClass sched_cls, bool actor_creation, int64_t *violations,
+      bool *is_infeasible,
+      rpc::SchedulingPolicyType policy_type = rpc::SchedulingPolicyType::DEFAULT_POLICY);
+
+  /// Compute where to place a batch of identical task requests with a single
+  /// pass over the cluster, instead of calling GetBestSchedulableNode once per
+  /// task. The plan follows the same preferences as GetBestSchedulableNode:
+  ///  1. If the local node can schedule the request, place every task there.
+  ///  2. Otherwise, spread the tasks round-robin over the nodes that have the
+  ///     resources available, up to the number of tasks each of them fits.
+  ///  3. If the local node is not feasible, place the remaining tasks on a
+  ///     remote node on which the request is at least feasible.
+  /// Tasks that cannot be placed are left out of the plan. Soft constraints
+  /// and placement hints of the request are not taken into account.
+  ///
+  /// \param task_request: Request shared by all the tasks.
+  /// \param num_tasks: Number of tasks to be placed.
+  /// \param is_infeasible[out]: Set true if the request is infeasible.
+  ///
+  /// \return Pairs of node ID and number of tasks to place on that node.
+  std::vector<std::pair<int64_t, int64_t>> GetBestSchedulableNodes(
+      const TaskRequest &task_request, int64_t num_tasks, bool *is_infeasible);
+
+  /// Similar to GetBestSchedulableNodes above, but takes and returns
+  /// resources and node IDs in string format.
+  std::vector<std::pair<std::string, int64_t>> GetBestSchedulableNodes(
+      const std::unordered_map<std::string, double> &task_request, int64_t num_tasks,
+      bool *is_infeasible);
+
+  /// Similar to the string version above, but takes the scheduling class
+  /// whose descriptor is the requested resources.
+  std::vector<std::pair<std::string, int64_t>> GetBestSchedulableNodes(
+      SchedulingClass sched_cls, int64_t num_tasks, bool *is_infeasible);
 
   /// Return resources associated to the given node_id in ret_resources.
   /// If node_id not found, return false; otherwise return true.
@@ -168,6 +257,12 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   /// Get number of nodes in the cluster.
   int64_t NumNodes();
 
+  /// Implements ClusterResourceViewInterface, for the node selection policies.
+  int64_t GetLocalNodeId() const override { return local_node_id_; }
+  size_t NumNodesInView() const override { return node_table_.NumNodes(); }
+  int64_t NodeIdAt(size_t index) const override { return node_table_.NodeIdAt(index); }
+  const NodeResources &GetNodeView(int64_t node_id) const override;
+
   /// Add a local resource that is available.
   ///
   /// \param resource_name: Resource which we want to update.
@@ -249,14 +344,15 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   ///
   /// \param demand: The resource amount to be allocated.
   /// \param soft: Specifies whether this demand has soft or hard constraints.
-  /// \param available: List of available capacities of the instances of the resource.
+  /// \param instances: Capacities of the instances of the resource. Their available
+  /// capacities are updated with the allocation.
   /// \param allocation: List of instance capacities allocated to satisfy the demand.
   /// This is a return parameter.
   ///
   /// \return true, if allocation successful. In this case, the sum of the elements in
   /// "allocation" is equal to "demand".
   bool AllocateResourceInstances(FixedPoint demand, bool soft,
-                                 std::vector<FixedPoint> &available,
+                                 ResourceInstanceCapacities *instances,
                                  std::vector<FixedPoint> *allocation);
 
   /// Allocate local resources to satisfy a given request (task_req).
@@ -350,6 +446,9 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   bool AllocateLocalTaskResources(const TaskRequest &task_request,
                                   std::shared_ptr<TaskResourceInstances> task_allocation);
 
+  bool AllocateLocalTaskResources(SchedulingClass sched_cls,
+                                  std::shared_ptr<TaskResourceInstances> task_allocation);
+
   /// Subtract the resources required by a given task request (task_req) from a given
   /// remote node.
   ///
@@ -361,6 +460,8 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
       const std::string &node_id,
       const std::unordered_map<std::string, double> &task_resources);
 
+  bool AllocateRemoteTaskResources(const std::string &node_id, SchedulingClass sched_cls);
+
   void ReleaseWorkerResources(std::shared_ptr<TaskResourceInstances> task_allocation);
 
   /// Update the available resources of the local node given
@@ -397,9 +498,18 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
     Node(const NodeResources &resources)
         : last_reported_(resources), local_view_(resources) {}
 
-    void ResetLocalView() { local_view_ = last_reported_; }
+    void ResetLocalView() {
+      local_view_ = last_reported_;
+      dirty_ = false;
+    }
 
-    NodeResources *GetMutableLocalView() { return &local_view_; }
+    NodeResources *GetMutableLocalView() {
+      dirty_ = true;
+      return &local_view_;
+    }
+
+    /// Whether the local view may differ from the last reported one.
+    bool IsDirty() const { return dirty_; }
 
     const NodeResources &GetLocalView() const { return local_view_; }
 
@@ -417,6 +527,8 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
     /// make sure that our local view does not skew too much from the actual
     /// resources when light heartbeats are enabled.
     NodeResources local_view_;
+    /// Whether the local view was modified since the last reset.
+    bool dirty_ = false;
   };
 
   /// Decrease the available resources of a node when a task request is
@@ -430,9 +542,65 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   bool SubtractRemoteNodeAvailableResources(int64_t node_id,
                                             const TaskRequest &task_request);
 
+  /// Check whether a task request can be scheduled on the local node now.
+  bool IsLocallySchedulable(const TaskRequest &task_req);
+
+  /// Get the version of the resources requested by a task request. See the
+  /// public GetResourceVersion.
+  uint64_t GetResourceVersion(const TaskRequest &task_req);
+
+  /// Convert the node IDs of a plan computed by GetBestSchedulableNodes to
+  /// their string format.
+  std::vector<std::pair<std::string, int64_t>> ToNodeStrings(
+      const std::vector<std::pair<int64_t, int64_t>> &plan) const;
+
+  /// Return how many copies of a task request fit in the available resources
+  /// of a node at once.
+  int64_t NumSchedulable(const TaskRequest &task_req,
+                         const NodeResources &resources) const;
+
+  /// Bump the version of every resource whose total or available capacity
+  /// is larger in `after` than in `before`.
+  ///
+  /// \param before: Resources of a node before an update, or nullptr if the
+  /// node is new.
+  /// \param after: Resources of the node after the update.
+  void BumpIncreasedResources(const NodeResources *before, const NodeResources &after);
+
+  /// Bump the version of a single resource.
+  ///
+  /// \param predefined_index: Index of the predefined resource, or -1 if
+  /// this is a custom resource.
+  /// \param resource_id: ID of the custom resource.
+  void BumpResourceVersion(int predefined_index, int64_t resource_id);
+
+  /// Get the policy of the given type, creating it on first use.
+  ///
+  /// \return The policy, or nullptr for the default policy.
+  NodeSelectionPolicyInterface *GetNodeSelectionPolicy(
+      rpc::SchedulingPolicyType policy_type);
+
+  /// Update node_index_ and node_table_ after a node's local view changed.
+  ///
+  /// \param node_id: ID of the node.
+  /// \param resources: Up to date local view of the node.
+  void UpdateNodeIndexes(int64_t node_id, const NodeResources &resources);
+
   /// List of nodes in the clusters and their resources organized as a map.
   /// The key of the map is the node ID.
   absl::flat_hash_map<int64_t, Node> nodes_;
+  /// Index of the nodes by available capacity of each predefined resource.
+  /// This must be kept in sync with the local views in nodes_.
+  NodeResourceIndex node_index_;
+  /// Whether node selection uses node_index_. See scheduler_node_index_enabled.
+  bool node_index_enabled_;
+  /// Columnar copy of the predefined resources in the local views in nodes_,
+  /// used to check a request against all nodes at once.
+  NodeResourceTable node_table_;
+  /// Version of each predefined resource. See GetResourceVersion.
+  std::array<uint64_t, PredefinedResources_MAX> predefined_resource_versions_{};
+  /// Version of each custom resource. See GetResourceVersion.
+  absl::flat_hash_map<int64_t, uint64_t> custom_resource_versions_;
   /// Identifier of local node.
   int64_t local_node_id_;
   /// Resources of local node.
@@ -440,6 +608,12 @@ class ClusterResourceScheduler : public ClusterResourceSchedulerInterface {
   /// Keep the mapping between node and resource IDs in string representation
   /// to integer representation. Used for improving map performance.
   StringIdMap string_to_int_map_;
+  /// Interned task request of each scheduling class. See GetTaskRequest.
+  std::unordered_map<SchedulingClass, TaskRequest> task_requests_;
+  /// The node selection policies that have been used so far, by type. The
+  /// policies keep state, e.g. the position of a round-robin, across requests.
+  absl::flat_hash_map<int, std::unique_ptr<NodeSelectionPolicyInterface>>
+      node_selection_policies_;
   /// Cached resources, used to compare with newest one in light heartbeat mode.
   std::unique_ptr<NodeResources> last_report_resources_;
 };
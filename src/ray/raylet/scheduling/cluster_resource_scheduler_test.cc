@@ -14,16 +14,17 @@
 
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 
+#include <chrono>
 #include <string>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
 #include "ray/common/task/scheduling_resources.h"
 #include "ray/raylet/scheduling/scheduling_ids.h"
+#include "ray/util/util.h"
 
 #ifdef UNORDERED_VS_ABSL_MAPS_EVALUATION
-#include <chrono>
-
 #include "absl/container/flat_hash_map.h"
 #endif  // UNORDERED_VS_ABSL_MAPS_EVALUATION
 
@@ -239,6 +240,16 @@ TEST_F(ClusterResourceSchedulerTest, SchedulingFixedPointTest) {
 
     ASSERT_TRUE(fp1.Double() == 1.);
   }
+
+  {
+    // Integer operations are evaluated at compile time.
+    constexpr FixedPoint fp1(1);
+    constexpr FixedPoint fp2(2);
+    static_assert((fp1 + fp2).Raw() == 3 * RESOURCE_UNIT_SCALING, "");
+    static_assert(fp2 - fp1 == fp1, "");
+    static_assert(-fp1 < FixedPoint(), "");
+    static_assert(FixedPoint::FromRaw(RESOURCE_UNIT_SCALING / 2).Double() == 0.5, "");
+  }
 }
 
 TEST_F(ClusterResourceSchedulerTest, SchedulingIdTest) {
@@ -880,6 +891,60 @@ TEST_F(ClusterResourceSchedulerTest, TaskResourceInstancesTest2) {
   }
 }
 
+TEST_F(ClusterResourceSchedulerTest, UnitInstanceAllocationTest) {
+  NodeResources node_resources;
+  vector<FixedPoint> pred_capacities{130. /* CPU */};
+  initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                    EmptyFixedPointVector);
+  ClusterResourceScheduler resource_scheduler(0, node_resources);
+  NodeResourceInstances old_local_resources = resource_scheduler.GetLocalResources();
+
+  // Leave a fractional capacity on an instance of the second bitmap word.
+  std::vector<double> fractional_instances(130, 0.);
+  fractional_instances[64] = 0.5;
+  resource_scheduler.SubtractCPUResourceInstances(fractional_instances);
+
+  TaskRequest task_req;
+  vector<FixedPoint> pred_demands = {100.5 /* CPU */};
+  vector<bool> pred_soft = {false};
+  initTaskRequest(task_req, pred_demands, pred_soft, EmptyIntVector,
+                  EmptyFixedPointVector, EmptyBoolVector, EmptyIntVector);
+  auto task_allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateTaskResourceInstances(task_req, task_allocation));
+
+  // Whole instances are allocated in order, skipping the fractional one, which
+  // is the best fit for the fractional demand.
+  auto cpu_instances = task_allocation->GetCPUInstancesDouble();
+  for (size_t i = 0; i < 101; i++) {
+    ASSERT_EQ(cpu_instances[i], i == 64 ? 0.5 : 1.);
+  }
+  for (size_t i = 101; i < 130; i++) {
+    ASSERT_EQ(cpu_instances[i], 0.);
+  }
+
+  // The remaining 29 instances cannot satisfy a larger demand.
+  TaskRequest large_task_req;
+  pred_demands = {30. /* CPU */};
+  initTaskRequest(large_task_req, pred_demands, pred_soft, EmptyIntVector,
+                  EmptyFixedPointVector, EmptyBoolVector, EmptyIntVector);
+  auto failed_allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_FALSE(resource_scheduler.AllocateTaskResourceInstances(large_task_req,
+                                                                failed_allocation));
+
+  resource_scheduler.FreeTaskResourceInstances(task_allocation);
+  resource_scheduler.AddCPUResourceInstances(fractional_instances);
+  ASSERT_TRUE(resource_scheduler.GetLocalResources() == old_local_resources);
+
+  // Freed instances are found again.
+  TaskRequest full_task_req;
+  pred_demands = {130. /* CPU */};
+  initTaskRequest(full_task_req, pred_demands, pred_soft, EmptyIntVector,
+                  EmptyFixedPointVector, EmptyBoolVector, EmptyIntVector);
+  auto full_allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(
+      resource_scheduler.AllocateTaskResourceInstances(full_task_req, full_allocation));
+}
+
 TEST_F(ClusterResourceSchedulerTest, TaskGPUResourceInstancesTest) {
   {
     NodeResources node_resources;
@@ -1204,6 +1269,373 @@ TEST_F(ClusterResourceSchedulerTest, AvailableResourceEmptyTest) {
   ASSERT_TRUE(resource_scheduler.IsAvailableResourceEmpty("custom123"));
 }
 
+TEST_F(ClusterResourceSchedulerTest, IndexedNodeSelectionTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 1}});
+  std::unordered_map<std::string, double> full_node({{"CPU", 8}});
+  for (int i = 0; i < 100; i++) {
+    resource_scheduler.AddOrUpdateNode(std::to_string(i), full_node, {{"CPU", 0.}});
+  }
+  int64_t total_violations;
+  bool is_infeasible;
+  std::unordered_map<std::string, double> task_request({{"CPU", 4}});
+
+  // Feasible everywhere but available nowhere; fall back to a feasible node.
+  std::string result = resource_scheduler.GetBestSchedulableNode(
+      task_request, false, &total_violations, &is_infeasible);
+  ASSERT_FALSE(result.empty());
+  ASSERT_FALSE(is_infeasible);
+
+  // The only node with enough available capacity must be picked.
+  resource_scheduler.AddOrUpdateNode("42", full_node, {{"CPU", 6.}});
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(task_request, false,
+                                                      &total_violations, &is_infeasible),
+            "42");
+
+  // Capacity subtracted from the node must be reflected in the index.
+  std::unordered_map<std::string, double> taken({{"CPU", 3}});
+  ASSERT_TRUE(resource_scheduler.AllocateRemoteTaskResources("42", taken));
+  resource_scheduler.AddOrUpdateNode("7", full_node, {{"CPU", 5.}});
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(task_request, false,
+                                                      &total_violations, &is_infeasible),
+            "7");
+
+  // Removed nodes must never be returned.
+  ASSERT_TRUE(resource_scheduler.RemoveNode("7"));
+  result = resource_scheduler.GetBestSchedulableNode(task_request, false,
+                                                     &total_violations, &is_infeasible);
+  ASSERT_NE(result, "7");
+  ASSERT_FALSE(result.empty());
+
+  // Requests with no predefined demand are still served by the full scan.
+  resource_scheduler.AddOrUpdateNode("custom", {{"custom", 1}}, {{"custom", 1}});
+  std::unordered_map<std::string, double> custom_request({{"custom", 1}});
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(custom_request, false,
+                                                      &total_violations, &is_infeasible),
+            "custom");
+}
+
+TEST_F(ClusterResourceSchedulerTest, IndexedNodeSelectionMatchesScanTest) {
+  const int num_nodes = 2000;
+  const int num_decisions = 1000;
+  std::unordered_map<std::string, double> task_request({{"CPU", 1}, {"memory", 1}});
+  // Only a few nodes are large enough for this request and none of them has it
+  // available, so the decision falls back to scanning all nodes.
+  std::unordered_map<std::string, double> large_request({{"CPU", 32}});
+
+  // Create the same cluster with and without the node index.
+  auto create_scheduler = [&](bool node_index_enabled) {
+    RayConfig::instance().initialize(
+        {{"scheduler_node_index_enabled", node_index_enabled ? "true" : "false"}});
+    auto resource_scheduler = std::make_shared<ClusterResourceScheduler>(
+        "local", std::unordered_map<std::string, double>({{"CPU", 0}}));
+    RayConfig::instance().initialize({{"scheduler_node_index_enabled", "true"}});
+    for (int i = 0; i < num_nodes; i++) {
+      double total = (i % 500 == 0) ? 64 : 16;
+      resource_scheduler->AddOrUpdateNode(std::to_string(i),
+                                          {{"CPU", total}, {"memory", 64}},
+                                          {{"CPU", 0}, {"memory", 64}});
+    }
+    return resource_scheduler;
+  };
+  auto indexed_scheduler = create_scheduler(/*node_index_enabled=*/true);
+  auto scan_scheduler = create_scheduler(/*node_index_enabled=*/false);
+
+  int64_t total_violations;
+  bool is_infeasible;
+  std::chrono::steady_clock::duration indexed_elapsed(0);
+  std::chrono::steady_clock::duration scan_elapsed(0);
+  auto get_best_node = [&](ClusterResourceScheduler &resource_scheduler,
+                           const std::unordered_map<std::string, double> &request,
+                           std::chrono::steady_clock::duration *elapsed) {
+    auto start = std::chrono::steady_clock::now();
+    std::string result = resource_scheduler.GetBestSchedulableNode(
+        request, false, &total_violations, &is_infeasible);
+    *elapsed += std::chrono::steady_clock::now() - start;
+    return result;
+  };
+
+  for (int i = 0; i < num_decisions; i++) {
+    // Only one node has CPUs available, so both paths must pick it.
+    const std::string node = std::to_string(rand() % num_nodes);
+    const double total = (std::stoi(node) % 500 == 0) ? 64 : 16;
+    for (auto resource_scheduler : {indexed_scheduler, scan_scheduler}) {
+      resource_scheduler->AddOrUpdateNode(node, {{"CPU", total}, {"memory", 64}},
+                                          {{"CPU", 16}, {"memory", 64}});
+    }
+    std::string indexed_result =
+        get_best_node(*indexed_scheduler, task_request, &indexed_elapsed);
+    ASSERT_EQ(indexed_result,
+              get_best_node(*scan_scheduler, task_request, &scan_elapsed));
+    ASSERT_EQ(indexed_result, node);
+
+    indexed_result = get_best_node(*indexed_scheduler, large_request, &indexed_elapsed);
+    ASSERT_EQ(indexed_result,
+              get_best_node(*scan_scheduler, large_request, &scan_elapsed));
+    ASSERT_EQ(std::stoi(indexed_result) % 500, 0);
+
+    for (auto resource_scheduler : {indexed_scheduler, scan_scheduler}) {
+      resource_scheduler->AddOrUpdateNode(node, {{"CPU", total}, {"memory", 64}},
+                                          {{"CPU", 0}, {"memory", 64}});
+    }
+  }
+  RAY_LOG(INFO) << 2 * num_decisions << " GetBestSchedulableNode decisions over "
+                << num_nodes << " nodes took "
+                << std::chrono::duration_cast<std::chrono::microseconds>(indexed_elapsed)
+                       .count()
+                << "us with the node index and "
+                << std::chrono::duration_cast<std::chrono::microseconds>(scan_elapsed)
+                       .count()
+                << "us without it";
+}
+
+TEST_F(ClusterResourceSchedulerTest, NodeResourceTableTest) {
+  NodeResourceTable table;
+  absl::flat_hash_map<int64_t, NodeResources> nodes;
+  // Use a number of nodes that is not a multiple of the vector width.
+  for (int64_t node_id = 0; node_id < 103; node_id++) {
+    vector<FixedPoint> pred_capacities;
+    for (int k = 0; k < PredefinedResources_MAX; k++) {
+      pred_capacities.push_back(rand() % 4);
+    }
+    NodeResources node_resources;
+    initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                      EmptyFixedPointVector);
+    for (auto &capacity : node_resources.predefined_resources) {
+      capacity.available = capacity.total - (rand() % 2);
+    }
+    table.AddOrUpdateNode(node_id, node_resources);
+    nodes[node_id] = node_resources;
+  }
+  for (int64_t node_id = 0; node_id < 103; node_id += 7) {
+    table.RemoveNode(node_id);
+    nodes.erase(node_id);
+  }
+  ASSERT_EQ(table.NumNodes(), nodes.size());
+
+  for (int i = 0; i < 100; i++) {
+    TaskRequest task_req;
+    vector<FixedPoint> pred_demands;
+    vector<bool> pred_soft;
+    for (int k = 0; k < PredefinedResources_MAX; k++) {
+      pred_demands.push_back(rand() % 3);
+      pred_soft.push_back(rand() % 2);
+    }
+    initTaskRequest(task_req, pred_demands, pred_soft, EmptyIntVector,
+                    EmptyFixedPointVector, EmptyBoolVector, EmptyIntVector);
+
+    std::vector<uint8_t> feasible;
+    std::vector<uint8_t> schedulable;
+    table.CheckPredefinedResources(task_req, &feasible, &schedulable);
+    ASSERT_EQ(feasible.size(), nodes.size());
+    for (size_t row = 0; row < table.NumNodes(); row++) {
+      const auto &node = nodes[table.NodeIdAt(row)];
+      bool expect_feasible = true;
+      bool expect_schedulable = true;
+      for (int k = 0; k < PredefinedResources_MAX; k++) {
+        const auto &request = task_req.predefined_resources[k];
+        const auto &capacity = node.predefined_resources[k];
+        expect_feasible &= request.demand <= capacity.total;
+        expect_schedulable &= request.soft || request.demand <= capacity.available;
+      }
+      ASSERT_EQ(feasible[row], expect_feasible);
+      ASSERT_EQ(schedulable[row], expect_schedulable);
+    }
+  }
+}
+
+TEST_F(ClusterResourceSchedulerTest, BatchSchedulingTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 4}});
+  std::unordered_map<std::string, double> task_request({{"CPU", 1}});
+  bool is_infeasible;
+
+  // The local node can run the tasks, so it takes all of them.
+  auto plan =
+      resource_scheduler.GetBestSchedulableNodes(task_request, 10, &is_infeasible);
+  ASSERT_FALSE(is_infeasible);
+  ASSERT_EQ(plan.size(), 1);
+  ASSERT_EQ(plan[0].first, "local");
+  ASSERT_EQ(plan[0].second, 10);
+
+  // The remote nodes are filled evenly up to their available capacity and
+  // the remaining tasks stay queued, since they are feasible locally.
+  std::shared_ptr<TaskResourceInstances> allocation =
+      std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"CPU", 4}}, allocation));
+  resource_scheduler.AddOrUpdateNode("remote1", {{"CPU", 8}}, {{"CPU", 3}});
+  resource_scheduler.AddOrUpdateNode("remote2", {{"CPU", 8}}, {{"CPU", 1}});
+  plan = resource_scheduler.GetBestSchedulableNodes(task_request, 10, &is_infeasible);
+  ASSERT_FALSE(is_infeasible);
+  std::unordered_map<std::string, int64_t> placed(plan.begin(), plan.end());
+  ASSERT_EQ(placed.size(), 2);
+  ASSERT_EQ(placed["remote1"], 3);
+  ASSERT_EQ(placed["remote2"], 1);
+
+  plan = resource_scheduler.GetBestSchedulableNodes(task_request, 2, &is_infeasible);
+  placed = std::unordered_map<std::string, int64_t>(plan.begin(), plan.end());
+  ASSERT_EQ(placed["remote1"], 1);
+  ASSERT_EQ(placed["remote2"], 1);
+
+  // Tasks that are not feasible locally are all sent to a feasible node.
+  std::unordered_map<std::string, double> large_request({{"CPU", 8}});
+  plan = resource_scheduler.GetBestSchedulableNodes(large_request, 3, &is_infeasible);
+  ASSERT_FALSE(is_infeasible);
+  ASSERT_EQ(plan.size(), 1);
+  ASSERT_EQ(plan[0].second, 3);
+
+  // Infeasible everywhere.
+  std::unordered_map<std::string, double> gpu_request({{"GPU", 1}});
+  plan = resource_scheduler.GetBestSchedulableNodes(gpu_request, 3, &is_infeasible);
+  ASSERT_TRUE(is_infeasible);
+  ASSERT_TRUE(plan.empty());
+}
+
+TEST_F(ClusterResourceSchedulerTest, ResourceVersionTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 4}});
+  std::unordered_map<std::string, double> cpu_request({{"CPU", 1}});
+  std::unordered_map<std::string, double> custom_request({{"custom", 1}});
+  uint64_t cpu_version = resource_scheduler.GetResourceVersion(cpu_request);
+  uint64_t custom_version = resource_scheduler.GetResourceVersion(custom_request);
+
+  // Local allocations do not change the version.
+  std::shared_ptr<TaskResourceInstances> allocation =
+      std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"CPU", 4}}, allocation));
+  ASSERT_FALSE(resource_scheduler.IsLocallySchedulable(cpu_request));
+  ASSERT_EQ(resource_scheduler.GetResourceVersion(cpu_request), cpu_version);
+
+  // A new node changes the version of the resources it has.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 4}}, {{"CPU", 2}});
+  ASSERT_NE(resource_scheduler.GetResourceVersion(cpu_request), cpu_version);
+  ASSERT_EQ(resource_scheduler.GetResourceVersion(custom_request), custom_version);
+  cpu_version = resource_scheduler.GetResourceVersion(cpu_request);
+
+  // Fewer resources do not change the version, more resources do.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 4}}, {{"CPU", 1}});
+  ASSERT_EQ(resource_scheduler.GetResourceVersion(cpu_request), cpu_version);
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 4}}, {{"CPU", 3}});
+  ASSERT_NE(resource_scheduler.GetResourceVersion(cpu_request), cpu_version);
+  cpu_version = resource_scheduler.GetResourceVersion(cpu_request);
+
+  // Resources spilled to a node are given back on the next heartbeat tick.
+  ASSERT_TRUE(resource_scheduler.AllocateRemoteTaskResources("remote", cpu_request));
+  ASSERT_EQ(resource_scheduler.GetResourceVersion(cpu_request), cpu_version);
+  auto data = std::make_shared<rpc::ResourcesData>();
+  resource_scheduler.FillResourceUsage(data);
+  ASSERT_NE(resource_scheduler.GetResourceVersion(cpu_request), cpu_version);
+  cpu_version = resource_scheduler.GetResourceVersion(cpu_request);
+  resource_scheduler.FillResourceUsage(data);
+  ASSERT_EQ(resource_scheduler.GetResourceVersion(cpu_request), cpu_version);
+
+  // Capacity updates change the version.
+  resource_scheduler.UpdateResourceCapacity("local", "custom", 1);
+  ASSERT_NE(resource_scheduler.GetResourceVersion(custom_request), custom_version);
+  ASSERT_EQ(resource_scheduler.GetResourceVersion(cpu_request), cpu_version);
+}
+
+TEST_F(ClusterResourceSchedulerTest, TaskRequestInterningTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 4}, {"custom", 2}});
+  const SchedulingClass sched_cls = TaskSpecification::GetSchedulingClass(
+      ResourceSet(std::unordered_map<std::string, double>({{"CPU", 2}, {"custom", 1}})));
+
+  // Each class is converted once.
+  const TaskRequest &task_request = resource_scheduler.GetTaskRequest(sched_cls);
+  ASSERT_EQ(&task_request, &resource_scheduler.GetTaskRequest(sched_cls));
+  ASSERT_EQ(task_request.predefined_resources[CPU].demand, 2);
+  ASSERT_EQ(task_request.custom_resources.size(), 1);
+  ASSERT_EQ(task_request.custom_resources[0].demand, 1);
+
+  auto allocation = std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources(sched_cls, allocation));
+  ASSERT_TRUE(resource_scheduler.IsLocallySchedulable(sched_cls));
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources(
+      sched_cls, std::make_shared<TaskResourceInstances>()));
+  ASSERT_FALSE(resource_scheduler.IsLocallySchedulable(sched_cls));
+
+  // Spill to a remote node through the interned request.
+  resource_scheduler.AddOrUpdateNode("remote", {{"CPU", 2}, {"custom", 1}},
+                                     {{"CPU", 2}, {"custom", 1}});
+  int64_t violations;
+  bool is_infeasible;
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(sched_cls, false, &violations,
+                                                      &is_infeasible),
+            "remote");
+  ASSERT_TRUE(resource_scheduler.AllocateRemoteTaskResources("remote", sched_cls));
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(sched_cls, false, &violations,
+                                                      &is_infeasible),
+            "");
+
+  // Requests are converted again after a custom resource is deleted.
+  resource_scheduler.ReleaseWorkerResources(allocation);
+  resource_scheduler.DeleteLocalResource("custom");
+  const TaskRequest &new_task_request = resource_scheduler.GetTaskRequest(sched_cls);
+  ASSERT_EQ(new_task_request.custom_resources.size(), 1);
+  ASSERT_EQ(new_task_request.custom_resources[0].demand, 1);
+}
+
+TEST_F(ClusterResourceSchedulerTest, NodeSelectionPolicyTest) {
+  ClusterResourceScheduler resource_scheduler("local", {{"CPU", 4}});
+  resource_scheduler.AddOrUpdateNode("remote1", {{"CPU", 4}}, {{"CPU", 4}});
+  resource_scheduler.AddOrUpdateNode("remote2", {{"CPU", 4}, {"GPU", 1}},
+                                     {{"CPU", 2}, {"GPU", 1}});
+  std::unordered_map<std::string, double> cpu_request({{"CPU", 1}});
+  int64_t violations;
+  bool is_infeasible;
+
+  // The hybrid policy packs onto the local node while it is below the
+  // threshold, then onto the next node below the threshold.
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(
+                cpu_request, false, &violations, &is_infeasible,
+                rpc::SchedulingPolicyType::HYBRID_POLICY),
+            "local");
+  std::shared_ptr<TaskResourceInstances> allocation =
+      std::make_shared<TaskResourceInstances>();
+  ASSERT_TRUE(resource_scheduler.AllocateLocalTaskResources({{"CPU", 3}}, allocation));
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(
+                cpu_request, false, &violations, &is_infeasible,
+                rpc::SchedulingPolicyType::HYBRID_POLICY),
+            "remote1");
+  // Once every node is above the threshold, it picks the least utilized.
+  resource_scheduler.AddOrUpdateNode("remote1", {{"CPU", 4}}, {{"CPU", 1}});
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(
+                cpu_request, false, &violations, &is_infeasible,
+                rpc::SchedulingPolicyType::HYBRID_POLICY),
+            "remote2");
+  // The default policy still prefers the local node.
+  ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(cpu_request, false, &violations,
+                                                      &is_infeasible),
+            "local");
+
+  // The spread policy visits every node with the resources available.
+  std::unordered_set<std::string> picked;
+  for (int i = 0; i < 3; i++) {
+    picked.insert(resource_scheduler.GetBestSchedulableNode(
+        cpu_request, false, &violations, &is_infeasible,
+        rpc::SchedulingPolicyType::SPREAD_POLICY));
+  }
+  ASSERT_EQ(picked.size(), 3);
+
+  // The random-of-two policy only picks nodes with the resources available,
+  // and falls back to the default policy if neither sample has them.
+  std::unordered_map<std::string, double> gpu_request({{"GPU", 1}});
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(
+                  gpu_request, false, &violations, &is_infeasible,
+                  rpc::SchedulingPolicyType::RANDOM_OF_TWO_POLICY),
+              "remote2");
+  }
+
+  // An infeasible request is reported as such under every policy.
+  std::unordered_map<std::string, double> infeasible_request({{"GPU", 2}});
+  for (auto policy_type : {rpc::SchedulingPolicyType::HYBRID_POLICY,
+                           rpc::SchedulingPolicyType::SPREAD_POLICY,
+                           rpc::SchedulingPolicyType::RANDOM_OF_TWO_POLICY}) {
+    ASSERT_EQ(resource_scheduler.GetBestSchedulableNode(
+                  infeasible_request, false, &violations, &is_infeasible, policy_type),
+              "");
+    ASSERT_TRUE(is_infeasible);
+  }
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -2,9 +2,12 @@
 
 #include <google/protobuf/map.h>
 
+#include <algorithm>
 #include <boost/range/join.hpp>
+#include <numeric>
 
 #include "ray/util/logging.h"
+#include "ray/util/util.h"
 
 namespace ray {
 namespace raylet {
@@ -12,6 +15,16 @@ namespace raylet {
 // The max number of pending actors to report in node stats.
 const int kMaxPendingActorsToReport = 20;
 
+namespace {
+
+// Whether the rank of a task differs from the one of a task without a priority or a
+// deadline queued at the same time.
+bool HasPriorityOrDeadline(const TaskSpecification &spec) {
+  return spec.GetPriority() != 0 || spec.GetDeadlineMs() > 0;
+}
+
+}  // namespace
+
 ClusterTaskManager::ClusterTaskManager(
     const NodeID &self_node_id,
     std::shared_ptr<ClusterResourceScheduler> cluster_resource_scheduler,
@@ -30,6 +43,9 @@ ClusterTaskManager::ClusterTaskManager(
       max_resource_shapes_per_load_report_(
           RayConfig::instance().max_resource_shapes_per_load_report()),
       report_worker_backlog_(RayConfig::instance().report_worker_backlog()),
+      priority_aging_period_ms_(RayConfig::instance().task_priority_aging_period_ms()),
+      deadline_urgency_window_ms_(
+          RayConfig::instance().task_deadline_urgency_window_ms()),
       worker_pool_(worker_pool),
       leased_workers_(leased_workers) {}
 
@@ -37,11 +53,41 @@ bool ClusterTaskManager::SchedulePendingTasks() {
   // Always try to schedule infeasible tasks in case they are now feasible.
   TryLocalInfeasibleTaskScheduling();
   bool did_schedule = false;
-  for (auto shapes_it = tasks_to_schedule_.begin();
-       shapes_it != tasks_to_schedule_.end();) {
+  const int64_t now_ms = current_sys_time_ms();
+  std::vector<BlockedClass> blocked_classes;
+  for (const auto scheduling_class :
+       OrderByRank(&tasks_to_schedule_, &ranked_classes_to_schedule_, now_ms)) {
+    auto shapes_it = tasks_to_schedule_.find(scheduling_class);
     auto &work_queue = shapes_it->second;
     bool is_infeasible = false;
-    for (auto work_it = work_queue.begin(); work_it != work_queue.end();) {
+    const auto &front_spec = std::get<0>(work_queue.front()).GetTaskSpecification();
+    const auto front_rank = GetWorkRank(work_queue.front(), now_ms);
+    if (IsHeldBack(scheduling_class, front_rank, blocked_classes)) {
+      continue;
+    }
+    uint64_t resource_version = cluster_resource_scheduler_->GetResourceVersion(
+        front_spec.GetPlacementSchedulingClass());
+    auto version_it = unschedulable_class_versions_.find(shapes_it->first);
+    if (version_it != unschedulable_class_versions_.end() &&
+        version_it->second == resource_version &&
+        !cluster_resource_scheduler_->IsLocallySchedulable(
+            front_spec.GetPlacementSchedulingClass())) {
+      // No node could schedule this class on the last pass and no remote
+      // node has gained any of the resources it needs since, so skip the
+      // cluster scan.
+      blocked_classes.push_back({scheduling_class, front_rank});
+      continue;
+    }
+    const auto policy_type = GetSchedulingPolicy(front_spec);
+    if (work_queue.size() > 1 && !front_spec.IsActorCreationTask() &&
+        policy_type == rpc::SchedulingPolicyType::DEFAULT_POLICY) {
+      // All tasks of a scheduling class request the same resources, so place
+      // the whole queue with one plan. Other policies than the default one
+      // pick a node per task.
+      did_schedule = ScheduleBatch(&work_queue, &is_infeasible) || did_schedule;
+    }
+    for (auto work_it = work_queue.begin();
+         work_it != work_queue.end() && !is_infeasible;) {
       // Check every task in task_to_schedule queue to see
       // whether it can be scheduled. This avoids head-of-line
       // blocking where a task which cannot be scheduled because
@@ -51,13 +97,12 @@ bool ClusterTaskManager::SchedulePendingTasks() {
       Task task = std::get<0>(work);
       RAY_LOG(DEBUG) << "Scheduling pending task "
                      << task.GetTaskSpecification().TaskId();
-      auto placement_resources =
-          task.GetTaskSpecification().GetRequiredPlacementResources().GetResourceMap();
       // This argument is used to set violation, which is an unsupported feature now.
       int64_t _unused;
       std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
-          placement_resources, task.GetTaskSpecification().IsActorCreationTask(),
-          &_unused, &is_infeasible);
+          task.GetTaskSpecification().GetPlacementSchedulingClass(),
+          task.GetTaskSpecification().IsActorCreationTask(),
+          &_unused, &is_infeasible, GetSchedulingPolicy(task.GetTaskSpecification()));
 
       // There is no node that has available resources to run the request.
       // Move on to the next shape.
@@ -91,16 +136,175 @@ bool ClusterTaskManager::SchedulePendingTasks() {
 
       // TODO(sang): Use a shared pointer deque to reduce copy overhead.
       infeasible_tasks_[shapes_it->first] = shapes_it->second;
-      shapes_it = tasks_to_schedule_.erase(shapes_it);
+      unschedulable_class_versions_[shapes_it->first] = resource_version;
+      tasks_to_schedule_.erase(shapes_it);
     } else if (work_queue.empty()) {
-      shapes_it = tasks_to_schedule_.erase(shapes_it);
+      unschedulable_class_versions_.erase(shapes_it->first);
+      tasks_to_schedule_.erase(shapes_it);
     } else {
-      shapes_it++;
+      // The scan stopped because no node could schedule the next task.
+      unschedulable_class_versions_[shapes_it->first] = resource_version;
+      blocked_classes.push_back(
+          {scheduling_class, GetWorkRank(work_queue.front(), now_ms)});
     }
   }
   return did_schedule;
 }
 
+bool ClusterTaskManager::ScheduleBatch(std::deque<Work> *work_queue,
+                                       bool *is_infeasible) {
+  const auto &spec = std::get<0>(work_queue->front()).GetTaskSpecification();
+  auto plan = cluster_resource_scheduler_->GetBestSchedulableNodes(
+      spec.GetPlacementSchedulingClass(), work_queue->size(), is_infeasible);
+  RAY_LOG(DEBUG) << "Scheduling " << work_queue->size() << " tasks of class "
+                 << spec.GetSchedulingClass() << " on " << plan.size() << " nodes";
+
+  bool did_schedule = false;
+  for (const auto &placement : plan) {
+    for (int64_t i = 0; i < placement.second; i++) {
+      RAY_CHECK(!work_queue->empty());
+      Work work = std::move(work_queue->front());
+      work_queue->pop_front();
+      if (placement.first == self_node_id_.Binary()) {
+        // Warning: WaitForTaskArgsRequests must execute (do not let it short
+        // circuit if did_schedule is true).
+        bool task_scheduled = WaitForTaskArgsRequests(work);
+        did_schedule = task_scheduled || did_schedule;
+      } else {
+        Spillback(NodeID::FromBinary(placement.first), work);
+      }
+    }
+  }
+  return did_schedule;
+}
+
+WorkRank ClusterTaskManager::GetWorkRank(const Work &work, int64_t now_ms) const {
+  const auto &spec = std::get<0>(work).GetTaskSpecification();
+  WorkRank rank;
+  rank.priority = spec.GetPriority();
+  rank.queued_at_ms = std::get<3>(work);
+  const int64_t deadline_ms = spec.GetDeadlineMs();
+  rank.urgent = deadline_ms > 0 && deadline_ms - now_ms <= deadline_urgency_window_ms_;
+  if (rank.urgent) {
+    rank.level = -deadline_ms;
+  } else {
+    rank.level = rank.priority;
+    if (priority_aging_period_ms_ > 0 && now_ms > rank.queued_at_ms) {
+      rank.level += (now_ms - rank.queued_at_ms) / priority_aging_period_ms_;
+    }
+  }
+  return rank;
+}
+
+void ClusterTaskManager::EnqueueWork(
+    std::deque<Work> *work_queue, Work work,
+    absl::flat_hash_set<SchedulingClass> *ranked_classes) {
+  const auto &spec = std::get<0>(work).GetTaskSpecification();
+  if (ranked_classes != nullptr && HasPriorityOrDeadline(spec)) {
+    ranked_classes->insert(spec.GetSchedulingClass());
+  }
+  // Tasks mostly arrive in rank order, so look for the place of the task from the
+  // back of the queue.
+  const int64_t now_ms = current_sys_time_ms();
+  const auto rank = GetWorkRank(work, now_ms);
+  auto work_it = work_queue->end();
+  while (work_it != work_queue->begin() &&
+         rank.Before(GetWorkRank(*std::prev(work_it), now_ms))) {
+    work_it--;
+  }
+  work_queue->insert(work_it, std::move(work));
+}
+
+bool ClusterTaskManager::RerankWork(std::deque<Work> *work_queue,
+                                    int64_t now_ms) const {
+  bool is_ranked = false;
+  std::vector<WorkRank> ranks;
+  ranks.reserve(work_queue->size());
+  for (const auto &work : *work_queue) {
+    is_ranked =
+        is_ranked || HasPriorityOrDeadline(std::get<0>(work).GetTaskSpecification());
+    ranks.push_back(GetWorkRank(work, now_ms));
+  }
+  auto before = [](const WorkRank &left, const WorkRank &right) {
+    return left.Before(right);
+  };
+  if (std::is_sorted(ranks.begin(), ranks.end(), before)) {
+    return is_ranked;
+  }
+  std::vector<size_t> order(ranks.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&ranks](size_t left, size_t right) {
+    return ranks[left].Before(ranks[right]);
+  });
+  std::deque<Work> reranked_queue;
+  for (size_t index : order) {
+    reranked_queue.push_back(std::move((*work_queue)[index]));
+  }
+  work_queue->swap(reranked_queue);
+  return is_ranked;
+}
+
+std::vector<SchedulingClass> ClusterTaskManager::OrderByRank(
+    std::unordered_map<SchedulingClass, std::deque<Work>> *queues,
+    absl::flat_hash_set<SchedulingClass> *ranked_classes, int64_t now_ms) const {
+  for (auto it = ranked_classes->begin(); it != ranked_classes->end();) {
+    auto queue_it = queues->find(*it);
+    if (queue_it == queues->end() || !RerankWork(&queue_it->second, now_ms)) {
+      ranked_classes->erase(it++);
+    } else {
+      it++;
+    }
+  }
+  std::vector<SchedulingClass> ordered_classes;
+  ordered_classes.reserve(queues->size());
+  if (queues->size() == 1) {
+    ordered_classes.push_back(queues->begin()->first);
+    return ordered_classes;
+  }
+  std::vector<std::pair<WorkRank, SchedulingClass>> ranks;
+  std::vector<SchedulingClass> empty_classes;
+  for (const auto &entry : *queues) {
+    if (entry.second.empty()) {
+      empty_classes.push_back(entry.first);
+    } else {
+      ranks.emplace_back(GetWorkRank(entry.second.front(), now_ms), entry.first);
+    }
+  }
+  std::sort(ranks.begin(), ranks.end(),
+            [](const std::pair<WorkRank, SchedulingClass> &left,
+               const std::pair<WorkRank, SchedulingClass> &right) {
+              return left.first.Before(right.first);
+            });
+  for (const auto &rank : ranks) {
+    ordered_classes.push_back(rank.second);
+  }
+  // Visit the empty queues last, so that they are cleaned up.
+  ordered_classes.insert(ordered_classes.end(), empty_classes.begin(),
+                         empty_classes.end());
+  return ordered_classes;
+}
+
+bool ClusterTaskManager::IsHeldBack(
+    SchedulingClass scheduling_class, const WorkRank &rank,
+    const std::vector<BlockedClass> &blocked_classes) const {
+  for (const auto &blocked_class : blocked_classes) {
+    if (!blocked_class.rank.HoldsBack(rank)) {
+      continue;
+    }
+    const auto blocked_resources =
+        TaskSpecification::GetSchedulingClassDescriptor(blocked_class.scheduling_class)
+            .GetResourceMap();
+    for (const auto &resource :
+         TaskSpecification::GetSchedulingClassDescriptor(scheduling_class)
+             .GetResourceMap()) {
+      if (blocked_resources.count(resource.first) > 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 bool ClusterTaskManager::WaitForTaskArgsRequests(Work work) {
   const auto &task = std::get<0>(work);
   const auto &scheduling_key = task.GetTaskSpecification().GetSchedulingClass();
@@ -112,7 +316,8 @@ bool ClusterTaskManager::WaitForTaskArgsRequests(Work work) {
     if (args_ready) {
       RAY_LOG(DEBUG) << "Args already ready, task can be dispatched "
                      << task.GetTaskSpecification().TaskId();
-      tasks_to_dispatch_[scheduling_key].push_back(work);
+      EnqueueWork(&tasks_to_dispatch_[scheduling_key], work,
+                  &ranked_classes_to_dispatch_);
     } else {
       RAY_LOG(DEBUG) << "Waiting for args for task: "
                      << task.GetTaskSpecification().TaskId();
@@ -123,7 +328,7 @@ bool ClusterTaskManager::WaitForTaskArgsRequests(Work work) {
   } else {
     RAY_LOG(DEBUG) << "No args, task can be dispatched "
                    << task.GetTaskSpecification().TaskId();
-    tasks_to_dispatch_[scheduling_key].push_back(work);
+    EnqueueWork(&tasks_to_dispatch_[scheduling_key], work, &ranked_classes_to_dispatch_);
   }
   return can_dispatch;
 }
@@ -136,9 +341,17 @@ void ClusterTaskManager::DispatchScheduledTasksToWorkers(
   // blocking where a task which cannot be dispatched because
   // there are not enough available resources blocks other
   // tasks from being dispatched.
-  for (auto shapes_it = tasks_to_dispatch_.begin();
-       shapes_it != tasks_to_dispatch_.end();) {
+  const int64_t now_ms = current_sys_time_ms();
+  std::vector<BlockedClass> blocked_classes;
+  for (const auto scheduling_class :
+       OrderByRank(&tasks_to_dispatch_, &ranked_classes_to_dispatch_, now_ms)) {
+    auto shapes_it = tasks_to_dispatch_.find(scheduling_class);
     auto &dispatch_queue = shapes_it->second;
+    if (!dispatch_queue.empty() &&
+        IsHeldBack(scheduling_class, GetWorkRank(dispatch_queue.front(), now_ms),
+                   blocked_classes)) {
+      continue;
+    }
     for (auto work_it = dispatch_queue.begin(); work_it != dispatch_queue.end();) {
       auto &work = *work_it;
       auto &task = std::get<0>(work);
@@ -190,14 +403,14 @@ void ClusterTaskManager::DispatchScheduledTasksToWorkers(
           }
           work_it = dispatch_queue.erase(work_it);
         } else {
+          // The task waits for local resources.
+          blocked_classes.push_back({scheduling_class, GetWorkRank(*work_it, now_ms)});
           break;
         }
       }
     }
     if (dispatch_queue.empty()) {
-      shapes_it = tasks_to_dispatch_.erase(shapes_it);
-    } else {
-      shapes_it++;
+      tasks_to_dispatch_.erase(shapes_it);
     }
   }
 }
@@ -211,7 +424,7 @@ bool ClusterTaskManager::AttemptDispatchWork(const Work &work,
 
   std::shared_ptr<TaskResourceInstances> allocated_instances(new TaskResourceInstances());
   bool schedulable = cluster_resource_scheduler_->AllocateLocalTaskResources(
-      spec.GetRequiredResources().GetResourceMap(), allocated_instances);
+      spec.GetSchedulingClass(), allocated_instances);
   bool dispatched = false;
   if (!schedulable) {
     *worker_leased = false;
@@ -219,9 +432,9 @@ bool ClusterTaskManager::AttemptDispatchWork(const Work &work,
     // queue.
     int64_t _unused;
     bool is_infeasible;
-    auto placement_resources = spec.GetRequiredPlacementResources().GetResourceMap();
     std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
-        placement_resources, spec.IsActorCreationTask(), &_unused, &is_infeasible);
+        spec.GetPlacementSchedulingClass(), spec.IsActorCreationTask(), &_unused,
+        &is_infeasible, GetSchedulingPolicy(spec));
     RAY_CHECK(!is_infeasible)
         << "Task cannot be infeasible when it is about to be dispatched";
     if (node_id_string != self_node_id_.Binary() && !node_id_string.empty()) {
@@ -251,16 +464,18 @@ void ClusterTaskManager::QueueAndScheduleTask(
     rpc::SendReplyCallback send_reply_callback) {
   RAY_LOG(DEBUG) << "Queuing and scheduling task "
                  << task.GetTaskSpecification().TaskId();
-  Work work = std::make_tuple(task, reply, [send_reply_callback] {
-    send_reply_callback(Status::OK(), nullptr, nullptr);
-  });
+  Work work = std::make_tuple(
+      task, reply,
+      [send_reply_callback] { send_reply_callback(Status::OK(), nullptr, nullptr); },
+      current_sys_time_ms());
   const auto &scheduling_class = task.GetTaskSpecification().GetSchedulingClass();
   // If the scheduling class is infeasible, just add the work to the infeasible queue
   // directly.
   if (infeasible_tasks_.count(scheduling_class) > 0) {
-    infeasible_tasks_[scheduling_class].push_back(work);
+    EnqueueWork(&infeasible_tasks_[scheduling_class], std::move(work), nullptr);
   } else {
-    tasks_to_schedule_[scheduling_class].push_back(work);
+    EnqueueWork(&tasks_to_schedule_[scheduling_class], std::move(work),
+                &ranked_classes_to_schedule_);
   }
   AddToBacklogTracker(task);
   ScheduleAndDispatchTasks();
@@ -284,7 +499,8 @@ void ClusterTaskManager::TasksUnblocked(const std::vector<TaskID> &ready_ids) {
       const auto &scheduling_key = task.GetTaskSpecification().GetSchedulingClass();
       RAY_LOG(DEBUG) << "Args ready, task can be dispatched "
                      << task.GetTaskSpecification().TaskId();
-      tasks_to_dispatch_[scheduling_key].push_back(work);
+      EnqueueWork(&tasks_to_dispatch_[scheduling_key], work,
+                  &ranked_classes_to_dispatch_);
       waiting_tasks_.erase(it);
     }
   }
@@ -651,13 +867,22 @@ void ClusterTaskManager::TryLocalInfeasibleTaskScheduling() {
     Task task = std::get<0>(work);
     RAY_LOG(DEBUG) << "Check if the infeasible task is schedulable in any node. task_id:"
                    << task.GetTaskSpecification().TaskId();
-    auto placement_resources =
-        task.GetTaskSpecification().GetRequiredPlacementResources().GetResourceMap();
+    const auto placement_class =
+        task.GetTaskSpecification().GetPlacementSchedulingClass();
+    // The shape stays infeasible until some node gains one of its resources.
+    uint64_t resource_version =
+        cluster_resource_scheduler_->GetResourceVersion(placement_class);
+    auto version_it = unschedulable_class_versions_.find(shapes_it->first);
+    if (version_it != unschedulable_class_versions_.end() &&
+        version_it->second == resource_version) {
+      shapes_it++;
+      continue;
+    }
     // This argument is used to set violation, which is an unsupported feature now.
     int64_t _unused;
     bool is_infeasible;
     std::string node_id_string = cluster_resource_scheduler_->GetBestSchedulableNode(
-        placement_resources, task.GetTaskSpecification().IsActorCreationTask(), &_unused,
+        placement_class, task.GetTaskSpecification().IsActorCreationTask(), &_unused,
         &is_infeasible);
 
     // There is no node that has available resources to run the request.
@@ -665,12 +890,16 @@ void ClusterTaskManager::TryLocalInfeasibleTaskScheduling() {
     if (is_infeasible) {
       RAY_LOG(DEBUG) << "No feasible node found for task "
                      << task.GetTaskSpecification().TaskId();
+      unschedulable_class_versions_[shapes_it->first] = resource_version;
       shapes_it++;
     } else {
       RAY_LOG(DEBUG) << "Infeasible task of task id "
                      << task.GetTaskSpecification().TaskId()
                      << " is now feasible. Move the entry back to tasks_to_schedule_";
       tasks_to_schedule_[shapes_it->first] = shapes_it->second;
+      // The ranks of the infeasible tasks are not tracked.
+      ranked_classes_to_schedule_.insert(shapes_it->first);
+      unschedulable_class_versions_.erase(shapes_it->first);
       shapes_it = infeasible_tasks_.erase(shapes_it);
     }
   }
@@ -749,20 +978,24 @@ void ClusterTaskManager::Spillback(const NodeID &spillback_to, const Work &work)
   RAY_LOG(DEBUG) << "Spilling task " << task_spec.TaskId() << " to node " << spillback_to;
 
   if (!cluster_resource_scheduler_->AllocateRemoteTaskResources(
-          spillback_to.Binary(), task_spec.GetRequiredResources().GetResourceMap())) {
+          spillback_to.Binary(), task_spec.GetSchedulingClass())) {
     RAY_LOG(INFO) << "Tried to allocate resources for request " << task_spec.TaskId()
                   << " on a remote node that are no longer available";
   }
 
-  auto node_info_opt = get_node_info_(spillback_to);
+  ReplyWithRetryAddress(spillback_to, work);
+}
+
+void ClusterTaskManager::ReplyWithRetryAddress(const NodeID &retry_at,
+                                               const Work &work) {
+  auto node_info_opt = get_node_info_(retry_at);
   RAY_CHECK(node_info_opt)
-      << "Spilling back to a node manager, but no GCS info found for node "
-      << spillback_to;
+      << "Spilling back to a node manager, but no GCS info found for node " << retry_at;
   auto reply = std::get<1>(work);
   reply->mutable_retry_at_raylet_address()->set_ip_address(
       node_info_opt->node_manager_address());
   reply->mutable_retry_at_raylet_address()->set_port(node_info_opt->node_manager_port());
-  reply->mutable_retry_at_raylet_address()->set_raylet_id(spillback_to.Binary());
+  reply->mutable_retry_at_raylet_address()->set_raylet_id(retry_at.Binary());
 
   auto send_reply_callback = std::get<2>(work);
   send_reply_callback();
@@ -846,6 +1079,84 @@ void ClusterTaskManager::OnNodeResourceUsageUpdated(
   ScheduleAndDispatchTasks();
 }
 
+void ClusterTaskManager::SetJobSchedulingPolicy(const JobID &job_id,
+                                                rpc::SchedulingPolicyType policy_type) {
+  if (policy_type == rpc::SchedulingPolicyType::DEFAULT_POLICY) {
+    job_scheduling_policies_.erase(job_id);
+  } else {
+    job_scheduling_policies_[job_id] = policy_type;
+  }
+}
+
+rpc::SchedulingPolicyType ClusterTaskManager::GetSchedulingPolicy(
+    const TaskSpecification &spec) const {
+  // Only the raylet of the owner applies the policy of the job. A lease that it spilled
+  // to this node is placed with the default policy, which keeps the lease here if this
+  // node can run it, so that the lease does not bounce between the nodes.
+  const auto &owner_node_id = spec.CallerAddress().raylet_id();
+  if (!owner_node_id.empty() && owner_node_id != self_node_id_.Binary()) {
+    return rpc::SchedulingPolicyType::DEFAULT_POLICY;
+  }
+  auto it = job_scheduling_policies_.find(spec.JobId());
+  if (it == job_scheduling_policies_.end()) {
+    return rpc::SchedulingPolicyType::DEFAULT_POLICY;
+  }
+  return it->second;
+}
+
+int64_t ClusterTaskManager::StealTasks(const NodeID &thief_node_id,
+                                       int64_t max_tasks) {
+  if (max_tasks <= 0 || !get_node_info_(thief_node_id)) {
+    return 0;
+  }
+  int64_t num_stolen = 0;
+  for (auto shapes_it = tasks_to_dispatch_.begin();
+       shapes_it != tasks_to_dispatch_.end() && num_stolen < max_tasks;) {
+    auto &dispatch_queue = shapes_it->second;
+    // Steal from the back of the queue so that the requests that have waited
+    // longest are still dispatched here first.
+    while (!dispatch_queue.empty() && num_stolen < max_tasks) {
+      const auto &work = dispatch_queue.back();
+      const auto &task = std::get<0>(work);
+      const auto &spec = task.GetTaskSpecification();
+      if (spec.IsActorCreationTask() ||
+          !cluster_resource_scheduler_->AllocateRemoteTaskResources(
+              thief_node_id.Binary(), spec.GetSchedulingClass())) {
+        // All tasks in the queue have the same shape, so if this one can't go
+        // to the thief, none of them can.
+        break;
+      }
+      RAY_LOG(DEBUG) << "Task " << spec.TaskId() << " stolen by node " << thief_node_id;
+      RemoveFromBacklogTracker(task);
+      if (!spec.GetDependencies().empty()) {
+        task_dependency_manager_.RemoveTaskDependencies(spec.TaskId());
+      }
+      ReplyWithRetryAddress(thief_node_id, work);
+      dispatch_queue.pop_back();
+      num_stolen++;
+    }
+    if (dispatch_queue.empty()) {
+      shapes_it = tasks_to_dispatch_.erase(shapes_it);
+    } else {
+      shapes_it++;
+    }
+  }
+  return num_stolen;
+}
+
+int64_t ClusterTaskManager::NumTasksToSteal() const {
+  if (!tasks_to_schedule_.empty() || !tasks_to_dispatch_.empty() ||
+      !waiting_tasks_.empty()) {
+    return 0;
+  }
+  const auto &local_resources = cluster_resource_scheduler_->GetLocalNodeResources();
+  if (local_resources.predefined_resources.size() <= CPU) {
+    return 0;
+  }
+  return static_cast<int64_t>(
+      local_resources.predefined_resources[CPU].available.Double());
+}
+
 void ClusterTaskManager::OnObjectMissing(const ObjectID &object_id,
                                          const std::vector<TaskID> &waiting_task_ids) {
   // We don't need to do anything if the new scheduler is enabled because tasks
@@ -18,8 +18,52 @@ namespace raylet {
 
 /// Work represents all the information needed to make a scheduling decision.
 /// This includes the task, the information we need to communicate to
-/// dispatch/spillback and the callback to trigger it.
-typedef std::tuple<Task, rpc::RequestWorkerLeaseReply *, std::function<void(void)>> Work;
+/// dispatch/spillback, the callback to trigger it and the time at which the
+/// task was queued, in milliseconds since the Unix epoch.
+typedef std::tuple<Task, rpc::RequestWorkerLeaseReply *, std::function<void(void)>,
+                   int64_t>
+    Work;
+
+/// The rank of a queued task. Tasks whose deadline is near rank first, earliest
+/// deadline first, then tasks by priority, raised by the time they have waited
+/// (see task_priority_aging_period_ms). Ties are broken by arrival order.
+struct WorkRank {
+  /// Whether the deadline of the task is near.
+  bool urgent;
+  /// Minus the deadline if the task is urgent, else its aged priority.
+  int64_t level;
+  /// The priority of the task, without aging.
+  int32_t priority;
+  /// The time at which the task was queued.
+  int64_t queued_at_ms;
+
+  /// Whether the task should be scheduled before another one.
+  bool Before(const WorkRank &other) const {
+    if (urgent != other.urgent || level != other.level) {
+      return Outranks(other);
+    }
+    return queued_at_ms < other.queued_at_ms;
+  }
+
+  /// Whether the task has strictly precedence over another one, regardless of
+  /// their arrival order.
+  bool Outranks(const WorkRank &other) const {
+    if (urgent != other.urgent) {
+      return urgent;
+    }
+    return level > other.level;
+  }
+
+  /// Whether the task may hold back another one that needs the same resources:
+  /// it outranks it, and either its deadline is near or it has a higher
+  /// priority. Tasks of the same priority never hold back each other.
+  bool HoldsBack(const WorkRank &other) const {
+    if (!Outranks(other)) {
+      return false;
+    }
+    return urgent || priority > other.priority;
+  }
+};
 
 typedef std::function<boost::optional<rpc::GcsNodeInfo>(const NodeID &node_id)>
     NodeInfoGetter;
@@ -38,6 +82,14 @@ typedef std::function<boost::optional<rpc::GcsNodeInfo>(const NodeID &node_id)>
 ///       there is a new worker which can dispatch the tasks.
 /// 5. When a worker finishes executing its task(s), the requester will return
 ///    it and we should release the resources in our view of the node's state.
+///
+/// Each queue is ordered by the rank of its tasks (see WorkRank), and is
+/// reordered at the start of steps 2 and 4 as ranks change over time. In these
+/// steps the queues of the scheduling classes are visited by the rank of their
+/// first task. If the first task of a class can be neither placed nor dispatched,
+/// the classes of a lower rank that need any of the same resources are held back,
+/// so that they do not take the resources it waits for. Running tasks are never
+/// preempted.
 class ClusterTaskManager : public ClusterTaskManagerInterface {
  public:
   /// fullfills_dependencies_func Should return if all dependencies are
@@ -160,6 +212,30 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   void OnNodeResourceUsageUpdated(const NodeID &node_id,
                                   const rpc::ResourcesData &resource_data) override;
 
+  /// Set the policy used to pick the nodes that the tasks and actors of a job
+  /// run on. Tasks of jobs without a policy use the default policy, and setting
+  /// the default policy forgets the job.
+  ///
+  /// \param job_id ID of the job.
+  /// \param policy_type The policy, from the job's config.
+  void SetJobSchedulingPolicy(const JobID &job_id,
+                              rpc::SchedulingPolicyType policy_type) override;
+
+  /// Redirect queued lease requests that are still waiting for dispatch to an
+  /// idle node. Requests are taken from the back of each dispatch queue, so
+  /// the oldest requests keep their place here. Actor creation tasks are
+  /// never stolen, and only requests that fit in our view of the thief's
+  /// available resources are redirected.
+  ///
+  /// \param thief_node_id ID of the idle node that asked for tasks.
+  /// \param max_tasks The maximum number of lease requests to redirect.
+  /// \return The number of lease requests that were redirected.
+  int64_t StealTasks(const NodeID &thief_node_id, int64_t max_tasks) override;
+
+  /// Return the number of whole CPUs available on this node if no tasks are
+  /// queued here, else zero.
+  int64_t NumTasksToSteal() const override;
+
   /// Handle the object missing event.
   ///
   /// \param object_id ID of the missing object.
@@ -213,11 +289,18 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
 
   const int max_resource_shapes_per_load_report_;
   const bool report_worker_backlog_;
+  const int64_t priority_aging_period_ms_;
+  const int64_t deadline_urgency_window_ms_;
 
   /// Queue of lease requests that are waiting for resources to become available.
   /// Tasks move from scheduled -> dispatch | waiting.
   std::unordered_map<SchedulingClass, std::deque<Work>> tasks_to_schedule_;
 
+  /// The scheduling classes whose queue in tasks_to_schedule_ may hold tasks with a
+  /// priority or a deadline. The other queues are in rank order already, since aging
+  /// never reorders tasks of the same priority, so they are not reranked.
+  absl::flat_hash_set<SchedulingClass> ranked_classes_to_schedule_;
+
   /// Queue of lease requests that should be scheduled onto workers.
   /// Tasks move from scheduled | waiting -> dispatch.
   /// Tasks can also move from dispatch -> waiting if one of their arguments is
@@ -227,6 +310,10 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   /// is still queued.
   std::unordered_map<SchedulingClass, std::deque<Work>> tasks_to_dispatch_;
 
+  /// The scheduling classes whose queue in tasks_to_dispatch_ may hold tasks with a
+  /// priority or a deadline.
+  absl::flat_hash_set<SchedulingClass> ranked_classes_to_dispatch_;
+
   /// Tasks waiting for arguments to be transferred locally.
   /// Tasks move from waiting -> dispatch.
   /// Tasks can also move from dispatch -> waiting if one of their arguments is
@@ -240,6 +327,16 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   /// Tasks go between scheduling <-> infeasible.
   std::unordered_map<SchedulingClass, std::deque<Work>> infeasible_tasks_;
 
+  /// For each scheduling class in tasks_to_schedule_ or infeasible_tasks_,
+  /// the resource version (see ClusterResourceScheduler::GetResourceVersion)
+  /// at which the last scan found no node to run it. The class is not
+  /// scanned again until the version changes, or for tasks_to_schedule_,
+  /// until the local node can run it.
+  absl::flat_hash_map<SchedulingClass, uint64_t> unschedulable_class_versions_;
+
+  /// The node selection policy of each job that does not use the default one.
+  absl::flat_hash_map<JobID, rpc::SchedulingPolicyType> job_scheduling_policies_;
+
   /// Track the cumulative backlog of all workers requesting a lease to this raylet.
   std::unordered_map<SchedulingClass, int> backlog_tracker_;
 
@@ -248,12 +345,70 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
   WorkerPoolInterface &worker_pool_;
   std::unordered_map<WorkerID, std::shared_ptr<WorkerInterface>> &leased_workers_;
 
+  /// A scheduling class whose first task could not be placed or dispatched.
+  struct BlockedClass {
+    SchedulingClass scheduling_class;
+    /// The rank of its first task.
+    WorkRank rank;
+  };
+
+  /// Compute the rank of a queued task.
+  ///
+  /// \param work: The queued task.
+  /// \param now_ms: The current time, in milliseconds since the Unix epoch.
+  WorkRank GetWorkRank(const Work &work, int64_t now_ms) const;
+
+  /// Queue a task behind the tasks of the same or a higher rank.
+  ///
+  /// \param work_queue: The queue of the scheduling class of the task.
+  /// \param ranked_classes: The classes whose queue may hold tasks with a priority or
+  /// a deadline, to which the class is added if the task has one. Null if the queue
+  /// is never reranked.
+  void EnqueueWork(std::deque<Work> *work_queue, Work work,
+                   absl::flat_hash_set<SchedulingClass> *ranked_classes);
+
+  /// Restore the rank order of a queue. The ranks of queued tasks change as they
+  /// age and as their deadlines approach, so that a task may come to outrank the
+  /// tasks queued before it.
+  ///
+  /// \return Whether the queue holds tasks with a priority or a deadline.
+  bool RerankWork(std::deque<Work> *work_queue, int64_t now_ms) const;
+
+  /// Rerank the tasks of the given queues that may hold tasks with a priority or a
+  /// deadline, and order the scheduling classes of all the queues by the rank of
+  /// their first task.
+  ///
+  /// \param ranked_classes: The classes whose queue may hold tasks with a priority
+  /// or a deadline. The classes whose queue holds none are removed.
+  std::vector<SchedulingClass> OrderByRank(
+      std::unordered_map<SchedulingClass, std::deque<Work>> *queues,
+      absl::flat_hash_set<SchedulingClass> *ranked_classes, int64_t now_ms) const;
+
+  /// Whether a scheduling class is held back by a blocked class of a higher
+  /// rank that needs some of the same resources.
+  ///
+  /// \param scheduling_class: The scheduling class.
+  /// \param rank: The rank of its first task.
+  /// \param blocked_classes: The classes that are blocked so far in this pass.
+  bool IsHeldBack(SchedulingClass scheduling_class, const WorkRank &rank,
+                  const std::vector<BlockedClass> &blocked_classes) const;
+
   /// Determine whether a task should be immediately dispatched,
   /// or placed on a wait queue.
   ///
   /// \return True if the work can be immediately dispatched.
   bool WaitForTaskArgsRequests(Work work);
 
+  /// Place the queued tasks of one scheduling class with a single placement
+  /// plan. Placed tasks are removed from the queue and either queued for
+  /// dispatch locally or spilled back. Tasks that could not be placed are
+  /// left in the queue.
+  ///
+  /// \param work_queue: Queued tasks, all of the same scheduling class.
+  /// \param is_infeasible[out]: Set true if the tasks are infeasible.
+  /// \return True if any task can be immediately dispatched.
+  bool ScheduleBatch(std::deque<Work> *work_queue, bool *is_infeasible);
+
   void Dispatch(
       std::shared_ptr<WorkerInterface> worker,
       std::unordered_map<WorkerID, std::shared_ptr<WorkerInterface>> &leased_workers_,
@@ -262,6 +417,13 @@ class ClusterTaskManager : public ClusterTaskManagerInterface {
 
   void Spillback(const NodeID &spillback_to, const Work &work);
 
+  /// Reply to a lease request, telling the requester to retry at another node.
+  void ReplyWithRetryAddress(const NodeID &retry_at, const Work &work);
+
+  /// Get the node selection policy of the job that a task belongs to, or the default
+  /// policy if the owner of the task is on another node.
+  rpc::SchedulingPolicyType GetSchedulingPolicy(const TaskSpecification &spec) const;
+
   void AddToBacklogTracker(const Task &task);
   void RemoveFromBacklogTracker(const Task &task);
 
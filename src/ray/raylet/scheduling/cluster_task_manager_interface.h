@@ -120,6 +120,27 @@ class ClusterTaskManagerInterface {
   virtual void OnNodeResourceUsageUpdated(const NodeID &node_id,
                                           const rpc::ResourcesData &resource_data) = 0;
 
+  /// Set the policy used to pick the nodes that the tasks and actors of a job
+  /// run on. Setting the default policy forgets the job, which is done when it
+  /// finishes.
+  ///
+  /// \param job_id ID of the job.
+  /// \param policy_type The policy, from the job's config.
+  virtual void SetJobSchedulingPolicy(const JobID &job_id,
+                                      rpc::SchedulingPolicyType policy_type) = 0;
+
+  /// Redirect queued lease requests that are still waiting for dispatch to an
+  /// idle node. The lease replies tell the requesters to retry at that node.
+  ///
+  /// \param thief_node_id ID of the idle node that asked for tasks.
+  /// \param max_tasks The maximum number of lease requests to redirect.
+  /// \return The number of lease requests that were redirected.
+  virtual int64_t StealTasks(const NodeID &thief_node_id, int64_t max_tasks) = 0;
+
+  /// Return how many queued tasks this node could take from busy peers. This is
+  /// zero unless nothing is queued locally.
+  virtual int64_t NumTasksToSteal() const = 0;
+
   /// Handle the object missing event.
   ///
   /// \param object_id ID of the missing object.
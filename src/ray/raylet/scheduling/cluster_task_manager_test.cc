@@ -15,8 +15,10 @@
 
 #include "ray/raylet/scheduling/cluster_task_manager.h"
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -30,8 +32,6 @@
 #include "ray/raylet/test/util.h"
 
 #ifdef UNORDERED_VS_ABSL_MAPS_EVALUATION
-#include <chrono>
-
 #include "absl/container/flat_hash_map.h"
 #endif  // UNORDERED_VS_ABSL_MAPS_EVALUATION
 
@@ -73,16 +73,21 @@ std::shared_ptr<ClusterResourceScheduler> CreateSingleNodeScheduler(
 }
 
 Task CreateTask(const std::unordered_map<std::string, double> &required_resources,
-                int num_args = 0) {
+                int num_args = 0, int32_t priority = 0, int64_t deadline_ms = 0,
+                const NodeID &owner_node_id = NodeID::Nil()) {
   TaskSpecBuilder spec_builder;
   TaskID id = RandomTaskId();
   JobID job_id = RandomJobId();
   rpc::Address address;
+  if (!owner_node_id.IsNil()) {
+    address.set_raylet_id(owner_node_id.Binary());
+  }
   spec_builder.SetCommonTaskSpec(id, "dummy_task", Language::PYTHON,
                                  FunctionDescriptorBuilder::BuildPython("", "", "", ""),
                                  job_id, TaskID::Nil(), 0, TaskID::Nil(), address, 0,
                                  required_resources, {},
                                  std::make_pair(PlacementGroupID::Nil(), -1), true, "");
+  spec_builder.SetSchedulingPriority(priority, deadline_ms);
 
   for (int i = 0; i < num_args; i++) {
     ObjectID put_id = ObjectID::FromIndex(TaskID::Nil(), /*index=*/i + 1);
@@ -148,6 +153,13 @@ class ClusterTaskManagerTest : public ::testing::Test {
     node_info_[id] = info;
   }
 
+  /// The number of classes whose queue of tasks to schedule, or to dispatch, is
+  /// reranked.
+  size_t NumRankedClasses() {
+    return task_manager_.ranked_classes_to_schedule_.size() +
+           task_manager_.ranked_classes_to_dispatch_.size();
+  }
+
   void AssertNoLeaks() {
     ASSERT_TRUE(task_manager_.tasks_to_schedule_.empty());
     ASSERT_TRUE(task_manager_.tasks_to_dispatch_.empty());
@@ -156,6 +168,26 @@ class ClusterTaskManagerTest : public ::testing::Test {
     ASSERT_TRUE(dependency_manager_.subscribed_tasks.empty());
   }
 
+  /// Pretend that the queued tasks were queued the given time earlier.
+  void AgeQueuedTasks(int64_t age_ms) {
+    for (auto &queues : {&task_manager_.tasks_to_schedule_,
+                         &task_manager_.tasks_to_dispatch_}) {
+      for (auto &entry : *queues) {
+        for (auto &work : entry.second) {
+          std::get<3>(work) -= age_ms;
+        }
+      }
+    }
+  }
+
+  void AddWorkers(int num_workers) {
+    for (int i = 0; i < num_workers; i++) {
+      std::shared_ptr<MockWorker> worker =
+          std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
+      pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+    }
+  }
+
   NodeID id_;
   std::shared_ptr<ClusterResourceScheduler> scheduler_;
   MockWorkerPool pool_;
@@ -345,6 +377,422 @@ TEST_F(ClusterTaskManagerTest, TestSpillAfterAssigned) {
   AssertNoLeaks();
 }
 
+TEST_F(ClusterTaskManagerTest, BatchSpillbackTest) {
+  /*
+    Tasks of the same scheduling class that queue up while the local node is
+    busy are placed together once remote capacity shows up, and are spread
+    across the remote nodes.
+  */
+  std::shared_ptr<MockWorker> worker =
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
+  pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+
+  // Take all the local CPUs.
+  rpc::RequestWorkerLeaseReply local_reply;
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 8}}),
+                                     &local_reply, callback);
+  ASSERT_EQ(leased_workers_.size(), 1);
+  ASSERT_EQ(num_callbacks, 1);
+
+  std::vector<rpc::RequestWorkerLeaseReply> replies(6);
+  for (auto &reply : replies) {
+    task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                       &reply, callback);
+  }
+  ASSERT_EQ(num_callbacks, 1);
+
+  auto remote_node_id1 = NodeID::FromRandom();
+  auto remote_node_id2 = NodeID::FromRandom();
+  AddNode(remote_node_id1, 2);
+  AddNode(remote_node_id2, 2);
+  task_manager_.ScheduleAndDispatchTasks();
+
+  // Four tasks fit on the remote nodes, the rest wait for local resources.
+  ASSERT_EQ(num_callbacks, 5);
+  std::unordered_map<std::string, int> num_spilled;
+  for (const auto &reply : replies) {
+    const auto &raylet_id = reply.retry_at_raylet_address().raylet_id();
+    if (!raylet_id.empty()) {
+      num_spilled[raylet_id]++;
+    }
+  }
+  ASSERT_EQ(num_spilled[remote_node_id1.Binary()], 2);
+  ASSERT_EQ(num_spilled[remote_node_id2.Binary()], 2);
+}
+
+TEST_F(ClusterTaskManagerTest, StealTasksTest) {
+  /*
+    Tasks that are waiting for a worker on a busy node are redirected to an
+    idle node that asks for them, newest first, as long as the idle node has
+    room for them.
+  */
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+
+  std::vector<rpc::RequestWorkerLeaseReply> replies(4);
+  for (auto &reply : replies) {
+    task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                       &reply, callback);
+  }
+  // No workers are available, so the tasks wait in the dispatch queue.
+  ASSERT_EQ(num_callbacks, 0);
+  ASSERT_EQ(task_manager_.NumTasksToSteal(), 0);
+
+  auto thief_node_id = NodeID::FromRandom();
+  ASSERT_EQ(task_manager_.StealTasks(thief_node_id, 3), 0);
+  AddNode(thief_node_id, 2);
+  // Only two tasks fit on the thief.
+  ASSERT_EQ(task_manager_.StealTasks(thief_node_id, 3), 2);
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_TRUE(replies[0].retry_at_raylet_address().raylet_id().empty());
+  ASSERT_TRUE(replies[1].retry_at_raylet_address().raylet_id().empty());
+  ASSERT_EQ(replies[2].retry_at_raylet_address().raylet_id(), thief_node_id.Binary());
+  ASSERT_EQ(replies[3].retry_at_raylet_address().raylet_id(), thief_node_id.Binary());
+  ASSERT_EQ(task_manager_.StealTasks(thief_node_id, 3), 0);
+
+  for (int i = 0; i < 2; i++) {
+    std::shared_ptr<MockWorker> worker =
+        std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
+    pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+  }
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(num_callbacks, 4);
+  ASSERT_EQ(leased_workers_.size(), 2);
+  // With nothing queued, the free CPUs can take stolen tasks.
+  ASSERT_EQ(task_manager_.NumTasksToSteal(), 6);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, JobSchedulingPolicyTest) {
+  /*
+    Tasks of a job with the spread policy are spread over the nodes, while the
+    tasks of other jobs still prefer the local node.
+  */
+  auto remote_node_id = NodeID::FromRandom();
+  AddNode(remote_node_id, 8);
+
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+
+  std::vector<rpc::RequestWorkerLeaseReply> replies(2);
+  for (auto &reply : replies) {
+    Task task = CreateTask({{ray::kCPU_ResourceLabel, 1}});
+    task_manager_.SetJobSchedulingPolicy(task.GetTaskSpecification().JobId(),
+                                         rpc::SchedulingPolicyType::SPREAD_POLICY);
+    task_manager_.QueueAndScheduleTask(task, &reply, callback);
+  }
+  // One task waits for a local worker and the other one was spilled.
+  ASSERT_EQ(num_callbacks, 1);
+  ASSERT_TRUE(replies[0].retry_at_raylet_address().raylet_id().empty());
+  ASSERT_EQ(replies[1].retry_at_raylet_address().raylet_id(), remote_node_id.Binary());
+
+  rpc::RequestWorkerLeaseReply default_reply;
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     &default_reply, callback);
+  ASSERT_EQ(num_callbacks, 1);
+
+  for (int i = 0; i < 2; i++) {
+    std::shared_ptr<MockWorker> worker =
+        std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
+    pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+  }
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(num_callbacks, 3);
+  ASSERT_EQ(leased_workers_.size(), 2);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, SpilledLeaseSettlesTest) {
+  /*
+    A lease that the raylet of its owner spilled to this node stays here if this
+    node can run it, instead of being spread again by the policy of its job.
+  */
+  auto remote_node_id = NodeID::FromRandom();
+  AddNode(remote_node_id, 8);
+
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+
+  std::vector<rpc::RequestWorkerLeaseReply> replies(4);
+  for (auto &reply : replies) {
+    Task task = CreateTask({{ray::kCPU_ResourceLabel, 1}}, /*num_args=*/0,
+                           /*priority=*/0, /*deadline_ms=*/0, remote_node_id);
+    task_manager_.SetJobSchedulingPolicy(task.GetTaskSpecification().JobId(),
+                                         rpc::SchedulingPolicyType::SPREAD_POLICY);
+    task_manager_.QueueAndScheduleTask(task, &reply, callback);
+  }
+  // None of the leases is spilled back to the node of the owner.
+  ASSERT_EQ(num_callbacks, 0);
+  for (const auto &reply : replies) {
+    ASSERT_TRUE(reply.retry_at_raylet_address().raylet_id().empty());
+  }
+
+  for (size_t i = 0; i < replies.size(); i++) {
+    std::shared_ptr<MockWorker> worker =
+        std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
+    pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+  }
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(num_callbacks, 4);
+  ASSERT_EQ(leased_workers_.size(), 4);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, UnschedulableClassRescanTest) {
+  /*
+    A scheduling class that no node can run right now is scanned again once
+    a remote node reports more resources or the local node frees some.
+  */
+  std::shared_ptr<MockWorker> worker =
+      std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
+  pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+
+  int num_callbacks = 0;
+  auto callback = [&](Status, std::function<void()>, std::function<void()>) {
+    num_callbacks++;
+  };
+
+  // Take all the local CPUs.
+  rpc::RequestWorkerLeaseReply local_reply;
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 8}}),
+                                     &local_reply, callback);
+  ASSERT_EQ(num_callbacks, 1);
+
+  auto remote_node_id = NodeID::FromRandom();
+  scheduler_->AddOrUpdateNode(remote_node_id.Binary(), {{ray::kCPU_ResourceLabel, 4}},
+                              {{ray::kCPU_ResourceLabel, 0}});
+  node_info_[remote_node_id] = rpc::GcsNodeInfo();
+
+  rpc::RequestWorkerLeaseReply spillback_reply;
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 2}}),
+                                     &spillback_reply, callback);
+  rpc::RequestWorkerLeaseReply local_reply2;
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 2}}),
+                                     &local_reply2, callback);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(num_callbacks, 1);
+
+  // The remote node reports available CPUs on a heartbeat.
+  rpc::ResourcesData resource_data;
+  resource_data.set_resources_available_changed(true);
+  (*resource_data.mutable_resources_total())[ray::kCPU_ResourceLabel] = 4;
+  (*resource_data.mutable_resources_available())[ray::kCPU_ResourceLabel] = 2;
+  ASSERT_TRUE(scheduler_->UpdateNode(remote_node_id.Binary(), resource_data));
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(num_callbacks, 2);
+  ASSERT_EQ(spillback_reply.retry_at_raylet_address().raylet_id(),
+            remote_node_id.Binary());
+
+  // The local task finishes, so the last task can run locally.
+  leased_workers_.clear();
+  task_manager_.ReleaseWorkerResources(worker);
+  pool_.PushWorker(std::dynamic_pointer_cast<WorkerInterface>(worker));
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(num_callbacks, 3);
+  ASSERT_EQ(leased_workers_.size(), 1);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, PriorityOrderTest) {
+  /*
+    Queued tasks of a higher priority are dispatched first, across and within
+    scheduling classes.
+  */
+  auto callback = [](Status, std::function<void()>, std::function<void()>) {};
+  std::vector<rpc::RequestWorkerLeaseReply> replies(4);
+  auto granted = [&](int i) { return !replies[i].worker_address().worker_id().empty(); };
+  // Low priority.
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     &replies[0], callback);
+  // High priority, in another class.
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 2}}, 0, /*priority=*/10), &replies[1],
+      callback);
+  // Low priority, in the class of the first task.
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     &replies[2], callback);
+  // Medium priority, in the class of the first task.
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 1}}, 0, /*priority=*/5), &replies[3],
+      callback);
+
+  for (int expected : {1, 3, 0, 2}) {
+    ASSERT_FALSE(granted(expected));
+    AddWorkers(1);
+    task_manager_.ScheduleAndDispatchTasks();
+    ASSERT_TRUE(granted(expected));
+  }
+  ASSERT_EQ(leased_workers_.size(), 4);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, DeadlineTest) {
+  /*
+    Tasks whose deadline is near are dispatched before tasks of any priority.
+    A deadline that is far does not change the order.
+  */
+  auto callback = [](Status, std::function<void()>, std::function<void()>) {};
+  std::vector<rpc::RequestWorkerLeaseReply> replies(3);
+  auto granted = [&](int i) { return !replies[i].worker_address().worker_id().empty(); };
+  const int64_t now_ms = current_sys_time_ms();
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 3}}, 0, 0,
+                 /*deadline_ms=*/now_ms + 3600 * 1000),
+      &replies[0], callback);
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 2}}, 0, /*priority=*/10), &replies[1],
+      callback);
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 1}}, 0, 0, /*deadline_ms=*/now_ms + 100),
+      &replies[2], callback);
+
+  for (int expected : {2, 1, 0}) {
+    AddWorkers(1);
+    task_manager_.ScheduleAndDispatchTasks();
+    ASSERT_TRUE(granted(expected));
+  }
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, DeadlineReordersClassTest) {
+  /*
+    A task whose deadline becomes near goes before the tasks of its class that
+    were ranked before it.
+  */
+  auto callback = [](Status, std::function<void()>, std::function<void()>) {};
+  std::vector<rpc::RequestWorkerLeaseReply> replies(2);
+  auto granted = [&](int i) { return !replies[i].worker_address().worker_id().empty(); };
+  const int64_t wait_ms = 100;
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 1}}, 0, /*priority=*/10), &replies[0],
+      callback);
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 1}}, 0, 0,
+                 /*deadline_ms=*/current_sys_time_ms() +
+                     RayConfig::instance().task_deadline_urgency_window_ms() +
+                     wait_ms / 2),
+      &replies[1], callback);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms));
+  for (int expected : {1, 0}) {
+    AddWorkers(1);
+    task_manager_.ScheduleAndDispatchTasks();
+    ASSERT_TRUE(granted(expected));
+  }
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, PriorityAgingTest) {
+  /*
+    A task of a low priority that waited long enough goes before newer tasks of
+    a higher priority.
+  */
+  auto callback = [](Status, std::function<void()>, std::function<void()>) {};
+  std::vector<rpc::RequestWorkerLeaseReply> replies(2);
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     &replies[0], callback);
+  AgeQueuedTasks(20 * RayConfig::instance().task_priority_aging_period_ms());
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 2}}, 0, /*priority=*/10), &replies[1],
+      callback);
+
+  AddWorkers(1);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_FALSE(replies[0].worker_address().worker_id().empty());
+  ASSERT_TRUE(replies[1].worker_address().worker_id().empty());
+  AddWorkers(1);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_FALSE(replies[1].worker_address().worker_id().empty());
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, RerankRankedClassesOnlyTest) {
+  /*
+    Only the queues that hold tasks with a priority or a deadline are reranked,
+    since aging never reorders the other ones.
+  */
+  auto callback = [](Status, std::function<void()>, std::function<void()>) {};
+  std::vector<rpc::RequestWorkerLeaseReply> replies(3);
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     &replies[0], callback);
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     &replies[1], callback);
+  ASSERT_EQ(NumRankedClasses(), 0);
+
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 1}}, 0, /*priority=*/10), &replies[2],
+      callback);
+  ASSERT_GT(NumRankedClasses(), 0);
+
+  // The class is no longer reranked once its task with a priority is dispatched.
+  AddWorkers(1);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_FALSE(replies[2].worker_address().worker_id().empty());
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(NumRankedClasses(), 0);
+  AddWorkers(2);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_EQ(leased_workers_.size(), 3);
+  AssertNoLeaks();
+}
+
+TEST_F(ClusterTaskManagerTest, PriorityHoldsBackTest) {
+  /*
+    While a task of a high priority waits for resources, tasks of a lower
+    priority that need the same resources wait too, but running tasks keep
+    running and tasks that need other resources are dispatched.
+  */
+  auto callback = [](Status, std::function<void()>, std::function<void()>) {};
+  std::vector<rpc::RequestWorkerLeaseReply> replies(4);
+  auto granted = [&](int i) { return !replies[i].worker_address().worker_id().empty(); };
+  AddWorkers(1);
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 4}}),
+                                     &replies[0], callback);
+  ASSERT_TRUE(granted(0));
+
+  // High priority, needs every CPU.
+  task_manager_.QueueAndScheduleTask(
+      CreateTask({{ray::kCPU_ResourceLabel, 8}}, 0, /*priority=*/10), &replies[1],
+      callback);
+  // Low priority, fits in the free CPUs.
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kCPU_ResourceLabel, 1}}),
+                                     &replies[2], callback);
+  // Low priority, needs no CPU.
+  task_manager_.QueueAndScheduleTask(CreateTask({{ray::kGPU_ResourceLabel, 1}}),
+                                     &replies[3], callback);
+  AddWorkers(3);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_FALSE(granted(1));
+  ASSERT_FALSE(granted(2));
+  ASSERT_TRUE(granted(3));
+
+  auto release = [&](int i) {
+    auto worker_id = WorkerID::FromBinary(replies[i].worker_address().worker_id());
+    task_manager_.ReleaseWorkerResources(leased_workers_[worker_id]);
+    leased_workers_.erase(worker_id);
+  };
+  release(0);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_TRUE(granted(1));
+  ASSERT_FALSE(granted(2));
+
+  release(1);
+  task_manager_.ScheduleAndDispatchTasks();
+  ASSERT_TRUE(granted(2));
+  AssertNoLeaks();
+}
+
 TEST_F(ClusterTaskManagerTest, TaskCancellationTest) {
   std::shared_ptr<MockWorker> worker =
       std::make_shared<MockWorker>(WorkerID::FromRandom(), 1234);
@@ -6,38 +6,65 @@
 #define RESOURCE_UNIT_SCALING 10000
 
 /// Fixed point data type.
+///
+/// Arithmetic and comparisons between FixedPoint values only touch the
+/// underlying integer, so they are constexpr and inlined. Only the
+/// conversions from and to double go through floating point.
 class FixedPoint {
  private:
   int64_t i_;
 
+  struct RawTag {};
+  constexpr FixedPoint(int64_t raw, RawTag) : i_(raw) {}
+
  public:
-  FixedPoint(double d = 0);
-  FixedPoint(int i);
+  constexpr FixedPoint() : i_(0) {}
+  FixedPoint(double d);
+  constexpr FixedPoint(int i) : i_(static_cast<int64_t>(i) * RESOURCE_UNIT_SCALING) {}
+
+  /// Create a FixedPoint from its underlying integer representation.
+  static constexpr FixedPoint FromRaw(int64_t raw) { return FixedPoint(raw, RawTag()); }
 
-  FixedPoint operator+(FixedPoint const &ru);
+  constexpr FixedPoint operator+(FixedPoint const &ru) const {
+    return FromRaw(i_ + ru.i_);
+  }
 
-  FixedPoint operator+=(FixedPoint const &ru);
+  FixedPoint operator+=(FixedPoint const &ru) {
+    i_ += ru.i_;
+    return *this;
+  }
 
-  FixedPoint operator-(FixedPoint const &ru);
+  constexpr FixedPoint operator-(FixedPoint const &ru) const {
+    return FromRaw(i_ - ru.i_);
+  }
 
-  FixedPoint operator-=(FixedPoint const &ru);
+  FixedPoint operator-=(FixedPoint const &ru) {
+    i_ -= ru.i_;
+    return *this;
+  }
 
-  FixedPoint operator-() const;
+  constexpr FixedPoint operator-() const { return FromRaw(-i_); }
 
-  FixedPoint operator+(double const d);
+  FixedPoint operator+(double const d) const;
 
-  FixedPoint operator-(double const d);
+  FixedPoint operator-(double const d) const;
 
   FixedPoint operator=(double const d);
 
-  bool operator<(FixedPoint const &ru1) const;
-  bool operator>(FixedPoint const &ru1) const;
-  bool operator<=(FixedPoint const &ru1) const;
-  bool operator>=(FixedPoint const &ru1) const;
-  bool operator==(FixedPoint const &ru1) const;
-  bool operator!=(FixedPoint const &ru1) const;
+  constexpr bool operator<(FixedPoint const &ru1) const { return i_ < ru1.i_; }
+  constexpr bool operator>(FixedPoint const &ru1) const { return i_ > ru1.i_; }
+  constexpr bool operator<=(FixedPoint const &ru1) const { return i_ <= ru1.i_; }
+  constexpr bool operator>=(FixedPoint const &ru1) const { return i_ >= ru1.i_; }
+  constexpr bool operator==(FixedPoint const &ru1) const { return i_ == ru1.i_; }
+  constexpr bool operator!=(FixedPoint const &ru1) const { return i_ != ru1.i_; }
+
+  constexpr double Double() const {
+    return static_cast<double>(i_) / RESOURCE_UNIT_SCALING;
+  }
 
-  double Double() const;
+  /// Return the underlying integer representation, in units of
+  /// 1/RESOURCE_UNIT_SCALING.
+  constexpr int64_t Raw() const { return i_; }
 
   friend std::ostream &operator<<(std::ostream &out, FixedPoint const &ru1);
 };
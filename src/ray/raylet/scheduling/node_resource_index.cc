@@ -0,0 +1,108 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/node_resource_index.h"
+
+namespace ray {
+
+int NodeResourceIndex::BucketOf(const FixedPoint &capacity) {
+  if (capacity.Raw() <= 0) {
+    return 0;
+  }
+  uint64_t raw = capacity.Raw();
+  int bucket = 0;
+  while (raw > 0 && bucket < kNumBuckets - 1) {
+    raw >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void NodeResourceIndex::AddOrUpdateNode(int64_t node_id,
+                                        const NodeResources &resources) {
+  ResourceBuckets new_buckets;
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    new_buckets[i] = i < resources.predefined_resources.size()
+                         ? BucketOf(resources.predefined_resources[i].available)
+                         : 0;
+  }
+
+  auto it = node_buckets_.find(node_id);
+  if (it == node_buckets_.end()) {
+    for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+      buckets_[i][new_buckets[i]].insert(node_id);
+    }
+    node_buckets_.emplace(node_id, new_buckets);
+    return;
+  }
+
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    if (it->second[i] != new_buckets[i]) {
+      buckets_[i][it->second[i]].erase(node_id);
+      buckets_[i][new_buckets[i]].insert(node_id);
+    }
+  }
+  it->second = new_buckets;
+}
+
+void NodeResourceIndex::RemoveNode(int64_t node_id) {
+  auto it = node_buckets_.find(node_id);
+  if (it == node_buckets_.end()) {
+    return;
+  }
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    buckets_[i][it->second[i]].erase(node_id);
+  }
+  node_buckets_.erase(it);
+}
+
+bool NodeResourceIndex::ForEachCandidateNode(
+    const TaskRequest &task_req, const std::function<bool(int64_t)> &visitor) const {
+  // Pick the hard predefined demand that rules out the most nodes.
+  int best_resource = -1;
+  int best_bucket = 0;
+  size_t min_candidates = 0;
+  for (size_t i = 0; i < PredefinedResources_MAX && i < task_req.predefined_resources.size();
+       i++) {
+    const auto &request = task_req.predefined_resources[i];
+    if (request.soft || request.demand <= 0) {
+      continue;
+    }
+    int bucket = BucketOf(request.demand);
+    size_t num_candidates = 0;
+    for (int b = bucket; b < kNumBuckets; b++) {
+      num_candidates += buckets_[i][b].size();
+    }
+    if (best_resource == -1 || num_candidates < min_candidates) {
+      best_resource = static_cast<int>(i);
+      best_bucket = bucket;
+      min_candidates = num_candidates;
+    }
+  }
+
+  if (best_resource == -1) {
+    return false;
+  }
+
+  for (int b = best_bucket; b < kNumBuckets; b++) {
+    for (const auto &node_id : buckets_[best_resource][b]) {
+      if (!visitor(node_id)) {
+        return true;
+      }
+    }
+  }
+  return true;
+}
+
+}  // end namespace ray
@@ -0,0 +1,82 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <functional>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "ray/raylet/scheduling/cluster_resource_data.h"
+#include "ray/raylet/scheduling/fixed_point.h"
+
+namespace ray {
+
+/// Index of the nodes in the cluster by the available capacity of each
+/// predefined resource. For each resource, nodes are grouped into buckets of
+/// exponentially increasing capacity, so the nodes that may be able to fit a
+/// demand can be enumerated without visiting the nodes that certainly cannot.
+/// The index is updated incrementally whenever a node's resources change.
+class NodeResourceIndex {
+ public:
+  /// Add a new node to the index or update the resources of an existing node.
+  ///
+  /// \param node_id: ID of the node.
+  /// \param resources: Up to date resources of the node.
+  void AddOrUpdateNode(int64_t node_id, const NodeResources &resources);
+
+  /// Remove a node from the index.
+  ///
+  /// \param node_id: ID of the node.
+  void RemoveNode(int64_t node_id);
+
+  /// Visit the nodes that might have enough available capacity to satisfy the
+  /// hard predefined resource demands of a task request. Nodes in the same
+  /// bucket as the demand are visited first, followed by nodes with strictly
+  /// more capacity, so that the visited nodes are still not guaranteed to
+  /// fit the request and the caller must check them.
+  ///
+  /// \param task_req: Task request to be scheduled.
+  /// \param visitor: Called for each candidate node. Return false to stop
+  /// the iteration.
+  /// \return false if the request has no hard predefined demand, in which
+  /// case the index cannot narrow down the candidates and nothing is visited.
+  bool ForEachCandidateNode(const TaskRequest &task_req,
+                            const std::function<bool(int64_t)> &visitor) const;
+
+  /// Get number of indexed nodes.
+  size_t NumNodes() const { return node_buckets_.size(); }
+
+ private:
+  /// Number of buckets per resource. Bucket 0 holds nodes with no available
+  /// capacity and bucket i > 0 holds capacities in [2^(i-1), 2^i) in raw
+  /// FixedPoint units.
+  static constexpr int kNumBuckets = 64;
+
+  using ResourceBuckets = std::array<int, PredefinedResources_MAX>;
+
+  /// Return the bucket that a capacity belongs to.
+  static int BucketOf(const FixedPoint &capacity);
+
+  /// Nodes in each bucket, for each predefined resource.
+  std::array<std::array<absl::flat_hash_set<int64_t>, kNumBuckets>,
+             PredefinedResources_MAX>
+      buckets_;
+
+  /// The buckets each node currently belongs to.
+  absl::flat_hash_map<int64_t, ResourceBuckets> node_buckets_;
+};
+
+}  // end namespace ray
@@ -0,0 +1,142 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/node_selection_policy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "ray/common/ray_config.h"
+
+namespace ray {
+
+namespace {
+
+float GetUtilization(const ResourceCapacity &capacity) {
+  if (capacity.total <= 0) {
+    return 0;
+  }
+  float utilization = 1 - static_cast<float>(capacity.available.Double() /
+                                             capacity.total.Double());
+  return std::max(0.f, std::min(1.f, utilization));
+}
+
+}  // namespace
+
+float GetCriticalResourceUtilization(const NodeResources &resources) {
+  float utilization = 0;
+  for (const auto &capacity : resources.predefined_resources) {
+    utilization = std::max(utilization, GetUtilization(capacity));
+  }
+  for (const auto &entry : resources.custom_resources) {
+    utilization = std::max(utilization, GetUtilization(entry.second));
+  }
+  return utilization;
+}
+
+int64_t HybridNodeSelectionPolicy::Schedule(const TaskRequest &task_req,
+                                            const ClusterResourceViewInterface &view) {
+  int64_t best_node = -1;
+  float best_utilization = std::numeric_limits<float>::max();
+  // Returns true once a node below the spread threshold is found, to stop the
+  // scan.
+  auto check_node = [&](int64_t node_id) {
+    const auto &resources = view.GetNodeView(node_id);
+    if (view.IsSchedulable(task_req, node_id, resources) != 0) {
+      return false;
+    }
+    float utilization = GetCriticalResourceUtilization(resources);
+    if (utilization < spread_threshold_) {
+      best_node = node_id;
+      return true;
+    }
+    if (utilization < best_utilization) {
+      best_utilization = utilization;
+      best_node = node_id;
+    }
+    return false;
+  };
+
+  const int64_t local_node_id = view.GetLocalNodeId();
+  if (check_node(local_node_id)) {
+    return best_node;
+  }
+  for (size_t i = 0; i < view.NumNodesInView(); i++) {
+    const int64_t node_id = view.NodeIdAt(i);
+    if (node_id != local_node_id && check_node(node_id)) {
+      break;
+    }
+  }
+  return best_node;
+}
+
+int64_t SpreadNodeSelectionPolicy::Schedule(const TaskRequest &task_req,
+                                            const ClusterResourceViewInterface &view) {
+  const size_t num_nodes = view.NumNodesInView();
+  for (size_t i = 0; i < num_nodes; i++) {
+    const size_t index = (next_index_ + i) % num_nodes;
+    const int64_t node_id = view.NodeIdAt(index);
+    if (view.IsSchedulable(task_req, node_id, view.GetNodeView(node_id)) == 0) {
+      next_index_ = index + 1;
+      return node_id;
+    }
+  }
+  return -1;
+}
+
+RandomOfTwoNodeSelectionPolicy::RandomOfTwoNodeSelectionPolicy()
+    : gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {}
+
+int64_t RandomOfTwoNodeSelectionPolicy::Schedule(
+    const TaskRequest &task_req, const ClusterResourceViewInterface &view) {
+  const size_t num_nodes = view.NumNodesInView();
+  if (num_nodes == 0) {
+    return -1;
+  }
+  std::uniform_int_distribution<size_t> distribution(0, num_nodes - 1);
+  int64_t best_node = -1;
+  float best_utilization = std::numeric_limits<float>::max();
+  for (int i = 0; i < 2; i++) {
+    const int64_t node_id = view.NodeIdAt(distribution(gen_));
+    const auto &resources = view.GetNodeView(node_id);
+    if (view.IsSchedulable(task_req, node_id, resources) != 0) {
+      continue;
+    }
+    float utilization = GetCriticalResourceUtilization(resources);
+    if (utilization < best_utilization) {
+      best_utilization = utilization;
+      best_node = node_id;
+    }
+  }
+  return best_node;
+}
+
+std::unique_ptr<NodeSelectionPolicyInterface> CreateNodeSelectionPolicy(
+    rpc::SchedulingPolicyType policy_type) {
+  switch (policy_type) {
+  case rpc::SchedulingPolicyType::HYBRID_POLICY:
+    return std::unique_ptr<NodeSelectionPolicyInterface>(new HybridNodeSelectionPolicy(
+        RayConfig::instance().scheduler_spread_threshold()));
+  case rpc::SchedulingPolicyType::SPREAD_POLICY:
+    return std::unique_ptr<NodeSelectionPolicyInterface>(new SpreadNodeSelectionPolicy());
+  case rpc::SchedulingPolicyType::RANDOM_OF_TWO_POLICY:
+    return std::unique_ptr<NodeSelectionPolicyInterface>(
+        new RandomOfTwoNodeSelectionPolicy());
+  default:
+    return nullptr;
+  }
+}
+
+}  // end namespace ray
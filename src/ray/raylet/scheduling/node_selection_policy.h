@@ -0,0 +1,136 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <random>
+
+#include "ray/raylet/scheduling/cluster_resource_data.h"
+#include "src/ray/protobuf/gcs.pb.h"
+
+namespace ray {
+
+/// \class ClusterResourceViewInterface
+///
+/// Read access to a scheduler's view of the resources of the cluster, used by
+/// the node selection policies.
+class ClusterResourceViewInterface {
+ public:
+  virtual ~ClusterResourceViewInterface() = default;
+
+  /// Get the ID of the local node.
+  virtual int64_t GetLocalNodeId() const = 0;
+
+  /// Get the number of nodes in the view, including the local node.
+  virtual size_t NumNodesInView() const = 0;
+
+  /// Get the ID of a node by its position in the view. Positions are dense
+  /// but may change when nodes are removed.
+  ///
+  /// \param index: Position of the node, in [0, NumNodesInView()).
+  virtual int64_t NodeIdAt(size_t index) const = 0;
+
+  /// Get our view of the resources of a node in the view.
+  virtual const NodeResources &GetNodeView(int64_t node_id) const = 0;
+
+  /// Check whether a task request can be scheduled on a node.
+  ///
+  /// \return -1 if a hard constraint is violated, else the number of soft
+  /// constraint violations.
+  virtual int64_t IsSchedulable(const TaskRequest &task_req, int64_t node_id,
+                                const NodeResources &resources) const = 0;
+};
+
+/// \class NodeSelectionPolicyInterface
+///
+/// Used for different kinds of policies to pick the node a task or an actor
+/// is scheduled on. A policy only chooses among the nodes that have the
+/// resources of the request available. If there is none, it returns -1 and
+/// the scheduler falls back to its default policy, which decides whether the
+/// request waits locally, goes to a node where it is feasible, or is
+/// infeasible.
+class NodeSelectionPolicyInterface {
+ public:
+  virtual ~NodeSelectionPolicyInterface() = default;
+
+  /// Select a node to schedule a request.
+  ///
+  /// \param task_req: The request to be scheduled.
+  /// \param view: The scheduler's view of the cluster.
+  /// \return The selected node, or -1 if no node has the resources available.
+  virtual int64_t Schedule(const TaskRequest &task_req,
+                           const ClusterResourceViewInterface &view) = 0;
+};
+
+/// \class HybridNodeSelectionPolicy
+///
+/// Pack requests onto the first node, starting with the local node, whose
+/// utilization is below a threshold. Once every available node is above the
+/// threshold, spread the requests by picking the least utilized node.
+class HybridNodeSelectionPolicy : public NodeSelectionPolicyInterface {
+ public:
+  /// \param spread_threshold: Utilization of a node's most utilized resource
+  /// above which the policy stops packing onto it.
+  explicit HybridNodeSelectionPolicy(float spread_threshold)
+      : spread_threshold_(spread_threshold) {}
+
+  int64_t Schedule(const TaskRequest &task_req,
+                   const ClusterResourceViewInterface &view) override;
+
+ private:
+  const float spread_threshold_;
+};
+
+/// \class SpreadNodeSelectionPolicy
+///
+/// Spread requests over the available nodes round-robin.
+class SpreadNodeSelectionPolicy : public NodeSelectionPolicyInterface {
+ public:
+  int64_t Schedule(const TaskRequest &task_req,
+                   const ClusterResourceViewInterface &view) override;
+
+ private:
+  /// Position in the view at which the next search starts.
+  size_t next_index_ = 0;
+};
+
+/// \class RandomOfTwoNodeSelectionPolicy
+///
+/// Sample two nodes at random and pick the less utilized one that has the
+/// resources available. This looks at a constant number of nodes per
+/// request, regardless of the size of the cluster.
+class RandomOfTwoNodeSelectionPolicy : public NodeSelectionPolicyInterface {
+ public:
+  RandomOfTwoNodeSelectionPolicy();
+
+  int64_t Schedule(const TaskRequest &task_req,
+                   const ClusterResourceViewInterface &view) override;
+
+ private:
+  std::mt19937_64 gen_;
+};
+
+/// Create the policy of a given type.
+///
+/// \return The policy, or nullptr for the default policy, which is
+/// implemented by the scheduler itself.
+std::unique_ptr<NodeSelectionPolicyInterface> CreateNodeSelectionPolicy(
+    rpc::SchedulingPolicyType policy_type);
+
+/// Get the utilization of the most utilized resource of a node, between 0
+/// and 1.
+float GetCriticalResourceUtilization(const NodeResources &resources);
+
+}  // end namespace ray
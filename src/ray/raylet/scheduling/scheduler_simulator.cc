@@ -0,0 +1,313 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/scheduler_simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+#include "absl/strings/numbers.h"
+#include "absl/time/clock.h"
+
+namespace ray {
+
+namespace {
+
+/// Tolerance when comparing the simulated available resources of a node.
+constexpr double kResourceEpsilon = 1e-9;
+
+std::string ShapeKey(const std::unordered_map<std::string, double> &resources) {
+  std::map<std::string, double> sorted(resources.begin(), resources.end());
+  std::stringstream key;
+  for (const auto &entry : sorted) {
+    key << entry.first << ":" << entry.second << ",";
+  }
+  return key.str();
+}
+
+int64_t Percentile(const std::vector<int64_t> &sorted, int percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[(sorted.size() - 1) * percentile / 100];
+}
+
+}  // namespace
+
+std::string SchedulerSimulatorReport::ToString() const {
+  std::stringstream result;
+  result << "tasks: " << num_tasks << "\n";
+  result << "finished: " << num_finished << "\n";
+  result << "infeasible: " << num_infeasible << "\n";
+  result << "spilled back: " << num_spilled_back << "\n";
+  result << "makespan ms: " << makespan_ms << "\n";
+  result << "scheduling latency ms: p50 " << latency_p50_ms << ", p90 " << latency_p90_ms
+         << ", p99 " << latency_p99_ms << ", max " << latency_max_ms << "\n";
+  result << "scheduling decisions: " << num_decisions << "\n";
+  result << "scheduler time ms: " << scheduler_time_ns / 1e6;
+  if (num_decisions > 0) {
+    result << " (" << scheduler_time_ns / num_decisions << " ns per decision)";
+  }
+  result << "\n";
+  return result.str();
+}
+
+SchedulerSimulatorReport SchedulerSimulator::Run(
+    const std::vector<SimulatedTask> &trace) {
+  RAY_CHECK(config_.num_nodes > 0);
+  RAY_CHECK(config_.heartbeat_period_ms > 0);
+  node_names_.clear();
+  node_indexes_.clear();
+  for (int64_t i = 0; i < config_.num_nodes; i++) {
+    node_names_.push_back("node_" + std::to_string(i));
+    node_indexes_[node_names_.back()] = i;
+  }
+  scheduler_.reset(new ClusterResourceScheduler(node_names_[0], config_.node_resources));
+  for (int64_t i = 1; i < config_.num_nodes; i++) {
+    scheduler_->AddOrUpdateNode(node_names_[i], config_.node_resources,
+                                config_.node_resources);
+  }
+  available_.assign(config_.num_nodes, config_.node_resources);
+  freed_since_report_.assign(config_.num_nodes, false);
+  num_freed_since_report_ = 0;
+  queues_.clear();
+  running_.clear();
+  completions_ = decltype(completions_)();
+  latencies_ms_.clear();
+  report_ = SchedulerSimulatorReport();
+  report_.num_tasks = trace.size();
+  for (const auto &task : trace) {
+    RAY_CHECK(task.submit_time_ms >= 0 && task.duration_ms >= 0);
+  }
+  if (trace.empty()) {
+    return report_;
+  }
+
+  std::vector<size_t> submit_order(trace.size());
+  std::iota(submit_order.begin(), submit_order.end(), 0);
+  std::stable_sort(submit_order.begin(), submit_order.end(), [&](size_t a, size_t b) {
+    return trace[a].submit_time_ms < trace[b].submit_time_ms;
+  });
+  const int64_t start_ms = trace[submit_order[0]].submit_time_ms;
+  int64_t next_heartbeat_ms = start_ms + config_.heartbeat_period_ms;
+  int64_t last_completion_ms = start_ms;
+  size_t next_submit = 0;
+
+  while (true) {
+    int64_t now_ms = std::numeric_limits<int64_t>::max();
+    if (next_submit < submit_order.size()) {
+      now_ms = trace[submit_order[next_submit]].submit_time_ms;
+    }
+    if (!completions_.empty()) {
+      now_ms = std::min(now_ms, completions_.top().first);
+    }
+    if (num_freed_since_report_ > 0) {
+      now_ms = std::min(now_ms, next_heartbeat_ms);
+    }
+    if (now_ms == std::numeric_limits<int64_t>::max()) {
+      // Nothing will happen anymore. Tasks that are still queued never run.
+      break;
+    }
+
+    while (!completions_.empty() && completions_.top().first == now_ms) {
+      const size_t task_index = completions_.top().second;
+      completions_.pop();
+      auto it = running_.find(task_index);
+      RAY_CHECK(it != running_.end());
+      const int64_t node_index = it->second.node_index;
+      if (node_index == 0) {
+        scheduler_->ReleaseWorkerResources(it->second.local_allocation);
+      } else {
+        for (const auto &resource : trace[task_index].resources) {
+          available_[node_index][resource.first] += resource.second;
+        }
+        if (!freed_since_report_[node_index]) {
+          freed_since_report_[node_index] = true;
+          num_freed_since_report_++;
+        }
+      }
+      running_.erase(it);
+      report_.num_finished++;
+      last_completion_ms = now_ms;
+    }
+
+    if (now_ms >= next_heartbeat_ms) {
+      ReportResourceUsage();
+      next_heartbeat_ms +=
+          ((now_ms - next_heartbeat_ms) / config_.heartbeat_period_ms + 1) *
+          config_.heartbeat_period_ms;
+    }
+
+    while (next_submit < submit_order.size() &&
+           trace[submit_order[next_submit]].submit_time_ms == now_ms) {
+      const size_t task_index = submit_order[next_submit++];
+      queues_[ShapeKey(trace[task_index].resources)].push_back(task_index);
+    }
+
+    ScheduleQueuedTasks(now_ms, trace);
+  }
+
+  report_.makespan_ms = last_completion_ms - start_ms;
+  std::sort(latencies_ms_.begin(), latencies_ms_.end());
+  report_.latency_p50_ms = Percentile(latencies_ms_, 50);
+  report_.latency_p90_ms = Percentile(latencies_ms_, 90);
+  report_.latency_p99_ms = Percentile(latencies_ms_, 99);
+  report_.latency_max_ms = Percentile(latencies_ms_, 100);
+  return report_;
+}
+
+void SchedulerSimulator::ScheduleQueuedTasks(int64_t now_ms,
+                                             const std::vector<SimulatedTask> &trace) {
+  for (auto queue_it = queues_.begin(); queue_it != queues_.end();) {
+    auto &queue = queue_it->second;
+    while (!queue.empty() && TrySchedule(now_ms, queue.front(), trace)) {
+      queue.pop_front();
+    }
+    if (queue.empty()) {
+      queue_it = queues_.erase(queue_it);
+    } else {
+      queue_it++;
+    }
+  }
+}
+
+bool SchedulerSimulator::TrySchedule(int64_t now_ms, size_t task_index,
+                                     const std::vector<SimulatedTask> &trace) {
+  const auto &task = trace[task_index];
+  int64_t violations;
+  bool is_infeasible;
+  const int64_t start_ns = absl::GetCurrentTimeNanos();
+  const std::string node_name = scheduler_->GetBestSchedulableNode(
+      task.resources, /*actor_creation=*/false, &violations, &is_infeasible,
+      config_.policy_type);
+  report_.scheduler_time_ns += absl::GetCurrentTimeNanos() - start_ns;
+  report_.num_decisions++;
+
+  if (is_infeasible) {
+    report_.num_infeasible++;
+    return true;
+  }
+  if (node_name.empty()) {
+    return false;
+  }
+
+  const int64_t node_index = node_indexes_[node_name];
+  RunningTask running_task{node_index, nullptr};
+  if (node_index == 0) {
+    running_task.local_allocation = std::make_shared<TaskResourceInstances>();
+    if (!scheduler_->AllocateLocalTaskResources(task.resources,
+                                                running_task.local_allocation)) {
+      return false;
+    }
+  } else {
+    auto &available = available_[node_index];
+    for (const auto &resource : task.resources) {
+      auto it = available.find(resource.first);
+      if (it == available.end() || it->second + kResourceEpsilon < resource.second) {
+        // The task was sent to a node on which it is only feasible.
+        return false;
+      }
+    }
+    scheduler_->AllocateRemoteTaskResources(node_name, task.resources);
+    for (const auto &resource : task.resources) {
+      available[resource.first] -= resource.second;
+    }
+    report_.num_spilled_back++;
+  }
+
+  latencies_ms_.push_back(now_ms - task.submit_time_ms);
+  running_.emplace(task_index, std::move(running_task));
+  completions_.emplace(now_ms + task.duration_ms, task_index);
+  return true;
+}
+
+void SchedulerSimulator::ReportResourceUsage() {
+  if (num_freed_since_report_ == 0) {
+    return;
+  }
+  for (size_t i = 1; i < freed_since_report_.size(); i++) {
+    if (freed_since_report_[i]) {
+      scheduler_->AddOrUpdateNode(node_names_[i], config_.node_resources, available_[i]);
+      freed_since_report_[i] = false;
+    }
+  }
+  num_freed_since_report_ = 0;
+}
+
+Status ParseResourceList(const std::string &list,
+                         std::unordered_map<std::string, double> *resources) {
+  std::istringstream resource_stream(list);
+  std::string resource_name;
+  std::string resource_quantity;
+  while (std::getline(resource_stream, resource_name, ',')) {
+    double quantity;
+    if (!std::getline(resource_stream, resource_quantity, ',') ||
+        !absl::SimpleAtod(resource_quantity, &quantity) || !(quantity >= 0)) {
+      return Status::Invalid("Malformed resource list: " + list);
+    }
+    (*resources)[resource_name] = quantity;
+  }
+  return Status::OK();
+}
+
+Status ParseSimulatedTrace(std::istream &in, std::vector<SimulatedTask> *trace) {
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream line_stream(line);
+    SimulatedTask task;
+    std::string resource_list;
+    if (!(line_stream >> task.submit_time_ms >> task.duration_ms >> resource_list)) {
+      return Status::Invalid("Malformed trace line: " + line);
+    }
+    if (task.submit_time_ms < 0 || task.duration_ms < 0) {
+      return Status::Invalid("Negative time in trace line: " + line);
+    }
+    if (!ParseResourceList(resource_list, &task.resources).ok()) {
+      return Status::Invalid("Malformed resource list in trace line: " + line);
+    }
+    trace->push_back(std::move(task));
+  }
+  return Status::OK();
+}
+
+std::vector<SimulatedTask> GenerateSimulatedTrace(
+    int64_t num_tasks, double tasks_per_second, double median_duration_ms,
+    double duration_sigma, const std::unordered_map<std::string, double> &resources,
+    uint64_t seed) {
+  std::mt19937_64 gen(seed);
+  std::exponential_distribution<double> interarrival_ms(tasks_per_second / 1000);
+  std::lognormal_distribution<double> duration_ms(std::log(median_duration_ms),
+                                                  duration_sigma);
+  std::vector<SimulatedTask> trace;
+  trace.reserve(num_tasks);
+  double submit_time_ms = 0;
+  for (int64_t i = 0; i < num_tasks; i++) {
+    SimulatedTask task;
+    task.submit_time_ms = static_cast<int64_t>(submit_time_ms);
+    task.duration_ms = std::max<int64_t>(1, std::llround(duration_ms(gen)));
+    task.resources = resources;
+    trace.push_back(std::move(task));
+    submit_time_ms += interarrival_ms(gen);
+  }
+  return trace;
+}
+
+}  // end namespace ray
@@ -0,0 +1,176 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+#include <istream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ray/common/status.h"
+#include "ray/raylet/scheduling/cluster_resource_scheduler.h"
+#include "src/ray/protobuf/gcs.pb.h"
+
+namespace ray {
+
+/// A task of a trace replayed by the SchedulerSimulator.
+struct SimulatedTask {
+  /// Virtual time at which the task is submitted.
+  int64_t submit_time_ms;
+  /// How long the task runs once it is placed on a node.
+  int64_t duration_ms;
+  /// Resources required by the task.
+  std::unordered_map<std::string, double> resources;
+};
+
+/// Configuration of a simulated cluster.
+struct SchedulerSimulatorConfig {
+  /// Number of nodes, including the node that all tasks are submitted to.
+  int64_t num_nodes = 1;
+  /// Total resources of each node.
+  std::unordered_map<std::string, double> node_resources;
+  /// Virtual time between two resource usage reports of a remote node. Until
+  /// a node reports, the submitting node does not see resources that the
+  /// node freed.
+  int64_t heartbeat_period_ms = 100;
+  /// The node selection policy to schedule with.
+  rpc::SchedulingPolicyType policy_type = rpc::SchedulingPolicyType::DEFAULT_POLICY;
+};
+
+/// Results of a simulation.
+struct SchedulerSimulatorReport {
+  int64_t num_tasks = 0;
+  int64_t num_finished = 0;
+  int64_t num_infeasible = 0;
+  /// Number of tasks placed on a node other than the submitting node.
+  int64_t num_spilled_back = 0;
+  /// Virtual time from the first submission to the last completion.
+  int64_t makespan_ms = 0;
+  /// Percentiles of the virtual time between submitting and placing a task.
+  int64_t latency_p50_ms = 0;
+  int64_t latency_p90_ms = 0;
+  int64_t latency_p99_ms = 0;
+  int64_t latency_max_ms = 0;
+  /// Number of calls to the scheduler to pick a node.
+  int64_t num_decisions = 0;
+  /// Real time spent in the scheduler picking nodes.
+  int64_t scheduler_time_ns = 0;
+
+  std::string ToString() const;
+};
+
+/// Replay a trace of task submissions against a ClusterResourceScheduler
+/// with synthetic nodes and virtual time.
+///
+/// Only the node selection of ClusterResourceScheduler and its policies is
+/// exercised. The queueing and dispatch of ClusterTaskManager, e.g., the
+/// dispatch order across scheduling classes, worker startup, and spillback
+/// between raylets, are not, and are instead modeled by a queue per task
+/// shape below.
+///
+/// All tasks are submitted to one node, whose scheduler sees the other nodes
+/// through their periodic resource usage reports, like a raylet does. A task
+/// is placed as soon as the scheduler picks a node that has the resources
+/// available. Otherwise it stays queued behind the earlier tasks that request
+/// the same resources, until resources are freed or reported. A task that
+/// the scheduler sends to a node that cannot run it yet also stays queued.
+class SchedulerSimulator {
+ public:
+  explicit SchedulerSimulator(const SchedulerSimulatorConfig &config)
+      : config_(config) {}
+
+  /// Replay a trace on a fresh cluster.
+  ///
+  /// \param trace: Tasks to submit, in any order. Their times must not be negative.
+  /// \return The results of the simulation.
+  SchedulerSimulatorReport Run(const std::vector<SimulatedTask> &trace);
+
+ private:
+  struct RunningTask {
+    int64_t node_index;
+    std::shared_ptr<TaskResourceInstances> local_allocation;
+  };
+
+  /// Try to place the queued tasks, in order of submission for each shape.
+  void ScheduleQueuedTasks(int64_t now_ms, const std::vector<SimulatedTask> &trace);
+
+  /// Try to place a single task.
+  ///
+  /// \return True if the task should be removed from the queue.
+  bool TrySchedule(int64_t now_ms, size_t task_index,
+                   const std::vector<SimulatedTask> &trace);
+
+  /// Make the submitting node see the resources of the remote nodes that
+  /// freed resources since the last report.
+  void ReportResourceUsage();
+
+  const SchedulerSimulatorConfig config_;
+  std::unique_ptr<ClusterResourceScheduler> scheduler_;
+  std::vector<std::string> node_names_;
+  std::unordered_map<std::string, int64_t> node_indexes_;
+  /// The actual available resources of each remote node.
+  std::vector<std::unordered_map<std::string, double>> available_;
+  /// Remote nodes that freed resources since the last report.
+  std::vector<bool> freed_since_report_;
+  size_t num_freed_since_report_ = 0;
+  /// Queued tasks by shape, in order of submission.
+  std::map<std::string, std::deque<size_t>> queues_;
+  std::unordered_map<size_t, RunningTask> running_;
+  /// Completion events: virtual time and task index.
+  std::priority_queue<std::pair<int64_t, size_t>,
+                      std::vector<std::pair<int64_t, size_t>>,
+                      std::greater<std::pair<int64_t, size_t>>>
+      completions_;
+  std::vector<int64_t> latencies_ms_;
+  SchedulerSimulatorReport report_;
+};
+
+/// Parse a resource list in the format
+/// "<resource>,<quantity>[,<resource>,<quantity>...]".
+///
+/// \param list: The resource list.
+/// \param resources[out]: The parsed resources.
+/// \return Status::Invalid if a quantity is missing, or is not a non-negative number.
+Status ParseResourceList(const std::string &list,
+                         std::unordered_map<std::string, double> *resources);
+
+/// Parse a trace, one task per line in the format
+/// "<submit_time_ms> <duration_ms> <resource>,<quantity>[,<resource>,<quantity>...]".
+/// Empty lines and lines starting with '#' are skipped.
+///
+/// \param in: Stream to read the trace from.
+/// \param trace[out]: The parsed tasks.
+/// \return Status::Invalid if a line cannot be parsed or has a negative time.
+Status ParseSimulatedTrace(std::istream &in, std::vector<SimulatedTask> *trace);
+
+/// Generate a trace with Poisson arrivals and log-normal task durations, so
+/// that a few tasks run much longer than the others.
+///
+/// \param num_tasks: Number of tasks.
+/// \param tasks_per_second: Mean arrival rate.
+/// \param median_duration_ms: Median task duration.
+/// \param duration_sigma: Standard deviation of the log of the durations.
+/// \param resources: Resources required by each task.
+/// \param seed: Seed of the random generator.
+std::vector<SimulatedTask> GenerateSimulatedTrace(
+    int64_t num_tasks, double tasks_per_second, double median_duration_ms,
+    double duration_sigma, const std::unordered_map<std::string, double> &resources,
+    uint64_t seed);
+
+}  // end namespace ray
@@ -0,0 +1,84 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fstream>
+#include <iostream>
+
+#include "gflags/gflags.h"
+#include "ray/raylet/scheduling/scheduler_simulator.h"
+
+DEFINE_int64(num_nodes, 100, "Number of nodes in the simulated cluster.");
+DEFINE_string(node_resources, "CPU,16", "The resource list of each node.");
+DEFINE_int64(heartbeat_period_ms, 100,
+             "Virtual time between two resource usage reports of a node.");
+DEFINE_string(policy, "default",
+              "The node selection policy: default, hybrid, spread or random_of_two.");
+DEFINE_string(trace_file, "",
+              "The trace to replay. If empty, a synthetic trace is generated.");
+DEFINE_int64(num_tasks, 100000, "Number of tasks of the synthetic trace.");
+DEFINE_double(tasks_per_second, 10000, "Arrival rate of the synthetic trace.");
+DEFINE_double(median_duration_ms, 100, "Median task duration of the synthetic trace.");
+DEFINE_double(duration_sigma, 1,
+              "Standard deviation of the log of the task durations of the synthetic "
+              "trace.");
+DEFINE_string(task_resources, "CPU,1",
+              "The resource list of each task of the synthetic trace.");
+DEFINE_uint64(seed, 0, "Seed of the synthetic trace.");
+
+namespace {
+
+std::unordered_map<std::string, double> ParseResourceListFlag(const std::string &list) {
+  std::unordered_map<std::string, double> resources;
+  RAY_CHECK_OK(ray::ParseResourceList(list, &resources));
+  return resources;
+}
+
+ray::rpc::SchedulingPolicyType ParsePolicy(const std::string &policy) {
+  if (policy == "hybrid") {
+    return ray::rpc::SchedulingPolicyType::HYBRID_POLICY;
+  } else if (policy == "spread") {
+    return ray::rpc::SchedulingPolicyType::SPREAD_POLICY;
+  } else if (policy == "random_of_two") {
+    return ray::rpc::SchedulingPolicyType::RANDOM_OF_TWO_POLICY;
+  }
+  RAY_CHECK(policy == "default") << "Unknown policy " << policy;
+  return ray::rpc::SchedulingPolicyType::DEFAULT_POLICY;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  ray::SchedulerSimulatorConfig config;
+  config.num_nodes = FLAGS_num_nodes;
+  config.node_resources = ParseResourceListFlag(FLAGS_node_resources);
+  config.heartbeat_period_ms = FLAGS_heartbeat_period_ms;
+  config.policy_type = ParsePolicy(FLAGS_policy);
+
+  std::vector<ray::SimulatedTask> trace;
+  if (!FLAGS_trace_file.empty()) {
+    std::ifstream trace_file(FLAGS_trace_file);
+    RAY_CHECK(trace_file) << "Failed to open " << FLAGS_trace_file;
+    RAY_CHECK_OK(ray::ParseSimulatedTrace(trace_file, &trace));
+  } else {
+    trace = ray::GenerateSimulatedTrace(
+        FLAGS_num_tasks, FLAGS_tasks_per_second, FLAGS_median_duration_ms,
+        FLAGS_duration_sigma, ParseResourceListFlag(FLAGS_task_resources), FLAGS_seed);
+  }
+
+  ray::SchedulerSimulator simulator(config);
+  std::cout << simulator.Run(trace).ToString();
+  return 0;
+}
@@ -0,0 +1,132 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling/scheduler_simulator.h"
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+class SchedulerSimulatorTest : public ::testing::Test {
+ public:
+  SchedulerSimulatorConfig TwoNodeConfig() {
+    SchedulerSimulatorConfig config;
+    config.num_nodes = 2;
+    config.node_resources = {{"CPU", 2}};
+    config.heartbeat_period_ms = 50;
+    return config;
+  }
+
+  std::vector<SimulatedTask> SubmitAtOnce(int num_tasks, double num_cpus) {
+    std::vector<SimulatedTask> trace;
+    for (int i = 0; i < num_tasks; i++) {
+      trace.push_back(SimulatedTask{0, 100, {{"CPU", num_cpus}}});
+    }
+    return trace;
+  }
+};
+
+TEST_F(SchedulerSimulatorTest, SpillbackTest) {
+  SchedulerSimulator simulator(TwoNodeConfig());
+  auto report = simulator.Run(SubmitAtOnce(4, 1));
+  ASSERT_EQ(report.num_tasks, 4);
+  ASSERT_EQ(report.num_finished, 4);
+  ASSERT_EQ(report.num_spilled_back, 2);
+  ASSERT_EQ(report.makespan_ms, 100);
+  ASSERT_EQ(report.latency_max_ms, 0);
+  ASSERT_EQ(report.num_decisions, 4);
+}
+
+TEST_F(SchedulerSimulatorTest, QueueingTest) {
+  auto config = TwoNodeConfig();
+  SchedulerSimulator simulator(config);
+  auto report = simulator.Run(SubmitAtOnce(8, 1));
+  ASSERT_EQ(report.num_finished, 8);
+  // The tasks on the remote node are only placed once it reports the freed
+  // resources.
+  ASSERT_GE(report.makespan_ms, 200);
+  ASSERT_LE(report.makespan_ms, 200 + config.heartbeat_period_ms);
+  ASSERT_EQ(report.latency_p50_ms, 0);
+  ASSERT_GE(report.latency_max_ms, 100);
+
+  // Replaying a trace starts from a fresh cluster.
+  auto second_report = simulator.Run(SubmitAtOnce(8, 1));
+  ASSERT_EQ(second_report.num_finished, 8);
+  ASSERT_EQ(second_report.makespan_ms, report.makespan_ms);
+}
+
+TEST_F(SchedulerSimulatorTest, InfeasibleTest) {
+  SchedulerSimulator simulator(TwoNodeConfig());
+  auto report = simulator.Run(SubmitAtOnce(2, 4));
+  ASSERT_EQ(report.num_finished, 0);
+  ASSERT_EQ(report.num_infeasible, 2);
+}
+
+TEST_F(SchedulerSimulatorTest, ParseTraceTest) {
+  std::istringstream valid("# submit duration resources\n"
+                           "\n"
+                           "0 10 CPU,1\n"
+                           "5 20 CPU,0.5,GPU,1\n");
+  std::vector<SimulatedTask> trace;
+  ASSERT_TRUE(ParseSimulatedTrace(valid, &trace).ok());
+  ASSERT_EQ(trace.size(), 2);
+  ASSERT_EQ(trace[1].submit_time_ms, 5);
+  ASSERT_EQ(trace[1].duration_ms, 20);
+  ASSERT_EQ(trace[1].resources.size(), 2);
+  ASSERT_EQ(trace[1].resources["CPU"], 0.5);
+
+  std::istringstream missing_quantity("0 10 CPU\n");
+  ASSERT_TRUE(ParseSimulatedTrace(missing_quantity, &trace).IsInvalid());
+  std::istringstream missing_duration("0 CPU,1\n");
+  ASSERT_TRUE(ParseSimulatedTrace(missing_duration, &trace).IsInvalid());
+  std::istringstream malformed_quantity("0 10 CPU,one\n");
+  ASSERT_TRUE(ParseSimulatedTrace(malformed_quantity, &trace).IsInvalid());
+  std::istringstream negative_quantity("0 10 CPU,-1\n");
+  ASSERT_TRUE(ParseSimulatedTrace(negative_quantity, &trace).IsInvalid());
+  std::istringstream negative_submit_time("-5 10 CPU,1\n");
+  ASSERT_TRUE(ParseSimulatedTrace(negative_submit_time, &trace).IsInvalid());
+  std::istringstream negative_duration("0 -10 CPU,1\n");
+  ASSERT_TRUE(ParseSimulatedTrace(negative_duration, &trace).IsInvalid());
+  ASSERT_EQ(trace.size(), 2);
+}
+
+TEST_F(SchedulerSimulatorTest, ParseResourceListTest) {
+  std::unordered_map<std::string, double> resources;
+  ASSERT_TRUE(ParseResourceList("CPU,16,memory,1e9", &resources).ok());
+  ASSERT_EQ(resources.size(), 2);
+  ASSERT_EQ(resources["memory"], 1e9);
+  ASSERT_TRUE(ParseResourceList("CPU,", &resources).IsInvalid());
+  ASSERT_TRUE(ParseResourceList("CPU,16x", &resources).IsInvalid());
+  ASSERT_TRUE(ParseResourceList("CPU,nan", &resources).IsInvalid());
+}
+
+TEST_F(SchedulerSimulatorTest, GenerateTraceTest) {
+  auto trace = GenerateSimulatedTrace(1000, 1000, 50, 1, {{"CPU", 1}}, /*seed=*/42);
+  ASSERT_EQ(trace.size(), 1000);
+  for (size_t i = 1; i < trace.size(); i++) {
+    ASSERT_GE(trace[i].submit_time_ms, trace[i - 1].submit_time_ms);
+    ASSERT_GE(trace[i].duration_ms, 1);
+  }
+  auto same_trace = GenerateSimulatedTrace(1000, 1000, 50, 1, {{"CPU", 1}}, 42);
+  ASSERT_EQ(same_trace.back().submit_time_ms, trace.back().submit_time_ms);
+
+  auto config = TwoNodeConfig();
+  config.num_nodes = 10;
+  auto report = SchedulerSimulator(config).Run(trace);
+  ASSERT_EQ(report.num_finished, 1000);
+}
+
+}  // namespace ray
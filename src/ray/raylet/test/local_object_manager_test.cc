@@ -34,24 +34,43 @@ using ::testing::_;
 
 class MockWorkerClient : public rpc::CoreWorkerClientInterface {
  public:
-  void WaitForObjectEviction(
-      const rpc::WaitForObjectEvictionRequest &request,
-      const rpc::ClientCallback<rpc::WaitForObjectEvictionReply> &callback) override {
+  void AddObjectEvictionSubscriptions(
+      const rpc::AddObjectEvictionSubscriptionsRequest &request,
+      const rpc::ClientCallback<rpc::AddObjectEvictionSubscriptionsReply> &callback)
+      override {
+    num_subscription_requests++;
+    for (const auto &object_id : request.object_ids()) {
+      subscribed_objects.push_back(ObjectID::FromBinary(object_id));
+    }
+    callback(Status::OK(), rpc::AddObjectEvictionSubscriptionsReply());
+  }
+
+  void GetObjectEvictions(
+      const rpc::GetObjectEvictionsRequest &request,
+      const rpc::ClientCallback<rpc::GetObjectEvictionsReply> &callback) override {
     callbacks.push_back(callback);
   }
 
-  bool ReplyObjectEviction(Status status = Status::OK()) {
+  /// Evict the oldest subscribed objects by replying to the outstanding
+  /// long-poll.
+  bool ReplyObjectEviction(Status status = Status::OK(), size_t num_objects = 1) {
     if (callbacks.size() == 0) {
       return false;
     }
     auto callback = callbacks.front();
-    auto reply = rpc::WaitForObjectEvictionReply();
-    callback(status, reply);
+    auto reply = rpc::GetObjectEvictionsReply();
+    for (size_t i = 0; i < num_objects && !subscribed_objects.empty(); i++) {
+      reply.add_evicted_object_ids(subscribed_objects.front().Binary());
+      subscribed_objects.pop_front();
+    }
     callbacks.pop_front();
+    callback(status, reply);
     return true;
   }
 
-  std::list<rpc::ClientCallback<rpc::WaitForObjectEvictionReply>> callbacks;
+  int num_subscription_requests = 0;
+  std::list<ObjectID> subscribed_objects;
+  std::list<rpc::ClientCallback<rpc::GetObjectEvictionsReply>> callbacks;
 };
 
 class MockIOWorkerClient : public rpc::CoreWorkerClientInterface {
@@ -345,6 +364,61 @@ TEST_F(LocalObjectManagerTest, TestPin) {
   ASSERT_EQ(freed, expected);
 }
 
+TEST_F(LocalObjectManagerTest, TestBatchedEvictionSubscriptions) {
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+
+  std::vector<ObjectID> object_ids;
+  std::vector<std::unique_ptr<RayObject>> objects;
+  for (size_t i = 0; i < free_objects_batch_size; i++) {
+    ObjectID object_id = ObjectID::FromRandom();
+    object_ids.push_back(object_id);
+    auto data_buffer = std::make_shared<MockObjectBuffer>(0, object_id, unpins);
+    std::unique_ptr<RayObject> object(
+        new RayObject(data_buffer, nullptr, std::vector<ObjectID>()));
+    objects.push_back(std::move(object));
+  }
+  manager.PinObjects(object_ids, std::move(objects));
+  manager.WaitForObjectFree(owner_address, object_ids);
+  // All objects are subscribed with a single request, and there is a single
+  // long-poll outstanding for the owner.
+  ASSERT_EQ(owner_client->num_subscription_requests, 1);
+  ASSERT_EQ(owner_client->subscribed_objects.size(), free_objects_batch_size);
+  ASSERT_EQ(owner_client->callbacks.size(), 1);
+
+  // All objects are reported freed in one reply.
+  ASSERT_TRUE(owner_client->ReplyObjectEviction(Status::OK(), free_objects_batch_size));
+  std::unordered_set<ObjectID> expected(object_ids.begin(), object_ids.end());
+  ASSERT_EQ(freed, expected);
+  // No more long-polls once nothing is subscribed.
+  ASSERT_TRUE(owner_client->callbacks.empty());
+}
+
+TEST_F(LocalObjectManagerTest, TestOwnerFailureReleasesObjects) {
+  rpc::Address owner_address;
+  owner_address.set_worker_id(WorkerID::FromRandom().Binary());
+
+  std::vector<ObjectID> object_ids;
+  std::vector<std::unique_ptr<RayObject>> objects;
+  for (size_t i = 0; i < free_objects_batch_size; i++) {
+    ObjectID object_id = ObjectID::FromRandom();
+    object_ids.push_back(object_id);
+    auto data_buffer = std::make_shared<MockObjectBuffer>(0, object_id, unpins);
+    std::unique_ptr<RayObject> object(
+        new RayObject(data_buffer, nullptr, std::vector<ObjectID>()));
+    objects.push_back(std::move(object));
+  }
+  manager.PinObjects(object_ids, std::move(objects));
+  manager.WaitForObjectFree(owner_address, object_ids);
+
+  // The long-poll fails because the owner died, so all of its objects are
+  // released even though none were reported.
+  ASSERT_TRUE(owner_client->ReplyObjectEviction(Status::IOError(""), 0));
+  std::unordered_set<ObjectID> expected(object_ids.begin(), object_ids.end());
+  ASSERT_EQ(freed, expected);
+  ASSERT_TRUE(owner_client->callbacks.empty());
+}
+
 TEST_F(LocalObjectManagerTest, TestRestoreSpilledObject) {
   // First, spill objects.
   std::vector<ObjectID> object_ids;
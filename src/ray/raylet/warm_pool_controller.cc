@@ -0,0 +1,102 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/warm_pool_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ray {
+
+namespace raylet {
+
+WarmPoolController::WarmPoolController(int64_t half_life_ms, double prestart_fraction)
+    : half_life_ms_(half_life_ms), prestart_fraction_(prestart_fraction) {}
+
+void WarmPoolController::RecordBacklog(const WarmPoolKey &key, int64_t backlog_size) {
+  auto &forecast = forecasts_[key];
+  forecast.backlog = std::max(forecast.backlog, backlog_size);
+}
+
+void WarmPoolController::Update(const WarmPoolSizes &num_busy_workers, int64_t now_ms) {
+  double decay = 1;
+  if (last_update_ms_ >= 0 && half_life_ms_ > 0) {
+    decay = std::pow(0.5, static_cast<double>(now_ms - last_update_ms_) / half_life_ms_);
+  } else if (last_update_ms_ >= 0) {
+    decay = 0;
+  }
+  last_update_ms_ = now_ms;
+
+  for (const auto &entry : num_busy_workers) {
+    // Make sure that the pools with busy workers have a forecast.
+    forecasts_[entry.first];
+  }
+  for (auto it = forecasts_.begin(); it != forecasts_.end();) {
+    auto busy_it = num_busy_workers.find(it->first);
+    int64_t demand = it->second.backlog;
+    if (busy_it != num_busy_workers.end()) {
+      demand += busy_it->second;
+    }
+    it->second.size = std::max(static_cast<double>(demand), it->second.size * decay);
+    it->second.backlog = 0;
+    if (it->second.size < 0.5) {
+      // The pool is no longer needed.
+      forecasts_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+}
+
+int64_t WarmPoolController::GetTargetSize(const WarmPoolKey &key) const {
+  auto it = forecasts_.find(key);
+  if (it == forecasts_.end()) {
+    return 0;
+  }
+  return std::llround(it->second.size);
+}
+
+WarmPoolSizes WarmPoolController::GetWorkersToPrestart(
+    const WarmPoolSizes &num_workers,
+    const std::unordered_map<Language, int64_t, std::hash<int>> &num_starting_workers)
+    const {
+  WarmPoolSizes workers_to_prestart;
+  for (const auto &entry : forecasts_) {
+    int64_t target_size = std::llround(entry.second.size);
+    auto it = num_workers.find(entry.first);
+    int64_t size = it == num_workers.end() ? 0 : it->second;
+    auto starting_it = num_starting_workers.find(entry.first.language);
+    if (starting_it != num_starting_workers.end()) {
+      size += starting_it->second;
+    }
+    if (size < prestart_fraction_ * target_size) {
+      workers_to_prestart[entry.first] = target_size - size;
+    }
+  }
+  return workers_to_prestart;
+}
+
+void WarmPoolController::RemoveJob(const JobID &job_id) {
+  for (auto it = forecasts_.begin(); it != forecasts_.end();) {
+    if (it->first.job_id == job_id) {
+      forecasts_.erase(it++);
+    } else {
+      it++;
+    }
+  }
+}
+
+}  // namespace raylet
+
+}  // end namespace ray
@@ -0,0 +1,113 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "ray/common/id.h"
+#include "ray/common/task/task_common.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// A warm pool holds the generic workers of a job in a language, which can run any
+/// normal task of the job.
+struct WarmPoolKey {
+  Language language;
+  JobID job_id;
+
+  bool operator==(const WarmPoolKey &other) const {
+    return language == other.language && job_id == other.job_id;
+  }
+};
+
+struct WarmPoolKeyHash {
+  size_t operator()(const WarmPoolKey &key) const {
+    return std::hash<JobID>()(key.job_id) ^ std::hash<int>()(key.language);
+  }
+};
+
+/// A number of workers per warm pool.
+using WarmPoolSizes = std::unordered_map<WarmPoolKey, int64_t, WarmPoolKeyHash>;
+
+/// \class WarmPoolController
+///
+/// Forecasts the number of workers each warm pool needs, so that the worker pool
+/// keeps that many workers, busy or idle, and prestarts the missing ones.
+///
+/// The demand of a pool is the number of its workers that run a task plus the
+/// backlog of tasks reported by its lease requests. The forecast follows the demand
+/// up immediately, and decays with a half life once the demand drops, so that the
+/// workers of a periodic workload are kept between two bursts. The forecast has
+/// hysteresis: idle workers are only killed above it, and workers are only
+/// prestarted well below it.
+class WarmPoolController {
+ public:
+  /// Create a warm pool controller.
+  ///
+  /// \param half_life_ms The half life of the forecast of a pool once its demand drops.
+  /// \param prestart_fraction Workers are prestarted once a pool has fewer workers
+  /// than this fraction of its forecast.
+  WarmPoolController(int64_t half_life_ms, double prestart_fraction);
+
+  /// Record the backlog of tasks reported by a lease request of a pool. Only the
+  /// largest backlog reported between two updates is used.
+  ///
+  /// \param key The pool of the lease request.
+  /// \param backlog_size The number of tasks queued by the client for this pool.
+  void RecordBacklog(const WarmPoolKey &key, int64_t backlog_size);
+
+  /// Update the forecasts with the demand since the last update.
+  ///
+  /// \param num_busy_workers The number of workers of each pool that run a task.
+  /// \param now_ms The current time.
+  void Update(const WarmPoolSizes &num_busy_workers, int64_t now_ms);
+
+  /// Return the number of workers, busy or idle, to keep in a pool.
+  int64_t GetTargetSize(const WarmPoolKey &key) const;
+
+  /// Return the number of workers to prestart in each pool.
+  ///
+  /// \param num_workers The number of registered workers of each pool.
+  /// \param num_starting_workers The number of starting workers of each language. As
+  /// the job of a starting worker is not known, it is counted in every pool of its
+  /// language.
+  WarmPoolSizes GetWorkersToPrestart(
+      const WarmPoolSizes &num_workers,
+      const std::unordered_map<Language, int64_t, std::hash<int>> &num_starting_workers)
+      const;
+
+  /// Forget the pools of a finished job.
+  void RemoveJob(const JobID &job_id);
+
+ private:
+  struct Forecast {
+    /// The forecast number of workers.
+    double size = 0;
+    /// The largest backlog reported since the last update.
+    int64_t backlog = 0;
+  };
+
+  const int64_t half_life_ms_;
+  const double prestart_fraction_;
+  /// The time of the last update.
+  int64_t last_update_ms_ = -1;
+  std::unordered_map<WarmPoolKey, Forecast, WarmPoolKeyHash> forecasts_;
+};
+
+}  // namespace raylet
+
+}  // end namespace ray
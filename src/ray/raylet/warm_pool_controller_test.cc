@@ -0,0 +1,89 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/warm_pool_controller.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+namespace raylet {
+
+const WarmPoolKey PY_POOL = {Language::PYTHON, JobID::FromInt(1)};
+const WarmPoolKey JAVA_POOL = {Language::JAVA, JobID::FromInt(1)};
+const WarmPoolKey OTHER_JOB_POOL = {Language::PYTHON, JobID::FromInt(2)};
+
+class WarmPoolControllerTest : public ::testing::Test {
+ public:
+  WarmPoolControllerTest()
+      : controller_(/*half_life_ms=*/1000, /*prestart_fraction=*/0.5) {}
+
+ protected:
+  WarmPoolController controller_;
+};
+
+TEST_F(WarmPoolControllerTest, TestForecastFollowsDemand) {
+  controller_.Update({{PY_POOL, 2}}, 0);
+  ASSERT_EQ(controller_.GetTargetSize(PY_POOL), 2);
+  ASSERT_EQ(controller_.GetTargetSize(JAVA_POOL), 0);
+
+  // The backlog of the lease requests adds to the busy workers.
+  controller_.RecordBacklog(PY_POOL, 3);
+  controller_.RecordBacklog(PY_POOL, 1);
+  controller_.Update({{PY_POOL, 2}}, 100);
+  ASSERT_EQ(controller_.GetTargetSize(PY_POOL), 5);
+
+  // The forecast decays once the demand drops.
+  controller_.Update({}, 1100);
+  ASSERT_EQ(controller_.GetTargetSize(PY_POOL), 3);
+  controller_.Update({{PY_POOL, 1}}, 2100);
+  ASSERT_EQ(controller_.GetTargetSize(PY_POOL), 1);
+
+  // A new burst raises the forecast again.
+  controller_.Update({{PY_POOL, 4}}, 2200);
+  ASSERT_EQ(controller_.GetTargetSize(PY_POOL), 4);
+
+  // The pool is forgotten once its forecast is negligible.
+  controller_.Update({}, 10000);
+  ASSERT_EQ(controller_.GetTargetSize(PY_POOL), 0);
+}
+
+TEST_F(WarmPoolControllerTest, TestPrestartHysteresis) {
+  controller_.Update({{PY_POOL, 4}, {JAVA_POOL, 1}}, 0);
+  // Pools with at least half of their forecast are not topped up.
+  auto to_prestart =
+      controller_.GetWorkersToPrestart({{PY_POOL, 2}, {JAVA_POOL, 1}}, {});
+  ASSERT_TRUE(to_prestart.empty());
+  // Pools below half of their forecast are filled up to it.
+  to_prestart = controller_.GetWorkersToPrestart({{PY_POOL, 1}}, {});
+  ASSERT_EQ(to_prestart.size(), 2);
+  ASSERT_EQ(to_prestart[PY_POOL], 3);
+  ASSERT_EQ(to_prestart[JAVA_POOL], 1);
+  // The starting workers count in the pools of their language.
+  to_prestart = controller_.GetWorkersToPrestart({}, {{Language::PYTHON, 2}});
+  ASSERT_EQ(to_prestart.size(), 1);
+  ASSERT_EQ(to_prestart[JAVA_POOL], 1);
+}
+
+TEST_F(WarmPoolControllerTest, TestRemoveJob) {
+  controller_.Update({{PY_POOL, 1}, {JAVA_POOL, 1}, {OTHER_JOB_POOL, 1}}, 0);
+  controller_.RemoveJob(PY_POOL.job_id);
+  ASSERT_EQ(controller_.GetTargetSize(PY_POOL), 0);
+  ASSERT_EQ(controller_.GetTargetSize(JAVA_POOL), 0);
+  ASSERT_EQ(controller_.GetTargetSize(OTHER_JOB_POOL), 1);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,99 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_lease_batcher.h"
+
+#include "ray/common/ray_config.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+WorkerLeaseBatcher::WorkerLeaseBatcher(boost::asio::io_service &io_service,
+                                       std::function<bool(const TaskID &)> cancel_lease)
+    : io_service_(io_service), cancel_lease_(std::move(cancel_lease)) {}
+
+void WorkerLeaseBatcher::AddBatch(const std::vector<TaskID> &task_ids,
+                                  rpc::SendReplyCallback send_reply_callback) {
+  RAY_CHECK(!task_ids.empty());
+  auto batch = std::make_shared<Batch>(io_service_);
+  batch->send_reply_callback = std::move(send_reply_callback);
+  batch->pending_task_ids.insert(task_ids.begin(), task_ids.end());
+  batches_[task_ids.front()] = std::move(batch);
+}
+
+void WorkerLeaseBatcher::OnLeaseResolved(const TaskID &batch_id, const TaskID &task_id,
+                                         std::function<void()> reply_failure_handler) {
+  auto it = batches_.find(batch_id);
+  RAY_CHECK(it != batches_.end());
+  auto batch = it->second;
+  batch->pending_task_ids.erase(task_id);
+  if (reply_failure_handler) {
+    batch->reply_failure_handlers.push_back(std::move(reply_failure_handler));
+  }
+
+  if (batch->pending_task_ids.empty()) {
+    batches_.erase(it);
+    batch->timer.cancel();
+    auto reply_failure_handlers = std::move(batch->reply_failure_handlers);
+    batch->send_reply_callback(Status::OK(), nullptr, [reply_failure_handlers]() {
+      for (const auto &handler : reply_failure_handlers) {
+        handler();
+      }
+    });
+    return;
+  }
+
+  if (!batch->timer_started) {
+    batch->timer_started = true;
+    batch->timer.expires_from_now(boost::posix_time::milliseconds(
+        RayConfig::instance().worker_lease_batch_reply_timeout_ms()));
+    batch->timer.async_wait(
+        [this, batch_id, batch](const boost::system::error_code &error) {
+          if (error == boost::asio::error::operation_aborted) {
+            return;
+          }
+          auto it = batches_.find(batch_id);
+          if (it == batches_.end() || it->second != batch) {
+            return;
+          }
+          RAY_LOG(DEBUG) << "Canceling the " << batch->pending_task_ids.size()
+                         << " pending leases of request " << batch_id;
+          CancelPendingLeases(batch_id);
+        });
+  }
+}
+
+bool WorkerLeaseBatcher::CancelBatch(const TaskID &batch_id) {
+  if (!batches_.contains(batch_id)) {
+    return false;
+  }
+  return CancelPendingLeases(batch_id);
+}
+
+bool WorkerLeaseBatcher::CancelPendingLeases(const TaskID &batch_id) {
+  // Canceling the last pending lease replies to the request and erases it.
+  const std::vector<TaskID> task_ids(batches_[batch_id]->pending_task_ids.begin(),
+                                     batches_[batch_id]->pending_task_ids.end());
+  bool canceled = false;
+  for (const auto &task_id : task_ids) {
+    canceled = cancel_lease_(task_id) || canceled;
+  }
+  return canceled;
+}
+
+}  // namespace raylet
+
+}  // namespace ray
@@ -0,0 +1,108 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "ray/common/id.h"
+#include "ray/rpc/server_call.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// Tracks the leases of `RequestWorkerLeases` requests, which lease several workers
+/// for tasks of the same scheduling key with a single RPC, and replies to each
+/// request once all of its leases are granted, spilled back or canceled.
+///
+/// The RPC layer only supports unary calls, so the granted workers wait for the reply
+/// of the whole request. To bound that wait when the workers start one at a time, a
+/// request whose first lease is resolved waits at most
+/// worker_lease_batch_reply_timeout_ms for the others. The leases still pending then
+/// are canceled, and the client requests them again if it still needs them.
+class WorkerLeaseBatcher {
+ public:
+  /// Create a worker lease batcher.
+  ///
+  /// \param io_service The event loop on which the reply timeouts run.
+  /// \param cancel_lease Cancels the queued lease of a task, which is then resolved
+  /// through OnLeaseResolved before it returns. Returns false if the lease was not
+  /// queued.
+  WorkerLeaseBatcher(boost::asio::io_service &io_service,
+                     std::function<bool(const TaskID &)> cancel_lease);
+
+  /// Track the leases of a request. The ID of the request is the ID of its first task.
+  ///
+  /// \param task_ids The IDs of the tasks to lease a worker for, one per lease.
+  /// \param send_reply_callback Replies to the request.
+  void AddBatch(const std::vector<TaskID> &task_ids,
+                rpc::SendReplyCallback send_reply_callback);
+
+  /// Record that a lease of a request was granted, spilled back or canceled. The
+  /// request is replied to if it was the last pending one.
+  ///
+  /// \param batch_id The ID of the request.
+  /// \param task_id The ID of the task of the lease.
+  /// \param reply_failure_handler Called if the lease was granted but the reply fails.
+  void OnLeaseResolved(const TaskID &batch_id, const TaskID &task_id,
+                       std::function<void()> reply_failure_handler);
+
+  /// Cancel the pending leases of a request.
+  ///
+  /// \param batch_id The ID of the request.
+  /// \return False if the request is unknown or had no queued lease.
+  bool CancelBatch(const TaskID &batch_id);
+
+  /// \return Whether a request with this ID has pending leases.
+  bool HasBatch(const TaskID &batch_id) const { return batches_.contains(batch_id); }
+
+  /// \return The number of requests that have pending leases.
+  size_t NumBatches() const { return batches_.size(); }
+
+ private:
+  struct Batch {
+    explicit Batch(boost::asio::io_service &io_service) : timer(io_service) {}
+
+    /// Replies to the request.
+    rpc::SendReplyCallback send_reply_callback;
+    /// The IDs of the tasks whose lease is neither granted, spilled back nor canceled.
+    absl::flat_hash_set<TaskID> pending_task_ids;
+    /// Called if the leases were granted but the reply fails.
+    std::vector<std::function<void()>> reply_failure_handlers;
+    /// Cancels the pending leases once the first lease was resolved for too long.
+    boost::asio::deadline_timer timer;
+    bool timer_started = false;
+  };
+
+  /// Cancel the pending leases of a request.
+  ///
+  /// \return False if none of them was queued.
+  bool CancelPendingLeases(const TaskID &batch_id);
+
+  boost::asio::io_service &io_service_;
+  std::function<bool(const TaskID &)> cancel_lease_;
+
+  /// The requests with pending leases, by the ID of their first task.
+  absl::flat_hash_map<TaskID, std::shared_ptr<Batch>> batches_;
+};
+
+}  // namespace raylet
+
+}  // namespace ray
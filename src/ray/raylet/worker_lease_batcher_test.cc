@@ -0,0 +1,122 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_lease_batcher.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
+
+namespace ray {
+
+namespace raylet {
+
+class WorkerLeaseBatcherTest : public ::testing::Test {
+ public:
+  WorkerLeaseBatcherTest()
+      : batcher_(io_service_, [this](const TaskID &task_id) {
+          // Like the cluster task manager, resolve a queued lease right away.
+          if (!queued_task_ids_.erase(task_id)) {
+            return false;
+          }
+          num_canceled_++;
+          batcher_.OnLeaseResolved(batch_id_, task_id, nullptr);
+          return true;
+        }) {
+    RayConfig::instance().initialize({{"worker_lease_batch_reply_timeout_ms", "500"}});
+  }
+
+  /// Request a batch of leases and queue them.
+  void RequestLeases(size_t num_leases) {
+    for (size_t i = 0; i < num_leases; i++) {
+      task_ids_.push_back(TaskID::ForFakeTask());
+    }
+    batch_id_ = task_ids_.front();
+    queued_task_ids_.insert(task_ids_.begin(), task_ids_.end());
+    batcher_.AddBatch(task_ids_,
+                      [this](Status status, std::function<void()> success,
+                             std::function<void()> failure) { num_replies_++; });
+  }
+
+  /// Grant the queued lease of a task.
+  void GrantLease(const TaskID &task_id) {
+    ASSERT_TRUE(queued_task_ids_.erase(task_id));
+    batcher_.OnLeaseResolved(batch_id_, task_id, nullptr);
+  }
+
+ protected:
+  boost::asio::io_service io_service_;
+  WorkerLeaseBatcher batcher_;
+  TaskID batch_id_;
+  std::vector<TaskID> task_ids_;
+  absl::flat_hash_set<TaskID> queued_task_ids_;
+  int num_replies_ = 0;
+  int num_canceled_ = 0;
+};
+
+TEST_F(WorkerLeaseBatcherTest, TestWorkersStartOneAtATime) {
+  RequestLeases(3);
+
+  // Each lease is granted once its worker has started. The request is replied to
+  // once all of them are granted, and none of them is canceled.
+  for (const auto &task_id : task_ids_) {
+    ASSERT_EQ(num_replies_, 0);
+    GrantLease(task_id);
+    io_service_.poll();
+  }
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_EQ(num_canceled_, 0);
+  ASSERT_EQ(batcher_.NumBatches(), 0);
+
+  // The timeout does not fire after the reply.
+  io_service_.run();
+  ASSERT_EQ(num_replies_, 1);
+}
+
+TEST_F(WorkerLeaseBatcherTest, TestCancelPendingLeasesAfterTimeout) {
+  RayConfig::instance().initialize({{"worker_lease_batch_reply_timeout_ms", "10"}});
+  RequestLeases(3);
+  GrantLease(task_ids_[0]);
+  io_service_.poll();
+  ASSERT_EQ(num_replies_, 0);
+
+  // The leases that are still pending once the timeout expires are canceled, and the
+  // request is replied to.
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  io_service_.run();
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_EQ(num_canceled_, 2);
+  ASSERT_TRUE(queued_task_ids_.empty());
+  ASSERT_EQ(batcher_.NumBatches(), 0);
+}
+
+TEST_F(WorkerLeaseBatcherTest, TestCancelBatch) {
+  RequestLeases(3);
+  GrantLease(task_ids_[1]);
+  ASSERT_TRUE(batcher_.HasBatch(batch_id_));
+
+  // Only the pending leases are canceled.
+  ASSERT_TRUE(batcher_.CancelBatch(batch_id_));
+  ASSERT_EQ(num_replies_, 1);
+  ASSERT_EQ(num_canceled_, 2);
+  ASSERT_FALSE(batcher_.HasBatch(batch_id_));
+  ASSERT_FALSE(batcher_.CancelBatch(batch_id_));
+  io_service_.run();
+  ASSERT_EQ(num_replies_, 1);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
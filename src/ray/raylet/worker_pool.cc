@@ -72,6 +72,8 @@ WorkerPool::WorkerPool(boost::asio::io_service &io_service, int num_workers_soft
       first_job_driver_wait_num_python_workers_(std::min(
           num_initial_python_workers_for_first_job, maximum_startup_concurrency)),
       num_initial_python_workers_for_first_job_(num_initial_python_workers_for_first_job),
+      warm_pool_(RayConfig::instance().worker_warm_pool_half_life_ms(),
+                 RayConfig::instance().worker_warm_pool_prestart_fraction()),
       kill_idle_workers_timer_(io_service) {
   RAY_CHECK(maximum_startup_concurrency > 0);
 #ifndef _WIN32
@@ -104,6 +106,15 @@ WorkerPool::WorkerPool(boost::asio::io_service &io_service, int num_workers_soft
       free_ports_->push(port);
     }
   }
+  if (RayConfig::instance().worker_cgroups_enabled()) {
+    cgroup_manager_.reset(
+        new CgroupManager(RayConfig::instance().worker_cgroup_root(),
+                          RayConfig::instance().worker_cgroup_memory_kill_fraction()));
+    if (!cgroup_manager_->Initialize()) {
+      RAY_LOG(WARNING) << "Workers are not placed in cgroups.";
+      cgroup_manager_.reset();
+    }
+  }
   ScheduleIdleWorkerKilling();
 }
 
@@ -162,6 +173,13 @@ Process WorkerPool::StartWorkerProcess(
   RAY_LOG(DEBUG) << "Starting new worker process, current pool has " << state.idle.size()
                  << " workers";
 
+  // Only the generic Python workers of a job are forked from its zygote. The workers
+  // of actors with their own options or environment are started from scratch.
+  const bool fork_from_zygote =
+      RayConfig::instance().worker_zygote_enabled() && language == Language::PYTHON &&
+      worker_type == rpc::WorkerType::WORKER && dynamic_options.empty() &&
+      override_environment_variables.empty();
+
   int workers_to_start = 1;
   if (dynamic_options.empty()) {
     if (language == Language::JAVA) {
@@ -276,22 +294,34 @@ Process WorkerPool::StartWorkerProcess(
   for (const auto &pair : override_environment_variables) {
     env[pair.first] = pair.second;
   }
+  if (fork_from_zygote) {
+    Process placeholder = ForkFromZygote(job_id, worker_command_args, env);
+    if (!placeholder.IsNull()) {
+      return placeholder;
+    }
+  }
   // Start a process and measure the startup time.
   auto start = std::chrono::high_resolution_clock::now();
   Process proc = StartProcess(worker_command_args, env);
   auto end = std::chrono::high_resolution_clock::now();
   auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
   stats::ProcessStartupTimeMs.Record(duration.count());
+  AddStartingWorkerProcess(proc, language, worker_type, workers_to_start);
+  return proc;
+}
 
+void WorkerPool::AddStartingWorkerProcess(const Process &proc, const Language &language,
+                                          const rpc::WorkerType worker_type,
+                                          int workers_to_start) {
   RAY_LOG(DEBUG) << "Started worker process of " << workers_to_start
                  << " worker(s) with pid " << proc.GetId();
+  auto &state = GetStateForLanguage(language);
   MonitorStartingWorkerProcess(proc, language, worker_type);
   state.starting_worker_processes.emplace(proc, workers_to_start);
   if (IsIOWorkerType(worker_type)) {
     auto &io_worker_state = GetIOWorkerStateFromWorkerType(worker_type, state);
     io_worker_state.num_starting_io_workers++;
   }
-  return proc;
 }
 
 void WorkerPool::MonitorStartingWorkerProcess(const Process &proc,
@@ -357,6 +387,58 @@ Process WorkerPool::StartProcess(const std::vector<std::string> &worker_command_
   return child;
 }
 
+Process WorkerPool::ForkFromZygote(const JobID &job_id,
+                                   const std::vector<std::string> &worker_command_args,
+                                   const ProcessEnvironment &env) {
+  auto it = zygotes_.find(job_id);
+  if (it != zygotes_.end() && it->second->IsBroken()) {
+    // Kill the zygote and start a new one.
+    zygotes_.erase(it);
+    it = zygotes_.end();
+  }
+  if (it == zygotes_.end()) {
+    // The zygote runs the command of the workers of the job, so it imports the same
+    // modules. Workers are started from scratch until it listens.
+    auto socket_name = WorkerZygote::MakeSocketName(job_id);
+    std::vector<std::string> zygote_command_args = worker_command_args;
+    zygote_command_args.push_back(kWorkerZygoteSocketFlag + socket_name);
+    RAY_LOG(DEBUG) << "Starting the worker zygote of job " << job_id;
+    Process zygote = StartProcess(zygote_command_args, env);
+    zygotes_.emplace(job_id, std::unique_ptr<WorkerZygote>(new WorkerZygote(
+                                 *io_service_, std::move(zygote), socket_name)));
+    return Process();
+  }
+
+  // The placeholder counts the worker as starting while the zygote forks it, so that
+  // the startup concurrency and the prestarted workers account for it.
+  Process placeholder = Process::CreateNewDummy();
+  auto &state = GetStateForLanguage(Language::PYTHON);
+  state.starting_worker_processes.emplace(placeholder, 1);
+  auto start = std::chrono::high_resolution_clock::now();
+  ForkProcess(*it->second, worker_command_args, env,
+              [this, placeholder, start, worker_command_args, env](Process proc) {
+                auto &state = GetStateForLanguage(Language::PYTHON);
+                state.starting_worker_processes.erase(placeholder);
+                if (proc.IsNull()) {
+                  proc = StartProcess(worker_command_args, env);
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration =
+                    std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+                stats::ProcessStartupTimeMs.Record(duration.count());
+                AddStartingWorkerProcess(proc, Language::PYTHON, rpc::WorkerType::WORKER,
+                                         /*workers_to_start=*/1);
+              });
+  return placeholder;
+}
+
+void WorkerPool::ForkProcess(WorkerZygote &zygote,
+                             const std::vector<std::string> &worker_command_args,
+                             const ProcessEnvironment &env,
+                             std::function<void(Process)> callback) {
+  zygote.Fork(worker_command_args, env, std::move(callback));
+}
+
 Status WorkerPool::GetNextFreePort(int *port) {
   if (!free_ports_) {
     *port = 0;
@@ -394,6 +476,10 @@ void WorkerPool::HandleJobFinished(const JobID &job_id) {
   // Currently we don't erase the job from `all_jobs_` , as a workaround for
   // https://github.com/ray-project/ray/issues/11437.
   // unfinished_jobs_.erase(job_id);
+
+  // The job will not start more workers, so its zygote is no longer needed.
+  zygotes_.erase(job_id);
+  warm_pool_.RemoveJob(job_id);
 }
 
 Status WorkerPool::RegisterWorker(const std::shared_ptr<WorkerInterface> &worker,
@@ -404,7 +490,8 @@ Status WorkerPool::RegisterWorker(const std::shared_ptr<WorkerInterface> &worker
   auto &state = GetStateForLanguage(worker->GetLanguage());
   auto process = Process::FromPid(pid);
 
-  if (state.starting_worker_processes.count(process) == 0) {
+  auto it = state.starting_worker_processes.find(process);
+  if (it == state.starting_worker_processes.end()) {
     RAY_LOG(WARNING) << "Received a register request from an unknown worker "
                      << process.GetId();
     Status status = Status::Invalid("Unknown worker");
@@ -424,6 +511,13 @@ Status WorkerPool::RegisterWorker(const std::shared_ptr<WorkerInterface> &worker
   RAY_LOG(DEBUG) << "Registering worker with pid " << pid << ", port: " << port
                  << ", worker_type: " << rpc::WorkerType_Name(worker->GetWorkerType());
   worker->SetAssignedPort(port);
+  if (cgroup_manager_) {
+    // The limits of a cgroup are those of the lease of its worker, so a process that
+    // hosts several workers, e.g., a Java one, is not placed in a cgroup.
+    if (it->second == 1 && GetWorkersByProcess(process).empty()) {
+      cgroup_manager_->AddWorker(worker->WorkerId(), pid);
+    }
+  }
 
   state.registered_workers.insert(worker);
 
@@ -615,6 +709,9 @@ void WorkerPool::PushWorker(const std::shared_ptr<WorkerInterface> &worker) {
   // Since the worker is now idle, unset its assigned task ID.
   RAY_CHECK(worker->GetAssignedTaskId().IsNil())
       << "Idle workers cannot have an assigned task ID";
+  if (cgroup_manager_) {
+    cgroup_manager_->ResetWorkerLimits(worker->WorkerId());
+  }
   auto &state = GetStateForLanguage(worker->GetLanguage());
   auto it = state.dedicated_workers_to_tasks.find(worker->GetProcess());
   if (it != state.dedicated_workers_to_tasks.end()) {
@@ -626,10 +723,35 @@ void WorkerPool::PushWorker(const std::shared_ptr<WorkerInterface> &worker) {
     // The worker is not used for the actor creation task with dynamic options.
     // Put the worker to the idle pool.
     state.idle.insert(worker);
-    int64_t now = current_time_ms();
-    idle_of_all_languages_.emplace_back(worker, now);
-    idle_of_all_languages_map_[worker] = now;
+    AddIdleWorker(worker, current_time_ms());
+  }
+}
+
+void WorkerPool::AddIdleWorker(const std::shared_ptr<WorkerInterface> &worker,
+                               int64_t now_ms) {
+  WarmPoolKey key{worker->GetLanguage(), worker->GetAssignedJobId()};
+  auto it = idle_of_all_languages_.insert(idle_of_all_languages_.end(),
+                                          IdleWorkerEntry{worker, now_ms, key, {}});
+  auto &pool = idle_by_pool_[key];
+  it->pool_it = pool.insert(pool.end(), it);
+  idle_of_all_languages_map_[worker] = it;
+}
+
+bool WorkerPool::RemoveIdleWorker(const std::shared_ptr<WorkerInterface> &worker) {
+  auto map_it = idle_of_all_languages_map_.find(worker);
+  if (map_it == idle_of_all_languages_map_.end()) {
+    return false;
   }
+  auto it = map_it->second;
+  auto pool_it = idle_by_pool_.find(it->pool);
+  RAY_CHECK(pool_it != idle_by_pool_.end());
+  pool_it->second.erase(it->pool_it);
+  if (pool_it->second.empty()) {
+    idle_by_pool_.erase(pool_it);
+  }
+  idle_of_all_languages_.erase(it);
+  idle_of_all_languages_map_.erase(map_it);
+  return true;
 }
 
 void WorkerPool::ScheduleIdleWorkerKilling() {
@@ -640,12 +762,90 @@ void WorkerPool::ScheduleIdleWorkerKilling() {
       if (error == boost::asio::error::operation_aborted) {
         return;
       }
+      if (RayConfig::instance().worker_warm_pool_enabled()) {
+        UpdateWarmPools();
+      }
+      if (cgroup_manager_) {
+        KillWorkersOverMemoryLimit();
+      }
       TryKillingIdleWorkers();
       ScheduleIdleWorkerKilling();
     });
   }
 }
 
+void WorkerPool::KillWorkersOverMemoryLimit() {
+  const auto workers_to_kill = cgroup_manager_->UpdateMemoryUsage();
+  if (workers_to_kill.empty()) {
+    return;
+  }
+  std::unordered_set<WorkerID> worker_ids(workers_to_kill.begin(),
+                                          workers_to_kill.end());
+  for (const auto &worker : GetAllRegisteredWorkers()) {
+    if (worker_ids.count(worker->WorkerId()) == 0 || worker->IsDead()) {
+      continue;
+    }
+    RAY_LOG(ERROR) << "Killing worker " << worker->WorkerId() << " with pid "
+                   << worker->GetProcess().GetId() << ", which uses "
+                   << cgroup_manager_->GetMemoryUsage(worker->WorkerId())
+                   << " bytes, close to the memory limit of its task "
+                   << worker->GetAssignedTaskId() << ".";
+    worker->GetProcess().Kill();
+  }
+}
+
+void WorkerPool::CountWarmPoolWorkers(WarmPoolSizes *num_workers,
+                                      WarmPoolSizes *num_busy_workers) const {
+  for (const auto &entry : states_by_lang_) {
+    for (const auto &worker : entry.second.registered_workers) {
+      if (worker->IsDead() || worker->GetWorkerType() != rpc::WorkerType::WORKER ||
+          worker->GetAssignedJobId().IsNil()) {
+        continue;
+      }
+      WarmPoolKey key{entry.first, worker->GetAssignedJobId()};
+      (*num_workers)[key]++;
+      if (num_busy_workers && entry.second.idle.count(worker) == 0) {
+        (*num_busy_workers)[key]++;
+      }
+    }
+  }
+}
+
+void WorkerPool::UpdateWarmPools() {
+  WarmPoolSizes num_workers;
+  WarmPoolSizes num_busy_workers;
+  CountWarmPoolWorkers(&num_workers, &num_busy_workers);
+  warm_pool_.Update(num_busy_workers, current_time_ms());
+
+  int64_t num_workers_total = 0;
+  for (const auto &worker : GetAllRegisteredWorkers()) {
+    if (!worker->IsDead()) {
+      num_workers_total++;
+    }
+  }
+  std::unordered_map<Language, int64_t, std::hash<int>> num_starting_workers;
+  for (const auto &entry : states_by_lang_) {
+    for (const auto &starting : entry.second.starting_worker_processes) {
+      num_starting_workers[entry.first] += starting.second;
+    }
+  }
+  for (const auto &entry :
+       warm_pool_.GetWorkersToPrestart(num_workers, num_starting_workers)) {
+    const auto &key = entry.first;
+    int64_t num_needed =
+        std::min<int64_t>(entry.second, num_workers_soft_limit_ - num_workers_total);
+    RAY_LOG(DEBUG) << "Prestarting " << num_needed << " workers of job " << key.job_id
+                   << " to keep " << warm_pool_.GetTargetSize(key) << " workers warm";
+    for (int64_t i = 0; i < num_needed; i++) {
+      if (StartWorkerProcess(key.language, rpc::WorkerType::WORKER, key.job_id)
+              .IsNull()) {
+        break;
+      }
+      num_workers_total++;
+    }
+  }
+}
+
 void WorkerPool::TryKillingIdleWorkers() {
   RAY_CHECK(idle_of_all_languages_.size() == idle_of_all_languages_map_.size());
 
@@ -656,21 +856,32 @@ void WorkerPool::TryKillingIdleWorkers() {
       running_size++;
     }
   }
+  // The number of workers of each warm pool, which are not killed below the forecast
+  // of their pool.
+  const bool warm_pool_enabled = RayConfig::instance().worker_warm_pool_enabled();
+  WarmPoolSizes num_warm_pool_workers;
+  if (warm_pool_enabled) {
+    CountWarmPoolWorkers(&num_warm_pool_workers, nullptr);
+  }
+
+  // The dead workers to remove from the idle workers once they have been visited.
+  std::vector<std::shared_ptr<WorkerInterface>> dead_workers;
 
   // Kill idle workers in FIFO order.
-  for (const auto &idle_pair : idle_of_all_languages_) {
+  for (const auto &idle_entry : idle_of_all_languages_) {
     if (running_size <= static_cast<size_t>(num_workers_soft_limit_)) {
       break;
     }
-    if (now - idle_pair.second <
+    if (now - idle_entry.idle_since_ms <
         RayConfig::instance().idle_worker_killing_time_threshold_ms()) {
       break;
     }
 
-    const auto &idle_worker = idle_pair.first;
+    const auto &idle_worker = idle_entry.worker;
     if (idle_worker->IsDead()) {
       // This worker has already been killed.
       // This is possible because a Java worker process may hold multiple workers.
+      dead_workers.push_back(idle_worker);
       continue;
     }
     auto process = idle_worker->GetProcess();
@@ -689,7 +900,7 @@ void WorkerPool::TryKillingIdleWorkers() {
     bool can_be_killed = true;
     for (const auto &worker : workers_in_the_same_process) {
       if (worker_state.idle.count(worker) == 0 ||
-          now - idle_of_all_languages_map_[worker] <
+          now - idle_of_all_languages_map_.at(worker)->idle_since_ms <
               RayConfig::instance().idle_worker_killing_time_threshold_ms()) {
         // Another worker in this process isn't idle, or hasn't been idle for a while, so
         // this process can't be killed.
@@ -701,11 +912,19 @@ void WorkerPool::TryKillingIdleWorkers() {
       continue;
     }
 
+    WarmPoolKey key{idle_worker->GetLanguage(), idle_worker->GetAssignedJobId()};
+    int64_t num_workers_left =
+        num_warm_pool_workers[key] - workers_in_the_same_process.size();
+    if (warm_pool_enabled && num_workers_left < warm_pool_.GetTargetSize(key)) {
+      // Keep the worker warm for the forecast demand of its job.
+      continue;
+    }
+
     if (running_size - workers_in_the_same_process.size() <
         static_cast<size_t>(num_workers_soft_limit_)) {
       // A Java worker process may contain multiple workers. Killing more workers than we
       // expect may slow the job.
-      return;
+      break;
     }
 
     for (const auto &worker : workers_in_the_same_process) {
@@ -729,21 +948,15 @@ void WorkerPool::TryKillingIdleWorkers() {
       if (!worker->IsDead()) {
         worker->MarkDead();
         running_size--;
+        num_warm_pool_workers[key]--;
       }
+      dead_workers.push_back(worker);
     }
   }
 
-  std::list<std::pair<std::shared_ptr<WorkerInterface>, int64_t>>
-      new_idle_of_all_languages;
-  idle_of_all_languages_map_.clear();
-  for (const auto &idle_pair : idle_of_all_languages_) {
-    if (!idle_pair.first->IsDead()) {
-      new_idle_of_all_languages.push_back(idle_pair);
-      idle_of_all_languages_map_.emplace(idle_pair);
-    }
+  for (const auto &worker : dead_workers) {
+    RemoveIdleWorker(worker);
   }
-
-  idle_of_all_languages_ = std::move(new_idle_of_all_languages);
   RAY_CHECK(idle_of_all_languages_.size() == idle_of_all_languages_map_.size());
 }
 
@@ -789,20 +1002,11 @@ std::shared_ptr<WorkerInterface> WorkerPool::PopWorker(
     // Code path of normal task or actor creation task without dynamic worker options.
     // Find an available worker which is already assigned to this job.
     // Try to pop the most recently pushed worker.
-    for (auto it = idle_of_all_languages_.rbegin(); it != idle_of_all_languages_.rend();
-         it++) {
-      if (task_spec.GetLanguage() != it->first->GetLanguage() ||
-          it->first->GetAssignedJobId() != task_spec.JobId()) {
-        continue;
-      }
-      state.idle.erase(it->first);
-      // We can't erase a reverse_iterator.
-      auto lit = it.base();
-      lit--;
-      worker = std::move(lit->first);
-      idle_of_all_languages_.erase(lit);
-      idle_of_all_languages_map_.erase(worker);
-      break;
+    auto pool_it = idle_by_pool_.find({task_spec.GetLanguage(), task_spec.JobId()});
+    if (pool_it != idle_by_pool_.end()) {
+      worker = pool_it->second.back()->worker;
+      state.idle.erase(worker);
+      RemoveIdleWorker(worker);
     }
     if (worker == nullptr) {
       // There are no more non-actor workers available to execute this task.
@@ -818,6 +1022,13 @@ std::shared_ptr<WorkerInterface> WorkerPool::PopWorker(
 
   if (worker) {
     RAY_CHECK(worker->GetAssignedJobId() == task_spec.JobId());
+    if (cgroup_manager_) {
+      const auto &resources = task_spec.GetRequiredResources();
+      cgroup_manager_->SetWorkerLimits(
+          worker->WorkerId(), resources.GetResource(kCPU_ResourceLabel).ToDouble(),
+          resources.GetResource(kMemory_ResourceLabel).ToDouble() *
+              kMemoryResourceUnitBytes);
+    }
   }
   return worker;
 }
@@ -830,6 +1041,9 @@ void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec,
       task_spec.OverrideEnvironmentVariables().size() > 0) {
     return;  // Not handled.
   }
+  if (RayConfig::instance().worker_warm_pool_enabled()) {
+    warm_pool_.RecordBacklog({task_spec.GetLanguage(), task_spec.JobId()}, backlog_size);
+  }
 
   auto &state = GetStateForLanguage(task_spec.GetLanguage());
   // The number of available workers that can be used for this task spec.
@@ -860,13 +1074,9 @@ void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec,
 bool WorkerPool::DisconnectWorker(const std::shared_ptr<WorkerInterface> &worker) {
   auto &state = GetStateForLanguage(worker->GetLanguage());
   RAY_CHECK(RemoveWorker(state.registered_workers, worker));
-  for (auto it = idle_of_all_languages_.begin(); it != idle_of_all_languages_.end();
-       it++) {
-    if (it->first == worker) {
-      idle_of_all_languages_.erase(it);
-      idle_of_all_languages_map_.erase(worker);
-      break;
-    }
+  RemoveIdleWorker(worker);
+  if (cgroup_manager_) {
+    cgroup_manager_->RemoveWorker(worker->WorkerId());
   }
 
   MarkPortAsFree(worker->AssignedPort());
@@ -1039,6 +1249,10 @@ std::string WorkerPool::DebugString() const {
            << " drivers: " << entry.second.registered_drivers.size();
   }
   result << "\n- num idle workers: " << idle_of_all_languages_.size();
+  result << "\n- num worker zygotes: " << zygotes_.size();
+  if (cgroup_manager_) {
+    result << "\n" << cgroup_manager_->DebugString();
+  }
   return result.str();
 }
 
@@ -17,6 +17,7 @@
 #include <inttypes.h>
 
 #include <boost/asio/io_service.hpp>
+#include <list>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
@@ -27,7 +28,10 @@
 #include "ray/common/task/task.h"
 #include "ray/common/task/task_common.h"
 #include "ray/gcs/gcs_client.h"
+#include "ray/raylet/cgroup_manager.h"
+#include "ray/raylet/warm_pool_controller.h"
 #include "ray/raylet/worker.h"
+#include "ray/raylet/worker_zygote.h"
 
 namespace ray {
 
@@ -317,7 +321,8 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// \param job_id The ID of the job to which the started worker process belongs.
   /// \param dynamic_options The dynamic options that we should add for worker command.
   /// \return The id of the process that we started if it's positive,
-  /// otherwise it means we didn't start a process.
+  /// otherwise it means we didn't start a process. A worker that is being forked from
+  /// a zygote is returned as a placeholder process without an id.
   Process StartWorkerProcess(
       const Language &language, const rpc::WorkerType worker_type, const JobID &job_id,
       std::vector<std::string> dynamic_options = {},
@@ -334,6 +339,18 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   virtual Process StartProcess(const std::vector<std::string> &worker_command_args,
                                const ProcessEnvironment &env);
 
+  /// Fork a new worker process from the zygote of its job, without blocking.
+  ///
+  /// \param zygote The zygote of the job of the worker.
+  /// \param worker_command_args The command arguments of the new worker process.
+  /// \param env Additional environment variables to be set on the new worker process.
+  /// \param callback Called on the event loop with the forked worker process, or with
+  /// a null process if the zygote could not fork it.
+  virtual void ForkProcess(WorkerZygote &zygote,
+                           const std::vector<std::string> &worker_command_args,
+                           const ProcessEnvironment &env,
+                           std::function<void(Process)> callback);
+
   /// Push an warning message to user if worker pool is getting to big.
   virtual void WarnAboutSize();
 
@@ -386,11 +403,37 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// Pool states per language.
   std::unordered_map<Language, State, std::hash<int>> states_by_lang_;
 
+  /// The zygotes of the jobs, if `worker_zygote_enabled` is set.
+  std::unordered_map<JobID, std::unique_ptr<WorkerZygote>> zygotes_;
+
  private:
   /// A helper function that returns the reference of the pool state
   /// for a given language.
   State &GetStateForLanguage(const Language &language);
 
+  /// Fork a Python worker process from the zygote of its job. If the job has no
+  /// zygote yet, start it. Until the zygote replies, a placeholder process counts as
+  /// starting. The worker is started from scratch if the zygote fails to fork it.
+  ///
+  /// \param job_id The ID of the job of the worker.
+  /// \param worker_command_args The command arguments of the worker process.
+  /// \param env Additional environment variables to be set on the worker process.
+  /// \return The placeholder process, or a null process if the worker must be
+  /// started from scratch.
+  Process ForkFromZygote(const JobID &job_id,
+                         const std::vector<std::string> &worker_command_args,
+                         const ProcessEnvironment &env);
+
+  /// Track a worker process until its workers register.
+  ///
+  /// \param proc The started worker process.
+  /// \param language The language of the workers.
+  /// \param worker_type The type of the workers.
+  /// \param workers_to_start The number of workers in the process.
+  void AddStartingWorkerProcess(const Process &proc, const Language &language,
+                                const rpc::WorkerType worker_type,
+                                int workers_to_start);
+
   /// Start a timer to monitor the starting worker process.
   ///
   /// If any workers in this process don't register within the timeout
@@ -425,9 +468,35 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   void TryStartIOWorkers(const Language &language, const rpc::WorkerType &worker_type);
 
   /// Try killing idle workers to ensure the running workers are in a
-  /// reasonable size.
+  /// reasonable size. If `worker_warm_pool_enabled` is set, the idle workers of a
+  /// warm pool are not killed below the forecast of the pool.
   void TryKillingIdleWorkers();
 
+  /// Add a worker to the idle workers of all languages and to those of its pool.
+  void AddIdleWorker(const std::shared_ptr<WorkerInterface> &worker, int64_t now_ms);
+
+  /// Remove a worker from the idle workers of all languages and from those of its pool.
+  ///
+  /// \param worker The worker to remove.
+  /// \return Whether the worker was idle.
+  bool RemoveIdleWorker(const std::shared_ptr<WorkerInterface> &worker);
+
+  /// Update the forecasts of the warm pools with their current demand, and prestart
+  /// the workers they miss.
+  void UpdateWarmPools();
+
+  /// Kill the workers whose memory usage nears the memory limit of their cgroup. The
+  /// worker is cleaned up once it disconnects.
+  void KillWorkersOverMemoryLimit();
+
+  /// Count the registered workers of each warm pool.
+  ///
+  /// \param num_workers[out] The number of workers of each pool.
+  /// \param num_busy_workers[out] If not null, the number of workers of each pool that
+  /// are not idle.
+  void CountWarmPoolWorkers(WarmPoolSizes *num_workers,
+                            WarmPoolSizes *num_busy_workers) const;
+
   /// Schedule the periodic killing of idle workers.
   void ScheduleIdleWorkerKilling();
 
@@ -475,6 +544,8 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// The callback that will be triggered once it times out to start a worker.
   std::function<void()> starting_worker_timeout_callback_;
   FRIEND_TEST(WorkerPoolTest, InitialWorkerProcessCount);
+  FRIEND_TEST(WorkerPoolTest, PrestartWarmPoolWorkers);
+  FRIEND_TEST(WorkerPoolTest, KeepWarmPoolWorkersIdle);
 
   /// The Job ID of the firstly received job.
   JobID first_job_;
@@ -495,16 +566,40 @@ class WorkerPool : public WorkerPoolInterface, public IOWorkerPoolInterface {
   /// This map tracks the latest infos of unfinished jobs.
   absl::flat_hash_map<JobID, rpc::JobConfig> all_jobs_;
 
-  /// The pool of idle non-actor workers of all languages. This is used to kill idle
-  /// workers in FIFO order. The second element of std::pair is the time a worker becomes
-  /// idle.
-  std::list<std::pair<std::shared_ptr<WorkerInterface>, int64_t>> idle_of_all_languages_;
+  /// An idle non-actor worker. It is linked both in the list of the idle workers of
+  /// all languages and in that of its warm pool.
+  struct IdleWorkerEntry;
+  using IdleWorkerIterator = std::list<IdleWorkerEntry>::iterator;
+  struct IdleWorkerEntry {
+    std::shared_ptr<WorkerInterface> worker;
+    /// The time the worker became idle.
+    int64_t idle_since_ms;
+    /// The warm pool of the worker.
+    WarmPoolKey pool;
+    /// The position of the worker in the list of the idle workers of its pool.
+    std::list<IdleWorkerIterator>::iterator pool_it;
+  };
+
+  /// The pool of idle non-actor workers of all languages, in the order they became
+  /// idle. This is used to kill idle workers in FIFO order.
+  std::list<IdleWorkerEntry> idle_of_all_languages_;
 
-  /// This map stores the same data as `idle_of_all_languages_`, but in a map structure
-  /// for lookup performance.
-  std::unordered_map<std::shared_ptr<WorkerInterface>, int64_t>
+  /// The position of each idle worker in `idle_of_all_languages_`.
+  std::unordered_map<std::shared_ptr<WorkerInterface>, IdleWorkerIterator>
       idle_of_all_languages_map_;
 
+  /// The idle workers of each warm pool, in the order they became idle. This is used to
+  /// pop the most recently pushed worker of a job in constant time.
+  std::unordered_map<WarmPoolKey, std::list<IdleWorkerIterator>, WarmPoolKeyHash>
+      idle_by_pool_;
+
+  /// Forecasts the number of workers of each job to keep warm.
+  WarmPoolController warm_pool_;
+
+  /// Places the workers in cgroups, if `worker_cgroups_enabled` is set and the
+  /// cgroups are available.
+  std::unique_ptr<CgroupManager> cgroup_manager_;
+
   /// The timer to trigger idle worker killing.
   boost::asio::deadline_timer kill_idle_workers_timer_;
 };
@@ -14,10 +14,16 @@
 
 #include "ray/raylet/worker_pool.h"
 
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/constants.h"
 #include "ray/raylet/node_manager.h"
+#include "ray/util/filesystem.h"
 #include "ray/util/process.h"
 
 namespace ray {
@@ -56,8 +62,37 @@ class WorkerPoolMock : public WorkerPool {
     return last_worker_process_;
   }
 
+  void ForkProcess(WorkerZygote &zygote,
+                   const std::vector<std::string> &worker_command_args,
+                   const ProcessEnvironment &env,
+                   std::function<void(Process)> callback) override {
+    pending_forks_.push_back([this, worker_command_args, env, callback]() {
+      if (!zygote_listening_) {
+        callback(Process());
+        return;
+      }
+      num_forked_processes_++;
+      callback(StartProcess(worker_command_args, env));
+    });
+  }
+
+  /// Reply to the pending fork requests to the zygotes.
+  void ReplyToForks() {
+    auto pending_forks = std::move(pending_forks_);
+    pending_forks_.clear();
+    for (const auto &fork : pending_forks) {
+      fork();
+    }
+  }
+
   void WarnAboutSize() override {}
 
+  void SetZygoteListening(bool listening) { zygote_listening_ = listening; }
+
+  int NumForkedProcesses() const { return num_forked_processes_; }
+
+  int NumZygotes() const { return zygotes_.size(); }
+
   Process LastStartedWorkerProcess() const { return last_worker_process_; }
 
   const std::vector<std::string> &GetWorkerCommand(Process proc) {
@@ -96,6 +131,9 @@ class WorkerPoolMock : public WorkerPool {
 
  private:
   Process last_worker_process_;
+  bool zygote_listening_ = true;
+  int num_forked_processes_ = 0;
+  std::vector<std::function<void()>> pending_forks_;
   // The worker commands by process.
   std::unordered_map<Process, std::vector<std::string>> worker_commands_by_proc_;
 };
@@ -140,6 +178,17 @@ class WorkerPoolTest : public ::testing::Test {
     return worker;
   }
 
+  /// Start a Python worker of the job, and register it with the pool.
+  std::shared_ptr<WorkerInterface> StartRegisteredWorker() {
+    Process proc = worker_pool_->StartWorkerProcess(Language::PYTHON,
+                                                    rpc::WorkerType::WORKER, JOB_ID);
+    auto worker = CreateWorker(Process());
+    RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, proc.GetId(), [](Status, int) {}));
+    worker->Connect(10000);
+    worker_pool_->OnWorkerStarted(worker);
+    return worker;
+  }
+
   std::shared_ptr<WorkerInterface> CreateSpillWorker(Process proc) {
     return CreateWorker(proc, Language::PYTHON, JobID::Nil(),
                         rpc::WorkerType::SPILL_WORKER);
@@ -343,6 +392,29 @@ TEST_F(WorkerPoolTest, HandleWorkerPushPop) {
   ASSERT_EQ(popped_worker, nullptr);
 }
 
+TEST_F(WorkerPoolTest, PopMostRecentlyPushedWorkerOfJob) {
+  auto job_id2 = JobID::FromInt(2);
+  RegisterDriver(Language::PYTHON, job_id2);
+  auto worker1 = CreateWorker(Process::CreateNewDummy());
+  auto worker2 = CreateWorker(Process::CreateNewDummy());
+  auto other_job_worker =
+      CreateWorker(Process::CreateNewDummy(), Language::PYTHON, job_id2);
+  worker_pool_->PushWorker(worker1);
+  worker_pool_->PushWorker(other_job_worker);
+  worker_pool_->PushWorker(worker2);
+
+  // The idle workers of a job are popped in LIFO order.
+  const auto task_spec = ExampleTaskSpec();
+  ASSERT_EQ(worker_pool_->PopWorker(task_spec), worker2);
+  worker_pool_->PushWorker(worker2);
+  ASSERT_EQ(worker_pool_->PopWorker(task_spec), worker2);
+  ASSERT_EQ(worker_pool_->PopWorker(task_spec), worker1);
+  ASSERT_EQ(worker_pool_->PopWorker(task_spec), nullptr);
+  const auto other_job_task_spec =
+      ExampleTaskSpec(ActorID::Nil(), Language::PYTHON, job_id2);
+  ASSERT_EQ(worker_pool_->PopWorker(other_job_task_spec), other_job_worker);
+}
+
 TEST_F(WorkerPoolTest, PopWorkersOfMultipleLanguages) {
   // Create a Python Worker, and add it to the pool
   auto py_worker = CreateWorker(Process::CreateNewDummy(), Language::PYTHON);
@@ -710,6 +782,171 @@ TEST_F(WorkerPoolTest, DeleteWorkerPushPop) {
   });
 }
 
+TEST_F(WorkerPoolTest, StartWorkersFromZygote) {
+  RayConfig::instance().initialize({{"worker_zygote_enabled", "true"}});
+  worker_pool_->SetZygoteListening(false);
+
+  // The first worker starts the zygote of the job along with it.
+  Process proc =
+      worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  ASSERT_EQ(worker_pool_->GetWorkerCommand(proc),
+            std::vector<std::string>({"dummy_py_worker_command"}));
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 2);
+  ASSERT_EQ(worker_pool_->NumZygotes(), 1);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 1);
+
+  // Workers are started from scratch until the zygote listens, including those that
+  // the zygote failed to fork.
+  proc =
+      worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  ASSERT_FALSE(proc.IsNull());
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 2);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+  worker_pool_->ReplyToForks();
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 3);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+  ASSERT_EQ(worker_pool_->NumForkedProcesses(), 0);
+
+  // The workers being forked count as starting until the zygote replies, and the
+  // forked workers are then tracked like the other workers.
+  worker_pool_->SetZygoteListening(true);
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID);
+  ASSERT_EQ(worker_pool_->GetProcessSize(), 3);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 3);
+  worker_pool_->ReplyToForks();
+  ASSERT_EQ(worker_pool_->NumForkedProcesses(), 1);
+  ASSERT_EQ(worker_pool_->NumZygotes(), 1);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 3);
+  proc = worker_pool_->LastStartedWorkerProcess();
+  auto worker = CreateWorker(Process());
+  RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, proc.GetId(), [](Status, int) {}));
+  worker_pool_->OnWorkerStarted(worker);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+
+  // Workers with their own environment are not forked.
+  worker_pool_->StartWorkerProcess(Language::PYTHON, rpc::WorkerType::WORKER, JOB_ID,
+                                   {}, {{"KEY", "VALUE"}});
+  ASSERT_EQ(worker_pool_->NumForkedProcesses(), 1);
+
+  // The zygote is killed once the job finishes.
+  worker_pool_->HandleJobFinished(JOB_ID);
+  ASSERT_EQ(worker_pool_->NumZygotes(), 0);
+  RayConfig::instance().initialize({{"worker_zygote_enabled", "false"}});
+}
+
+TEST_F(WorkerPoolTest, PrestartWarmPoolWorkers) {
+  RayConfig::instance().initialize({{"worker_warm_pool_enabled", "true"}});
+  const auto task_spec = ExampleTaskSpec();
+
+  // Three workers of the job run tasks, so three workers are forecast for it.
+  std::vector<std::shared_ptr<WorkerInterface>> workers;
+  for (int i = 0; i < 3; i++) {
+    workers.push_back(StartRegisteredWorker());
+    worker_pool_->PushWorker(workers.back());
+  }
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NE(worker_pool_->PopWorker(task_spec), nullptr);
+  }
+  worker_pool_->UpdateWarmPools();
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 0);
+
+  // Once the workers exit, as many are prestarted for the forecast.
+  for (const auto &worker : workers) {
+    ASSERT_FALSE(worker_pool_->DisconnectWorker(worker));
+  }
+  worker_pool_->UpdateWarmPools();
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 3);
+
+  // The starting workers count towards the forecast.
+  worker_pool_->UpdateWarmPools();
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 3);
+
+  // The forecast of a finished job is dropped.
+  worker_pool_->HandleJobFinished(JOB_ID);
+  worker_pool_->UpdateWarmPools();
+  ASSERT_EQ(worker_pool_->NumWorkersStarting(), 3);
+  RayConfig::instance().initialize({{"worker_warm_pool_enabled", "false"}});
+}
+
+TEST_F(WorkerPoolTest, KeepWarmPoolWorkersIdle) {
+  RayConfig::instance().initialize({{"worker_warm_pool_enabled", "true"},
+                                    {"idle_worker_killing_time_threshold_ms", "0"}});
+  const auto task_spec = ExampleTaskSpec();
+
+  // One more worker than the soft limit runs a task, so that many workers are
+  // forecast for the job.
+  std::vector<std::shared_ptr<WorkerInterface>> workers;
+  for (int i = 0; i < POOL_SIZE_SOFT_LIMIT + 1; i++) {
+    workers.push_back(StartRegisteredWorker());
+    worker_pool_->PushWorker(workers.back());
+  }
+  for (int i = 0; i < POOL_SIZE_SOFT_LIMIT + 1; i++) {
+    ASSERT_NE(worker_pool_->PopWorker(task_spec), nullptr);
+  }
+  worker_pool_->UpdateWarmPools();
+
+  // The workers become idle, and are not killed while the forecast holds.
+  for (const auto &worker : workers) {
+    worker_pool_->PushWorker(worker);
+  }
+  worker_pool_->TryKillingIdleWorkers();
+  for (const auto &worker : workers) {
+    ASSERT_FALSE(worker->IsDead());
+  }
+
+  // Without a forecast, the oldest idle worker above the soft limit is killed.
+  worker_pool_->HandleJobFinished(JOB_ID);
+  worker_pool_->TryKillingIdleWorkers();
+  ASSERT_TRUE(workers.front()->IsDead());
+  for (size_t i = 1; i < workers.size(); i++) {
+    ASSERT_FALSE(workers[i]->IsDead());
+  }
+  RayConfig::instance().initialize({{"worker_warm_pool_enabled", "false"},
+                                    {"idle_worker_killing_time_threshold_ms", "1000"}});
+}
+
+TEST_F(WorkerPoolTest, PlaceUnsharedProcessesInCgroups) {
+  // The cgroup is mimicked by a regular directory.
+  const std::string cgroup_root =
+      JoinPaths(GetUserTempDir(), "worker_pool_test_cgroup_" + std::to_string(getpid()));
+  boost::filesystem::create_directories(cgroup_root);
+  std::ofstream(JoinPaths(cgroup_root, "cgroup.controllers")) << "cpu memory";
+  RayConfig::instance().initialize(
+      {{"worker_cgroups_enabled", "true"}, {"worker_cgroup_root", cgroup_root}});
+  SetWorkerCommands(
+      {{Language::PYTHON, {"dummy_py_worker_command"}},
+       {Language::JAVA,
+        {"dummy_java_worker_command", "RAY_WORKER_RAYLET_CONFIG_PLACEHOLDER"}}});
+  const std::string raylet_cgroup =
+      JoinPaths(cgroup_root, "raylet_" + std::to_string(getpid()));
+  auto num_worker_cgroups = [&raylet_cgroup]() {
+    int num_cgroups = 0;
+    for (boost::filesystem::directory_iterator it(raylet_cgroup), end; it != end; it++) {
+      num_cgroups += boost::filesystem::is_directory(it->path());
+    }
+    return num_cgroups;
+  };
+
+  // The workers of a Java process hold different leases, so the process is not
+  // placed in a cgroup.
+  Process proc =
+      worker_pool_->StartWorkerProcess(Language::JAVA, rpc::WorkerType::WORKER, JOB_ID);
+  for (int i = 0; i < NUM_WORKERS_PER_PROCESS_JAVA; i++) {
+    auto worker = CreateWorker(Process(), Language::JAVA);
+    RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, proc.GetId(), [](Status, int) {}));
+    worker_pool_->OnWorkerStarted(worker);
+  }
+  ASSERT_EQ(num_worker_cgroups(), 0);
+
+  // A Python process hosts a single worker, and gets its own cgroup.
+  StartRegisteredWorker();
+  ASSERT_EQ(num_worker_cgroups(), 1);
+
+  worker_pool_.reset();
+  boost::filesystem::remove_all(cgroup_root);
+  RayConfig::instance().initialize({{"worker_cgroups_enabled", "false"}});
+}
+
 }  // namespace raylet
 
 }  // namespace ray
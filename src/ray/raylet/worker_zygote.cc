@@ -0,0 +1,203 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/worker_zygote.h"
+
+#ifdef __linux__
+#include <unistd.h>
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <cstdlib>
+#include <istream>
+#endif
+
+#include "ray/common/ray_config.h"
+#include "ray/util/logging.h"
+
+namespace ray {
+
+namespace raylet {
+
+#ifdef __linux__
+namespace {
+
+/// Sent to the zygote once the raylet knows the pid of the forked worker, which then
+/// starts.
+constexpr char kStartWorkerMessage[] = "start\n";
+
+}  // namespace
+
+/// A fork request to a zygote. It is kept alive by its pending handlers, and fails
+/// if the zygote does not reply within `worker_zygote_fork_timeout_ms`.
+class WorkerZygote::ForkRequest : public std::enable_shared_from_this<ForkRequest> {
+ public:
+  ForkRequest(boost::asio::io_service &io_service, pid_t zygote_pid,
+              std::shared_ptr<ZygoteState> zygote_state, std::string payload,
+              std::function<void(Process)> callback)
+      : socket_(io_service),
+        timer_(io_service),
+        zygote_pid_(zygote_pid),
+        zygote_state_(std::move(zygote_state)),
+        payload_(std::move(payload)),
+        callback_(std::move(callback)) {}
+
+  void Start(const std::string &socket_name) {
+    auto self = shared_from_this();
+    timer_.expires_from_now(boost::posix_time::milliseconds(
+        RayConfig::instance().worker_zygote_fork_timeout_ms()));
+    timer_.async_wait([self](const boost::system::error_code &error) {
+      if (error != boost::asio::error::operation_aborted) {
+        // Abort the pending operation on the socket.
+        boost::system::error_code ignored;
+        self->socket_.close(ignored);
+      }
+    });
+    // The name of an abstract socket starts with a null byte.
+    boost::asio::local::stream_protocol::endpoint endpoint(std::string(1, '\0') +
+                                                           socket_name);
+    socket_.async_connect(endpoint, [self](const boost::system::error_code &error) {
+      self->OnConnected(error);
+    });
+  }
+
+ private:
+  void OnConnected(const boost::system::error_code &error) {
+    if (error) {
+      // The zygote is still importing the runtime, or it died before it listened.
+      if (zygote_state_->listening) {
+        RAY_LOG(WARNING) << "Worker zygote " << zygote_pid_ << " stopped listening.";
+        zygote_state_->broken = true;
+      }
+      Finish(Process());
+      return;
+    }
+    auto self = shared_from_this();
+    boost::asio::async_write(
+        socket_, boost::asio::buffer(payload_),
+        [self](const boost::system::error_code &error, size_t bytes_transferred) {
+          if (error) {
+            self->Fail();
+            return;
+          }
+          boost::asio::async_read_until(
+              self->socket_, self->reply_, '\n',
+              [self](const boost::system::error_code &error, size_t bytes_transferred) {
+                self->OnReplied(error);
+              });
+        });
+  }
+
+  void OnReplied(const boost::system::error_code &error) {
+    if (error) {
+      Fail();
+      return;
+    }
+    std::istream stream(&reply_);
+    std::string line;
+    std::getline(stream, line);
+    pid_t pid = std::atoi(line.c_str());
+    if (pid <= 0) {
+      Fail();
+      return;
+    }
+    zygote_state_->listening = true;
+    RAY_LOG(DEBUG) << "Worker zygote " << zygote_pid_ << " forked worker " << pid;
+    Finish(Process::FromPid(pid));
+    // The raylet now knows the pid, so the worker can start and register.
+    auto self = shared_from_this();
+    boost::asio::async_write(
+        socket_,
+        boost::asio::buffer(kStartWorkerMessage, sizeof(kStartWorkerMessage) - 1),
+        [self](const boost::system::error_code &error, size_t bytes_transferred) {
+          if (error) {
+            // The worker exits without starting, and is counted as failed to register.
+            RAY_LOG(WARNING) << "Failed to start a worker forked from zygote "
+                             << self->zygote_pid_ << ": " << error.message();
+          }
+        });
+  }
+
+  void Fail() {
+    RAY_LOG(WARNING) << "Worker zygote " << zygote_pid_ << " failed to fork a worker.";
+    zygote_state_->broken = true;
+    boost::system::error_code ignored;
+    socket_.close(ignored);
+    Finish(Process());
+  }
+
+  void Finish(Process proc) {
+    timer_.cancel();
+    callback_(std::move(proc));
+  }
+
+  boost::asio::local::stream_protocol::socket socket_;
+  boost::asio::deadline_timer timer_;
+  const pid_t zygote_pid_;
+  const std::shared_ptr<ZygoteState> zygote_state_;
+  const std::string payload_;
+  boost::asio::streambuf reply_;
+  const std::function<void(Process)> callback_;
+};
+#endif
+
+WorkerZygote::WorkerZygote(boost::asio::io_service &io_service, Process process,
+                           const std::string &socket_name)
+    : io_service_(io_service),
+      process_(std::move(process)),
+      socket_name_(socket_name),
+      state_(std::make_shared<ZygoteState>()) {}
+
+WorkerZygote::~WorkerZygote() { process_.Kill(); }
+
+std::string WorkerZygote::MakeSocketName(const JobID &job_id) {
+  // A restarted zygote gets a new name, in case the socket of the previous one is not
+  // released yet.
+  static int num_zygotes = 0;
+  return "ray_worker_zygote_" + std::to_string(getpid()) + "_" + job_id.Hex() + "_" +
+         std::to_string(num_zygotes++);
+}
+
+void WorkerZygote::Fork(const std::vector<std::string> &worker_command_args,
+                        const ProcessEnvironment &env,
+                        std::function<void(Process)> callback) {
+#ifdef __linux__
+  if (!state_->broken) {
+    // The request is the number of arguments, the arguments and the environment
+    // variables, separated by null bytes and prefixed by their size.
+    std::string payload = std::to_string(worker_command_args.size());
+    for (const auto &arg : worker_command_args) {
+      payload.push_back('\0');
+      payload.append(arg);
+    }
+    for (const auto &entry : env) {
+      payload.push_back('\0');
+      payload.append(entry.first + "=" + entry.second);
+    }
+    auto request = std::make_shared<ForkRequest>(
+        io_service_, process_.GetId(), state_,
+        std::to_string(payload.size()) + "\n" + payload, std::move(callback));
+    request->Start(socket_name_);
+    return;
+  }
+#endif
+  io_service_.post([callback]() { callback(Process()); });
+}
+
+}  // namespace raylet
+
+}  // end namespace ray
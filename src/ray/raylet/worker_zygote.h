@@ -0,0 +1,104 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio/io_service.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ray/common/id.h"
+#include "ray/util/process.h"
+
+namespace ray {
+
+namespace raylet {
+
+/// The command line flag that turns a worker process into a zygote.
+constexpr char kWorkerZygoteSocketFlag[] = "--zygote-socket=";
+
+/// \class WorkerZygote
+///
+/// A zygote is a worker process of a job that imports the worker runtime and then,
+/// instead of connecting to the raylet, forks workers on request. The forked workers
+/// skip the imports, so they start in milliseconds instead of seconds.
+///
+/// The zygote listens on an abstract Unix socket. Each request carries the command
+/// line arguments and the environment variables of a worker, and the zygote replies
+/// with the pid of the forked worker. The forked worker waits for the raylet to
+/// acknowledge its pid before it starts, so that it cannot register before the raylet
+/// knows it. The zygote only serves its raylet. The forked workers are children of the
+/// zygote, which reaps them, and the zygote exits once the raylet is gone.
+///
+/// Only Python workers are forked, and only on Linux.
+class WorkerZygote {
+ public:
+  /// Create the handle of a zygote.
+  ///
+  /// \param io_service The event loop to talk to the zygote on.
+  /// \param process The zygote process.
+  /// \param socket_name The name of the socket the zygote listens on.
+  WorkerZygote(boost::asio::io_service &io_service, Process process,
+               const std::string &socket_name);
+
+  /// Kill the zygote. The workers forked from it keep running.
+  ~WorkerZygote();
+
+  /// Return a new name for the socket of a zygote of a job on this node, without the
+  /// leading null byte of abstract socket names.
+  static std::string MakeSocketName(const JobID &job_id);
+
+  /// Return the zygote process.
+  const Process &GetProcess() const { return process_; }
+
+  /// Return the name of the socket the zygote listens on.
+  const std::string &GetSocketName() const { return socket_name_; }
+
+  /// Fork a worker from the zygote. This does not block: the callback is called on the
+  /// event loop once the zygote replies, or after `worker_zygote_fork_timeout_ms`.
+  /// The forked worker starts once the callback returns.
+  ///
+  /// \param worker_command_args The command line arguments of the worker.
+  /// \param env The environment variables to set in the worker.
+  /// \param callback Called with the forked worker process, or with a null process if
+  /// the zygote is not listening yet or failed to fork the worker.
+  void Fork(const std::vector<std::string> &worker_command_args,
+            const ProcessEnvironment &env, std::function<void(Process)> callback);
+
+  /// Whether the zygote failed after it started to listen, in which case it will not
+  /// fork any more workers.
+  bool IsBroken() const { return state_->broken; }
+
+ private:
+  class ForkRequest;
+
+  /// What the pending fork requests learned about the zygote. It is shared with them,
+  /// as they may complete after the zygote was killed.
+  struct ZygoteState {
+    /// Whether the zygote already forked a worker.
+    bool listening = false;
+    bool broken = false;
+  };
+
+  boost::asio::io_service &io_service_;
+  Process process_;
+  const std::string socket_name_;
+  std::shared_ptr<ZygoteState> state_;
+};
+
+}  // namespace raylet
+
+}  // end namespace ray
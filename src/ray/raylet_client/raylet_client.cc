@@ -302,6 +302,18 @@ void raylet::RayletClient::RequestWorkerLease(
   grpc_client_->RequestWorkerLease(request, callback);
 }
 
+void raylet::RayletClient::RequestWorkerLeases(
+    const std::vector<TaskSpecification> &resource_specs,
+    const rpc::ClientCallback<rpc::RequestWorkerLeasesReply> &callback,
+    const int64_t backlog_size) {
+  rpc::RequestWorkerLeasesRequest request;
+  for (const auto &resource_spec : resource_specs) {
+    request.add_resource_specs()->CopyFrom(resource_spec.GetMessage());
+  }
+  request.set_backlog_size(backlog_size);
+  grpc_client_->RequestWorkerLeases(request, callback);
+}
+
 /// Spill objects to external storage.
 void raylet::RayletClient::RequestObjectSpillage(
     const ObjectID &object_id,
@@ -366,26 +378,32 @@ void raylet::RayletClient::CancelWorkerLease(
 }
 
 void raylet::RayletClient::PrepareBundleResources(
-    const BundleSpecification &bundle_spec,
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
     const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback) {
   rpc::PrepareBundleResourcesRequest request;
-  request.mutable_bundle_spec()->CopyFrom(bundle_spec.GetMessage());
+  for (const auto &bundle_spec : bundle_specs) {
+    request.add_bundle_specs()->CopyFrom(bundle_spec->GetMessage());
+  }
   grpc_client_->PrepareBundleResources(request, callback);
 }
 
 void raylet::RayletClient::CommitBundleResources(
-    const BundleSpecification &bundle_spec,
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
     const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback) {
   rpc::CommitBundleResourcesRequest request;
-  request.mutable_bundle_spec()->CopyFrom(bundle_spec.GetMessage());
+  for (const auto &bundle_spec : bundle_specs) {
+    request.add_bundle_specs()->CopyFrom(bundle_spec->GetMessage());
+  }
   grpc_client_->CommitBundleResources(request, callback);
 }
 
 void raylet::RayletClient::CancelResourceReserve(
-    BundleSpecification &bundle_spec,
+    const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
     const ray::rpc::ClientCallback<ray::rpc::CancelResourceReserveReply> &callback) {
   rpc::CancelResourceReserveRequest request;
-  request.mutable_bundle_spec()->CopyFrom(bundle_spec.GetMessage());
+  for (const auto &bundle_spec : bundle_specs) {
+    request.add_bundle_specs()->CopyFrom(bundle_spec->GetMessage());
+  }
   grpc_client_->CancelResourceReserve(request, callback);
 }
 
@@ -66,6 +66,17 @@ class WorkerLeaseInterface {
       const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
       const int64_t backlog_size = -1) = 0;
 
+  /// Requests several workers from the raylet with a single request. The raylet replies
+  /// once some of the leases are granted or spilled back, and cancels the others.
+  /// \param resource_specs The specs of the tasks to lease a worker for, which have the
+  /// same scheduling key.
+  /// \param backlog_size The queue length for the given shape on the CoreWorker, not
+  /// counting the requested leases.
+  virtual void RequestWorkerLeases(
+      const std::vector<ray::TaskSpecification> &resource_specs,
+      const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeasesReply> &callback,
+      const int64_t backlog_size = -1) = 0;
+
   /// Returns a worker to the raylet.
   /// \param worker_port The local port of the worker on the raylet node.
   /// \param worker_id The unique worker id of the worker on the raylet node.
@@ -92,29 +103,28 @@ class WorkerLeaseInterface {
 /// Interface for leasing resource.
 class ResourceReserveInterface {
  public:
-  /// Request a raylet to prepare resources of a given bundle for atomic placement group
-  /// creation. This is used for the first phase of atomic placement group creation. The
-  /// callback will be sent via gRPC.
-  /// \param resource_spec Resources that should be
-  /// allocated for the worker.
+  /// Request a raylet to prepare resources of the given bundles for atomic placement
+  /// group creation. This is used for the first phase of atomic placement group
+  /// creation. The bundles are prepared atomically: either all of them are prepared, or
+  /// none of them is. The callback will be sent via gRPC.
+  /// \param bundle_specs Bundles whose resources should be prepared on the raylet.
   /// \return ray::Status
   virtual void PrepareBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply>
           &callback) = 0;
 
-  /// Request a raylet to commit resources of a given bundle for atomic placement group
-  /// creation. This is used for the first phase of atomic placement group creation. The
-  /// callback will be sent via gRPC.
-  /// \param resource_spec Resources that should be
-  /// allocated for the worker.
+  /// Request a raylet to commit resources of the given bundles for atomic placement
+  /// group creation. This is used for the second phase of atomic placement group
+  /// creation. The callback will be sent via gRPC.
+  /// \param bundle_specs Bundles whose resources should be committed on the raylet.
   /// \return ray::Status
   virtual void CommitBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback) = 0;
 
   virtual void CancelResourceReserve(
-      BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::CancelResourceReserveReply> &callback) = 0;
 
   virtual void ReleaseUnusedBundles(
@@ -347,6 +357,12 @@ class RayletClient : public RayletClientInterface {
       const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
       const int64_t backlog_size) override;
 
+  /// Implements WorkerLeaseInterface.
+  void RequestWorkerLeases(
+      const std::vector<ray::TaskSpecification> &resource_specs,
+      const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeasesReply> &callback,
+      const int64_t backlog_size) override;
+
   /// Implements WorkerLeaseInterface.
   ray::Status ReturnWorker(int worker_port, const WorkerID &worker_id,
                            bool disconnect_worker) override;
@@ -362,19 +378,19 @@ class RayletClient : public RayletClientInterface {
 
   /// Implements PrepareBundleResourcesInterface.
   void PrepareBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::PrepareBundleResourcesReply> &callback)
       override;
 
   /// Implements CommitBundleResourcesInterface.
   void CommitBundleResources(
-      const BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::CommitBundleResourcesReply> &callback)
       override;
 
   /// Implements CancelResourceReserveInterface.
   void CancelResourceReserve(
-      BundleSpecification &bundle_spec,
+      const std::vector<std::shared_ptr<const BundleSpecification>> &bundle_specs,
       const ray::rpc::ClientCallback<ray::rpc::CancelResourceReserveReply> &callback)
       override;
 
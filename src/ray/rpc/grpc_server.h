@@ -26,12 +26,13 @@
 namespace ray {
 namespace rpc {
 
-#define RPC_SERVICE_HANDLER(SERVICE, HANDLER)                                   \
-  std::unique_ptr<ServerCallFactory> HANDLER##_call_factory(                    \
-      new ServerCallFactoryImpl<SERVICE, SERVICE##Handler, HANDLER##Request,    \
-                                HANDLER##Reply>(                                \
-          service_, &SERVICE::AsyncService::Request##HANDLER, service_handler_, \
-          &SERVICE##Handler::Handle##HANDLER, cq, main_service_));              \
+#define RPC_SERVICE_HANDLER(SERVICE, HANDLER)                                     \
+  std::unique_ptr<ServerCallFactory> HANDLER##_call_factory(                      \
+      new ServerCallFactoryImpl<SERVICE, SERVICE##Handler, HANDLER##Request,      \
+                                HANDLER##Reply>(                                  \
+          service_, &SERVICE::AsyncService::Request##HANDLER, service_handler_,   \
+          &SERVICE##Handler::Handle##HANDLER, cq, main_service_,                  \
+          #SERVICE "." #HANDLER));                                                \
   server_call_factories->emplace_back(std::move(HANDLER##_call_factory));
 
 // Define a void RPC client method.
@@ -49,6 +49,9 @@ class NodeManagerClient {
     GetNodeStats(request, callback);
   }
 
+  /// Ask a remote node manager to redirect queued tasks to this node.
+  VOID_RPC_CLIENT_METHOD(NodeManagerService, StealTasks, grpc_client_, )
+
  private:
   /// The RPC client.
   std::unique_ptr<GrpcClient<NodeManagerService>> grpc_client_;
@@ -73,6 +76,9 @@ class NodeManagerWorkerClient
   /// Request a worker lease.
   VOID_RPC_CLIENT_METHOD(NodeManagerService, RequestWorkerLease, grpc_client_, )
 
+  /// Request several worker leases at once.
+  VOID_RPC_CLIENT_METHOD(NodeManagerService, RequestWorkerLeases, grpc_client_, )
+
   /// Return a worker lease.
   VOID_RPC_CLIENT_METHOD(NodeManagerService, ReturnWorker, grpc_client_, )
 
@@ -106,6 +112,12 @@ class NodeManagerWorkerClient
   /// Release unused bundles.
   VOID_RPC_CLIENT_METHOD(NodeManagerService, ReleaseUnusedBundles, grpc_client_, )
 
+  /// Reserve resources for a group of leases, all or nothing.
+  VOID_RPC_CLIENT_METHOD(NodeManagerService, RequestGangLease, grpc_client_, )
+
+  /// Release the resources of a gang.
+  VOID_RPC_CLIENT_METHOD(NodeManagerService, ReturnGangLease, grpc_client_, )
+
  private:
   /// Constructor.
   ///
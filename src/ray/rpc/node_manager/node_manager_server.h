@@ -25,6 +25,7 @@ namespace rpc {
 /// NOTE: See src/ray/core_worker/core_worker.h on how to add a new grpc handler.
 #define RAY_NODE_MANAGER_RPC_HANDLERS                             \
   RPC_SERVICE_HANDLER(NodeManagerService, RequestWorkerLease)     \
+  RPC_SERVICE_HANDLER(NodeManagerService, RequestWorkerLeases)    \
   RPC_SERVICE_HANDLER(NodeManagerService, ReturnWorker)           \
   RPC_SERVICE_HANDLER(NodeManagerService, ReleaseUnusedWorkers)   \
   RPC_SERVICE_HANDLER(NodeManagerService, CancelWorkerLease)      \
@@ -37,7 +38,10 @@ namespace rpc {
   RPC_SERVICE_HANDLER(NodeManagerService, CancelResourceReserve)  \
   RPC_SERVICE_HANDLER(NodeManagerService, RequestObjectSpillage)  \
   RPC_SERVICE_HANDLER(NodeManagerService, RestoreSpilledObject)   \
-  RPC_SERVICE_HANDLER(NodeManagerService, ReleaseUnusedBundles)
+  RPC_SERVICE_HANDLER(NodeManagerService, ReleaseUnusedBundles)   \
+  RPC_SERVICE_HANDLER(NodeManagerService, StealTasks)             \
+  RPC_SERVICE_HANDLER(NodeManagerService, RequestGangLease)       \
+  RPC_SERVICE_HANDLER(NodeManagerService, ReturnGangLease)
 
 /// Interface of the `NodeManagerService`, see `src/ray/protobuf/node_manager.proto`.
 class NodeManagerServiceHandler {
@@ -57,6 +61,10 @@ class NodeManagerServiceHandler {
                                         RequestWorkerLeaseReply *reply,
                                         SendReplyCallback send_reply_callback) = 0;
 
+  virtual void HandleRequestWorkerLeases(const RequestWorkerLeasesRequest &request,
+                                         RequestWorkerLeasesReply *reply,
+                                         SendReplyCallback send_reply_callback) = 0;
+
   virtual void HandleReturnWorker(const ReturnWorkerRequest &request,
                                   ReturnWorkerReply *reply,
                                   SendReplyCallback send_reply_callback) = 0;
@@ -110,6 +118,17 @@ class NodeManagerServiceHandler {
   virtual void HandleReleaseUnusedBundles(const ReleaseUnusedBundlesRequest &request,
                                           ReleaseUnusedBundlesReply *reply,
                                           SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleStealTasks(const StealTasksRequest &request, StealTasksReply *reply,
+                                SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleRequestGangLease(const RequestGangLeaseRequest &request,
+                                      RequestGangLeaseReply *reply,
+                                      SendReplyCallback send_reply_callback) = 0;
+
+  virtual void HandleReturnGangLease(const ReturnGangLeaseRequest &request,
+                                     ReturnGangLeaseReply *reply,
+                                     SendReplyCallback send_reply_callback) = 0;
 };
 
 /// The `GrpcService` for `NodeManagerService`.
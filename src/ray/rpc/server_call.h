@@ -18,8 +18,10 @@
 
 #include <boost/asio.hpp>
 
+#include "absl/time/clock.h"
 #include "ray/common/grpc_util.h"
 #include "ray/common/status.h"
+#include "ray/util/event_stats.h"
 
 namespace ray {
 namespace rpc {
@@ -122,16 +124,18 @@ class ServerCallImpl : public ServerCall {
   /// \param[in] service_handler The service handler that handles the request.
   /// \param[in] handle_request_function Pointer to the service handler function.
   /// \param[in] io_service The event loop.
+  /// \param[in] call_name The name of the RPC method, for the event loop stats.
   ServerCallImpl(
       const ServerCallFactory &factory, ServiceHandler &service_handler,
       HandleRequestFunction<ServiceHandler, Request, Reply> handle_request_function,
-      boost::asio::io_service &io_service)
+      boost::asio::io_service &io_service, const std::string &call_name)
       : state_(ServerCallState::PENDING),
         factory_(factory),
         service_handler_(service_handler),
         handle_request_function_(handle_request_function),
         response_writer_(&context_),
-        io_service_(io_service) {}
+        io_service_(io_service),
+        call_name_(call_name) {}
 
   ServerCallState GetState() const override { return state_; }
 
@@ -139,6 +143,7 @@ class ServerCallImpl : public ServerCall {
 
   void HandleRequest() override {
     if (!io_service_.stopped()) {
+      queued_at_ns_ = absl::GetCurrentTimeNanos();
       io_service_.post([this] { HandleRequestImpl(); });
     } else {
       // Handle service for rpc call has stopped, we must handle the call here
@@ -149,6 +154,8 @@ class ServerCallImpl : public ServerCall {
   }
 
   void HandleRequestImpl() {
+    // NOTE: The timer does not refer to this call, which may be deleted by the handler.
+    ScopedHandlerTimer timer(call_name_, queued_at_ns_);
     state_ = ServerCallState::PROCESSING;
     // NOTE(hchen): This `factory` local variable is needed. Because `SendReply` runs in
     // a different thread, and will cause `this` to be deleted.
@@ -216,6 +223,12 @@ class ServerCallImpl : public ServerCall {
   /// The event loop.
   boost::asio::io_service &io_service_;
 
+  /// The name of the RPC method.
+  const std::string &call_name_;
+
+  /// When the request was posted to the event loop.
+  int64_t queued_at_ns_ = -1;
+
   /// The request message.
   Request request_;
 
@@ -262,25 +275,27 @@ class ServerCallFactoryImpl : public ServerCallFactory {
   /// \param[in] handle_request_function Pointer to the service handler function.
   /// \param[in] cq The `CompletionQueue`.
   /// \param[in] io_service The event loop.
+  /// \param[in] call_name The name of the RPC method, for the event loop stats.
   ServerCallFactoryImpl(
       AsyncService &service,
       RequestCallFunction<GrpcService, Request, Reply> request_call_function,
       ServiceHandler &service_handler,
       HandleRequestFunction<ServiceHandler, Request, Reply> handle_request_function,
       const std::unique_ptr<grpc::ServerCompletionQueue> &cq,
-      boost::asio::io_service &io_service)
+      boost::asio::io_service &io_service, std::string call_name)
       : service_(service),
         request_call_function_(request_call_function),
         service_handler_(service_handler),
         handle_request_function_(handle_request_function),
         cq_(cq),
-        io_service_(io_service) {}
+        io_service_(io_service),
+        call_name_(std::move(call_name)) {}
 
   void CreateCall() const override {
     // Create a new `ServerCall`. This object will eventually be deleted by
     // `GrpcServer::PollEventsFromCompletionQueue`.
     auto call = new ServerCallImpl<ServiceHandler, Request, Reply>(
-        *this, service_handler_, handle_request_function_, io_service_);
+        *this, service_handler_, handle_request_function_, io_service_, call_name_);
     /// Request gRPC runtime to starting accepting this kind of request, using the call as
     /// the tag.
     (service_.*request_call_function_)(&call->context_, &call->request_,
@@ -306,6 +321,9 @@ class ServerCallFactoryImpl : public ServerCallFactory {
 
   /// The event loop.
   boost::asio::io_service &io_service_;
+
+  /// The name of the RPC method.
+  const std::string call_name_;
 };
 
 }  // namespace rpc
@@ -142,6 +142,16 @@ class CoreWorkerClientInterface {
       const WaitForObjectEvictionRequest &request,
       const ClientCallback<WaitForObjectEvictionReply> &callback) {}
 
+  /// Notify the owner of a batch of objects that the objects have been pinned.
+  virtual void AddObjectEvictionSubscriptions(
+      const AddObjectEvictionSubscriptionsRequest &request,
+      const ClientCallback<AddObjectEvictionSubscriptionsReply> &callback) {}
+
+  /// Wait for the owner to report pinned objects that have gone out of scope.
+  virtual void GetObjectEvictions(
+      const GetObjectEvictionsRequest &request,
+      const ClientCallback<GetObjectEvictionsReply> &callback) {}
+
   virtual void AddObjectLocationOwner(
       const AddObjectLocationOwnerRequest &request,
       const ClientCallback<AddObjectLocationOwnerReply> &callback) {}
@@ -230,6 +240,11 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
 
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, WaitForObjectEviction, grpc_client_, override)
 
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, AddObjectEvictionSubscriptions, grpc_client_,
+                         override)
+
+  VOID_RPC_CLIENT_METHOD(CoreWorkerService, GetObjectEvictions, grpc_client_, override)
+
   VOID_RPC_CLIENT_METHOD(CoreWorkerService, AddObjectLocationOwner, grpc_client_,
                          override)
 
@@ -32,6 +32,8 @@ namespace rpc {
   RPC_SERVICE_HANDLER(CoreWorkerService, GetObjectStatus)                \
   RPC_SERVICE_HANDLER(CoreWorkerService, WaitForActorOutOfScope)         \
   RPC_SERVICE_HANDLER(CoreWorkerService, WaitForObjectEviction)          \
+  RPC_SERVICE_HANDLER(CoreWorkerService, AddObjectEvictionSubscriptions) \
+  RPC_SERVICE_HANDLER(CoreWorkerService, GetObjectEvictions)             \
   RPC_SERVICE_HANDLER(CoreWorkerService, WaitForRefRemoved)              \
   RPC_SERVICE_HANDLER(CoreWorkerService, AddObjectLocationOwner)         \
   RPC_SERVICE_HANDLER(CoreWorkerService, RemoveObjectLocationOwner)      \
@@ -53,6 +55,8 @@ namespace rpc {
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(GetObjectStatus)                \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(WaitForActorOutOfScope)         \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(WaitForObjectEviction)          \
+  DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(AddObjectEvictionSubscriptions) \
+  DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(GetObjectEvictions)             \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(WaitForRefRemoved)              \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(AddObjectLocationOwner)         \
   DECLARE_VOID_RPC_SERVICE_HANDLER_METHOD(RemoveObjectLocationOwner)      \
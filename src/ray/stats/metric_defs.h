@@ -75,6 +75,21 @@ static Histogram HeartbeatReportMs(
     "heartbeats.",
     "ms", {100, 200, 400, 800, 1600, 3200, 6400, 15000, 30000});
 
+static Histogram EventLoopLagMs(
+    "event_loop_lag_ms",
+    "How late a periodic timer runs on the raylet event loop. If this value is high, "
+    "the event loop is saturated by its handlers.",
+    "ms", {1, 10, 100, 1000, 10000});
+
+static Histogram HandlerQueueingMs(
+    "handler_queueing_ms",
+    "Time an event loop handler waited between being posted and running.", "ms",
+    {0.1, 1, 10, 100, 1000, 10000}, {HandlerNameKey});
+
+static Histogram HandlerExecutionMs("handler_execution_ms",
+                                    "Execution time of an event loop handler.", "ms",
+                                    {0.1, 1, 10, 100, 1000, 10000}, {HandlerNameKey});
+
 static Histogram ProcessStartupTimeMs("process_startup_time_ms",
                                       "Time to start up a worker process.", "ms",
                                       {1, 10, 100, 1000, 10000});
@@ -94,6 +109,35 @@ static Gauge AvgNumExecutedTasks("avg_num_executed_tasks",
 static Gauge AvgNumSpilledBackTasks("avg_num_spilled_back_tasks",
                                     "Number of spilled back tasks per second.", "tasks");
 
+static Histogram SpillManagerLatencyMs(
+    "spill_manager_latency_ms",
+    "End-to-end latency of a successful spill, restore or delete operation, including "
+    "the time spent waiting for an IO worker.",
+    "ms", {1, 10, 100, 1000, 10000, 100000}, {SpillOperationKey});
+
+static Histogram SpillManagerIOWorkerQueueingMs(
+    "spill_manager_io_worker_queueing_ms",
+    "Time a spill, restore or delete request waited for an IO worker to become "
+    "available.",
+    "ms", {1, 10, 100, 1000, 10000, 100000}, {SpillOperationKey});
+
+static Histogram SpillManagerBatchBytes(
+    "spill_manager_batch_bytes",
+    "Number of bytes spilled or restored by a single IO worker request.", "bytes",
+    {1024, 1024 * 1024, 16 * 1024 * 1024, 100 * 1024 * 1024, 1024 * 1024 * 1024},
+    {SpillOperationKey});
+
+static Gauge SpillManagerThroughputMB(
+    "spill_manager_throughput_mb",
+    "Cumulative spill or restore throughput of this node in MiB/s.", "MiB/s",
+    {SpillOperationKey});
+
+static Gauge SpillManagerBlockedCreateRequests(
+    "spill_manager_num_blocked_create_requests",
+    "Number of object creation requests queued in the object store while waiting "
+    "for objects to be spilled.",
+    "requests");
+
 ///
 /// GCS Server Metrics
 ///
@@ -39,3 +39,7 @@ static const TagKeyType DriverPidKey = TagKeyType::Register("DriverPid");
 static const TagKeyType ResourceNameKey = TagKeyType::Register("ResourceName");
 
 static const TagKeyType ActorIdKey = TagKeyType::Register("ActorId");
+
+static const TagKeyType SpillOperationKey = TagKeyType::Register("SpillOperation");
+
+static const TagKeyType HandlerNameKey = TagKeyType::Register("HandlerName");
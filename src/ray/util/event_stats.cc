@@ -0,0 +1,96 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/event_stats.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "absl/time/clock.h"
+
+namespace ray {
+
+EventTracker &EventTracker::Instance() {
+  static EventTracker instance;
+  return instance;
+}
+
+void EventTracker::RecordExecution(const std::string &name, int64_t queueing_ns,
+                                   int64_t execution_ns) {
+  Recorder recorder;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto &stats = stats_[name];
+    stats.count++;
+    stats.cum_queueing_ns += queueing_ns;
+    stats.max_queueing_ns = std::max(stats.max_queueing_ns, queueing_ns);
+    stats.cum_execution_ns += execution_ns;
+    stats.max_execution_ns = std::max(stats.max_execution_ns, execution_ns);
+    recorder = recorder_;
+  }
+  if (recorder) {
+    recorder(name, queueing_ns, execution_ns);
+  }
+}
+
+void EventTracker::SetRecorder(Recorder recorder) {
+  absl::MutexLock lock(&mutex_);
+  recorder_ = std::move(recorder);
+}
+
+std::vector<std::pair<std::string, HandlerStats>> EventTracker::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  return {stats_.begin(), stats_.end()};
+}
+
+std::string EventTracker::DebugString() const {
+  auto stats = GetStats();
+  std::sort(stats.begin(), stats.end(), [](const auto &left, const auto &right) {
+    return left.second.cum_execution_ns > right.second.cum_execution_ns;
+  });
+  std::stringstream result;
+  result << "EventTracker:";
+  for (const auto &entry : stats) {
+    const auto &handler = entry.second;
+    result << "\n- " << entry.first << ": count " << handler.count
+           << ", total execution ms " << handler.cum_execution_ns / 1000000
+           << ", max execution ms " << handler.max_execution_ns / 1000000
+           << ", mean queueing ms "
+           << handler.cum_queueing_ns / std::max<int64_t>(handler.count, 1) / 1000000.0
+           << ", max queueing ms " << handler.max_queueing_ns / 1000000;
+  }
+  return result.str();
+}
+
+ScopedHandlerTimer::ScopedHandlerTimer(std::string name, int64_t queued_at_ns)
+    : name_(std::move(name)),
+      start_ns_(absl::GetCurrentTimeNanos()),
+      queueing_ns_(queued_at_ns < 0 ? 0
+                                    : std::max<int64_t>(start_ns_ - queued_at_ns, 0)) {}
+
+ScopedHandlerTimer::~ScopedHandlerTimer() {
+  EventTracker::Instance().RecordExecution(name_, queueing_ns_,
+                                           absl::GetCurrentTimeNanos() - start_ns_);
+}
+
+void PostWithStats(boost::asio::io_service &io_service, std::function<void()> handler,
+                   std::string name) {
+  const int64_t queued_at_ns = absl::GetCurrentTimeNanos();
+  io_service.post([handler = std::move(handler), name = std::move(name), queued_at_ns]() {
+    ScopedHandlerTimer timer(name, queued_at_ns);
+    handler();
+  });
+}
+
+}  // namespace ray
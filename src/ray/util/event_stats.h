@@ -0,0 +1,99 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+
+namespace ray {
+
+/// The statistics of the executions of an event loop handler.
+struct HandlerStats {
+  /// The number of executions.
+  int64_t count = 0;
+  /// The total and the largest time between posting the handler and running it.
+  int64_t cum_queueing_ns = 0;
+  int64_t max_queueing_ns = 0;
+  /// The total and the largest execution time of the handler.
+  int64_t cum_execution_ns = 0;
+  int64_t max_execution_ns = 0;
+};
+
+/// \class EventTracker
+///
+/// Tracks the queueing delay and the execution time of the handlers run by the event
+/// loops of the process, per handler name, so that the handlers that saturate an event
+/// loop can be found. This class is thread safe.
+class EventTracker {
+ public:
+  /// Called with each execution, with the name of the handler, its queueing delay and
+  /// its execution time.
+  using Recorder =
+      std::function<void(const std::string &, int64_t queueing_ns, int64_t execution_ns)>;
+
+  /// The tracker of the process.
+  static EventTracker &Instance();
+
+  /// Record an execution of a handler.
+  ///
+  /// \param name The name of the handler.
+  /// \param queueing_ns The time between posting the handler and running it.
+  /// \param execution_ns The execution time of the handler.
+  void RecordExecution(const std::string &name, int64_t queueing_ns,
+                       int64_t execution_ns);
+
+  /// Set a function called with each execution, to export it as metrics.
+  void SetRecorder(Recorder recorder);
+
+  /// Return the statistics of each handler.
+  std::vector<std::pair<std::string, HandlerStats>> GetStats() const;
+
+  /// Return the handlers with the largest total execution time first.
+  std::string DebugString() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  std::unordered_map<std::string, HandlerStats> stats_ GUARDED_BY(mutex_);
+  Recorder recorder_ GUARDED_BY(mutex_);
+};
+
+/// Times a handler from its construction to its destruction, and records it to the
+/// event tracker.
+class ScopedHandlerTimer {
+ public:
+  /// \param name The name of the handler.
+  /// \param queued_at_ns When the handler was posted or was due, or -1 if unknown.
+  ScopedHandlerTimer(std::string name, int64_t queued_at_ns = -1);
+
+  ~ScopedHandlerTimer();
+
+ private:
+  const std::string name_;
+  const int64_t start_ns_;
+  const int64_t queueing_ns_;
+};
+
+/// Post a handler to an event loop, and record its queueing delay and its execution
+/// time under the given name.
+void PostWithStats(boost::asio::io_service &io_service, std::function<void()> handler,
+                   std::string name);
+
+}  // namespace ray
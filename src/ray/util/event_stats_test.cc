@@ -0,0 +1,69 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/util/event_stats.h"
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+HandlerStats GetHandlerStats(const std::string &name) {
+  for (const auto &entry : EventTracker::Instance().GetStats()) {
+    if (entry.first == name) {
+      return entry.second;
+    }
+  }
+  return HandlerStats();
+}
+
+TEST(EventStatsTest, TestRecordExecution) {
+  EventTracker::Instance().RecordExecution("TestRecordExecution", 10, 100);
+  EventTracker::Instance().RecordExecution("TestRecordExecution", 30, 50);
+  auto stats = GetHandlerStats("TestRecordExecution");
+  ASSERT_EQ(stats.count, 2);
+  ASSERT_EQ(stats.cum_queueing_ns, 40);
+  ASSERT_EQ(stats.max_queueing_ns, 30);
+  ASSERT_EQ(stats.cum_execution_ns, 150);
+  ASSERT_EQ(stats.max_execution_ns, 100);
+}
+
+TEST(EventStatsTest, TestPostWithStats) {
+  std::vector<std::pair<std::string, int64_t>> recorded;
+  EventTracker::Instance().SetRecorder(
+      [&recorded](const std::string &name, int64_t queueing_ns, int64_t execution_ns) {
+        recorded.emplace_back(name, execution_ns);
+      });
+  boost::asio::io_service io_service;
+  PostWithStats(
+      io_service,
+      []() { std::this_thread::sleep_for(std::chrono::milliseconds(10)); },
+      "TestPostWithStats");
+  // The handler waits in the queue until the event loop runs.
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  io_service.run();
+  EventTracker::Instance().SetRecorder(nullptr);
+
+  auto stats = GetHandlerStats("TestPostWithStats");
+  ASSERT_EQ(stats.count, 1);
+  ASSERT_GE(stats.cum_queueing_ns, 10 * 1000 * 1000);
+  ASSERT_GE(stats.cum_execution_ns, 10 * 1000 * 1000);
+  ASSERT_EQ(recorded.size(), 1);
+  ASSERT_EQ(recorded[0].first, "TestPostWithStats");
+  ASSERT_EQ(recorded[0].second, stats.cum_execution_ns);
+}
+
+}  // namespace ray